@@ -0,0 +1,505 @@
+import Foundation
+import OmFileFormat
+import OmFileFormatC
+
+/// Benchmarks for codecs, filters, decoder planning and end-to-end reads.
+///
+/// Run with `swift run -c release OmFileFormatBenchmarks [--quick] [--output results.jsonl] [--file real.om]`.
+/// Each result is printed as one JSON object per line. With `--output`, results are appended to a file to track them over time.
+/// `--file` adds a real world field from an OM file. The root variable or the first float array child is used.
+@main
+struct OmFileFormatBenchmarks {
+    static func main() async throws {
+        let arguments = Array(CommandLine.arguments.dropFirst())
+        func value(_ name: String) -> String? {
+            return arguments.firstIndex(of: name).flatMap { $0 + 1 < arguments.count ? arguments[$0 + 1] : nil }
+        }
+        let quick = arguments.contains("--quick")
+        let benchmark = Benchmark(minTime: quick ? 0.05 : 0.5, output: value("--output"))
+
+        var fields = [
+            Field.temperature(dimensions: [128, 128, 48], chunks: [4, 16, 24]),
+            Field.precipitation(dimensions: [128, 128, 48], chunks: [4, 16, 24]),
+            Field.noise(dimensions: [128, 128, 48], chunks: [4, 16, 24])
+        ]
+        if let file = value("--file") {
+            fields.append(try await Field.read(file: file))
+        }
+
+        for field in fields {
+            try benchmark.codecs(field: field)
+            try benchmark.planning(field: field)
+            try await benchmark.reads(field: field)
+        }
+        benchmark.filters()
+    }
+}
+
+/// A field of float values with chunk dimensions used for writing
+struct Field {
+    let name: String
+    let dimensions: [UInt64]
+    let chunks: [UInt64]
+    let values: [Float]
+
+    /// Smooth field with a diurnal cycle and small noise similar to 2 metre temperature
+    static func temperature(dimensions: [UInt64], chunks: [UInt64]) -> Field {
+        var random = SplitMix64(seed: 1)
+        let values = Field.generate(dimensions: dimensions) { x, y, t in
+            let spatial = 10 * sin(Float(x) * 0.05) * cos(Float(y) * 0.03)
+            let diurnal = 5 * sin(Float(t) * 2 * .pi / 24)
+            return 15 + spatial + diurnal + Float.random(in: -0.05...0.05, using: &random)
+        }
+        return Field(name: "temperature", dimensions: dimensions, chunks: chunks, values: values)
+    }
+
+    /// Mostly zero with localised showers similar to precipitation
+    static func precipitation(dimensions: [UInt64], chunks: [UInt64]) -> Field {
+        var random = SplitMix64(seed: 2)
+        let values = Field.generate(dimensions: dimensions) { x, y, t in
+            let cells = sin(Float(x) * 0.2 + Float(t) * 0.3) * cos(Float(y) * 0.15 - Float(t) * 0.1)
+            guard cells > 0.7 else {
+                return 0
+            }
+            return (cells - 0.7) * 20 + Float.random(in: 0...0.5, using: &random)
+        }
+        return Field(name: "precipitation", dimensions: dimensions, chunks: chunks, values: values)
+    }
+
+    /// Uniform white noise. Worst case for delta coding.
+    static func noise(dimensions: [UInt64], chunks: [UInt64]) -> Field {
+        var random = SplitMix64(seed: 3)
+        let values = Field.generate(dimensions: dimensions) { _, _, _ in
+            return Float.random(in: -100...100, using: &random)
+        }
+        return Field(name: "noise", dimensions: dimensions, chunks: chunks, values: values)
+    }
+
+    /// Call `fn` with the first, the second and the last coordinate for each element of a row-major array
+    static func generate(dimensions: [UInt64], _ fn: (Int, Int, Int) -> Float) -> [Float] {
+        let count = Int(dimensions.reduce(1, *))
+        let last = Int(dimensions.last ?? 1)
+        let second = dimensions.count >= 3 ? Int(dimensions[dimensions.count - 2]) : 1
+        return (0..<count).map { i in
+            fn(i / last / second, (i / last) % second, i % last)
+        }
+    }
+
+    /// Read a real world field. Large arrays are reduced along the leading dimensions to at most 16 million elements.
+    static func read(file: String) async throws -> Field {
+        let reader = try await OmFileReader(mmapFile: file)
+        var array = reader.asArray(of: Float.self)
+        for i in 0..<reader.numberOfChildren where array == nil {
+            array = try await reader.getChild(i)?.asArray(of: Float.self)
+        }
+        guard let array else {
+            throw OmFileFormatSwiftError.invalidDataType
+        }
+        let chunks = array.getChunkDimensions()
+        var dimensions = array.getDimensions()
+        let limit: UInt64 = 16 * 1024 * 1024
+        for i in 0..<dimensions.count where dimensions.reduce(1, *) > limit {
+            let rest = dimensions.reduce(1, *) / dimensions[i]
+            dimensions[i] = max(min(chunks[i], dimensions[i]), limit / max(rest, 1))
+        }
+        let values = try await array.read(range: dimensions.map { 0..<$0 })
+        let name = URL(fileURLWithPath: file).deletingPathExtension().lastPathComponent
+        return Field(name: name, dimensions: dimensions, chunks: chunks, values: values)
+    }
+
+    var bytes: Int {
+        return values.count * MemoryLayout<Float>.stride
+    }
+}
+
+/// One benchmark result. Encoded as a single JSON line.
+struct BenchmarkResult: Encodable {
+    let suite: String
+    let name: String
+    let field: String
+    var dataType: String? = nil
+    var compression: String? = nil
+    var chunks: String? = nil
+    var shape: String? = nil
+    var compressionRatio: Double? = nil
+    let iterations: Int
+    /// Fastest iteration
+    let seconds: Double
+    /// Uncompressed bytes processed in one iteration
+    let bytes: Int
+    /// Operations in one iteration, e.g. point reads or data reads
+    let operations: Int
+    let gigabytesPerSecond: Double
+    let operationsPerSecond: Double
+    let timestamp: String
+}
+
+struct Benchmark {
+    /// Minimum time to repeat each benchmark in seconds
+    let minTime: Double
+    /// Results are appended to this file
+    let output: String?
+    let timestamp = ISO8601DateFormatter().string(from: Date())
+    let encoder: JSONEncoder = {
+        let encoder = JSONEncoder()
+        encoder.outputFormatting = .sortedKeys
+        return encoder
+    }()
+
+    init(minTime: Double, output: String?) {
+        self.minTime = minTime
+        self.output = output
+    }
+
+    /// Run `body` once to warm up and then repeatedly until `minTime` has elapsed. Returns the fastest iteration.
+    func measure(_ body: () throws -> Void) rethrows -> (iterations: Int, seconds: Double) {
+        try body()
+        var iterations = 0
+        var best = Double.infinity
+        let start = DispatchTime.now().uptimeNanoseconds
+        repeat {
+            let t = DispatchTime.now().uptimeNanoseconds
+            try body()
+            best = min(best, Double(DispatchTime.now().uptimeNanoseconds - t) / 1e9)
+            iterations += 1
+        } while iterations < 3 || Double(DispatchTime.now().uptimeNanoseconds - start) / 1e9 < minTime
+        return (iterations, best)
+    }
+
+    /// Async version of `measure`
+    func measureAsync(_ body: () async throws -> Void) async rethrows -> (iterations: Int, seconds: Double) {
+        try await body()
+        var iterations = 0
+        var best = Double.infinity
+        let start = DispatchTime.now().uptimeNanoseconds
+        repeat {
+            let t = DispatchTime.now().uptimeNanoseconds
+            try await body()
+            best = min(best, Double(DispatchTime.now().uptimeNanoseconds - t) / 1e9)
+            iterations += 1
+        } while iterations < 3 || Double(DispatchTime.now().uptimeNanoseconds - start) / 1e9 < minTime
+        return (iterations, best)
+    }
+
+    /// Print a result as JSON line and append it to `output`
+    func report(suite: String, name: String, field: String, measurement: (iterations: Int, seconds: Double), bytes: Int, operations: Int = 1, configure: (inout BenchmarkResult) -> Void = { _ in }) {
+        var result = BenchmarkResult(
+            suite: suite,
+            name: name,
+            field: field,
+            iterations: measurement.iterations,
+            seconds: measurement.seconds,
+            bytes: bytes,
+            operations: operations,
+            gigabytesPerSecond: Double(bytes) / measurement.seconds / 1e9,
+            operationsPerSecond: Double(operations) / measurement.seconds,
+            timestamp: timestamp
+        )
+        configure(&result)
+        guard let json = try? encoder.encode(result) else {
+            return
+        }
+        print(String(decoding: json, as: UTF8.self))
+        if let output {
+            if !FileManager.default.fileExists(atPath: output) {
+                FileManager.default.createFile(atPath: output, contents: nil)
+            }
+            if let handle = FileHandle(forWritingAtPath: output) {
+                handle.seekToEndOfFile()
+                handle.write(json + [UInt8(ascii: "\n")])
+                handle.closeFile()
+            }
+        }
+    }
+
+    /// Raw compression and decompression throughput for each data type and compression
+    /// `om_encode_compress` and `om_decode_decompress` are internal inline helpers of the C library and are not exported.
+    /// They are measured through the public `om_encoder_compress_chunk` and `om_decoder_decode_chunks`, which add the chunk copy.
+    func codecs(field: Field) throws {
+        let configurations: [(compression: OmCompressionType, scaleFactor: Float)] = [
+            (.pfor_delta2d_int16, 20),
+            (.pfor_delta2d_int16_logarithmic, 20),
+            (.pfor_delta2d, 1000),
+            (.fpx_xor2d, 1),
+            (.pfor_float_linear2d, 1)
+        ]
+        for (compression, scaleFactor) in configurations {
+            try codec(field: field, values: field.values, compression: compression, scaleFactor: scaleFactor)
+        }
+        let doubles = field.values.map(Double.init)
+        for (compression, scaleFactor) in configurations where compression == .pfor_delta2d || compression == .fpx_xor2d || compression == .pfor_float_linear2d {
+            try codec(field: field, values: doubles, compression: compression, scaleFactor: scaleFactor)
+        }
+    }
+
+    func codec<OmType: OmFileArrayDataTypeProtocol>(field: Field, values: [OmType], compression: OmCompressionType, scaleFactor: Float) throws {
+        let bytes = values.count * MemoryLayout<OmType>.stride
+        let dataType = "\(OmType.self)".lowercased()
+
+        // Encode all chunks with `om_encoder_compress_chunk`
+        var compressedBytes = 0
+        let encode = try values.withUnsafeBufferPointer { values in
+            try field.dimensions.withUnsafeBufferPointer { dimensions in
+                try field.chunks.withUnsafeBufferPointer { chunks in
+                    var encoder = OmEncoder_t()
+                    let error = om_encoder_init(&encoder, scaleFactor, 0, OmCompression_t(rawValue: numericCast(compression.rawValue)), OmDataType_t(rawValue: numericCast(OmType.dataTypeArray.rawValue)), dimensions.baseAddress, chunks.baseAddress, UInt64(dimensions.count))
+                    guard error == ERROR_OK else {
+                        throw OmFileFormatSwiftError.omEncoder(error: String(cString: om_error_string(error)))
+                    }
+                    let nChunks = om_encoder_count_chunks(&encoder)
+                    let chunkBuffer = UnsafeMutablePointer<UInt8>.allocate(capacity: Int(om_encoder_chunk_buffer_size(&encoder)))
+                    defer { chunkBuffer.deallocate() }
+                    let outSize = Int(om_encoder_compressed_chunk_buffer_size(&encoder) * nChunks)
+                    let out = UnsafeMutablePointer<UInt8>.allocate(capacity: outSize)
+                    defer { out.deallocate() }
+                    let offset = [UInt64](repeating: 0, count: dimensions.count)
+                    return measure {
+                        var position = 0
+                        for chunk in 0..<nChunks {
+                            position += Int(om_encoder_compress_chunk(&encoder, values.baseAddress, dimensions.baseAddress, offset, dimensions.baseAddress, chunk, chunk, out.advanced(by: position), chunkBuffer))
+                        }
+                        compressedBytes = position
+                    }
+                }
+            }
+        }
+        let ratio = Double(bytes) / Double(max(compressedBytes, 1))
+        report(suite: "codec", name: "encode", field: field.name, measurement: encode, bytes: bytes) {
+            $0.dataType = dataType
+            $0.compression = "\(compression)"
+            $0.chunks = field.chunks.shape
+            $0.compressionRatio = ratio
+        }
+
+        // Decode all chunks from memory with `om_decoder_decode_chunks`
+        let file = try InMemoryFile(values: values, dimensions: field.dimensions, chunks: field.chunks, compression: compression, scaleFactor: scaleFactor)
+        let into = UnsafeMutableRawPointer.allocate(byteCount: bytes, alignment: 64)
+        defer { into.deallocate() }
+        let decode = try measure {
+            _ = try file.decode(offset: field.dimensions.map { _ in 0 }, count: field.dimensions, into: into)
+        }
+        report(suite: "codec", name: "decode", field: field.name, measurement: decode, bytes: bytes) {
+            $0.dataType = dataType
+            $0.compression = "\(compression)"
+            $0.chunks = field.chunks.shape
+            $0.compressionRatio = ratio
+        }
+    }
+
+    /// Cost of 2D delta and xor filters on chunk shaped buffers
+    func filters() {
+        let shapes: [(length0: Int, length1: Int)] = [(64, 24), (1, 1024), (256, 256)]
+        for (length0, length1) in shapes {
+            let count = length0 * length1
+            let shape = "\(length0)x\(length1)"
+            var random = SplitMix64(seed: 4)
+
+            var int16 = (0..<count).map { _ in Int16.random(in: -1000...1000, using: &random) }
+            report(suite: "filter", name: "delta2d_encode16", field: "random", measurement: measure { delta2d_encode16(length0, length1, &int16) }, bytes: count * 2) { $0.shape = shape }
+            report(suite: "filter", name: "delta2d_decode16", field: "random", measurement: measure { delta2d_decode16(length0, length1, &int16) }, bytes: count * 2) { $0.shape = shape }
+
+            var int32 = (0..<count).map { _ in Int32.random(in: -100000...100000, using: &random) }
+            report(suite: "filter", name: "delta2d_encode32", field: "random", measurement: measure { delta2d_encode32(length0, length1, &int32) }, bytes: count * 4) { $0.shape = shape }
+            report(suite: "filter", name: "delta2d_decode32", field: "random", measurement: measure { delta2d_decode32(length0, length1, &int32) }, bytes: count * 4) { $0.shape = shape }
+
+            var float = (0..<count).map { _ in Float.random(in: -100...100, using: &random) }
+            report(suite: "filter", name: "delta2d_encode_xor", field: "random", measurement: measure { delta2d_encode_xor(length0, length1, &float) }, bytes: count * 4) { $0.shape = shape }
+            report(suite: "filter", name: "delta2d_decode_xor", field: "random", measurement: measure { delta2d_decode_xor(length0, length1, &float) }, bytes: count * 4) { $0.shape = shape }
+        }
+    }
+
+    /// Cost of `om_decoder_next_index_read` and `om_decoder_next_data_read` without decompression for different chunk shapes
+    func planning(field: Field) throws {
+        let n = field.dimensions.count
+        var shapes = [field.chunks]
+        if n == 3 {
+            let extra: [[UInt64]] = [[1, 50, 24], [2, 2, 2], [32, 32, 1]]
+            shapes += extra.map { shape in zip(shape, field.dimensions).map { min($0, $1) } }
+        }
+        for chunks in shapes {
+            let file = try InMemoryFile(values: field.values, dimensions: field.dimensions, chunks: chunks, compression: .pfor_delta2d_int16, scaleFactor: 20)
+            for (name, offset, count) in field.reads {
+                var dataReads = 0
+                let measurement = try measure {
+                    dataReads = try file.decode(offset: offset, count: count, into: nil)
+                }
+                report(suite: "planning", name: name, field: field.name, measurement: measurement, bytes: Int(count.reduce(1, *)) * 4, operations: dataReads) {
+                    $0.chunks = chunks.shape
+                    $0.shape = count.shape
+                }
+            }
+        }
+    }
+
+    /// End-to-end point, box and full field reads through `MmapFile`
+    func reads(field: Field) async throws {
+        let path = FileManager.default.temporaryDirectory.appendingPathComponent("om-benchmark-\(field.name).om").path
+        defer { try? FileManager.default.removeItem(atPath: path) }
+        let fn = try FileHandle.createNewFile(file: path, overwrite: true)
+        let fileWriter = OmFileWriter(fn: fn, initialCapacity: 1024 * 1024)
+        let writer = try fileWriter.prepareArray(type: Float.self, dimensions: field.dimensions, chunkDimensions: field.chunks, compression: .pfor_delta2d_int16, scale_factor: 20, add_offset: 0)
+        try writer.writeData(array: field.values)
+        let variable = try fileWriter.write(array: try writer.finalise(), name: field.name, children: [])
+        try fileWriter.writeTrailer(rootVariable: variable)
+        try fn.close()
+
+        let read = try await OmFileReader(mmapFile: path).expectArray(of: Float.self)
+        let chunks = field.chunks.shape
+        var random = SplitMix64(seed: 5)
+
+        // Many single location time series
+        let points = 1000
+        let pointRanges = (0..<points).map { _ in
+            field.dimensions.enumerated().map { i, dimension -> Range<UInt64> in
+                if i == field.dimensions.count - 1 && field.dimensions.count > 1 {
+                    return 0..<dimension
+                }
+                let x = UInt64.random(in: 0..<dimension, using: &random)
+                return x..<x+1
+            }
+        }
+        let pointBytes = pointRanges.reduce(0) { sum, range in sum + range.reduce(4) { $0 * $1.count } }
+        let point = try await measureAsync {
+            for range in pointRanges {
+                _ = try await read.read(range: range)
+            }
+        }
+        report(suite: "read", name: "point", field: field.name, measurement: point, bytes: pointBytes, operations: points) { $0.chunks = chunks }
+
+        let batch = try await measureAsync {
+            _ = try await read.readBatch(ranges: pointRanges)
+        }
+        report(suite: "read", name: "point_batch", field: field.name, measurement: batch, bytes: pointBytes, operations: points) { $0.chunks = chunks }
+
+        // Boxes of up to 32 elements in each dimension except the last
+        let boxes = 20
+        let boxRanges = (0..<boxes).map { _ in
+            field.dimensions.enumerated().map { i, dimension -> Range<UInt64> in
+                let size = i == field.dimensions.count - 1 ? dimension : min(32, dimension)
+                let x = UInt64.random(in: 0...(dimension - size), using: &random)
+                return x..<x+size
+            }
+        }
+        let boxBytes = boxRanges.reduce(0) { sum, range in sum + range.reduce(4) { $0 * $1.count } }
+        let box = try await measureAsync {
+            for range in boxRanges {
+                _ = try await read.read(range: range)
+            }
+        }
+        report(suite: "read", name: "box", field: field.name, measurement: box, bytes: boxBytes, operations: boxes) {
+            $0.chunks = chunks
+            $0.shape = boxRanges[0].map { UInt64($0.count) }.shape
+        }
+
+        let full = try await measureAsync {
+            _ = try await read.read()
+        }
+        report(suite: "read", name: "full", field: field.name, measurement: full, bytes: field.bytes) { $0.chunks = chunks }
+
+        let fullConcurrent = try await measureAsync {
+            _ = try await read.readConcurrent()
+        }
+        report(suite: "read", name: "full_concurrent", field: field.name, measurement: fullConcurrent, bytes: field.bytes) { $0.chunks = chunks }
+    }
+}
+
+extension Field {
+    /// Point, box and full reads for planning benchmarks
+    var reads: [(name: String, offset: [UInt64], count: [UInt64])] {
+        let n = dimensions.count
+        let point = dimensions.enumerated().map { i, dimension in i == n - 1 && n > 1 ? dimension : 1 }
+        let box = dimensions.enumerated().map { i, dimension in i == n - 1 ? dimension : min(32, dimension) }
+        return [
+            ("point", dimensions.map { $0 / 2 }.enumerated().map { i, x in i == n - 1 && n > 1 ? 0 : x }, point),
+            ("box", dimensions.enumerated().map { i, dimension in i == n - 1 ? 0 : (dimension - box[i]) / 2 }, box),
+            ("full", dimensions.map { _ in 0 }, dimensions)
+        ]
+    }
+}
+
+/// A compressed array in memory that is decoded directly with the C decoder without any backend
+final class InMemoryFile {
+    let data: Data
+
+    init<OmType: OmFileArrayDataTypeProtocol>(values: [OmType], dimensions: [UInt64], chunks: [UInt64], compression: OmCompressionType, scaleFactor: Float) throws {
+        let backend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: backend, initialCapacity: 1024 * 1024)
+        let writer = try fileWriter.prepareArray(type: OmType.self, dimensions: dimensions, chunkDimensions: chunks, compression: compression, scale_factor: scaleFactor, add_offset: 0)
+        try writer.writeData(array: values)
+        let variable = try fileWriter.write(array: try writer.finalise(), name: "data", children: [])
+        try fileWriter.writeTrailer(rootVariable: variable)
+        self.data = backend.data
+    }
+
+    /// Decode a hyperslab. If `into` is nil, only index and data reads are planned. Returns the number of data reads.
+    func decode(offset: [UInt64], count: [UInt64], into: UnsafeMutableRawPointer?) throws -> Int {
+        return try data.withUnsafeBytes { file in
+            let base = file.baseAddress!
+            var variableOffset: UInt64 = 0
+            var variableSize: UInt64 = 0
+            guard om_trailer_read(base.advanced(by: file.count - om_trailer_size()), &variableOffset, &variableSize) else {
+                throw OmFileFormatSwiftError.notAnOpenMeteoFile
+            }
+            let variable = om_variable_init(base.advanced(by: Int(variableOffset)))
+            // The decoder keeps pointers to offset and count
+            return try offset.withUnsafeBufferPointer { offset in
+                try count.withUnsafeBufferPointer { count in
+                    let cubeOffset = [UInt64](repeating: 0, count: count.count)
+                    return try cubeOffset.withUnsafeBufferPointer { cubeOffset in
+                        var decoder = OmDecoder_t()
+                        var error = om_decoder_init(&decoder, variable, UInt64(count.count), offset.baseAddress, count.baseAddress, cubeOffset.baseAddress, count.baseAddress, 512, 65536)
+                        guard error == ERROR_OK else {
+                            throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
+                        }
+                        let chunkBuffer = UnsafeMutableRawPointer.allocate(byteCount: Int(om_decoder_read_buffer_size(&decoder)), alignment: 64)
+                        defer { chunkBuffer.deallocate() }
+                        var dataReads = 0
+                        var indexRead = OmDecoder_indexRead_t()
+                        om_decoder_init_index_read(&decoder, &indexRead)
+                        while om_decoder_next_index_read(&decoder, &indexRead) {
+                            var dataRead = OmDecoder_dataRead_t()
+                            om_decoder_init_data_read(&dataRead, &indexRead)
+                            while om_decoder_next_data_read(&decoder, &dataRead, base.advanced(by: Int(indexRead.offset)), indexRead.count, &error) {
+                                dataReads += 1
+                                guard let into else {
+                                    continue
+                                }
+                                guard om_decoder_decode_chunks(&decoder, dataRead.chunkIndex, base.advanced(by: Int(dataRead.offset)), dataRead.count, into, chunkBuffer, &error) else {
+                                    throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
+                                }
+                            }
+                            guard error == ERROR_OK else {
+                                throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
+                            }
+                        }
+                        return dataReads
+                    }
+                }
+            }
+        }
+    }
+}
+
+/// Deterministic random numbers to generate the same synthetic fields on every run
+struct SplitMix64: RandomNumberGenerator {
+    var state: UInt64
+
+    init(seed: UInt64) {
+        state = seed
+    }
+
+    mutating func next() -> UInt64 {
+        state &+= 0x9E3779B97F4A7C15
+        var z = state
+        z = (z ^ (z >> 30)) &* 0xBF58476D1CE4E5B9
+        z = (z ^ (z >> 27)) &* 0x94D049BB133111EB
+        return z ^ (z >> 31)
+    }
+}
+
+extension Array where Element == UInt64 {
+    /// Dimensions formatted like `4x16x24`
+    var shape: String {
+        return map(String.init).joined(separator: "x")
+    }
+}
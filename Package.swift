@@ -5,7 +5,9 @@ import Foundation
 
 #if arch(x86_64)
 // Docker and Ubuntu release system uses `march=skylake`
-let mArch = ProcessInfo.processInfo.environment["MARCH_SKYLAKE"] == "TRUE" ? ["-march=skylake"] : ["-march=native"]
+// Portable builds use `MARCH_PORTABLE=TRUE`. AVX2 kernels are then selected at runtime, see `om_dispatch.h`.
+let mArch = ProcessInfo.processInfo.environment["MARCH_PORTABLE"] == "TRUE" ? ["-march=x86-64-v2"] :
+    ProcessInfo.processInfo.environment["MARCH_SKYLAKE"] == "TRUE" ? ["-march=skylake"] : ["-march=native"]
 #else
 let mArch: [String] = []
 #endif
@@ -48,5 +50,11 @@ let package = Package(
             name: "OmFileFormatTests",
             dependencies: ["OmFileFormat"]
         ),
+        .executableTarget(
+            name: "OmFileFormatBenchmarks",
+            dependencies: ["OmFileFormat", "OmFileFormatC"],
+            path: "Benchmarks/OmFileFormatBenchmarks",
+            swiftSettings: swiftFlags
+        ),
     ]
 )
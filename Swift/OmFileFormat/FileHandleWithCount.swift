@@ -20,7 +20,8 @@ extension FileHandleWithCount: OmFileReaderBackend {
     }
     
     public func getData(offset: Int, count: Int) async throws -> Data {
-        var data = Data(repeating: 0, count: count)
+        /// Memory is reused for index reads of later decoder calls
+        var data = OmBufferPool.shared.data(count: count)
         let err = data.withUnsafeMutableBytes({ data in
             /// Pread is thread safe
             pread(fileHandle.fileDescriptor, data.baseAddress, count, off_t(offset))
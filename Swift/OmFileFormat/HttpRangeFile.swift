@@ -0,0 +1,195 @@
+import Foundation
+#if canImport(FoundationNetworking)
+import FoundationNetworking
+#endif
+
+/// Read remote files with HTTP `Range` requests, e.g. from S3. `URLSession` keeps connections alive and uses HTTP/2 if the server supports it.
+///
+/// To reduce the number of serial round trips:
+/// - On open, the last `tailSize` bytes are fetched with a single suffix range request. This contains the trailer, the root variable and, for most files, the LUTs.
+/// - Meta data and index reads through `getData` are cached in memory
+/// - All data reads of one batch are coalesced if the gap between them is below `coalesceGap` and fetched concurrently
+public final class HttpRangeFile: @unchecked Sendable {
+    public let url: URL
+    public let count: Int
+    public let session: URLSession
+
+    /// Reads closer than this are fetched with a single request. Reading unused bytes is cheaper than another round trip.
+    public let coalesceGap: Int
+    /// Upper limit for a coalesced request
+    public let maxRequestSize: Int
+    /// Maximum number of concurrent requests for a batch
+    public let maxConcurrentRequests: Int
+    /// Maximum number of bytes for cached meta data and index blocks
+    public let cacheSize: Int
+
+    /// The end of the file fetched on open
+    private let tail: Data
+    private let tailOffset: Int
+
+    /// Cached meta data and index blocks. The oldest blocks are evicted first.
+    private var cache = [(offset: Int, data: Data)]()
+    private var cachedBytes = 0
+    private let lock = NSLock()
+
+    public init(url: URL, session: URLSession = .shared, tailSize: Int = 64 * 1024, coalesceGap: Int = 256 * 1024, maxRequestSize: Int = 16 * 1024 * 1024, maxConcurrentRequests: Int = 16, cacheSize: Int = 64 * 1024 * 1024) async throws {
+        self.url = url
+        self.session = session
+        self.coalesceGap = coalesceGap
+        self.maxRequestSize = maxRequestSize
+        self.maxConcurrentRequests = maxConcurrentRequests
+        self.cacheSize = cacheSize
+
+        var request = URLRequest(url: url)
+        request.setValue("bytes=-\(tailSize)", forHTTPHeaderField: "Range")
+        let (data, response) = try await session.data(for: request)
+        let statusCode = (response as? HTTPURLResponse)?.statusCode ?? 0
+        switch statusCode {
+        case 200:
+            // Server ignored the range and returned the entire file
+            self.count = data.count
+            self.tail = data
+            self.tailOffset = 0
+        case 206:
+            // Content-Range: bytes 1000-1999/2000
+            guard let contentRange = (response as? HTTPURLResponse)?.value(forHTTPHeaderField: "Content-Range"),
+                  let total = contentRange.split(separator: "/").last.flatMap({ Int($0) }) else {
+                throw OmFileFormatSwiftError.httpRequestFailed(url: url.absoluteString, statusCode: statusCode)
+            }
+            self.count = total
+            self.tail = data
+            self.tailOffset = total - data.count
+        default:
+            throw OmFileFormatSwiftError.httpRequestFailed(url: url.absoluteString, statusCode: statusCode)
+        }
+    }
+
+    /// Fetch a range with a single request
+    private func fetch(offset: Int, count: Int) async throws -> Data {
+        var request = URLRequest(url: url)
+        request.setValue("bytes=\(offset)-\(offset + count - 1)", forHTTPHeaderField: "Range")
+        let (data, response) = try await session.data(for: request)
+        let statusCode = (response as? HTTPURLResponse)?.statusCode ?? 0
+        if statusCode == 200 && data.count == self.count {
+            return data.subdata(in: offset ..< offset + count)
+        }
+        guard statusCode == 206, data.count == count else {
+            throw OmFileFormatSwiftError.httpRequestFailed(url: url.absoluteString, statusCode: statusCode)
+        }
+        return data
+    }
+
+    /// Return data from the tail or the cache without a request
+    private func cached(offset: Int, count: Int) -> Data? {
+        if offset >= tailOffset {
+            return tail.subdata(in: offset - tailOffset ..< offset - tailOffset + count)
+        }
+        lock.lock()
+        defer { lock.unlock() }
+        for block in cache where block.offset <= offset && offset + count <= block.offset + block.data.count {
+            return block.data.subdata(in: offset - block.offset ..< offset - block.offset + count)
+        }
+        return nil
+    }
+
+    private func insertCache(offset: Int, data: Data) {
+        guard data.count <= cacheSize else {
+            return
+        }
+        lock.lock()
+        defer { lock.unlock() }
+        cache.append((offset, data))
+        cachedBytes += data.count
+        while cachedBytes > cacheSize {
+            cachedBytes -= cache.removeFirst().data.count
+        }
+    }
+}
+
+extension HttpRangeFile: OmFileReaderBackend {
+    public func prefetchData(offset: Int, count: Int) async throws {
+        // Data is fetched on demand. Prefetching every data read would double the number of requests.
+    }
+
+    /// Object storage like S3 with a high time to first byte
+    public var ioCostModel: OmIoCostModel? {
+        return OmIoCostModel(latency: 0.03, bandwidth: 100_000_000, parallelism: maxConcurrentRequests)
+    }
+
+    /// Used for meta data and index reads. Results are cached.
+    public func getData(offset: Int, count: Int) async throws -> Data {
+        if let data = cached(offset: offset, count: count) {
+            return data
+        }
+        let data = try await fetch(offset: offset, count: count)
+        insertCache(offset: offset, data: data)
+        return data
+    }
+
+    public func withData<T>(offset: Int, count: Int, fn: (UnsafeRawBufferPointer) throws -> T) async throws -> T {
+        if let data = cached(offset: offset, count: count) {
+            return try data.withUnsafeBytes(fn)
+        }
+        return try await fetch(offset: offset, count: count).withUnsafeBytes(fn)
+    }
+
+    public func withDataBatch(reads: [OmFileRead], concurrent: Bool, fn: @escaping @Sendable (Int, UnsafeRawBufferPointer) throws -> Void) async throws {
+        /// Coalesced requests and the reads they contain
+        var coalesced = [(offset: Int, count: Int, reads: [Int])]()
+        for i in reads.indices.sorted(by: { reads[$0].offset < reads[$1].offset }) {
+            let read = reads[i]
+            if let data = cached(offset: read.offset, count: read.count) {
+                try data.withUnsafeBytes { try fn(i, $0) }
+                continue
+            }
+            if let last = coalesced.last, read.offset <= last.offset + last.count + coalesceGap, read.offset + read.count - last.offset <= maxRequestSize {
+                coalesced[coalesced.count - 1].count = max(last.count, read.offset + read.count - last.offset)
+                coalesced[coalesced.count - 1].reads.append(i)
+                continue
+            }
+            coalesced.append((read.offset, read.count, [i]))
+        }
+        let requests = coalesced
+
+        /// Call `fn` for all reads of a request
+        @Sendable func process(_ request: (offset: Int, count: Int, reads: [Int]), _ data: Data) throws {
+            try data.withUnsafeBytes { data in
+                for i in request.reads {
+                    try fn(i, UnsafeRawBufferPointer(rebasing: data[reads[i].offset - request.offset ..< reads[i].offset - request.offset + reads[i].count]))
+                }
+            }
+        }
+
+        try await withThrowingTaskGroup(of: (Int, Data)?.self) { group in
+            /// Consume a finished request. Serial processing happens on this task.
+            func consume(_ result: (Int, Data)?) throws {
+                if let (index, data) = result {
+                    try process(requests[index], data)
+                }
+            }
+            for (index, request) in requests.enumerated() {
+                if index >= maxConcurrentRequests, let result = try await group.next() {
+                    try consume(result)
+                }
+                group.addTask {
+                    let data = try await self.fetch(offset: request.offset, count: request.count)
+                    guard concurrent else {
+                        return (index, data)
+                    }
+                    try process(request, data)
+                    return nil
+                }
+            }
+            while let result = try await group.next() {
+                try consume(result)
+            }
+        }
+    }
+}
+
+extension OmFileReader where Backend == HttpRangeFile {
+    public init(url: URL, session: URLSession = .shared) async throws {
+        let file = try await HttpRangeFile(url: url, session: session)
+        try await self.init(fn: file)
+    }
+}
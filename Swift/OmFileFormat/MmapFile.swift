@@ -35,33 +35,83 @@ public final class MmapFile: Sendable {
         }
     }
 
+    /// Mapping options for frequently read files
+    public struct Options: Sendable {
+        /// Read the entire file into memory while mapping it (`MAP_POPULATE`). Later reads do not cause page faults. Only available on Linux.
+        /// Page cache pages are allocated on the NUMA node of the thread that first reads them. On multi-socket systems, map a file from a thread bound to the node whose threads serve reads of this file.
+        public var populate: Bool
+
+        /// Ask the kernel to back the mapping with transparent huge pages (`MADV_HUGEPAGE`) to reduce TLB misses. Only a hint, which is ignored if the file system does not support huge pages. Only available on Linux.
+        public var hugePages: Bool
+
+        public init(populate: Bool = false, hugePages: Bool = false) {
+            self.populate = populate
+            self.hugePages = hugePages
+        }
+    }
+
     /// Mmap the entire filehandle
-    public init(fn: FileHandle, mode: Mode = .readOnly) throws {
+    public init(fn: FileHandle, mode: Mode = .readOnly, options: Options = .init()) throws {
         let len = try Int(fn.seekToEnd())
-        guard let mem = mmap(nil, len, mode.prot, MAP_SHARED, fn.fileDescriptor, 0), mem != UnsafeMutableRawPointer(bitPattern: -1) else {
+        var flags = MAP_SHARED
+        #if os(Linux)
+        if options.populate {
+            flags |= MAP_POPULATE
+        }
+        #endif
+        guard let mem = mmap(nil, len, mode.prot, flags, fn.fileDescriptor, 0), mem != UnsafeMutableRawPointer(bitPattern: -1) else {
             let error = String(cString: strerror(errno))
             throw OmFileFormatSwiftError.cannotOpenFile(errno: errno, error: error)
         }
+        #if os(Linux)
+        if options.hugePages {
+            _ = madvise(mem, len, MADV_HUGEPAGE)
+        }
+        #endif
         //madvise(mem, len, MADV_SEQUENTIAL)
         let start = mem.assumingMemoryBound(to: UInt8.self)
         self.data = UnsafeBufferPointer(start: start, count: len)
         self.file = fn
     }
 
-    /// Tell the OS to prefault the required memory pages. Subsequent calls to read data should be faster
-    public func prefetchData(offset: Int, count: Int, advice: MAdvice) {
+    /// Start and length of all memory pages that contain the bytes `offset..<offset+count`
+    private func pages(offset: Int, count: Int) -> (start: UnsafeMutableRawPointer, length: Int) {
+        let pageSize = Int(getpagesize())
         /// Page start aligned to page size
-        let pageStart = (offset / 4096) * 4096
+        let pageStart = (offset / pageSize) * pageSize
         /// Length as a multiple of the page size
-        let length = (count + 4096 - 1) / 4096 * 4096
+        let length = (offset + count - pageStart + pageSize - 1) / pageSize * pageSize
+        return (UnsafeMutableRawPointer(mutating: data.baseAddress!.advanced(by: pageStart)), length)
+    }
 
-        let ret = madvise(UnsafeMutableRawPointer(mutating: data.baseAddress!.advanced(by: pageStart)), length, advice.mode)
+    /// Tell the OS to prefault the required memory pages. Subsequent calls to read data should be faster
+    public func prefetchData(offset: Int, count: Int, advice: MAdvice) {
+        let (start, length) = pages(offset: offset, count: count)
+        let ret = madvise(start, length, advice.mode)
         guard ret == 0 else {
             let error = String(cString: strerror(errno))
             fatalError("madvice failed! ret=\(ret), errno=\(errno), \(error)")
         }
     }
 
+    /// Load the memory pages of a range and keep them in memory with `mlock`, e.g. for LUTs of hot files. Limited by `RLIMIT_MEMLOCK`.
+    public func lock(offset: Int, count: Int) throws {
+        let (start, length) = pages(offset: offset, count: count)
+        guard mlock(start, length) == 0 else {
+            let error = String(cString: strerror(errno))
+            throw OmFileFormatSwiftError.mlockFailed(errno: errno, error: error)
+        }
+    }
+
+    /// Release memory pages locked with `lock`
+    public func unlock(offset: Int, count: Int) throws {
+        let (start, length) = pages(offset: offset, count: count)
+        guard munlock(start, length) == 0 else {
+            let error = String(cString: strerror(errno))
+            throw OmFileFormatSwiftError.mlockFailed(errno: errno, error: error)
+        }
+    }
+
     deinit {
         let len = data.count * MemoryLayout<UInt8>.size
         guard munmap(UnsafeMutableRawPointer(mutating: data.baseAddress!), len) == 0 else {
@@ -78,6 +128,17 @@ extension MmapFile: OmFileReaderBackend {
     public func prefetchData(offset: Int, count: Int) async throws {
         self.prefetchData(offset: offset, count: count, advice: .willneed)
     }
+
+    public func prefetchData(offset: Int, count: Int, hint: OmPrefetchHint) async throws {
+        switch hint {
+        case .willNeed:
+            self.prefetchData(offset: offset, count: count, advice: .willneed)
+        case .pin:
+            try lock(offset: offset, count: count)
+        case .unpin:
+            try unlock(offset: offset, count: count)
+        }
+    }
     
     public func withData<T>(offset: Int, count: Int, fn: (UnsafeRawBufferPointer) throws -> T) async throws -> T {
         return try fn(getData(offset: offset, count: count))
@@ -90,9 +151,9 @@ extension MmapFile: OmFileReaderBackend {
 }
 
 extension OmFileReader where Backend == MmapFile {
-    public init(mmapFile: String) async throws {
+    public init(mmapFile: String, options: MmapFile.Options = .init()) async throws {
         let fn = try FileHandle.openFileReading(file: mmapFile)
-        let mmap = try MmapFile(fn: fn)
+        let mmap = try MmapFile(fn: fn, options: options)
         try await self.init(fn: mmap)
     }
 }
@@ -0,0 +1,97 @@
+import Foundation
+
+/// Pool of reusable memory for decoder scratch buffers and index reads. Can be shared between multiple arrays, files and threads.
+/// Buffers are grouped into power of two size classes. Once all size classes of a workload are populated, reads do not allocate memory for scratch buffers.
+public final class OmBufferPool: @unchecked Sendable {
+    /// Pool used by all readers
+    public static let shared = OmBufferPool(maxBufferSize: 64 * 1024 * 1024, maxBuffersPerSize: 64)
+
+    /// Larger buffers are allocated and freed on every use
+    public let maxBufferSize: Int
+
+    /// Maximum number of free buffers kept for each size class
+    public let maxBuffersPerSize: Int
+
+    /// Free buffers by size class
+    private var free = [Int: [UnsafeMutableRawPointer]]()
+    private var hits: UInt64 = 0
+    private var misses: UInt64 = 0
+    private let lock = NSLock()
+
+    public init(maxBufferSize: Int, maxBuffersPerSize: Int) {
+        self.maxBufferSize = maxBufferSize
+        self.maxBuffersPerSize = maxBuffersPerSize
+    }
+
+    deinit {
+        for buffers in free.values {
+            buffers.forEach { $0.deallocate() }
+        }
+    }
+
+    /// Number of buffers reused from the pool and newly allocated since initialisation or the last clear
+    public var statistics: (hits: UInt64, misses: UInt64) {
+        lock.lock()
+        defer { lock.unlock() }
+        return (hits, misses)
+    }
+
+    /// Free all unused buffers
+    public func clear() {
+        lock.lock()
+        defer { lock.unlock() }
+        for buffers in free.values {
+            buffers.forEach { $0.deallocate() }
+        }
+        free.removeAll()
+        hits = 0
+        misses = 0
+    }
+
+    /// Return a buffer with at least `byteCount` bytes and its capacity. Must be returned with `release`.
+    func acquire(byteCount: Int) -> (buffer: UnsafeMutableRawPointer, capacity: Int) {
+        let capacity = max(4096, 1 << (Int.bitWidth - max(byteCount - 1, 1).leadingZeroBitCount))
+        guard capacity <= maxBufferSize else {
+            return (.allocate(byteCount: byteCount, alignment: 64), byteCount)
+        }
+        lock.lock()
+        if let buffer = free[capacity]?.popLast() {
+            hits += 1
+            lock.unlock()
+            return (buffer, capacity)
+        }
+        misses += 1
+        lock.unlock()
+        return (.allocate(byteCount: capacity, alignment: 64), capacity)
+    }
+
+    func release(_ buffer: UnsafeMutableRawPointer, capacity: Int) {
+        guard capacity <= maxBufferSize && capacity.nonzeroBitCount == 1 else {
+            buffer.deallocate()
+            return
+        }
+        lock.lock()
+        if free[capacity, default: []].count < maxBuffersPerSize {
+            free[capacity, default: []].append(buffer)
+            lock.unlock()
+            return
+        }
+        lock.unlock()
+        buffer.deallocate()
+    }
+
+    /// Call `fn` with a buffer of at least `byteCount` bytes. The buffer is returned to the pool afterwards.
+    public func withBuffer<T>(byteCount: Int, _ fn: (UnsafeMutableRawPointer) throws -> T) rethrows -> T {
+        let (buffer, capacity) = acquire(byteCount: byteCount)
+        defer { release(buffer, capacity: capacity) }
+        return try fn(buffer)
+    }
+
+    /// Uninitialised `Data` of `count` bytes. The memory is returned to the pool once `Data` is released.
+    public func data(count: Int) -> Data {
+        let (buffer, capacity) = acquire(byteCount: count)
+        return Data(bytesNoCopy: buffer, count: count, deallocator: .custom({ [self] buffer, _ in
+            self.release(buffer, capacity: capacity)
+        }))
+    }
+}
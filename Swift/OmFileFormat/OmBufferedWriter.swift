@@ -15,13 +15,34 @@ public final class OmBufferedWriter<FileHandle: OmFileWriterBackend> {
 
     private var initialCapacity: Int
 
-    public init(backend: FileHandle, initialCapacity: Int = 1024) {
+    /// Alignment of the buffer memory
+    private let alignment: Int
+
+    /// Buffers that are written to the backend in the background. `nil` if all writes are synchronous.
+    private let writeBehind: OmWriteBehind?
+
+    /// `totalBytesWritten` is the size of existing data in the backend if new data is appended
+    ///
+    /// With `writeBehindBuffers` of 2 or more, full buffers are written to the backend on a background thread while the next buffer is filled. Writes block only while all buffers are in flight.
+    /// Errors of background writes are thrown by the next `writeToFile` or `flush`. `flush` must be called after the last write. `alignment` can be set to the page size, e.g. 4096, for page aligned buffers.
+    public init(backend: FileHandle, initialCapacity: Int = 1024, totalBytesWritten: Int = 0, writeBehindBuffers: Int = 0, alignment: Int = 1) {
         self.writePosition = 0
-        self.totalBytesWritten = 0
+        self.totalBytesWritten = totalBytesWritten
         self.backend = backend
-        self.buffer = .allocate(byteCount: initialCapacity, alignment: 1)
+        self.buffer = .allocate(byteCount: initialCapacity, alignment: alignment)
         buffer.initializeMemory(as: UInt8.self, repeating: 0)
         self.initialCapacity = initialCapacity
+        self.alignment = alignment
+        if writeBehindBuffers >= 2 {
+            let spare = (1..<writeBehindBuffers).map { _ in
+                let spare = UnsafeMutableRawBufferPointer.allocate(byteCount: initialCapacity, alignment: alignment)
+                spare.initializeMemory(as: UInt8.self, repeating: 0)
+                return spare
+            }
+            self.writeBehind = OmWriteBehind(buffers: spare, write: { [backend] in try backend.write(contentsOf: $0) })
+        } else {
+            self.writeBehind = nil
+        }
     }
 
     func incrementWritePosition(by bytes: Int) {
@@ -66,12 +87,27 @@ public final class OmBufferedWriter<FileHandle: OmFileWriterBackend> {
         }
         // Need to grow buffer to a multiple of the initial capacity
         let newCapacity = (minimumCapacity + initialCapacity - 1) / initialCapacity * initialCapacity
-        buffer = UnsafeMutableRawBufferPointer(start: realloc(buffer.baseAddress, newCapacity), count: newCapacity)
+        if alignment <= 1 {
+            buffer = UnsafeMutableRawBufferPointer(start: realloc(buffer.baseAddress, newCapacity), count: newCapacity)
+        } else {
+            // The buffer is empty after `writeToFile`, no data needs to be copied
+            buffer.deallocate()
+            buffer = .allocate(byteCount: newCapacity, alignment: alignment)
+        }
         bufferAtWritePosition.initializeMemory(as: UInt8.self, repeating: 0, count: remainingCapacity)
     }
 
-    /// Write buffer to file
+    /// Write buffer to file. With write-behind, the buffer is queued for writing and an empty buffer is used for new data.
     public func writeToFile() throws {
+        if let writeBehind {
+            try writeBehind.throwError()
+            if writePosition == 0 {
+                return
+            }
+            buffer = writeBehind.enqueue(buffer, count: writePosition)
+            resetWritePosition()
+            return
+        }
         let readableBytes = UnsafeRawBufferPointer(start: buffer.baseAddress, count: writePosition)
         try backend.write(contentsOf: readableBytes)
         resetWritePosition()
@@ -79,7 +115,97 @@ public final class OmBufferedWriter<FileHandle: OmFileWriterBackend> {
         bufferAtWritePosition.initializeMemory(as: UInt8.self, repeating: 0, count: readableBytes.count)
     }
 
+    /// Write buffer to file and wait until all background writes are completed
+    public func flush() throws {
+        try writeToFile()
+        try writeBehind?.wait()
+    }
+
     deinit {
+        writeBehind?.group.wait()
         buffer.deallocate()
     }
 }
+
+/// Buffers of `OmBufferedWriter` that are filled or in flight. Queued buffers are written in order on a serial queue.
+fileprivate final class OmWriteBehind: @unchecked Sendable {
+    let queue = DispatchQueue(label: "om.writebehind")
+    let group = DispatchGroup()
+
+    /// Number of free buffers
+    private let available: DispatchSemaphore
+    private let lock = NSLock()
+
+    /// Buffers that are not in use. Written buffers are zero filled before they are returned.
+    private var free: [UnsafeMutableRawBufferPointer]
+
+    /// Buffers waiting to be written including the number of valid bytes
+    private var pending = [(buffer: UnsafeMutableRawBufferPointer, count: Int)]()
+
+    /// First error of a background write. All later writes are skipped.
+    private var error: Error? = nil
+
+    private let write: (UnsafeRawBufferPointer) throws -> Void
+
+    init(buffers: [UnsafeMutableRawBufferPointer], write: @escaping (UnsafeRawBufferPointer) throws -> Void) {
+        self.free = buffers
+        self.available = DispatchSemaphore(value: buffers.count)
+        self.write = write
+    }
+
+    deinit {
+        free.forEach { $0.deallocate() }
+    }
+
+    /// Queue `count` bytes of `buffer` for writing and return a free buffer. Blocks if all buffers are in flight.
+    func enqueue(_ buffer: UnsafeMutableRawBufferPointer, count: Int) -> UnsafeMutableRawBufferPointer {
+        available.wait()
+        lock.lock()
+        pending.append((buffer, count))
+        let next = free.removeLast()
+        lock.unlock()
+        group.enter()
+        queue.async {
+            self.writeNext()
+            self.group.leave()
+        }
+        return next
+    }
+
+    /// Write the oldest pending buffer and return it to the free list
+    private func writeNext() {
+        lock.lock()
+        let (buffer, count) = pending.removeFirst()
+        let failed = error != nil
+        lock.unlock()
+        if !failed {
+            do {
+                try write(UnsafeRawBufferPointer(start: buffer.baseAddress, count: count))
+            } catch {
+                lock.lock()
+                self.error = error
+                lock.unlock()
+            }
+        }
+        buffer.baseAddress?.initializeMemory(as: UInt8.self, repeating: 0, count: count)
+        lock.lock()
+        free.append(buffer)
+        lock.unlock()
+        available.signal()
+    }
+
+    /// Throw the error of a previous background write
+    func throwError() throws {
+        lock.lock()
+        defer { lock.unlock() }
+        if let error {
+            throw error
+        }
+    }
+
+    /// Wait for all pending writes
+    func wait() throws {
+        group.wait()
+        try throwError()
+    }
+}
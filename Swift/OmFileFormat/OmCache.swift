@@ -0,0 +1,68 @@
+import OmFileFormatC
+
+/// Cache for decompressed LUT chunks. Can be shared between multiple arrays, files and threads.
+/// Memory is allocated once and cached LUT chunks are evicted using a CLOCK strategy if the cache is full.
+public final class OmLutCache: @unchecked Sendable {
+    let cache: UnsafeMutablePointer<OmCache_t>
+
+    let memory: UnsafeMutableRawPointer
+
+    /// Allocate a cache with a memory budget in bytes. Each cached LUT chunk uses around 550 bytes.
+    public init(memoryBudget: Int) {
+        cache = .allocate(capacity: 1)
+        memory = .allocate(byteCount: memoryBudget, alignment: 64)
+        om_cache_init(cache, memory, UInt64(memoryBudget), UInt64(LUT_CHUNK_COUNT) * 8)
+    }
+
+    /// Number of cache hits and misses since initialisation or the last clear
+    public var statistics: (hits: UInt64, misses: UInt64) {
+        var hits: UInt64 = 0
+        var misses: UInt64 = 0
+        om_cache_statistics(cache, &hits, &misses)
+        return (hits, misses)
+    }
+
+    /// Remove all cached LUT chunks
+    public func clear() {
+        om_cache_clear(cache)
+    }
+
+    deinit {
+        memory.deallocate()
+        cache.deallocate()
+    }
+}
+
+/// Cache for decompressed data chunks. Can be shared between multiple arrays, files and threads.
+/// Reads of cached chunks skip IO and decompression. Chunks are evicted using a CLOCK strategy if the cache is full.
+public final class OmChunkCache: @unchecked Sendable {
+    let cache: UnsafeMutablePointer<OmCache_t>
+
+    let memory: UnsafeMutableRawPointer
+
+    /// Allocate a cache with a memory budget in bytes. `maxChunkBytes` is the size of the largest chunk to cache.
+    /// For a float array with chunk dimensions `[1, 50, 24]` this is `1 * 50 * 24 * 4`. Larger chunks are not cached.
+    public init(memoryBudget: Int, maxChunkBytes: Int) {
+        cache = .allocate(capacity: 1)
+        memory = .allocate(byteCount: memoryBudget, alignment: 64)
+        om_cache_init(cache, memory, UInt64(memoryBudget), UInt64(maxChunkBytes))
+    }
+
+    /// Number of cache hits and misses since initialisation or the last clear
+    public var statistics: (hits: UInt64, misses: UInt64) {
+        var hits: UInt64 = 0
+        var misses: UInt64 = 0
+        om_cache_statistics(cache, &hits, &misses)
+        return (hits, misses)
+    }
+
+    /// Remove all cached chunks
+    public func clear() {
+        om_cache_clear(cache)
+    }
+
+    deinit {
+        memory.deallocate()
+        cache.deallocate()
+    }
+}
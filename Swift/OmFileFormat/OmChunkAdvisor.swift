@@ -0,0 +1,169 @@
+import Foundation
+
+/// Compare chunk dimensions for a query workload. Every candidate is written to memory and each query is planned and decoded to count bytes read, IO operations and decoded data.
+/// The estimated time combines the IO cost model of the target backend with a decode throughput. The recommendation is the candidate with the lowest weighted time.
+public enum OmChunkAdvisor {
+    /// A read of `range` that occurs `weight` times in the workload
+    public struct Query: Sendable {
+        public let name: String
+        public let range: [Range<UInt64>]
+        public let weight: Double
+
+        public init(name: String, range: [Range<UInt64>], weight: Double = 1) {
+            self.name = name
+            self.range = range
+            self.weight = weight
+        }
+
+        /// All values along the last dimension at one position, e.g. a time series at one location
+        public static func timeSeries(at position: [UInt64], dimensions: [UInt64], weight: Double = 1) -> Query {
+            return Query(name: "time series \(position)", range: position.map({ $0..<$0+1 }) + [0..<dimensions[dimensions.count-1]], weight: weight)
+        }
+
+        /// All values of the leading dimensions at one position of the last dimension, e.g. a field at one timestep
+        public static func field(at last: UInt64, dimensions: [UInt64], weight: Double = 1) -> Query {
+            return Query(name: "field at \(last)", range: dimensions.dropLast().map({ 0..<$0 }) + [last..<last+1], weight: weight)
+        }
+
+        /// The entire array
+        public static func full(dimensions: [UInt64], weight: Double = 1) -> Query {
+            return Query(name: "full", range: dimensions.map({ 0..<$0 }), weight: weight)
+        }
+    }
+
+    /// Cost of a single query for one candidate
+    public struct QueryResult: Sendable {
+        public let name: String
+        /// Index and data bytes read
+        public let bytesRead: Int
+        /// Number of index and data reads
+        public let ioCount: Int
+        /// Chunks decoded including chunks that are only read to merge IO
+        public let chunksDecoded: UInt64
+        /// Approximate uncompressed bytes of all decoded chunks
+        public let decodedBytes: UInt64
+        /// IO and decode time in seconds
+        public let estimatedSeconds: Double
+    }
+
+    /// Cost of the workload for one chunk shape
+    public struct Candidate: Sendable {
+        public let chunks: [UInt64]
+        /// Size of the compressed array including the LUT
+        public let compressedBytes: Int
+        public let queries: [QueryResult]
+        /// Sum of query estimates multiplied by their weight
+        public let estimatedSeconds: Double
+    }
+
+    public struct Report: Sendable {
+        /// All candidates sorted by estimated time
+        public let candidates: [Candidate]
+
+        public var recommendation: Candidate {
+            return candidates[0]
+        }
+    }
+
+    /// Candidate chunk dimensions with powers of two and the full length for each dimension. Only shapes between `minElements` and `maxElements` are returned.
+    public static func candidates(dimensions: [UInt64], minElements: UInt64 = 256, maxElements: UInt64 = 8192) -> [[UInt64]] {
+        var result: [[UInt64]] = [[]]
+        for dimension in dimensions {
+            var lengths = [UInt64]()
+            var length: UInt64 = 1
+            while length < dimension {
+                lengths.append(length)
+                length *= 2
+            }
+            lengths.append(dimension)
+            result = result.flatMap { prefix in
+                lengths.compactMap { length in
+                    prefix.reduce(length, *) <= maxElements ? prefix + [length] : nil
+                }
+            }
+        }
+        return result.filter { $0.reduce(1, *) >= minElements }
+    }
+
+    /// Evaluate `queries` against `values` of shape `dimensions` for every candidate chunk shape.
+    /// `decodeBytesPerSecond` is the uncompressed throughput of decompression and filtering on the target system.
+    public static func analyse<OmType: OmFileArrayDataTypeProtocol>(values: [OmType], dimensions: [UInt64], queries: [Query], candidates: [[UInt64]]? = nil, compression: OmCompressionType = .pfor_delta2d_int16, scaleFactor: Float = 1, addOffset: Float = 0, ioCostModel: OmIoCostModel = OmIoCostModel(latency: 0.0001, bandwidth: 500_000_000), decodeBytesPerSecond: Double = 1_000_000_000) async throws -> Report {
+        guard values.count == dimensions.reduce(1, *) else {
+            throw OmFileFormatSwiftError.chunkHasWrongNumberOfElements
+        }
+        for query in queries {
+            guard query.range.count == dimensions.count else {
+                throw OmFileFormatSwiftError.requireDimensionsToMatch(required: dimensions.count, actual: query.range.count)
+            }
+            for (range, dimension) in zip(query.range, dimensions) where range.upperBound > dimension {
+                throw OmFileFormatSwiftError.dimensionOutOfBounds(range: Int(range.lowerBound)..<Int(range.upperBound), allowed: Int(dimension))
+            }
+        }
+        let candidates = candidates ?? self.candidates(dimensions: dimensions)
+        guard !candidates.isEmpty else {
+            throw OmFileFormatSwiftError.omEncoder(error: "No candidate chunk dimensions")
+        }
+        let thresholds = ioCostModel.thresholds
+        var results = [Candidate]()
+        results.reserveCapacity(candidates.count)
+        for chunks in candidates {
+            let backend = DataAsClass(data: Data())
+            let fileWriter = OmFileWriter(fn: backend, initialCapacity: 1024 * 1024)
+            let writer = try fileWriter.prepareArray(type: OmType.self, dimensions: dimensions, chunkDimensions: chunks, compression: compression, scale_factor: scaleFactor, add_offset: addOffset)
+            try writer.writeData(array: values)
+            let variable = try fileWriter.write(array: try writer.finalise(), name: "", children: [])
+            try fileWriter.writeTrailer(rootVariable: variable)
+
+            let reader = try await OmFileReader(fn: backend).expectArray(of: OmType.self, io_size_max: thresholds.io_size_max, io_size_merge: thresholds.io_size_merge)
+            let chunkBytes = chunks.reduce(1, *) * UInt64(MemoryLayout<OmType>.stride)
+            let stats = OmReadStatistics()
+            var queryResults = [QueryResult]()
+            queryResults.reserveCapacity(queries.count)
+            for query in queries {
+                let plan = try await reader.readPlan(range: query.range)
+                stats.reset()
+                _ = try await reader.read(range: query.range, stats: stats)
+                let snapshot = stats.snapshot
+                let decodedBytes = snapshot.uncompressedBytes + snapshot.chunksSkipped * chunkBytes
+                let reads = plan.indexReads + plan.dataReads
+                queryResults.append(QueryResult(
+                    name: query.name,
+                    bytesRead: reads.reduce(0, { $0 + $1.count }),
+                    ioCount: reads.count,
+                    chunksDecoded: snapshot.chunksDecoded + snapshot.chunksSkipped,
+                    decodedBytes: decodedBytes,
+                    estimatedSeconds: plan.estimate(model: ioCostModel) + Double(decodedBytes) / decodeBytesPerSecond
+                ))
+            }
+            let estimatedSeconds = zip(queries, queryResults).reduce(0, { $0 + $1.0.weight * $1.1.estimatedSeconds })
+            results.append(Candidate(chunks: chunks, compressedBytes: backend.count, queries: queryResults, estimatedSeconds: estimatedSeconds))
+        }
+        results.sort(by: { $0.estimatedSeconds < $1.estimatedSeconds })
+        return Report(candidates: results)
+    }
+}
+
+extension OmFileReaderArray {
+    /// Read `sample` of this array and evaluate `queries` for candidate chunk shapes. Query ranges are relative to the sample. The current chunk dimensions are always included as a candidate.
+    public func analyseChunks(sample: [Range<UInt64>]? = nil, queries: [OmChunkAdvisor.Query], candidates: [[UInt64]]? = nil, ioCostModel: OmIoCostModel? = nil, decodeBytesPerSecond: Double = 1_000_000_000) async throws -> OmChunkAdvisor.Report {
+        let sample = sample ?? getDimensions().map({ 0..<$0 })
+        let dimensions = sample.map({ UInt64($0.count) })
+        let current = zip(getChunkDimensions(), dimensions).map({ min($0, $1) })
+        var candidates = candidates ?? OmChunkAdvisor.candidates(dimensions: dimensions)
+        if !candidates.contains(current) {
+            candidates.append(current)
+        }
+        let values = try await read(range: sample)
+        return try await OmChunkAdvisor.analyse(
+            values: values,
+            dimensions: dimensions,
+            queries: queries,
+            candidates: candidates,
+            compression: compression,
+            scaleFactor: scaleFactor,
+            addOffset: addOffset,
+            ioCostModel: ioCostModel ?? fn.ioCostModel ?? OmIoCostModel(latency: 0.0001, bandwidth: 500_000_000),
+            decodeBytesPerSecond: decodeBytesPerSecond
+        )
+    }
+}
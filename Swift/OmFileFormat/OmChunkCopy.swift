@@ -0,0 +1,99 @@
+import Foundation
+import OmFileFormatC
+
+extension OmFileWriterArray {
+    /// Write the part `range` of `source` into this array, e.g. to extract a region or to combine variables into a new file. The dimensions of this array must match the size of `range`.
+    ///
+    /// If chunks, compression, scale factor, offset and codec selection match the source and `range` starts at chunk boundaries, chunks that are identical to a source chunk are copied without decompression.
+    /// Only a new LUT is computed. Chunks at the end of `range` that only partially cover a source chunk are decoded and compressed again. Otherwise all chunks are decoded and compressed again.
+    /// Consecutive copied chunks are read together in blocks of up to `maxCopyBytes`. Must be called before any other data is written to this array.
+    /// Returns the number of chunks that have been copied.
+    @discardableResult
+    public func writeData<Backend: OmFileReaderBackend>(copying source: OmFileReaderArray<Backend, OmType>, range: [Range<UInt64>]? = nil, maxCopyBytes: Int = 16 * 1024 * 1024) async throws -> Int {
+        let nDimensions = dimensions.count
+        let sourceDimensions = source.getDimensions()
+        let range = range ?? sourceDimensions.map({ 0..<$0 })
+        guard range.count == nDimensions, sourceDimensions.count == nDimensions else {
+            throw OmFileFormatSwiftError.requireDimensionsToMatch(required: nDimensions, actual: range.count)
+        }
+        for i in 0..<nDimensions where range[i].upperBound > sourceDimensions[i] || UInt64(range[i].count) != dimensions[i] {
+            throw OmFileFormatSwiftError.dimensionOutOfBounds(range: Int(range[i].lowerBound)..<Int(range[i].upperBound), allowed: Int(sourceDimensions[i]))
+        }
+
+        var copyable = source.getChunkDimensions() == chunks &&
+            source.compression == compression &&
+            source.scaleFactor == scale_factor &&
+            source.addOffset == add_offset &&
+            source.isAdaptive == adaptive &&
+            zip(range, chunks).allSatisfy({ $0.lowerBound % $1 == 0 })
+
+        /// Copied chunks keep the statistics of the source
+        var sourceStats: [OmChunkStats_t]? = nil
+        if copyable && chunkStats != nil {
+            if let float = source as? OmFileReaderArray<Backend, Float> {
+                sourceStats = try await float.readChunkStatistics()?.map({ OmChunkStats_t(min: $0.min, max: $0.max, nan_count: $0.nanCount) })
+            }
+            copyable = sourceStats != nil
+        }
+        let lut = copyable ? try await source.readLookUpTable() : []
+
+        let nChunks = zip(dimensions, chunks).map({ ($0 + $1 - 1) / $1 })
+        let sourceChunksCount = zip(sourceDimensions, chunks).map({ ($0 + $1 - 1) / $1 })
+        let totalChunks = nChunks.reduce(1, *)
+
+        /// Consecutive source chunks that are copied with a single read
+        var pending: Range<UInt64> = 0..<0
+        func flush() async throws {
+            guard !pending.isEmpty else {
+                return
+            }
+            let start = lut[Int(pending.lowerBound)]
+            let data = try await source.fn.getDataChecked(offset: Int(start), count: Int(lut[Int(pending.upperBound)] - start))
+            let ends = lut[Int(pending.lowerBound + 1)...Int(pending.upperBound)].map({ $0 - start })
+            let stats = sourceStats?[Int(pending.lowerBound)..<Int(pending.upperBound)]
+            try data.withUnsafeBytes({ try writeCompressed(data: $0, ends: ends, chunkStats: stats) })
+            pending = 0..<0
+        }
+
+        var copied = 0
+        var position = [UInt64](repeating: 0, count: nDimensions)
+        for _ in 0..<totalChunks {
+            /// Region of this chunk and the matching source chunk
+            var chunkRange = [Range<UInt64>]()
+            var sourceChunk: UInt64 = 0
+            var identical = copyable
+            for i in 0..<nDimensions {
+                let lower = position[i] * chunks[i]
+                let upper = min(lower + chunks[i], dimensions[i])
+                let sourceLower = range[i].lowerBound + lower
+                chunkRange.append(sourceLower..<sourceLower + upper - lower)
+                identical = identical && upper - lower == min(sourceLower + chunks[i], sourceDimensions[i]) - sourceLower
+                sourceChunk = sourceChunk * sourceChunksCount[i] + sourceLower / chunks[i]
+            }
+
+            if identical {
+                if pending.upperBound != sourceChunk || Int(lut[Int(sourceChunk) + 1] - lut[Int(pending.lowerBound)]) > maxCopyBytes {
+                    try await flush()
+                    pending = sourceChunk..<sourceChunk
+                }
+                pending = pending.lowerBound..<sourceChunk + 1
+                copied += 1
+            } else {
+                try await flush()
+                let values = try await source.read(range: chunkRange)
+                try writeData(array: values, arrayDimensions: chunkRange.map({ UInt64($0.count) }))
+            }
+
+            /// Next chunk in chunk order
+            for i in (0..<nDimensions).reversed() {
+                position[i] += 1
+                if position[i] < nChunks[i] {
+                    break
+                }
+                position[i] = 0
+            }
+        }
+        try await flush()
+        return copied
+    }
+}
@@ -0,0 +1,193 @@
+import Foundation
+
+/// Limits for concurrent reads with `readConcurrent`. Reading and decoding are bounded separately, so slow storage does not block decoding and large reads do not create thousands of tasks.
+/// Data reads are passed to `withDataBatch` of the backend in windows, so batching and coalescing of the backend still apply.
+public struct OmDecodeScheduler: Sendable {
+    /// Maximum number of data reads in one window passed to the backend
+    public let maxConcurrentReads: Int
+
+    /// Maximum number of reads that are decoded at the same time. Each decoder uses one scratch buffer.
+    public let maxConcurrentDecodes: Int
+
+    /// Maximum number of compressed bytes in one window and of read data waiting to be decoded. The next window is read once it fits next to the
+    /// data still queued for decoding. A single read larger than this limit is still performed.
+    public let maxBufferedBytes: Int
+
+    public init(maxConcurrentReads: Int, maxConcurrentDecodes: Int = ProcessInfo.processInfo.activeProcessorCount, maxBufferedBytes: Int = 64 * 1024 * 1024) {
+        self.maxConcurrentReads = max(maxConcurrentReads, 1)
+        self.maxConcurrentDecodes = max(maxConcurrentDecodes, 1)
+        self.maxBufferedBytes = maxBufferedBytes
+    }
+
+    /// Use the parallelism of the IO cost model for reads. Without a model, one read per processor is used.
+    public init(model: OmIoCostModel?) {
+        self.init(maxConcurrentReads: model?.parallelism ?? ProcessInfo.processInfo.activeProcessorCount)
+    }
+
+    /// Split reads into consecutive windows of at most `maxConcurrentReads` reads and `maxBufferedBytes` bytes
+    func windows(reads: [OmFileRead]) -> [Range<Int>] {
+        var windows = [Range<Int>]()
+        var start = 0
+        while start < reads.count {
+            var end = start
+            var bytes = 0
+            while end < reads.count && end - start < maxConcurrentReads && (end == start || bytes + reads[end].count <= maxBufferedBytes) {
+                bytes += reads[end].count
+                end += 1
+            }
+            windows.append(start ..< end)
+            start = end
+        }
+        return windows
+    }
+}
+
+/// Decode pool with at most `maxConcurrentDecodes` worker threads that run alongside IO. IO callbacks copy data into a buffer of `OmBufferPool.shared`,
+/// queue it and return, so a backend that calls back from a single thread keeps reading while earlier reads are decoded. Workers share one FIFO queue.
+final class OmDecodePool: @unchecked Sendable {
+    let maxConcurrentDecodes: Int
+    let maxBufferedBytes: Int
+    let fn: @Sendable (Int, UnsafeRawBufferPointer) throws -> Void
+
+    private let lock = NSLock()
+    /// Number of running workers
+    private var workers = 0
+    /// Queued reads. Entries before `head` are already taken.
+    private var queue = [(index: Int, buffer: UnsafeMutableRawPointer, count: Int, capacity: Int)]()
+    private var head = 0
+    /// Number and bytes of submitted reads that are not decoded yet
+    private var pendingReads = 0
+    private var pendingBytes = 0
+    /// Callers of `reserve` waiting for pending bytes to be decoded
+    private var waiters = [(bytes: Int, continuation: CheckedContinuation<Void, Never>)]()
+    /// First error of any decoder. Later work is skipped.
+    private var error: (any Error)? = nil
+
+    init(maxConcurrentDecodes: Int, maxBufferedBytes: Int, fn: @escaping @Sendable (Int, UnsafeRawBufferPointer) throws -> Void) {
+        self.maxConcurrentDecodes = maxConcurrentDecodes
+        self.maxBufferedBytes = maxBufferedBytes
+        self.fn = fn
+    }
+
+    /// Queue a copy of `data` for read `index` and start a worker if fewer than `maxConcurrentDecodes` are running.
+    /// Throws the first error of any decoder to stop further reads.
+    func submit(_ index: Int, _ data: UnsafeRawBufferPointer) throws {
+        if let error = firstError() {
+            throw error
+        }
+        let (buffer, capacity) = OmBufferPool.shared.acquire(byteCount: data.count)
+        if let baseAddress = data.baseAddress {
+            buffer.copyMemory(from: baseAddress, byteCount: data.count)
+        }
+        lock.lock()
+        queue.append((index, buffer, data.count, capacity))
+        pendingReads += 1
+        pendingBytes += data.count
+        let start = workers < maxConcurrentDecodes
+        if start {
+            workers += 1
+        }
+        lock.unlock()
+        if start {
+            DispatchQueue.global().async { self.work() }
+        }
+    }
+
+    /// Wait until `bytes` more fit into `maxBufferedBytes` next to the pending reads, or all pending reads are decoded
+    func reserve(bytes: Int) async {
+        await withCheckedContinuation { (continuation: CheckedContinuation<Void, Never>) in
+            lock.lock()
+            guard fits(bytes: bytes) else {
+                waiters.append((bytes, continuation))
+                lock.unlock()
+                return
+            }
+            lock.unlock()
+            continuation.resume()
+        }
+    }
+
+    /// Wait for all submitted reads to be decoded and throw the first error of any decoder
+    func finish() async throws {
+        await reserve(bytes: Int.max)
+        if let error = firstError() {
+            throw error
+        }
+    }
+
+    private func firstError() -> (any Error)? {
+        lock.lock()
+        defer { lock.unlock() }
+        return error
+    }
+
+    /// Decode queued entries until the queue is empty, then stop the worker
+    private func work() {
+        while true {
+            lock.lock()
+            guard head < queue.count else {
+                queue.removeAll(keepingCapacity: true)
+                head = 0
+                workers -= 1
+                lock.unlock()
+                return
+            }
+            let entry = queue[head]
+            head += 1
+            let failed = error != nil
+            lock.unlock()
+            if !failed {
+                do {
+                    try fn(entry.index, UnsafeRawBufferPointer(start: entry.buffer, count: entry.count))
+                } catch {
+                    lock.lock()
+                    if self.error == nil {
+                        self.error = error
+                    }
+                    lock.unlock()
+                }
+            }
+            OmBufferPool.shared.release(entry.buffer, capacity: entry.capacity)
+            lock.lock()
+            pendingReads -= 1
+            pendingBytes -= entry.count
+            var ready = [CheckedContinuation<Void, Never>]()
+            waiters.removeAll { waiter in
+                guard fits(bytes: waiter.bytes) else {
+                    return false
+                }
+                ready.append(waiter.continuation)
+                return true
+            }
+            lock.unlock()
+            ready.forEach { $0.resume() }
+        }
+    }
+
+    /// Requires `lock`
+    private func fits(bytes: Int) -> Bool {
+        return pendingReads == 0 || bytes <= maxBufferedBytes - pendingBytes
+    }
+}
+
+extension OmFileReaderBackend {
+    /// Read all ranges in windows of `scheduler` with `withDataBatch` and call `fn` with the index and data of each read. Reads are expected in file order.
+    /// At most `maxConcurrentDecodes` calls of `fn` run at the same time on worker threads of the decode pool. Returns once all reads are decoded.
+    func withDataScheduled(reads: [OmFileRead], scheduler: OmDecodeScheduler, fn: @escaping @Sendable (Int, UnsafeRawBufferPointer) throws -> Void) async throws {
+        let pool = OmDecodePool(maxConcurrentDecodes: scheduler.maxConcurrentDecodes, maxBufferedBytes: scheduler.maxBufferedBytes, fn: fn)
+        do {
+            for window in scheduler.windows(reads: reads) {
+                let start = window.lowerBound
+                await pool.reserve(bytes: reads[window].reduce(0, { $0 + $1.count }))
+                try await self.withDataBatch(reads: Array(reads[window]), concurrent: true) { i, data in
+                    try pool.submit(start + i, data)
+                }
+            }
+        } catch {
+            /// `fn` may still run on a worker and must finish before the caller releases the decoder
+            try? await pool.finish()
+            throw error
+        }
+        try await pool.finish()
+    }
+}
@@ -0,0 +1,187 @@
+import Foundation
+import OmFileFormatC
+
+/// Extend the root array of an existing file along its first dimension without encoding existing chunks again.
+///
+/// The LUT requires that each chunk ends where the next chunk starts. New chunks therefore continue directly after the last complete row of existing chunks.
+/// Only bytes before `truncateOffset` are kept. The old LUT, meta data and trailer, and an incomplete last row of chunks are dropped.
+/// Afterwards the incomplete row, new chunks, a new LUT, meta data and trailer are written.
+///
+/// By default `append(file:data:)` truncates the file in place and only writes the new data. The write volume does not depend on the size of the file.
+/// Because the trailer is read from the end of the file and new chunks must start at `truncateOffset`, an interrupted append leaves the file unreadable.
+/// With `atomic: true`, kept bytes are copied into a new file which atomically replaces the original. The file is never left incomplete,
+/// but every append copies the whole file. Use it if the file cannot be recreated from its sources.
+///
+/// Appending to other dimensions would change the index of every chunk and requires rewriting the file.
+/// Readers must not access the file while it is appended in place.
+public struct OmFileAppend<OmType: OmFileArrayDataTypeProtocol> {
+    /// Number of bytes of the original file that are kept
+    public let truncateOffset: Int
+
+    let name: String
+    let dimensions: [UInt64]
+    let chunks: [UInt64]
+    let compression: OmCompressionType
+    let adaptive: Bool
+    let packedLut: Bool
+    let scale_factor: Float
+    let add_offset: Float
+
+    /// Values of the last incomplete row of chunks. They are written again together with new data.
+    let partialValues: [OmType]
+
+    /// Offsets of all kept chunks and the end of the last kept chunk
+    let lookUpTable: [UInt64]
+
+    /// Statistics of all kept chunks if the array has chunk statistics
+    let chunkStats: [OmChunkStats_t]?
+
+    let children: [Child]
+
+    enum Child {
+        /// Child before `truncateOffset`
+        case kept(OmOffsetSize)
+        /// Meta data of a child after `truncateOffset` that is written again
+        case copy(Data, nameHash: UInt64)
+    }
+
+    /// Write `data` as new elements of the first dimension. The other dimensions must match the existing array.
+    /// `writer` has to write to the end of a file that contains the first `truncateOffset` bytes of the original file.
+    public func write<FileHandle: OmFileWriterBackend>(data: [OmType], writer: OmFileWriter<FileHandle>) throws {
+        let rowElements = Int(dimensions.dropFirst().reduce(1, *))
+        guard rowElements > 0, data.count % rowElements == 0 else {
+            throw OmFileFormatSwiftError.chunkHasWrongNumberOfElements
+        }
+        let rows = UInt64(data.count / rowElements)
+        let partialRows = UInt64(partialValues.count / rowElements)
+        let newDimensions = [dimensions[0] + rows] + dimensions.dropFirst()
+        let array = try writer.prepareArray(type: OmType.self, dimensions: newDimensions, chunkDimensions: chunks, compression: compression, scale_factor: scale_factor, add_offset: add_offset, chunkStatistics: chunkStats != nil, adaptive: adaptive, packedLut: packedLut)
+        array.resume(lookUpTable: lookUpTable, chunkStats: chunkStats)
+        try array.writeData(array: partialValues + data, arrayDimensions: [partialRows + rows] + dimensions.dropFirst())
+        let finalised = try array.finalise()
+        let children = try children.map { child -> OmOffsetSize in
+            switch child {
+            case .kept(let child):
+                return child
+            case .copy(let data, let nameHash):
+                return try data.withUnsafeBytes({ try writer.writeCopy(variable: $0, nameHash: nameHash) })
+            }
+        }
+        let variable = try writer.write(array: finalised, name: name, children: children)
+        try writer.writeTrailer(rootVariable: variable)
+    }
+
+    /// Append `data` to the root array of `file`. Only new data is written, but the file is unreadable if appending is interrupted.
+    /// With `atomic`, the first `truncateOffset` bytes are copied into a temporary file which is completed, synchronised and then renamed to `file`.
+    /// If appending fails or the process is interrupted, `file` is unchanged. Readers that opened the file before keep reading the previous version.
+    public static func append(file: String, data: [OmType], atomic: Bool = false) async throws {
+        guard atomic else {
+            let fn = try FileHandle.openFileReadWrite(file: file)
+            defer { try? fn.close() }
+            let append = try await OmFileReader(fn: try FileHandleWithCount(fn)).prepareAppend(of: OmType.self)
+            try fn.truncate(atOffset: UInt64(append.truncateOffset))
+            try fn.seekToEnd()
+            let writer = OmFileWriter(fn: fn, initialCapacity: 1024 * 1024, offset: append.truncateOffset)
+            try append.write(data: data, writer: writer)
+            try fn.synchronize()
+            return
+        }
+        let fn = try FileHandle.openFileReading(file: file)
+        defer { try? fn.close() }
+        let append = try await OmFileReader(fn: try FileHandleWithCount(fn)).prepareAppend(of: OmType.self)
+
+        /// On Linux the temporary file has no name until it is linked
+        let temporary = try FileHandle.createNewFile(file: file, overwrite: true, temporary: true)
+        do {
+            try fn.seek(toOffset: 0)
+            var remaining = append.truncateOffset
+            while remaining > 0 {
+                guard let block = try fn.read(upToCount: min(remaining, 16 * 1024 * 1024)), !block.isEmpty else {
+                    throw OmFileFormatSwiftError.cannotReadFile(errno: errno, error: "Unexpected end of file")
+                }
+                try temporary.write(contentsOf: block)
+                remaining -= block.count
+            }
+            let writer = OmFileWriter(fn: temporary, initialCapacity: 1024 * 1024, offset: append.truncateOffset)
+            try append.write(data: data, writer: writer)
+            try temporary.synchronize()
+            try temporary.linkTemporary(file: file)
+            try temporary.close()
+        } catch {
+            try? temporary.close()
+            #if !os(Linux)
+            try? FileManager.default.removeItem(atPath: "\(file)~")
+            #endif
+            throw error
+        }
+    }
+}
+
+extension OmFileReader {
+    /// Prepare appending to this array along its first dimension. This must be the root variable of the file.
+    /// Reads the LUT, an incomplete last row of chunks and children that are stored after the data. See `OmFileAppend`.
+    public func prepareAppend<OmType: OmFileArrayDataTypeProtocol>(of: OmType.Type) async throws -> OmFileAppend<OmType> {
+        guard try await !isLegacyFormat() else {
+            throw OmFileFormatSwiftError.omEncoder(error: "Legacy files cannot be appended")
+        }
+        let array = try expectArray(of: OmType.self)
+        let dimensions = array.getDimensions()
+        let chunks = array.getChunkDimensions()
+        guard let chunksFirst = chunks.first, let dimensionsFirst = dimensions.first else {
+            throw OmFileFormatSwiftError.dimensionMustBeLargerThan0
+        }
+
+        let lut = try await array.readLookUpTable()
+
+        // Chunks of an incomplete last row are written again
+        let chunksPerRow = zip(dimensions, chunks).dropFirst().reduce(1, { $0 * (($1.0 + $1.1 - 1) / $1.1) })
+        let completeRows = dimensionsFirst / chunksFirst * chunksFirst
+        let firstChunk = Int(completeRows / chunksFirst * chunksPerRow)
+        let truncateOffset = Int(lut[firstChunk])
+        let partialValues = completeRows < dimensionsFirst ? try await array.read(range: [completeRows..<dimensionsFirst] + dimensions.dropFirst().map({ 0..<$0 })) : []
+
+        var chunkStats: [OmChunkStats_t]? = nil
+        if let float = array as? OmFileReaderArray<Backend, Float>, float.hasChunkStatistics {
+            chunkStats = try await float.readChunkStatistics(chunks: 0..<UInt64(firstChunk))?.map({ OmChunkStats_t(min: $0.min, max: $0.max, nan_count: $0.nanCount) })
+        }
+
+        // Keep children before the truncated part and copy leaf variables after it
+        var children = [OmFileAppend<OmType>.Child]()
+        for i in 0..<numberOfChildren {
+            var offset: UInt64 = 0
+            var size: UInt64 = 0
+            guard variable.withUnsafeBytes({ om_variable_get_children(om_variable_init($0.baseAddress?.advanced(by: variableOffset)), i, 1, &offset, &size) }),
+                  let child = try await getChild(i) else {
+                throw OmFileFormatSwiftError.notAnOpenMeteoFile
+            }
+            let nameHash = child.withName({ name in
+                var name = name
+                return name.withUTF8({ om_variable_name_hash($0.baseAddress, UInt16($0.count)) })
+            })
+            if offset + size <= UInt64(truncateOffset) {
+                children.append(.kept(OmOffsetSize(offset: offset, size: size, nameHash: nameHash)))
+                continue
+            }
+            guard child.numberOfChildren == 0, child.dataType.rawValue < OmDataType.int8_array.rawValue else {
+                throw OmFileFormatSwiftError.omEncoder(error: "Children with own children or data after the array cannot be preserved while appending")
+            }
+            let data = try await fn.getDataChecked(offset: Int(offset), count: Int(size))
+            children.append(.copy(data.withUnsafeBytes({ Data($0) }), nameHash: nameHash))
+        }
+        return OmFileAppend(
+            truncateOffset: truncateOffset,
+            name: getName(),
+            dimensions: dimensions,
+            chunks: chunks,
+            compression: array.compression,
+            adaptive: array.isAdaptive,
+            packedLut: array.isLutPacked,
+            scale_factor: array.scaleFactor,
+            add_offset: array.addOffset,
+            partialValues: partialValues,
+            lookUpTable: Array(lut[0...firstChunk]),
+            chunkStats: chunkStats,
+            children: children
+        )
+    }
+}
@@ -22,6 +22,8 @@ public enum OmFileFormatSwiftError: Error {
     case notAnOpenMeteoFile
     case requireDimensionsToMatch(required: Int, actual: Int)
     case invalidDataType
+    case httpRequestFailed(url: String, statusCode: Int)
+    case mlockFailed(errno: Int32, error: String)
 }
 
 
@@ -68,6 +70,10 @@ public enum OmCompressionType: UInt8, Codable, Sendable {
     ///  Similar to `pfor_delta2d_int16` but applies `log10(1+x)` before
     case pfor_delta2d_int16_logarithmic = 3
 
+    /// Lossless compression for float and double values. Values are mapped to ordered integers, predicted from the previous row and linearly from the previous two values in a row. Residuals are PFor compressed.
+    /// Typically compresses smooth fields better than `fpx_xor2d`, but decodes slower.
+    case pfor_float_linear2d = 5
+
     func toC() -> OmCompression_t {
         switch self {
         case .pfor_delta2d_int16:
@@ -78,6 +84,20 @@ public enum OmCompressionType: UInt8, Codable, Sendable {
             return COMPRESSION_PFOR_DELTA2D
         case .pfor_delta2d_int16_logarithmic:
             return COMPRESSION_PFOR_DELTA2D_INT16_LOGARITHMIC
+        case .pfor_float_linear2d:
+            return COMPRESSION_PFOR_FLOAT_LINEAR2D
+        }
+    }
+
+    /// Compression type including `OM_COMPRESSION_ADAPTIVE` if each chunk selects its own codec and `OM_COMPRESSION_LUT_PACKED` if the LUT is bit packed
+    func toC(adaptive: Bool, packedLut: Bool = false) -> OmCompression_t {
+        var rawValue = toC().rawValue
+        if adaptive {
+            rawValue |= UInt32(OM_COMPRESSION_ADAPTIVE)
+        }
+        if packedLut {
+            rawValue |= UInt32(OM_COMPRESSION_LUT_PACKED)
         }
+        return OmCompression_t(rawValue: rawValue)
     }
 }
@@ -13,6 +13,21 @@ public struct OmFileReader<Backend: OmFileReaderBackend> {
     /// Underlaying memory for the variable. Could just be a pointer or a reference counted allocated memory region
     let variable: Backend.DataType
 
+    /// Position of the variable inside `variable`. Non zero if the variable was resolved inside a metadata subtree.
+    let variableOffset: Int
+
+    /// Size of the variable in bytes including an optional name index
+    let variableSize: Int
+
+    /// Meta data of descendants read with `readMetadataSubtree`. Children inside this buffer are resolved without IO.
+    let metadata: MetadataBuffer?
+
+    /// Contiguous file data starting at file position `offset`
+    struct MetadataBuffer: Sendable {
+        let data: Backend.DataType
+        let offset: Int
+    }
+
     /// Open a file and decode om file meta data. In this case  fn is typically mmap or just plain memory
     public init(fn: Backend) async throws {
         self.fn = fn
@@ -37,6 +52,9 @@ public struct OmFileReader<Backend: OmFileReaderBackend> {
                 throw OmFileFormatSwiftError.notAnOpenMeteoFile
             }
             self.variable = data
+            self.variableOffset = 0
+            self.variableSize = headerSize
+            self.metadata = nil
             return
         }
         /// Read data from root.offset by root.size. Important: data must remain accessible throughout the use of this variable!!
@@ -48,11 +66,17 @@ public struct OmFileReader<Backend: OmFileReaderBackend> {
             }
         }
         self.variable = dataVariable
+        self.variableOffset = 0
+        self.variableSize = Int(size)
+        self.metadata = nil
     }
 
-    init(fn: Backend, variable: Backend.DataType) {
+    init(fn: Backend, variable: Backend.DataType, variableOffset: Int = 0, variableSize: Int? = nil, metadata: MetadataBuffer? = nil) {
         self.fn = fn
         self.variable = variable
+        self.variableOffset = variableOffset
+        self.variableSize = variableSize ?? variable.withUnsafeBytes({ $0.count }) - variableOffset
+        self.metadata = metadata
     }
 
     public func isLegacyFormat() async throws -> Bool {
@@ -63,7 +87,7 @@ public struct OmFileReader<Backend: OmFileReaderBackend> {
 
     public var dataType: OmDataType {
         return variable.withUnsafeBytes({
-            let variable = om_variable_init($0.baseAddress)
+            let variable = om_variable_init($0.baseAddress?.advanced(by: variableOffset))
             return OmDataType(rawValue: UInt8(om_variable_get_type(variable).rawValue))!
         })
     }
@@ -71,7 +95,7 @@ public struct OmFileReader<Backend: OmFileReaderBackend> {
     /// Temporarily return the name of the variable. The string refers to internal memory and should not be used outside its scope.
     public func withName<R>(_ body: (String) throws -> R) rethrows -> R {
         return try variable.withUnsafeBytes({
-            let variable = om_variable_init($0.baseAddress)
+            let variable = om_variable_init($0.baseAddress?.advanced(by: variableOffset))
             var length: UInt16 = 0
             let name = om_variable_get_name(variable, &length);
             guard let name, length > 0 else {
@@ -85,7 +109,7 @@ public struct OmFileReader<Backend: OmFileReaderBackend> {
     /// Get the name of the variable. The String is copied form the underlaying buffer memory..
     public func getName() -> String {
         return variable.withUnsafeBytes({
-            let variable = om_variable_init($0.baseAddress)
+            let variable = om_variable_init($0.baseAddress?.advanced(by: variableOffset))
             var length: UInt16 = 0
             let name = om_variable_get_name(variable, &length);
             guard let name, length > 0 else {
@@ -98,16 +122,19 @@ public struct OmFileReader<Backend: OmFileReaderBackend> {
 
     public var numberOfChildren: UInt32 {
         return variable.withUnsafeBytes({
-            let variable = om_variable_init($0.baseAddress)
+            let variable = om_variable_init($0.baseAddress?.advanced(by: variableOffset))
             return om_variable_get_children_count(variable)
         })
     }
 
     public func getChild(_ index: UInt32) async throws -> OmFileReader<Backend>? {
+        if let metadata, let child = childInMetadata(index, metadata: metadata) {
+            return child
+        }
         var size: UInt64 = 0
         var offset: UInt64 = 0
         guard variable.withUnsafeBytes({
-            let variable = om_variable_init($0.baseAddress)
+            let variable = om_variable_init($0.baseAddress?.advanced(by: variableOffset))
             return om_variable_get_children(variable, index, 1, &offset, &size)
         }) else {
             return nil
@@ -120,10 +147,111 @@ public struct OmFileReader<Backend: OmFileReaderBackend> {
                 throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
             }
         }
-        return OmFileReader(fn: fn, variable: dataChild)
+        return OmFileReader(fn: fn, variable: dataChild, metadata: metadata)
+    }
+
+    /// Resolve a child as a pointer into the metadata buffer. Returns nil if the child is not contained in the buffer.
+    func childInMetadata(_ index: UInt32, metadata: MetadataBuffer) -> OmFileReader<Backend>? {
+        guard let child = variable.withUnsafeBytes({ variable in
+            metadata.data.withUnsafeBytes({ buffer -> (position: Int, size: Int)? in
+                let variable = om_variable_init(variable.baseAddress?.advanced(by: variableOffset))
+                var offset: UInt64 = 0
+                var size: UInt64 = 0
+                guard om_variable_get_children(variable, index, 1, &offset, &size), let child = om_variable_get_child_in_buffer(variable, index, buffer.baseAddress, UInt64(metadata.offset), UInt64(buffer.count)) else {
+                    return nil
+                }
+                return (buffer.baseAddress!.distance(to: UnsafeRawPointer(child)), Int(size))
+            })
+        }) else {
+            return nil
+        }
+        return OmFileReader(fn: fn, variable: metadata.data, variableOffset: child.position, variableSize: child.size, metadata: metadata)
+    }
+
+    /// Read the meta data of all descendants in one IO and resolve children, names and scalars inside this buffer without copying or further reads.
+    /// Children are written before their parent, therefore the range of direct children is extended to grandchildren that are located before it. The range is limited to `maxBytes`, descendants outside are read individually by `getChild`.
+    /// Data of arrays between meta data is part of the read. For files with many attributes and few arrays this reduces opening a file to a single read.
+    public func readMetadataSubtree(maxBytes: Int = 1024 * 1024) async throws -> Self {
+        guard var range = variable.withUnsafeBytes({ variable -> Range<Int>? in
+            let variable = om_variable_init(variable.baseAddress?.advanced(by: variableOffset))
+            var offset: UInt64 = 0
+            var size: UInt64 = 0
+            guard om_variable_get_children_range(variable, &offset, &size) else {
+                return nil
+            }
+            return Int(offset)..<Int(offset + size)
+        }), range.count <= maxBytes else {
+            return self
+        }
+        while true {
+            let data = try await fn.getDataChecked(offset: range.lowerBound, count: range.count)
+            let buffer = MetadataBuffer(data: data, offset: range.lowerBound)
+            let reader = OmFileReader(fn: fn, variable: variable, variableOffset: variableOffset, variableSize: variableSize, metadata: buffer)
+            guard let missing = reader.missingDescendants() else {
+                return reader
+            }
+            let extended = min(missing.lowerBound, range.lowerBound)..<max(missing.upperBound, range.upperBound)
+            guard extended.count <= maxBytes, extended != range else {
+                return reader
+            }
+            range = extended
+        }
+    }
+
+    /// File range of all descendants that are not contained in the metadata buffer
+    func missingDescendants() -> Range<Int>? {
+        guard let metadata else {
+            return nil
+        }
+        return variable.withUnsafeBytes({ variable in
+            metadata.data.withUnsafeBytes({ buffer -> Range<Int>? in
+                var missing: Range<Int>? = nil
+                /// Positions inside the buffer. Visited variables are skipped to guard against cycles in corrupted files.
+                var visited = Set<Int>()
+                var stack = [UnsafePointer<OmVariable_t?>]()
+                if let root = om_variable_init(variable.baseAddress?.advanced(by: variableOffset)) {
+                    stack.append(root)
+                }
+                while let parent = stack.popLast() {
+                    for index in 0..<om_variable_get_children_count(parent) {
+                        if let child = om_variable_get_child_in_buffer(parent, index, buffer.baseAddress, UInt64(metadata.offset), UInt64(buffer.count)) {
+                            if visited.insert(buffer.baseAddress!.distance(to: UnsafeRawPointer(child))).inserted {
+                                stack.append(child)
+                            }
+                            continue
+                        }
+                        var offset: UInt64 = 0
+                        var size: UInt64 = 0
+                        guard om_variable_get_children(parent, index, 1, &offset, &size) else {
+                            continue
+                        }
+                        let range = Int(offset)..<Int(offset + size)
+                        missing = missing.map({ min($0.lowerBound, range.lowerBound)..<max($0.upperBound, range.upperBound) }) ?? range
+                    }
+                }
+                return missing
+            })
+        })
     }
     
+    /// Find a child by name. Files with a name index only read the matching child, otherwise all children are read until the name matches.
     public func getChild(name: String) async throws -> Self? {
+        let (hasIndex, found, index) = variable.withUnsafeBytes({
+            let variable = om_variable_init($0.baseAddress?.advanced(by: variableOffset))
+            var found = false
+            var index: UInt32 = 0
+            let hasIndex = om_variable_lookup_child(variable, UInt64(variableSize), name, UInt16(clamping: name.utf8.count), &found, &index)
+            return (hasIndex, found, index)
+        })
+        if hasIndex {
+            guard found else {
+                return nil
+            }
+            if let child = try await getChild(index), child.withName({$0 == name}) {
+                return child
+            }
+            // Different names with the same hash. Fall back to comparing all names.
+        }
         for i in 0..<numberOfChildren {
             if let child = try await getChild(i), child.withName({$0 == name}) {
                 return child
@@ -138,7 +266,7 @@ public struct OmFileReader<Backend: OmFileReaderBackend> {
             return nil
         }
         return variable.withUnsafeBytes({
-            let variable = om_variable_init($0.baseAddress)
+            let variable = om_variable_init($0.baseAddress?.advanced(by: variableOffset))
             var ptr = UnsafeMutableRawPointer(bitPattern: 0)
             var size: UInt64 = 0
             guard om_variable_get_scalar(variable, &ptr, &size) == ERROR_OK, let ptr else {
@@ -151,30 +279,38 @@ public struct OmFileReader<Backend: OmFileReaderBackend> {
     /// If it is an array of specified type, return a type safe reader for this type
     /// `io_size_merge` The maximum size (in bytes) for merging consecutive IO operations. It helps to optimise read performance by merging small reads.
     /// `io_size_max` The maximum size (in bytes) for a single IO operation before it is split. It defines the threshold for splitting large reads.
-    public func asArray<OmType: OmFileArrayDataTypeProtocol>(of: OmType.Type, io_size_max: UInt64 = 65536, io_size_merge: UInt64 = 512) -> OmFileReaderArray<Backend, OmType>? {
+    /// If not set, both are derived from the IO cost model of the backend or default to 512 bytes and 64 KiB.
+    public func asArray<OmType: OmFileArrayDataTypeProtocol>(of: OmType.Type, io_size_max: UInt64? = nil, io_size_merge: UInt64? = nil) -> OmFileReaderArray<Backend, OmType>? {
         guard OmType.dataTypeArray == self.dataType else {
             return nil
         }
+        let thresholds = fn.ioCostModel?.thresholds
         return OmFileReaderArray(
             fn: fn,
             variable: variable,
-            io_size_max: io_size_max,
-            io_size_merge: io_size_merge
+            variableOffset: variableOffset,
+            variableSize: variableSize,
+            io_size_max: io_size_max ?? thresholds?.io_size_max ?? 65536,
+            io_size_merge: io_size_merge ?? thresholds?.io_size_merge ?? 512
         )
     }
     
     /// If it is an array of specified type, return a type safe reader for this type otherwise throw an error
     /// `io_size_merge` The maximum size (in bytes) for merging consecutive IO operations. It helps to optimise read performance by merging small reads.
     /// `io_size_max` The maximum size (in bytes) for a single IO operation before it is split. It defines the threshold for splitting large reads.
-    public func expectArray<OmType>(of: OmType.Type, io_size_max: UInt64 = 65536, io_size_merge: UInt64 = 512) throws -> OmFileReaderArray<Backend, OmType> where OmType : OmFileArrayDataTypeProtocol {
+    /// If not set, both are derived from the IO cost model of the backend or default to 512 bytes and 64 KiB.
+    public func expectArray<OmType>(of: OmType.Type, io_size_max: UInt64? = nil, io_size_merge: UInt64? = nil) throws -> OmFileReaderArray<Backend, OmType> where OmType : OmFileArrayDataTypeProtocol {
         guard OmType.dataTypeArray == self.dataType else {
             throw OmFileFormatSwiftError.invalidDataType
         }
+        let thresholds = fn.ioCostModel?.thresholds
         return OmFileReaderArray(
             fn: fn,
             variable: variable,
-            io_size_max: io_size_max,
-            io_size_merge: io_size_merge
+            variableOffset: variableOffset,
+            variableSize: variableSize,
+            io_size_max: io_size_max ?? thresholds?.io_size_max ?? 65536,
+            io_size_merge: io_size_merge ?? thresholds?.io_size_merge ?? 512
         )
     }
 }
@@ -9,27 +9,70 @@ public struct OmFileReaderArray<Backend: OmFileReaderBackend, OmType: OmFileArra
 
     let variable: Backend.DataType
 
+    /// Position of the variable inside `variable`. Non zero if the variable was resolved inside a metadata subtree.
+    var variableOffset: Int = 0
+
+    /// Size of the variable including optional name index and chunk statistics. Nil if the variable extends to the end of `variable`.
+    var variableSize: Int? = nil
+
     let io_size_max: UInt64
 
     let io_size_merge: UInt64
 
+    /// Optional cache for decompressed LUT chunks
+    var lutCache: OmLutCache? = nil
+
+    /// Optional cache for decompressed data chunks
+    var chunkCache: OmChunkCache? = nil
+
+    /// Identifies the file in the LUT and chunk cache
+    var cacheFile: UInt64 = 0
+
+    /// The entire LUT of this array if pinned with `pinLut()` or `withPinnedLut`
+    var lutPinned: OmPinnedLut? = nil
+
+    /// Number of bytes before index data that are read together with index data
+    var lookahead: Int = 0
+
+    /// Optional counters filled by the decoder
+    var statistics: OmReadStatistics? = nil
+
+    /// Limits for `readConcurrent`. If nil, all data reads of an index block are passed to the backend in one batch.
+    var scheduler: OmDecodeScheduler? = nil
+
     public var compression: OmCompressionType {
         return variable.withUnsafeBytes({
-            let variable = om_variable_init($0.baseAddress)
+            let variable = om_variable_init($0.baseAddress?.advanced(by: variableOffset))
             return OmCompressionType(rawValue: UInt8(om_variable_get_compression(variable).rawValue))!
         })
     }
 
+    /// True if each chunk selects its own codec. See `prepareArray(adaptive:)`
+    public var isAdaptive: Bool {
+        return variable.withUnsafeBytes({
+            let variable = om_variable_init($0.baseAddress?.advanced(by: variableOffset))
+            return om_variable_is_adaptive(variable)
+        })
+    }
+
+    /// True if the LUT is stored in bit packed blocks. See `prepareArray(packedLut:)`
+    public var isLutPacked: Bool {
+        return variable.withUnsafeBytes({
+            let variable = om_variable_init($0.baseAddress?.advanced(by: variableOffset))
+            return om_variable_is_lut_packed(variable)
+        })
+    }
+
     public var scaleFactor: Float {
         return variable.withUnsafeBytes({
-            let variable = om_variable_init($0.baseAddress)
+            let variable = om_variable_init($0.baseAddress?.advanced(by: variableOffset))
             return om_variable_get_scale_factor(variable)
         })
     }
 
     public var addOffset: Float {
         return variable.withUnsafeBytes({
-            let variable = om_variable_init($0.baseAddress)
+            let variable = om_variable_init($0.baseAddress?.advanced(by: variableOffset))
             return om_variable_get_add_offset(variable)
         })
     }
@@ -37,7 +80,7 @@ public struct OmFileReaderArray<Backend: OmFileReaderBackend, OmType: OmFileArra
     /// Zero copy access to dimensions
     public func withDimensions<R>(_ body: (_: UnsafeBufferPointer<UInt64>) -> R) -> R {
         return variable.withUnsafeBytes({
-            let variable = om_variable_init($0.baseAddress)
+            let variable = om_variable_init($0.baseAddress?.advanced(by: variableOffset))
             let count = om_variable_get_dimensions_count(variable)
             let dimensions = om_variable_get_dimensions(variable)
             return body(UnsafeBufferPointer<UInt64>(start: dimensions, count: Int(count)))
@@ -47,7 +90,7 @@ public struct OmFileReaderArray<Backend: OmFileReaderBackend, OmType: OmFileArra
     /// Zero copy access to chunk dimensions
     public func withChunkDimensions<R>(_ body: (_: UnsafeBufferPointer<UInt64>) -> R) -> R {
         return variable.withUnsafeBytes({
-            let variable = om_variable_init($0.baseAddress)
+            let variable = om_variable_init($0.baseAddress?.advanced(by: variableOffset))
             let count = om_variable_get_dimensions_count(variable)
             let dimensions = om_variable_get_chunks(variable)
             return body(UnsafeBufferPointer<UInt64>(start: dimensions, count: Int(count)))
@@ -62,6 +105,126 @@ public struct OmFileReaderArray<Backend: OmFileReaderBackend, OmType: OmFileArra
         return withChunkDimensions(Array.init)
     }
 
+    /// Use a cache for decompressed LUT chunks. The cache can be shared between multiple arrays, files and threads.
+    /// If all LUT chunks for a read are cached, index data is not read at all.
+    /// `file` must uniquely identify the underlying file for all readers using the same cache.
+    public func withLutCache(_ cache: OmLutCache, file: UInt64) -> Self {
+        var copy = self
+        copy.lutCache = cache
+        copy.cacheFile = file
+        return copy
+    }
+
+    /// Use a cache for decompressed data chunks. The cache can be shared between multiple arrays, files and threads.
+    /// Cached chunks are not read and decompressed again. Combined with a LUT cache, reads of cached regions do not perform any IO.
+    /// `file` must uniquely identify the underlying file and must be the same as for the LUT cache.
+    public func withChunkCache(_ cache: OmChunkCache, file: UInt64) -> Self {
+        var copy = self
+        copy.chunkCache = cache
+        copy.cacheFile = file
+        return copy
+    }
+
+    /// Record counters and timings of all reads in `statistics`. The same instance can be shared between arrays and threads.
+    public func withStatistics(_ statistics: OmReadStatistics) -> Self {
+        var copy = self
+        copy.statistics = statistics
+        return copy
+    }
+
+    /// Read the entire LUT of this array once and keep it in memory. Afterwards reads do not perform any index reads and only require a single round trip for data.
+    /// Useful for remote files that are read many times.
+    public func pinLut() async throws -> Self {
+        let dimensions = getDimensions()
+        let offset = [UInt64](repeating: 0, count: dimensions.count)
+        var decoder = try initDecoder(offset: offset, count: dimensions, intoCubeOffset: nil, intoCubeDimension: nil, nDimensions: dimensions.count)
+        var lutOffset: UInt64 = 0
+        var lutCount: UInt64 = 0
+        om_decoder_lut_range(&decoder, &lutOffset, &lutCount)
+        var copy = self
+        copy.lutPinned = OmPinnedLut(try await fn.getDataChecked(offset: Int(lutOffset), count: Int(lutCount)))
+        return copy
+    }
+
+    /// Prefetch the LUT of this array with `hint`. With `.pin`, a memory mapped file keeps the LUT pages locked in memory, so index lookups never wait for page faults. Undo with `.unpin`.
+    /// Other backends only prefetch the LUT for `.willNeed`. Use `pinLut` to keep a copy of the LUT for remote files.
+    public func prefetchLut(hint: OmPrefetchHint) async throws {
+        let dimensions = getDimensions()
+        let offset = [UInt64](repeating: 0, count: dimensions.count)
+        var decoder = try initDecoder(offset: offset, count: dimensions, intoCubeOffset: nil, intoCubeDimension: nil, nDimensions: dimensions.count)
+        var lutOffset: UInt64 = 0
+        var lutCount: UInt64 = 0
+        om_decoder_lut_range(&decoder, &lutOffset, &lutCount)
+        try await fn.prefetchData(offset: Int(lutOffset), count: Int(lutCount), hint: hint)
+    }
+
+    /// Limit in-flight reads, decode tasks and buffered data of `readConcurrent`. Useful on shared servers to keep memory and latency predictable for large reads.
+    /// `OmDecodeScheduler(model:)` derives the number of reads from the IO cost model of the backend.
+    public func withScheduler(_ scheduler: OmDecodeScheduler) -> Self {
+        var copy = self
+        copy.scheduler = scheduler
+        return copy
+    }
+
+    /// Read up to `bytes` before each index block in the same request. The writer places data chunks before the LUT, so for small arrays or reads close to the end of an array, data is available without another round trip.
+    /// A good value is the number of bytes the backend can transfer during the latency of one request (`latency * bandwidth` of the IO cost model).
+    public func withLookahead(_ bytes: Int) -> Self {
+        var copy = self
+        copy.lookahead = bytes
+        return copy
+    }
+
+    /// Initialise a decoder and attach caches
+    func initDecoder(offset: UnsafePointer<UInt64>, count: UnsafePointer<UInt64>, intoCubeOffset: UnsafePointer<UInt64>?, intoCubeDimension: UnsafePointer<UInt64>?, nDimensions: Int) throws -> OmDecoder_t {
+        return try variable.withUnsafeBytes({
+            let variable = om_variable_init($0.baseAddress?.advanced(by: variableOffset))
+            var decoder = OmDecoder_t()
+            let error = om_decoder_init(
+                &decoder,
+                variable,
+                UInt64(nDimensions),
+                offset,
+                count,
+                intoCubeOffset,
+                intoCubeDimension,
+                io_size_merge,
+                io_size_max
+            )
+            guard error == ERROR_OK else {
+                throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
+            }
+            if let lutCache {
+                om_decoder_set_lut_cache(&decoder, lutCache.cache, cacheFile)
+            }
+            if let chunkCache {
+                om_decoder_set_chunk_cache(&decoder, chunkCache.cache, cacheFile)
+            }
+            if let statistics {
+                om_decoder_set_stats(&decoder, statistics.stats)
+            }
+            if let lutPinned {
+                om_decoder_set_lut_pinned(&decoder, lutPinned.buffer.baseAddress, UInt64(lutPinned.buffer.count))
+            }
+            return decoder
+        })
+    }
+
+    /// Read and decompress the entire LUT. Entry `i` is the file offset of chunk `i` and the last entry is the end of the last chunk.
+    func readLookUpTable() async throws -> [UInt64] {
+        let dimensions = getDimensions()
+        var decoder = try initDecoder(offset: [UInt64](repeating: 0, count: dimensions.count), count: dimensions, intoCubeOffset: nil, intoCubeDimension: nil, nDimensions: dimensions.count)
+        var lutOffset: UInt64 = 0
+        var lutCount: UInt64 = 0
+        om_decoder_lut_range(&decoder, &lutOffset, &lutCount)
+        let lutData = try await fn.getDataChecked(offset: Int(lutOffset), count: Int(lutCount))
+        var lut = [UInt64](repeating: 0, count: Int(decoder.number_of_chunks) + 1)
+        let error = lutData.withUnsafeBytes({ om_decoder_decode_lut(&decoder, $0.baseAddress, UInt64($0.count), &lut) })
+        guard error == ERROR_OK else {
+            throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
+        }
+        return lut
+    }
+
     /// Read variable as float array
     public func read(offset: [UInt64], count: [UInt64]) async throws -> [OmType] {
         let n = count.reduce(1, *)
@@ -95,6 +258,11 @@ public struct OmFileReaderArray<Backend: OmFileReaderBackend, OmType: OmFileArra
         return out
     }
     
+    /// Read variable as float array and add counters and timings of this read to `stats`
+    public func read(range: [Range<UInt64>]? = nil, stats: OmReadStatistics) async throws -> [OmType] {
+        return try await withStatistics(stats).read(range: range)
+    }
+
     /// Prefetch data
     public func willNeed(range: [Range<UInt64>]? = nil) async throws {
         let range = range ?? self.getDimensions().map({ 0..<$0 })
@@ -117,56 +285,122 @@ public struct OmFileReaderArray<Backend: OmFileReaderBackend, OmType: OmFileArra
         try await self.read(into: into, offset: offset, count: count, intoCubeOffset: intoCubeOffset, intoCubeDimension: intoCubeDimension, nDimensions: nDimensions)
     }
 
+    /// Read into a target with a byte stride for each dimension, e.g. padded rows, a transposed layout or a flipped grid.
+    /// `into` is the element for the first coordinate of `range` and strides may be negative.
+    public func read(into: UnsafeMutablePointer<OmType>, range: [Range<UInt64>], byteStrides: [Int]) async throws {
+        let offset = range.map({$0.lowerBound})
+        let count = range.map({UInt64($0.count)})
+        guard byteStrides.count == range.count else {
+            throw OmFileFormatSwiftError.requireDimensionsToMatch(required: range.count, actual: byteStrides.count)
+        }
+        let strides = byteStrides.map({ Int64($0) })
+        try await self.read(into: into, offset: offset, count: count, byteStrides: strides, nDimensions: range.count)
+    }
+
+    /// Read data by offset and count into a target with a byte stride for each dimension
+    public func read(into: UnsafeMutablePointer<OmType>, offset: UnsafePointer<UInt64>, count: UnsafePointer<UInt64>, byteStrides: UnsafePointer<Int64>, nDimensions: Int) async throws {
+        var decoder = try initDecoder(offset: offset, count: count, intoCubeOffset: nil, intoCubeDimension: nil, nDimensions: nDimensions)
+        om_decoder_set_cube_strides(&decoder, byteStrides)
+        try await fn.decode(decoder: &decoder, into: into, lookahead: lookahead)
+    }
+
     /// Read data by offset and count
     public func read(into: UnsafeMutablePointer<OmType>, offset: UnsafePointer<UInt64>, count: UnsafePointer<UInt64>, intoCubeOffset: UnsafePointer<UInt64>, intoCubeDimension: UnsafePointer<UInt64>, nDimensions: Int) async throws {
-        var decoder = try variable.withUnsafeBytes({
-            let variable = om_variable_init($0.baseAddress)
-            var decoder = OmDecoder_t()
-            let error = om_decoder_init(
-                &decoder,
-                variable,
-                UInt64(nDimensions),
-                offset,
-                count,
-                intoCubeOffset,
-                intoCubeDimension,
-                io_size_merge,
-                io_size_max
-            )
-            guard error == ERROR_OK else {
-                throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
-            }
-            return decoder
-        })
+        var decoder = try initDecoder(offset: offset, count: count, intoCubeOffset: intoCubeOffset, intoCubeDimension: intoCubeDimension, nDimensions: nDimensions)
         // TODO: Technically memory from `variable` is escaping through decoder. Consider copy all dimension information into decoder
-        try await fn.decode(decoder: &decoder, into: into)
+        try await fn.decode(decoder: &decoder, into: into, lookahead: lookahead)
     }
 
     /// Prefetch data
     public func willNeed(offset: UnsafePointer<UInt64>, count: UnsafePointer<UInt64>, nDimensions: Int) async throws {
-        var decoder = try variable.withUnsafeBytes({
-            let variable = om_variable_init($0.baseAddress)
-            var decoder = OmDecoder_t()
-            let error = om_decoder_init(
-                &decoder,
-                variable,
-                UInt64(nDimensions),
-                offset,
-                count,
-                nil,
-                nil,
-                io_size_merge,
-                io_size_max
-            )
-            guard error == ERROR_OK else {
-                throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
-            }
-            return decoder
-        })
+        var decoder = try initDecoder(offset: offset, count: count, intoCubeOffset: nil, intoCubeDimension: nil, nDimensions: nDimensions)
         // TODO: Technically memory from `variable` is escaping through decoder. Consider copy all dimension information into decoder
         try await fn.decodePrefetch(decoder: &decoder)
     }
 
+    /// Return all index and data reads for a range without reading data. Index data is read to resolve chunk offsets.
+    /// Useful to inspect how `io_size_merge` and `io_size_max` or the IO cost model of the backend split a read.
+    public func readPlan(range: [Range<UInt64>]? = nil) async throws -> OmReadPlan {
+        let range = range ?? self.getDimensions().map({ 0..<$0 })
+        let offset = range.map({$0.lowerBound})
+        let count = range.map({UInt64($0.count)})
+        return try await self.readPlan(offset: offset, count: count, nDimensions: offset.count)
+    }
+
+    /// Return all index and data reads without reading data
+    public func readPlan(offset: UnsafePointer<UInt64>, count: UnsafePointer<UInt64>, nDimensions: Int) async throws -> OmReadPlan {
+        var decoder = try initDecoder(offset: offset, count: count, intoCubeOffset: nil, intoCubeDimension: nil, nDimensions: nDimensions)
+        // TODO: Technically memory from `variable` is escaping through decoder. Consider copy all dimension information into decoder
+        let range = (0..<nDimensions).map({ offset[$0]..<offset[$0] + count[$0] })
+        return try await fn.decodePlan(decoder: &decoder, range: range)
+    }
+
+    /// File range of the LUT. A planner can fetch it once and attach it with `withPinnedLut` to create read plans without IO.
+    public func lutRange() throws -> OmFileRead {
+        let dimensions = getDimensions()
+        let offset = [UInt64](repeating: 0, count: dimensions.count)
+        var decoder = try initDecoder(offset: offset, count: dimensions, intoCubeOffset: nil, intoCubeDimension: nil, nDimensions: dimensions.count)
+        var lutOffset: UInt64 = 0
+        var lutCount: UInt64 = 0
+        om_decoder_lut_range(&decoder, &lutOffset, &lutCount)
+        return OmFileRead(offset: Int(lutOffset), count: Int(lutCount))
+    }
+
+    /// Use LUT data that has been fetched elsewhere, e.g. from an edge cache. `data` must contain the bytes of `lutRange()`. See `pinLut`.
+    /// The data is copied.
+    public func withPinnedLut<Bytes: ContiguousBytes>(_ data: Bytes) -> Self {
+        var copy = self
+        copy.lutPinned = OmPinnedLut(data)
+        return copy
+    }
+
+    /// Decode the range of `plan` from data that has been fetched according to the plan, e.g. on another host. `data[i]` must contain the bytes of `plan.dataReads[i]`.
+    /// No index or data reads are performed. The plan must have been created for this array.
+    public func read<Bytes: ContiguousBytes>(plan: OmReadPlan, data: [Bytes]) throws -> [OmType] {
+        let n = plan.range.reduce(1, { $0 * $1.count })
+        var out = [OmType].init(unsafeUninitializedCapacity: n) {
+            $1 += n
+        }
+        guard n > 0 else {
+            return out
+        }
+        try out.withUnsafeMutableBufferPointer {
+            try read(into: $0.baseAddress!, plan: plan, data: data)
+        }
+        return out
+    }
+
+    /// Decode the range of `plan` into a dense array from data that has been fetched according to the plan
+    public func read<Bytes: ContiguousBytes>(into: UnsafeMutablePointer<OmType>, plan: OmReadPlan, data: [Bytes]) throws {
+        guard data.count == plan.dataReads.count, plan.dataChunks.count == plan.dataReads.count else {
+            throw OmFileFormatSwiftError.requireDimensionsToMatch(required: plan.dataReads.count, actual: data.count)
+        }
+        let offset = plan.range.map({ $0.lowerBound })
+        let count = plan.range.map({ UInt64($0.count) })
+        let intoCubeOffset = [UInt64](repeating: 0, count: count.count)
+        try offset.withUnsafeBufferPointer { offset in
+            try count.withUnsafeBufferPointer { count in
+                try intoCubeOffset.withUnsafeBufferPointer { intoCubeOffset in
+                    var decoder = try initDecoder(offset: offset.baseAddress!, count: count.baseAddress!, intoCubeOffset: intoCubeOffset.baseAddress!, intoCubeDimension: count.baseAddress!, nDimensions: count.count)
+                    let bufferSize = om_decoder_read_buffer_size(&decoder)
+                    try OmBufferPool.shared.withBuffer(byteCount: Int(bufferSize)) { buffer in
+                        for (i, chunks) in plan.dataChunks.enumerated() {
+                            try data[i].withUnsafeBytes { data in
+                                guard data.count == plan.dataReads[i].count else {
+                                    throw OmFileFormatSwiftError.omDecoder(error: "Data does not match the read plan")
+                                }
+                                var error: OmError_t = ERROR_OK
+                                guard om_decoder_decode_chunks(&decoder, OmRange_t(lowerBound: chunks.lowerBound, upperBound: chunks.upperBound), data.baseAddress, UInt64(data.count), into, buffer, &error) else {
+                                    throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        }
+    }
+
     /// Read variable as float array
     public func readConcurrent(offset: [UInt64], count: [UInt64]) async throws -> [OmType] {
         let n = count.reduce(1, *)
@@ -217,33 +451,77 @@ public struct OmFileReaderArray<Backend: OmFileReaderBackend, OmType: OmFileArra
     public func readConcurrent(into: UnsafeMutablePointer<OmType>, offset: UnsafePointer<UInt64>, count: UnsafePointer<UInt64>, intoCubeOffset: UnsafePointer<UInt64>, intoCubeDimension: UnsafePointer<UInt64>, nDimensions: Int) async throws {
 
         // TODO allow null pointer for intoCubeOffset and intoCubeDimension
-        var decoder = try variable.withUnsafeBytes({
-            let variable = om_variable_init($0.baseAddress)
-            var decoder = OmDecoder_t()
-            let error = om_decoder_init(
-                &decoder,
-                variable,
-                UInt64(nDimensions),
-                offset,
-                count,
-                intoCubeOffset,
-                intoCubeDimension,
-                io_size_merge,
-                io_size_max
-            )
-            guard error == ERROR_OK else {
-                throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
+        var decoder = try initDecoder(offset: offset, count: count, intoCubeOffset: intoCubeOffset, intoCubeDimension: intoCubeDimension, nDimensions: nDimensions)
+        // TODO: Technically memory from `variable` is escaping through decoder. Consider copy all dimension information into decoder
+        try await fn.decodeConcurrent(decoder: &decoder, into: into, lookahead: lookahead, scheduler: scheduler)
+    }
+
+    /// Read data by offset and count into a target with a byte stride for each dimension. See `read(into:range:byteStrides:)`.
+    public func readConcurrent(into: UnsafeMutablePointer<OmType>, offset: UnsafePointer<UInt64>, count: UnsafePointer<UInt64>, byteStrides: UnsafePointer<Int64>, nDimensions: Int) async throws {
+        var decoder = try initDecoder(offset: offset, count: count, intoCubeOffset: nil, intoCubeDimension: nil, nDimensions: nDimensions)
+        om_decoder_set_cube_strides(&decoder, byteStrides)
+        try await fn.decodeConcurrent(decoder: &decoder, into: into, lookahead: lookahead, scheduler: scheduler)
+    }
+
+    /// Read multiple hyperslabs in a single pass. Chunks that are required by multiple reads are only read and decompressed once.
+    /// Useful to read many points or small boxes from the same array.
+    public func readBatch(ranges: [[Range<UInt64>]]) async throws -> [[OmType]] {
+        guard let nDimensions = ranges.first?.count else {
+            return []
+        }
+        for range in ranges {
+            guard range.count == nDimensions else {
+                throw OmFileFormatSwiftError.requireDimensionsToMatch(required: nDimensions, actual: range.count)
             }
-            return decoder
-        })
+        }
+        let offset = ranges.flatMap({ $0.map({ $0.lowerBound }) })
+        let count = ranges.flatMap({ $0.map({ UInt64($0.count) }) })
+        let elementCount = ranges.map({ range in range.reduce(1, { $0 * $1.count }) })
+        let n = elementCount.reduce(0, +)
+        var out = [OmType].init(unsafeUninitializedCapacity: n) {
+            $1 += n
+        }
+        try await readBatch(into: &out, offset: offset, count: count, nDimensions: nDimensions, nReads: ranges.count)
+        var result = [[OmType]]()
+        result.reserveCapacity(ranges.count)
+        var position = 0
+        for length in elementCount {
+            result.append(Array(out[position ..< position + length]))
+            position += length
+        }
+        return result
+    }
+
+    /// Read multiple hyperslabs in a single pass. `offset` and `count` contain `nDimensions` elements for each read.
+    /// The results of all reads are stored consecutively in `into`.
+    public func readBatch(into: UnsafeMutablePointer<OmType>, offset: UnsafePointer<UInt64>, count: UnsafePointer<UInt64>, nDimensions: Int, nReads: Int) async throws {
+        let decoders = UnsafeMutablePointer<OmDecoder_t>.allocate(capacity: nReads)
+        decoders.initialize(repeating: OmDecoder_t(), count: nReads)
+        defer { decoders.deallocate() }
+        var outputs = [UnsafeMutableRawPointer?]()
+        outputs.reserveCapacity(nReads)
+        var position = 0
+        for i in 0..<nReads {
+            decoders[i] = try initDecoder(offset: offset.advanced(by: i * nDimensions), count: count.advanced(by: i * nDimensions), intoCubeOffset: nil, intoCubeDimension: nil, nDimensions: nDimensions)
+            outputs.append(UnsafeMutableRawPointer(into.advanced(by: position)))
+            position += (0..<nDimensions).reduce(1, { $0 * Int(count[i * nDimensions + $1]) })
+        }
+        let chunksCount = om_decoder_batch_chunks_count(decoders, UInt64(nReads))
+        let chunks = UnsafeMutablePointer<UInt64>.allocate(capacity: Int(chunksCount))
+        defer { chunks.deallocate() }
+        var batch = OmDecoderBatch_t()
+        let error = om_decoder_batch_init(&batch, decoders, UInt64(nReads), chunks, chunksCount)
+        guard error == ERROR_OK else {
+            throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
+        }
         // TODO: Technically memory from `variable` is escaping through decoder. Consider copy all dimension information into decoder
-        try await fn.decodeConcurrent(decoder: &decoder, into: into)
+        try await fn.decodeBatch(batch: &batch, into: outputs)
     }
 }
 
 extension OmFileReaderBackend {
-    /// Read and decode
-    func decode(decoder: UnsafePointer<OmDecoder_t>, into: UnsafeMutableRawPointer) async throws {
+    /// Read and decode. With `lookahead`, bytes before each index block are read in the same request and data reads inside are not read again.
+    func decode(decoder: UnsafePointer<OmDecoder_t>, into: UnsafeMutableRawPointer, lookahead: Int = 0) async throws {
         var indexRead = OmDecoder_indexRead_t()
         om_decoder_init_index_read(decoder, &indexRead)
 
@@ -254,79 +532,135 @@ extension OmFileReaderBackend {
         while om_decoder_next_index_read(decoder, &indexRead) {
             var indexRead = indexRead
             //print("Read index \(indexRead)")
-            let indexData = try await self.getDataChecked(offset: Int(indexRead.offset), count: Int(indexRead.count))
-            //try await self.withDataChecked(offset: Int(indexRead.offset), count: Int(indexRead.count)) { indexData in
-            var dataRead = OmDecoder_dataRead_t()
-            om_decoder_init_data_read(&dataRead, &indexRead)
-            var error: OmError_t = ERROR_OK
-            /// Loop over data blocks and read compressed data chunks
-            while indexData.withUnsafeBytes({ om_decoder_next_data_read(decoder, &dataRead, $0.baseAddress, UInt64(indexRead.count), &error) }) {
-                //print("Read data \(dataRead) for chunk index \(dataRead.chunkIndex)")
-                let chunkIndex = dataRead.chunkIndex
-                let dataReadCount = dataRead.count
-                try await self.withDataChecked(offset: Int(dataRead.offset), count: Int(dataReadCount)) { dataDataBuffer in
-                    try withUnsafeTemporaryAllocation(byteCount: Int(bufferSize), alignment: 1) { buffer in
-                        var error: OmError_t = ERROR_OK
-                        guard om_decoder_decode_chunks(decoder, chunkIndex, dataDataBuffer.baseAddress, dataReadCount, into, buffer.baseAddress, &error) else {
-                            throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
-                        }
+            let (data, indexDataOffset) = try await getIndexData(decoder: decoder, indexRead: indexRead, lookahead: lookahead)
+            var indexData = data
+            let (reads, chunkIndices) = try await collectDataReads(decoder: decoder, indexRead: &indexRead, indexData: &indexData, indexDataOffset: indexDataOffset, into: into, bufferSize: bufferSize)
+            /// All data reads of one index block are submitted together
+            try await self.withDataBatchChecked(reads: reads, window: indexData, windowStart: Int(indexRead.offset) - indexDataOffset, concurrent: false) { i, dataDataBuffer in
+                try OmBufferPool.shared.withBuffer(byteCount: Int(bufferSize)) { buffer in
+                    var error: OmError_t = ERROR_OK
+                    guard om_decoder_decode_chunks(decoder, chunkIndices[i], dataDataBuffer.baseAddress, UInt64(dataDataBuffer.count), into, buffer, &error) else {
+                        throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
                     }
                 }
             }
-            guard error == ERROR_OK else {
-                throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
-            }
-            
         }
     }
 
     /// Read and decode using multiple threads
     /// Note: This function uses more memory
     /// Decodes chunks concurrently (limited by io sizes). Only `om_decoder_decode_chunks` is called concurrently
-    func decodeConcurrent(decoder: UnsafePointer<OmDecoder_t>, into: UnsafeMutableRawPointer) async throws {
+    /// Without a `scheduler`, all data reads of an index block are submitted at once
+    /// The next index block is read while data of the previous block is still read and decoded. At most one block of data reads is in flight.
+    func decodeConcurrent(decoder: UnsafePointer<OmDecoder_t>, into: UnsafeMutableRawPointer, lookahead: Int = 0, scheduler: OmDecodeScheduler? = nil) async throws {
         var indexRead = OmDecoder_indexRead_t()
         om_decoder_init_index_read(decoder, &indexRead)
 
+        /// The size to decode a single chunk
+        let bufferSize = om_decoder_read_buffer_size(decoder)
+
         try await withThrowingTaskGroup(of: Void.self) { group in
-            /// The size to decode a single chunk
-            let bufferSize = om_decoder_read_buffer_size(decoder)
+            /// True while data reads of the previous index block are running
+            var pending = false
 
             /// Loop over index blocks and read index data
             while om_decoder_next_index_read(decoder, &indexRead) {
                 //print("Read index \(indexRead)")
-                let indexData = try await self.getDataChecked(offset: Int(indexRead.offset), count: Int(indexRead.count))
-                //try await self.withDataChecked(offset: Int(indexRead.offset), count: Int(indexRead.count)) { indexData in
-                var dataRead = OmDecoder_dataRead_t()
-                om_decoder_init_data_read(&dataRead, &indexRead)
-                
-                var error: OmError_t = ERROR_OK
-                /// Loop over data blocks and read compressed data chunks
-                while indexData.withUnsafeBytes({ om_decoder_next_data_read(decoder, &dataRead, $0.baseAddress, UInt64(indexRead.count), &error) }) {
-                    //print("ENQUEUE chunk index \(dataRead.chunkIndex)")
-                    let dataReadOffset = dataRead.offset
-                    let dataReadCount = dataRead.count
-                    let chunkIndex = dataRead.chunkIndex
-                    group.addTask {
-                        //print("Read data chunk index \(chunkIndex), count=\(dataReadCount)")
-                        // print(dataReadOffset, dataReadCount)
-                        try await self.withDataChecked(offset: Int(dataReadOffset), count: Int(dataReadCount)) { dataData in
-                            try withUnsafeTemporaryAllocation(byteCount: Int(bufferSize), alignment: 8) { buffer in
-                                var error: OmError_t = ERROR_OK
-                                guard om_decoder_decode_chunks(decoder, chunkIndex, dataData.baseAddress, dataReadCount, into, buffer.baseAddress, &error) else {
-                                    throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
-                                }
+                let (data, indexDataOffset) = try await getIndexData(decoder: decoder, indexRead: indexRead, lookahead: lookahead)
+                var indexData = data
+                let (reads, chunkIndices) = try await collectDataReads(decoder: decoder, indexRead: &indexRead, indexData: &indexData, indexDataOffset: indexDataOffset, into: into, bufferSize: bufferSize)
+                if pending {
+                    _ = try await group.next()
+                }
+                let window = indexData
+                let windowStart = Int(indexRead.offset) - indexDataOffset
+                group.addTask {
+                    try await self.withDataBatchChecked(reads: reads, window: window, windowStart: windowStart, concurrent: true, scheduler: scheduler) { i, dataData in
+                        try OmBufferPool.shared.withBuffer(byteCount: Int(bufferSize)) { buffer in
+                            var error: OmError_t = ERROR_OK
+                            guard om_decoder_decode_chunks(decoder, chunkIndices[i], dataData.baseAddress, UInt64(dataData.count), into, buffer, &error) else {
+                                throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
                             }
                         }
                     }
                 }
-                guard error == ERROR_OK else {
-                    throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
-                }
+                pending = true
             }
             try await group.waitForAll()
         }
     }
 
+    /// Collect all data reads of one index block. Chunks available in the chunk cache are decoded immediately and not read.
+    func collectDataReads(decoder: UnsafePointer<OmDecoder_t>, indexRead: inout OmDecoder_indexRead_t, indexData: inout DataType?, indexDataOffset: Int = 0, into: UnsafeMutableRawPointer, bufferSize: UInt64) async throws -> (reads: [OmFileRead], chunkIndices: [OmRange_t]) {
+        var reads = [OmFileRead]()
+        var chunkIndices = [OmRange_t]()
+        var dataRead = OmDecoder_dataRead_t()
+        om_decoder_init_data_read(&dataRead, &indexRead)
+        /// Loop over data blocks and collect compressed data chunks
+        while try await nextDataRead(decoder: decoder, indexRead: indexRead, dataRead: &dataRead, indexData: &indexData, indexDataOffset: indexDataOffset) {
+            //print("Read data \(dataRead) for chunk index \(dataRead.chunkIndex)")
+            if decodeCached(decoder: decoder, chunkIndex: dataRead.chunkIndex, into: into, bufferSize: bufferSize) {
+                continue
+            }
+            reads.append(OmFileRead(offset: Int(dataRead.offset), count: Int(dataRead.count)))
+            chunkIndices.append(dataRead.chunkIndex)
+        }
+        return (reads, chunkIndices)
+    }
+
+    /// Read and decode a batch of reads. Each chunk is only read and decompressed once.
+    func decodeBatch(batch: UnsafePointer<OmDecoderBatch_t>, into: [UnsafeMutableRawPointer?]) async throws {
+        var indexRead = OmDecoderBatch_indexRead_t()
+        om_decoder_batch_init_index_read(&indexRead)
+
+        /// The size to decode a single chunk
+        let bufferSize = om_decoder_read_buffer_size(batch.pointee.decoders)
+
+        /// Loop over index blocks and read index data
+        while om_decoder_batch_next_index_read(batch, &indexRead) {
+            var indexData = try await getIndexData(decoder: batch.pointee.decoders, indexRead: indexRead)
+            var dataRead = OmDecoderBatch_dataRead_t()
+            om_decoder_batch_init_data_read(&dataRead, &indexRead)
+            var reads = [OmFileRead]()
+            var chunkIndices = [OmRange_t]()
+            /// Loop over data blocks and collect compressed data chunks
+            while try await nextDataRead(batch: batch, indexRead: indexRead, dataRead: &dataRead, indexData: &indexData) {
+                reads.append(OmFileRead(offset: Int(dataRead.offset), count: Int(dataRead.count)))
+                chunkIndices.append(dataRead.chunkIndex)
+            }
+            /// All data reads of one index block are submitted together
+            try await self.withDataBatchChecked(reads: reads, concurrent: false) { [chunkIndices] i, dataDataBuffer in
+                try OmBufferPool.shared.withBuffer(byteCount: Int(bufferSize)) { buffer in
+                    var error: OmError_t = ERROR_OK
+                    guard om_decoder_batch_decode_chunks(batch, chunkIndices[i], dataDataBuffer.baseAddress, UInt64(dataDataBuffer.count), into, buffer, &error) else {
+                        throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
+                    }
+                }
+            }
+        }
+    }
+
+    /// Get the next data read of a batch. If LUT chunks are not cached, index data is read and the data read is repeated.
+    func nextDataRead(batch: UnsafePointer<OmDecoderBatch_t>, indexRead: OmDecoderBatch_indexRead_t, dataRead: inout OmDecoderBatch_dataRead_t, indexData: inout DataType?) async throws -> Bool {
+        while true {
+            var error: OmError_t = ERROR_OK
+            let next: Bool
+            if let indexData {
+                next = indexData.withUnsafeBytes({ om_decoder_batch_next_data_read(batch, &dataRead, $0.baseAddress, UInt64(indexRead.count), &error) })
+            } else {
+                next = om_decoder_batch_next_data_read(batch, &dataRead, nil, 0, &error)
+            }
+            if error == ERROR_LUT_CACHE_MISS && indexData == nil {
+                indexData = try await self.getDataChecked(offset: Int(indexRead.offset), count: Int(indexRead.count))
+                continue
+            }
+            guard error == ERROR_OK else {
+                throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
+            }
+            return next
+        }
+    }
+
     /// Do an madvice to load data chunks from disk into page cache in the background
     func decodePrefetch(decoder: UnsafePointer<OmDecoder_t>) async throws {
         var indexRead = OmDecoder_indexRead_t()
@@ -336,19 +670,134 @@ extension OmFileReaderBackend {
         while om_decoder_next_index_read(decoder, &indexRead) {
             var indexRead = indexRead
             //print("Read index \(indexRead)")
-            let indexData = try await self.getDataChecked(offset: Int(indexRead.offset), count: Int(indexRead.count))
-            //try await self.withDataChecked(offset: Int(indexRead.offset), count: Int(indexRead.count)) { indexData in
+            var indexData = try await getIndexData(decoder: decoder, indexRead: indexRead)
             var dataRead = OmDecoder_dataRead_t()
             om_decoder_init_data_read(&dataRead, &indexRead)
-            var error: OmError_t = ERROR_OK
             /// Loop over data blocks and read compressed data chunks
-            while indexData.withUnsafeBytes({ om_decoder_next_data_read(decoder, &dataRead, $0.baseAddress, UInt64(indexRead.count), &error) }) {
+            while try await nextDataRead(decoder: decoder, indexRead: indexRead, dataRead: &dataRead, indexData: &indexData) {
                 try await self.prefetchData(offset: Int(dataRead.offset), count: Int(dataRead.count))
             }
+        }
+    }
+
+    /// Collect index and data reads without reading data
+    func decodePlan(decoder: UnsafePointer<OmDecoder_t>, range: [Range<UInt64>]) async throws -> OmReadPlan {
+        var indexReads = [OmFileRead]()
+        var dataReads = [OmFileRead]()
+        var dataChunks = [Range<UInt64>]()
+        var indexRead = OmDecoder_indexRead_t()
+        om_decoder_init_index_read(decoder, &indexRead)
+
+        /// Loop over index blocks and read index data
+        while om_decoder_next_index_read(decoder, &indexRead) {
+            var indexRead = indexRead
+            var indexData = try await getIndexData(decoder: decoder, indexRead: indexRead)
+            var dataRead = OmDecoder_dataRead_t()
+            om_decoder_init_data_read(&dataRead, &indexRead)
+            /// Loop over data blocks
+            while try await nextDataRead(decoder: decoder, indexRead: indexRead, dataRead: &dataRead, indexData: &indexData) {
+                dataReads.append(OmFileRead(offset: Int(dataRead.offset), count: Int(dataRead.count)))
+                dataChunks.append(dataRead.chunkIndex.lowerBound..<dataRead.chunkIndex.upperBound)
+            }
+            /// Index data is not read with a pinned LUT or if all LUT chunks are cached
+            if indexData != nil {
+                indexReads.append(OmFileRead(offset: Int(indexRead.offset), count: Int(indexRead.count)))
+            }
+        }
+        return OmReadPlan(range: range, indexReads: indexReads, dataReads: dataReads, dataChunks: dataChunks)
+    }
+
+    /// Copy chunks from the chunk cache. Returns false if the decoder has no chunk cache or not all chunks are cached.
+    func decodeCached(decoder: UnsafePointer<OmDecoder_t>, chunkIndex: OmRange_t, into: UnsafeMutableRawPointer, bufferSize: UInt64) -> Bool {
+        guard decoder.pointee.chunk_cache != nil else {
+            return false
+        }
+        return OmBufferPool.shared.withBuffer(byteCount: Int(bufferSize)) { buffer in
+            om_decoder_decode_cached_chunks(decoder, chunkIndex, into, buffer)
+        }
+    }
+
+    /// Read index data for an index read. If the decoder uses a LUT cache, index data is only read later on a cache miss. With a pinned LUT, index data is not read at all.
+    func getIndexData(decoder: UnsafePointer<OmDecoder_t>, indexRead: OmDecoder_indexRead_t) async throws -> DataType? {
+        if decoder.pointee.lut_cache != nil || decoder.pointee.lut_pinned != nil {
+            return nil
+        }
+        return try await self.getDataChecked(offset: Int(indexRead.offset), count: Int(indexRead.count))
+    }
+
+    /// Read index data together with up to `lookahead` bytes before it. Returns the data and the number of bytes before index data.
+    func getIndexData(decoder: UnsafePointer<OmDecoder_t>, indexRead: OmDecoder_indexRead_t, lookahead: Int) async throws -> (data: DataType?, offset: Int) {
+        guard lookahead > 0, decoder.pointee.lut_cache == nil, decoder.pointee.lut_pinned == nil else {
+            return (try await getIndexData(decoder: decoder, indexRead: indexRead), 0)
+        }
+        let start = max(0, Int(indexRead.offset) - lookahead)
+        let data = try await self.getDataChecked(offset: start, count: Int(indexRead.offset) + Int(indexRead.count) - start)
+        return (data, Int(indexRead.offset) - start)
+    }
+
+    /// Call `fn` directly for all reads inside `window` which starts at file offset `windowStart`. All other reads are submitted as a batch.
+    func withDataBatchChecked(reads: [OmFileRead], window: DataType?, windowStart: Int, concurrent: Bool, scheduler: OmDecodeScheduler? = nil, fn: @escaping @Sendable (Int, UnsafeRawBufferPointer) throws -> Void) async throws {
+        guard let window else {
+            return try await withDataBatchChecked(reads: reads, concurrent: concurrent, scheduler: scheduler, fn: fn)
+        }
+        var remaining = [OmFileRead]()
+        var remainingIndices = [Int]()
+        try window.withUnsafeBytes { window in
+            for (i, read) in reads.enumerated() {
+                let start = read.offset - windowStart
+                guard start >= 0 && start + read.count <= window.count else {
+                    remaining.append(read)
+                    remainingIndices.append(i)
+                    continue
+                }
+                try fn(i, UnsafeRawBufferPointer(rebasing: window[start ..< start + read.count]))
+            }
+        }
+        guard !remaining.isEmpty else {
+            return
+        }
+        let indices = remainingIndices
+        try await withDataBatchChecked(reads: remaining, concurrent: concurrent, scheduler: scheduler) { i, data in
+            try fn(indices[i], data)
+        }
+    }
+
+    /// Get the next data read. If LUT chunks are not cached, index data is read and the data read is repeated.
+    /// `indexDataOffset` is the number of bytes before index data in `indexData`.
+    func nextDataRead(decoder: UnsafePointer<OmDecoder_t>, indexRead: OmDecoder_indexRead_t, dataRead: inout OmDecoder_dataRead_t, indexData: inout DataType?, indexDataOffset: Int = 0) async throws -> Bool {
+        while true {
+            var error: OmError_t = ERROR_OK
+            let next: Bool
+            if let indexData {
+                next = indexData.withUnsafeBytes({ om_decoder_next_data_read(decoder, &dataRead, $0.baseAddress?.advanced(by: indexDataOffset), UInt64(indexRead.count), &error) })
+            } else {
+                next = om_decoder_next_data_read(decoder, &dataRead, nil, 0, &error)
+            }
+            if error == ERROR_LUT_CACHE_MISS && indexData == nil {
+                indexData = try await self.getDataChecked(offset: Int(indexRead.offset), count: Int(indexRead.count))
+                continue
+            }
             guard error == ERROR_OK else {
                 throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
             }
+            return next
         }
     }
 }
 
+/// Copy of a pinned LUT. The decoder keeps a pointer to the LUT, so it is stored in memory that does not move while any copy of the reader exists.
+final class OmPinnedLut: @unchecked Sendable {
+    let buffer: UnsafeMutableRawBufferPointer
+
+    init<Bytes: ContiguousBytes>(_ data: Bytes) {
+        buffer = data.withUnsafeBytes {
+            let buffer = UnsafeMutableRawBufferPointer.allocate(byteCount: $0.count, alignment: 8)
+            buffer.copyMemory(from: $0)
+            return buffer
+        }
+    }
+
+    deinit {
+        buffer.deallocate()
+    }
+}
@@ -1,4 +1,5 @@
 import Foundation
+import OmFileFormatC
 
 
 /// OmFileReader can read data from this backend
@@ -11,12 +12,96 @@ public protocol OmFileReaderBackend: Sendable {
 
     /// Prefect data for future access. E.g. madvice on memory mapped files
     func prefetchData(offset: Int, count: Int) async throws
+
+    /// Prefetch data with a hint how it will be accessed. Backends without support for a hint fall back to `prefetchData(offset:count:)`.
+    func prefetchData(offset: Int, count: Int, hint: OmPrefetchHint) async throws
     
     /// Read data. Data will be retained of type `DataType`. Reads must be thread safe.
     func getData(offset: Int, count: Int) async throws -> DataType
     
     /// Read data. Data is only temporarily read inside the callback without async
     func withData<T>(offset: Int, count: Int, fn: @Sendable (UnsafeRawBufferPointer) throws -> T) async throws -> T
+
+    /// Read multiple ranges and call `fn` with the index and data of each read. Backends with asynchronous IO submit all reads at once.
+    /// If `concurrent` is set, `fn` may be called from multiple threads at the same time.
+    func withDataBatch(reads: [OmFileRead], concurrent: Bool, fn: @escaping @Sendable (Int, UnsafeRawBufferPointer) throws -> Void) async throws
+
+    /// Cost model to derive IO merge and split sizes. If nil, fixed defaults are used.
+    var ioCostModel: OmIoCostModel? { get }
+}
+
+/// IO operations of a read without reading data. See `readPlan(range:)`.
+/// A plan can be serialised, e.g. to fetch data reads on other hosts. `read(plan:data:)` decodes the fetched data without further IO.
+public struct OmReadPlan: Sendable, Codable {
+    /// The range of the array that is read
+    public let range: [Range<UInt64>]
+    /// Reads of index data. Empty with a pinned LUT and skipped for LUT chunks that are in a LUT cache.
+    public let indexReads: [OmFileRead]
+    /// Reads of compressed data
+    public let dataReads: [OmFileRead]
+    /// Chunks that are contained in each data read
+    public let dataChunks: [Range<UInt64>]
+
+    /// Estimated wall time in seconds. Data reads can only start after index data has been read.
+    public func estimate(model: OmIoCostModel) -> Double {
+        return model.estimate(reads: indexReads) + model.estimate(reads: dataReads)
+    }
+}
+
+/// Simple IO cost model of a backend. See `om_io_cost_model_thresholds`.
+public struct OmIoCostModel: Sendable {
+    /// Time to first byte of a single request in seconds
+    public let latency: Double
+    /// Throughput of a single request in bytes per second
+    public let bandwidth: Double
+    /// Number of requests that can run concurrently
+    public let parallelism: Int
+
+    public init(latency: Double, bandwidth: Double, parallelism: Int = 1) {
+        self.latency = latency
+        self.bandwidth = bandwidth
+        self.parallelism = parallelism
+    }
+
+    var model: OmIoCostModel_t {
+        return OmIoCostModel_t(latency: latency, bandwidth: bandwidth, parallelism: UInt64(max(parallelism, 1)))
+    }
+
+    /// Merge and split thresholds that minimise the estimated wall time
+    public var thresholds: (io_size_merge: UInt64, io_size_max: UInt64) {
+        var model = self.model
+        var io_size_merge: UInt64 = 0
+        var io_size_max: UInt64 = 0
+        om_io_cost_model_thresholds(&model, &io_size_merge, &io_size_max)
+        return (io_size_merge, io_size_max)
+    }
+
+    /// Estimated wall time in seconds to perform all reads
+    public func estimate(reads: [OmFileRead]) -> Double {
+        var model = self.model
+        return om_io_cost_model_estimate(&model, UInt64(reads.count), UInt64(reads.reduce(0, { $0 + $1.count })))
+    }
+}
+
+/// How prefetched data will be accessed
+public enum OmPrefetchHint: Sendable {
+    /// Data will be needed soon
+    case willNeed
+    /// Data is read often and must stay in memory, e.g. LUTs and meta data. Memory mapped files lock the pages with `mlock`.
+    case pin
+    /// Release pinned data
+    case unpin
+}
+
+/// A single read of `count` bytes at `offset`
+public struct OmFileRead: Sendable, Codable {
+    public let offset: Int
+    public let count: Int
+
+    public init(offset: Int, count: Int) {
+        self.offset = offset
+        self.count = count
+    }
 }
 
 extension OmFileReaderBackend {
@@ -33,6 +118,51 @@ extension OmFileReaderBackend {
         }
         return try await self.withData(offset: offset, count: count, fn: fn)
     }
+
+    public var ioCostModel: OmIoCostModel? {
+        return nil
+    }
+
+    /// Default implementation ignores the hint. Pinning and unpinning do nothing.
+    public func prefetchData(offset: Int, count: Int, hint: OmPrefetchHint) async throws {
+        if hint == .willNeed {
+            try await prefetchData(offset: offset, count: count)
+        }
+    }
+
+    /// Default implementation reads one range after the other or uses one task per read if `concurrent` is set
+    public func withDataBatch(reads: [OmFileRead], concurrent: Bool, fn: @escaping @Sendable (Int, UnsafeRawBufferPointer) throws -> Void) async throws {
+        guard concurrent else {
+            for (i, read) in reads.enumerated() {
+                try await self.withData(offset: read.offset, count: read.count) { try fn(i, $0) }
+            }
+            return
+        }
+        try await withThrowingTaskGroup(of: Void.self) { group in
+            for (i, read) in reads.enumerated() {
+                group.addTask {
+                    try await self.withData(offset: read.offset, count: read.count) { try fn(i, $0) }
+                }
+            }
+            try await group.waitForAll()
+        }
+    }
+
+    /// With a `scheduler`, concurrent reads are passed to `withDataBatch` in bounded windows and decoded by at most `maxConcurrentDecodes` threads
+    func withDataBatchChecked(reads: [OmFileRead], concurrent: Bool, scheduler: OmDecodeScheduler? = nil, fn: @escaping @Sendable (Int, UnsafeRawBufferPointer) throws -> Void) async throws {
+        for read in reads {
+            guard read.offset + read.count <= self.count else {
+                throw OmFileFormatSwiftError.omDecoder(error: "Read out of bounds")
+            }
+        }
+        if reads.isEmpty {
+            return
+        }
+        if concurrent, let scheduler {
+            return try await self.withDataScheduled(reads: reads, scheduler: scheduler, fn: fn)
+        }
+        try await self.withDataBatch(reads: reads, concurrent: concurrent, fn: fn)
+    }
 }
 
 /// Protocol for `OmFileReaderArray` to type erase the underlaying backend implementation
@@ -60,4 +190,10 @@ public protocol OmFileReaderArrayProtocol<OmType>: Sendable {
     func readConcurrent(range: [Range<UInt64>]?) async throws -> [OmType]
     func readConcurrent(into: UnsafeMutablePointer<OmType>, range: [Range<UInt64>], intoCubeOffset: [UInt64]?, intoCubeDimension: [UInt64]?) async throws
     func readConcurrent(into: UnsafeMutablePointer<OmType>, offset: UnsafePointer<UInt64>, count: UnsafePointer<UInt64>, intoCubeOffset: UnsafePointer<UInt64>, intoCubeDimension: UnsafePointer<UInt64>, nDimensions: Int) async throws
+
+    func readBatch(ranges: [[Range<UInt64>]]) async throws -> [[OmType]]
+    func readBatch(into: UnsafeMutablePointer<OmType>, offset: UnsafePointer<UInt64>, count: UnsafePointer<UInt64>, nDimensions: Int, nReads: Int) async throws
+
+    func readPlan(range: [Range<UInt64>]?) async throws -> OmReadPlan
+    func read<Bytes: ContiguousBytes>(plan: OmReadPlan, data: [Bytes]) throws -> [OmType]
 }
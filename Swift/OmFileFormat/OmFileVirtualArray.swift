@@ -0,0 +1,106 @@
+import Foundation
+
+/// Multiple arrays concatenated along one dimension and read as a single logical array. E.g. one file per month along the time dimension.
+/// Reads are split into hyperslabs of each array and written directly into the output cube. All arrays are decoded concurrently.
+public struct OmFileVirtualArray<Backend: OmFileReaderBackend, OmType: OmFileArrayDataTypeProtocol>: Sendable {
+    /// Arrays in the order of `dimension`
+    public let arrays: [OmFileReaderArray<Backend, OmType>]
+
+    /// Dimension along which arrays are concatenated
+    public let dimension: Int
+
+    /// Position of each array along `dimension` in the virtual array. The last element is the total length.
+    let starts: [UInt64]
+
+    /// All other dimensions must be identical for all arrays
+    public init(arrays: [OmFileReaderArray<Backend, OmType>], dimension: Int) throws {
+        guard let first = arrays.first?.getDimensions() else {
+            throw OmFileFormatSwiftError.dimensionMustBeLargerThan0
+        }
+        guard dimension >= 0, dimension < first.count else {
+            throw OmFileFormatSwiftError.requireDimensionsToMatch(required: first.count, actual: dimension)
+        }
+        var starts = [UInt64(0)]
+        starts.reserveCapacity(arrays.count + 1)
+        for array in arrays {
+            let dimensions = array.getDimensions()
+            guard dimensions.count == first.count, zip(dimensions, first).enumerated().allSatisfy({ $0.offset == dimension || $0.element.0 == $0.element.1 }) else {
+                throw OmFileFormatSwiftError.requireDimensionsToMatch(required: first.count, actual: dimensions.count)
+            }
+            starts.append(starts.last! + dimensions[dimension])
+        }
+        self.arrays = arrays
+        self.dimension = dimension
+        self.starts = starts
+    }
+
+    /// Open the root array of each file concurrently
+    public static func open(_ backends: [Backend], dimension: Int) async throws -> Self {
+        let arrays = try await withThrowingTaskGroup(of: (Int, OmFileReaderArray<Backend, OmType>).self) { group in
+            for (i, fn) in backends.enumerated() {
+                group.addTask {
+                    return (i, try await OmFileReader(fn: fn).expectArray(of: OmType.self))
+                }
+            }
+            var arrays = [OmFileReaderArray<Backend, OmType>?](repeating: nil, count: backends.count)
+            for try await (i, array) in group {
+                arrays[i] = array
+            }
+            return arrays.compactMap({ $0 })
+        }
+        return try Self(arrays: arrays, dimension: dimension)
+    }
+
+    public func getDimensions() -> [UInt64] {
+        var dimensions = arrays[0].getDimensions()
+        dimensions[dimension] = starts.last!
+        return dimensions
+    }
+
+    /// Read `range` of the virtual array
+    public func read(range: [Range<UInt64>]? = nil) async throws -> [OmType] {
+        let range = range ?? self.getDimensions().map({ 0..<$0 })
+        let n = range.reduce(1, { $0 * $1.count })
+        var out = [OmType].init(unsafeUninitializedCapacity: n) {
+            $1 += n
+        }
+        try await read(into: &out, range: range)
+        return out
+    }
+
+    /// Read `range` of the virtual array into a larger cube. Only arrays that overlap `range` are read.
+    public func read(into: UnsafeMutablePointer<OmType>, range: [Range<UInt64>], intoCubeOffset: [UInt64]? = nil, intoCubeDimension: [UInt64]? = nil) async throws {
+        let dimensions = getDimensions()
+        guard range.count == dimensions.count else {
+            throw OmFileFormatSwiftError.requireDimensionsToMatch(required: dimensions.count, actual: range.count)
+        }
+        for (r, dimension) in zip(range, dimensions) where r.upperBound > dimension {
+            throw OmFileFormatSwiftError.dimensionOutOfBounds(range: Int(r.lowerBound)..<Int(r.upperBound), allowed: Int(dimension))
+        }
+        if range.contains(where: { $0.isEmpty }) {
+            return
+        }
+        let intoCubeOffset = intoCubeOffset ?? .init(repeating: 0, count: range.count)
+        let intoCubeDimension = intoCubeDimension ?? range.map({ UInt64($0.count) })
+        let d = dimension
+        /// Arrays write into disjoint parts of the output
+        let into = UnsafeMutableRawPointer(into)
+        try await withThrowingTaskGroup(of: Void.self) { group in
+            for (i, array) in arrays.enumerated() {
+                let lower = max(range[d].lowerBound, starts[i])
+                let upper = min(range[d].upperBound, starts[i+1])
+                guard lower < upper else {
+                    continue
+                }
+                var local = range
+                local[d] = lower - starts[i] ..< upper - starts[i]
+                var cubeOffset = intoCubeOffset
+                cubeOffset[d] += lower - range[d].lowerBound
+                group.addTask { [local, cubeOffset] in
+                    try await array.readConcurrent(into: into.assumingMemoryBound(to: OmType.self), range: local, intoCubeOffset: cubeOffset, intoCubeDimension: intoCubeDimension)
+                }
+            }
+            try await group.waitForAll()
+        }
+    }
+}
@@ -6,8 +6,14 @@ import OmFileFormatC
 public struct OmFileWriter<FileHandle: OmFileWriterBackend> {
     let buffer: OmBufferedWriter<FileHandle>
 
-    public init(fn: FileHandle, initialCapacity: Int) {
-        self.buffer = OmBufferedWriter(backend: fn, initialCapacity: initialCapacity)
+    /// Variables with at least this many children get a name index for fast lookup with `getChild(name:)`
+    let nameIndexMinimumChildren: Int
+
+    /// `offset` is the current size of `fn` if data is appended to an existing file. The header is only written if `offset` is 0.
+    /// With `writeBehindBuffers` of 2 or more, compressed data is written to `fn` on a background thread while compression continues, see `OmBufferedWriter`. `fn` is only complete after `writeTrailer`.
+    public init(fn: FileHandle, initialCapacity: Int, nameIndexMinimumChildren: Int = 16, offset: Int = 0, writeBehindBuffers: Int = 0, alignment: Int = 1) {
+        self.buffer = OmBufferedWriter(backend: fn, initialCapacity: initialCapacity, totalBytesWritten: offset, writeBehindBuffers: writeBehindBuffers, alignment: alignment)
+        self.nameIndexMinimumChildren = nameIndexMinimumChildren
     }
 
     public func writeHeaderIfRequired() throws {
@@ -43,7 +49,8 @@ public struct OmFileWriter<FileHandle: OmFileWriterBackend> {
                 )
             })
 
-            try buffer.reallocate(minimumCapacity: Int(size))
+            let nameIndexSize = self.nameIndexSize(variableSize: size, children: children)
+            try buffer.reallocate(minimumCapacity: Int(size) + nameIndexSize)
             value.withOmBytes(body: { value in
                 om_variable_write_scalar(
                     buffer.bufferAtWritePosition,
@@ -57,8 +64,9 @@ public struct OmFileWriter<FileHandle: OmFileWriterBackend> {
                     value.count
                 )
             })
-            buffer.incrementWritePosition(by: size)
-            return OmOffsetSize(offset: offset, size: UInt64(size))
+            writeNameIndex(variableSize: size, children: children)
+            buffer.incrementWritePosition(by: size + nameIndexSize)
+            return OmOffsetSize(offset: offset, size: UInt64(size + nameIndexSize), nameHash: om_variable_name_hash(name.baseAddress, UInt16(name.count)))
         }
     }
 
@@ -66,9 +74,12 @@ public struct OmFileWriter<FileHandle: OmFileWriterBackend> {
         return try write(value: OmNone(), name: name, children: children)
     }
 
-    public func prepareArray<OmType: OmFileArrayDataTypeProtocol>(type: OmType.Type, dimensions: [UInt64], chunkDimensions: [UInt64], compression: OmCompressionType, scale_factor: Float, add_offset: Float) throws -> OmFileWriterArray<OmType, FileHandle> {
+    /// Prepare an array for writing. With `chunkStatistics`, min, max and NaN count of each chunk of a float array are stored for `readChunkStatistics` and `read(range:where:)`.
+    /// With `adaptive`, every chunk is stored with the smallest of filtered, unfiltered, uncompressed or constant encoding. Constant chunks, e.g. all zero or all NaN, then only use a few bytes. Compression is slower and older readers cannot read the array.
+    /// With `packedLut`, the LUT is stored with fixed width entries, so reads look up chunk offsets without decompressing LUT chunks. The LUT is larger and older readers cannot read the array.
+    public func prepareArray<OmType: OmFileArrayDataTypeProtocol>(type: OmType.Type, dimensions: [UInt64], chunkDimensions: [UInt64], compression: OmCompressionType, scale_factor: Float, add_offset: Float, chunkStatistics: Bool = false, adaptive: Bool = false, packedLut: Bool = false) throws -> OmFileWriterArray<OmType, FileHandle> {
         try writeHeaderIfRequired()
-        return try .init(dimensions: dimensions, chunkDimensions: chunkDimensions, compression: compression, scale_factor: scale_factor, add_offset: add_offset, buffer: buffer)
+        return try .init(dimensions: dimensions, chunkDimensions: chunkDimensions, compression: compression, scale_factor: scale_factor, add_offset: add_offset, buffer: buffer, chunkStatistics: chunkStatistics, adaptive: adaptive, packedLut: packedLut)
     }
 
     public func write(array: OmFileWriterArrayFinalised, name: String, children: [OmOffsetSize]) throws -> OmOffsetSize {
@@ -82,15 +93,54 @@ public struct OmFileWriter<FileHandle: OmFileWriterBackend> {
             try buffer.alignTo64Bytes()
             let size = om_variable_write_numeric_array_size(UInt16(name.count), UInt32(children.count), UInt64(array.dimensions.count))
             let offset = UInt64(buffer.totalBytesWritten)
-            try buffer.reallocate(minimumCapacity: Int(size))
+            let nameIndexSize = self.nameIndexSize(variableSize: size, children: children)
+            /// Chunk statistics are located after the name index or at the next 8 byte boundary
+            let chunkStatsStart = nameIndexSize > 0 ? size + nameIndexSize : (size + 7) / 8 * 8
+            let totalSize = array.chunkStats == nil ? size + nameIndexSize : chunkStatsStart + om_variable_write_chunk_stats_size()
+            try buffer.reallocate(minimumCapacity: totalSize)
             let childrenOffsets = children.map {$0.offset}
             let childrenSizes = children.map {$0.size}
-            om_variable_write_numeric_array(buffer.bufferAtWritePosition, UInt16(name.count), UInt32(children.count), childrenOffsets, childrenSizes, name.baseAddress, array.datatype.toC(), array.compression.toC(), array.scale_factor, array.add_offset, UInt64(array.dimensions.count), array.dimensions, array.chunks, UInt64(array.lutSize), UInt64(array.lutOffset))
-            buffer.incrementWritePosition(by: size)
-            return OmOffsetSize(offset: offset, size: UInt64(size))
+            om_variable_write_numeric_array(buffer.bufferAtWritePosition, UInt16(name.count), UInt32(children.count), childrenOffsets, childrenSizes, name.baseAddress, array.datatype.toC(), array.compressionC, array.scale_factor, array.add_offset, UInt64(array.dimensions.count), array.dimensions, array.chunks, UInt64(array.lutSize), UInt64(array.lutOffset))
+            writeNameIndex(variableSize: size, children: children)
+            if let chunkStats = array.chunkStats {
+                buffer.bufferAtWritePosition.advanced(by: size + nameIndexSize).initializeMemory(as: UInt8.self, repeating: 0, count: chunkStatsStart - size - nameIndexSize)
+                om_variable_write_chunk_stats(buffer.bufferAtWritePosition.advanced(by: chunkStatsStart), chunkStats.offset, chunkStats.size)
+            }
+            buffer.incrementWritePosition(by: totalSize)
+            return OmOffsetSize(offset: offset, size: UInt64(totalSize), nameHash: om_variable_name_hash(name.baseAddress, UInt16(name.count)))
+        }
+    }
+
+    /// Write the meta data of a variable that does not reference other parts of the file, e.g. a scalar without children
+    func writeCopy(variable: UnsafeRawBufferPointer, nameHash: UInt64?) throws -> OmOffsetSize {
+        try buffer.alignTo64Bytes()
+        let offset = UInt64(buffer.totalBytesWritten)
+        try buffer.reallocate(minimumCapacity: variable.count)
+        buffer.bufferAtWritePosition.copyMemory(from: variable.baseAddress!, byteCount: variable.count)
+        buffer.incrementWritePosition(by: variable.count)
+        return OmOffsetSize(offset: offset, size: UInt64(variable.count), nameHash: nameHash)
+    }
+
+    /// Size of the name index including padding after a variable of `variableSize` bytes. 0 if the variable does not get a name index.
+    /// Requires that all children have been written by an `OmFileWriter` that recorded their names.
+    func nameIndexSize(variableSize: Int, children: [OmOffsetSize]) -> Int {
+        guard children.count >= nameIndexMinimumChildren, children.allSatisfy({ $0.nameHash != nil }) else {
+            return 0
+        }
+        return (variableSize + 7) / 8 * 8 - variableSize + om_variable_write_name_index_size(UInt32(children.count))
+    }
+
+    /// Write the name index behind the variable at the current write position
+    func writeNameIndex(variableSize: Int, children: [OmOffsetSize]) {
+        guard nameIndexSize(variableSize: variableSize, children: children) > 0 else {
+            return
         }
+        let padding = (variableSize + 7) / 8 * 8 - variableSize
+        let dst = buffer.bufferAtWritePosition.advanced(by: variableSize)
+        dst.initializeMemory(as: UInt8.self, repeating: 0, count: padding)
+        om_variable_write_name_index(dst.advanced(by: padding), UInt32(children.count), children.map({ $0.nameHash! }))
     }
-    
+
     public func writeArray<OmType: OmFileArrayDataTypeProtocol>(data: [OmType], dimensions: [UInt64], chunkDimensions: [UInt64], compression: OmCompressionType, scale_factor: Float, add_offset: Float) throws -> OmFileWriterArrayFinalised {
         let prepare = try self.prepareArray(type: OmType.self, dimensions: dimensions, chunkDimensions: chunkDimensions, compression: compression, scale_factor: scale_factor, add_offset: add_offset)
         try prepare.writeData(array: data)
@@ -107,15 +157,15 @@ public struct OmFileWriter<FileHandle: OmFileWriterBackend> {
         om_trailer_write(buffer.bufferAtWritePosition, rootVariable.offset, rootVariable.size)
         buffer.incrementWritePosition(by: size)
 
-        // Flush
-        try buffer.writeToFile()
+        // Flush and wait for background writes
+        try buffer.flush()
     }
 }
 
 /// Compress a single variable inside an om file. A om file may contain multiple variables
 public final class OmFileWriterArray<OmType: OmFileArrayDataTypeProtocol, FileHandle: OmFileWriterBackend> {
     /// Store all byte offsets where our compressed chunks start. Later, we want to decompress chunk 1234 and know it starts at byte offset 5346545
-    private var lookUpTable: [UInt64]
+    private(set) var lookUpTable: [UInt64]
 
     private var encoder: OmEncoder_t
 
@@ -131,6 +181,12 @@ public final class OmFileWriterArray<OmType: OmFileArrayDataTypeProtocol, FileHa
     /// Type of compression and coding. E.g. delta, zigzag coding is then implemented in different compression routines
     let compression: OmCompressionType
 
+    /// Each chunk selects its own codec
+    let adaptive: Bool
+
+    /// The LUT is stored in bit packed blocks
+    let packedLut: Bool
+
     /// The dimensions of the file
     let dimensions: [UInt64]
 
@@ -144,10 +200,16 @@ public final class OmFileWriterArray<OmType: OmFileArrayDataTypeProtocol, FileHa
     /// Temporarily write data here. Keeps also track of `totalBytesWritten`
     let buffer: OmBufferedWriter<FileHandle>
 
+    /// Statistics for each chunk. Nil if chunk statistics are not written.
+    let chunkStats: UnsafeMutableBufferPointer<OmChunkStats_t>?
 
-    public init(dimensions: [UInt64], chunkDimensions: [UInt64], compression: OmCompressionType, scale_factor: Float, add_offset: Float, buffer: OmBufferedWriter<FileHandle>) throws {
+
+    public init(dimensions: [UInt64], chunkDimensions: [UInt64], compression: OmCompressionType, scale_factor: Float, add_offset: Float, buffer: OmBufferedWriter<FileHandle>, chunkStatistics: Bool = false, adaptive: Bool = false, packedLut: Bool = false) throws {
 
         assert(dimensions.count == chunkDimensions.count)
+        guard !chunkStatistics || OmType.dataTypeArray == .float_array else {
+            throw OmFileFormatSwiftError.omEncoder(error: "Chunk statistics require a float array")
+        }
         
         var chunks = chunkDimensions
         var dimensions = dimensions
@@ -155,12 +217,14 @@ public final class OmFileWriterArray<OmType: OmFileArrayDataTypeProtocol, FileHa
         self.chunks = chunkDimensions
         self.dimensions = dimensions
         self.compression = compression
+        self.adaptive = adaptive
+        self.packedLut = packedLut
         self.scale_factor = scale_factor
         self.add_offset = add_offset
 
         // Note: The encoder keeps the pointer to `&self.dimensions`. It is important that this array is not deallocated!
         self.encoder = OmEncoder_t()
-        let error = om_encoder_init(&encoder, scale_factor, add_offset, compression.toC(), OmType.dataTypeArray.toC(), &dimensions, &chunks, UInt64(dimensions.count))
+        let error = om_encoder_init(&encoder, scale_factor, add_offset, compression.toC(adaptive: adaptive), OmType.dataTypeArray.toC(), &dimensions, &chunks, UInt64(dimensions.count))
 
         guard error == ERROR_OK else {
             throw OmFileFormatSwiftError.omEncoder(error: String(cString: om_error_string(error)))
@@ -182,6 +246,14 @@ public final class OmFileWriterArray<OmType: OmFileArrayDataTypeProtocol, FileHa
         self.lookUpTable = .init(repeating: 0, count: Int(nChunks) + 1)
 
         self.buffer = buffer
+
+        if chunkStatistics {
+            let chunkStats = UnsafeMutableBufferPointer<OmChunkStats_t>.allocate(capacity: Int(nChunks))
+            chunkStats.initialize(repeating: OmChunkStats_t())
+            self.chunkStats = chunkStats
+        } else {
+            self.chunkStats = nil
+        }
     }
 
     /// Compress data and write it to file. Can be all, a single or multiple chunks. If multiple chunks are given at once, they must align with chunks.
@@ -220,12 +292,11 @@ public final class OmFileWriterArray<OmType: OmFileArrayDataTypeProtocol, FileHa
             lookUpTable[chunkIndex] = UInt64(buffer.totalBytesWritten)
         }
 
-        // This loop could be done in parallel. However, the order of chunks must remain the same in the LUT and final output buffer.
-        // For multithreading, multiple buffers are required that need to be copied into the final buffer afterwards
+        // The order of chunks must remain the same in the LUT and final output buffer. See `writeDataConcurrent` for a multithreaded version
         for chunkIndexOffsetInThisArray in 0..<numberOfChunksInArray {
             try buffer.reallocate(minimumCapacity: Int(compressedChunkBufferSize))
 
-            let bytes_written = om_encoder_compress_chunk(
+            let bytes_written = om_encoder_compress_chunk_stats(
                 &encoder,
                 pointer.baseAddress,
                 arrayDimensions,
@@ -234,7 +305,8 @@ public final class OmFileWriterArray<OmType: OmFileArrayDataTypeProtocol, FileHa
                 UInt64(chunkIndex),
                 chunkIndexOffsetInThisArray,
                 buffer.bufferAtWritePosition,
-                chunkBuffer.baseAddress
+                chunkBuffer.baseAddress,
+                chunkStats?.baseAddress?.advanced(by: chunkIndex)
             )
 
             buffer.incrementWritePosition(by: Int(bytes_written))
@@ -245,31 +317,225 @@ public final class OmFileWriterArray<OmType: OmFileArrayDataTypeProtocol, FileHa
         }
     }
 
+    /// Compress data from an input with a byte stride for each dimension, e.g. padded rows, a transposed layout or a flipped grid, without repacking it first.
+    /// `pointer` is the element at coordinate 0 of all dimensions and strides may be negative. `arrayOffset` and `arrayCount` select the part of the input that is written.
+    /// The output is identical to `writeData` with a dense copy of the input.
+    public func writeData(pointer: UnsafePointer<OmType>, byteStrides: [Int], arrayOffset: [UInt64]? = nil, arrayCount: [UInt64]? = nil) throws {
+        let arrayCount = arrayCount ?? self.dimensions
+        let arrayOffset = arrayOffset ?? [UInt64](repeating: 0, count: arrayCount.count)
+        guard byteStrides.count == dimensions.count, arrayCount.count == dimensions.count, arrayOffset.count == dimensions.count else {
+            throw OmFileFormatSwiftError.requireDimensionsToMatch(required: dimensions.count, actual: byteStrides.count)
+        }
+        let strides = byteStrides.map({ Int64($0) })
+
+        try buffer.reallocate(minimumCapacity: Int(compressedChunkBufferSize) * 4)
+        let numberOfChunksInArray = om_encoder_count_chunks_in_array(&encoder, arrayCount)
+        if chunkIndex == 0 {
+            lookUpTable[chunkIndex] = UInt64(buffer.totalBytesWritten)
+        }
+        for chunkIndexOffsetInThisArray in 0..<numberOfChunksInArray {
+            try buffer.reallocate(minimumCapacity: Int(compressedChunkBufferSize))
+            let bytes_written = om_encoder_compress_chunk_strided(
+                &encoder,
+                pointer,
+                strides,
+                arrayOffset,
+                arrayCount,
+                UInt64(chunkIndex),
+                chunkIndexOffsetInThisArray,
+                buffer.bufferAtWritePosition,
+                chunkBuffer.baseAddress,
+                chunkStats?.baseAddress?.advanced(by: chunkIndex)
+            )
+            buffer.incrementWritePosition(by: Int(bytes_written))
+            lookUpTable[chunkIndex+1] = UInt64(buffer.totalBytesWritten)
+            chunkIndex += 1
+        }
+    }
+
+    /// Compress data using multiple threads and write it to file. The output is identical to `writeData`.
+    /// `concurrency` is the number of threads. `maxMemory` limits the scratch memory for compressed chunks that have not yet been written to the output buffer.
+    public func writeDataConcurrent(array: [OmType], arrayDimensions: [UInt64]? = nil, arrayOffset: [UInt64]? = nil, arrayCount: [UInt64]? = nil, concurrency: Int = ProcessInfo.processInfo.activeProcessorCount, maxMemory: Int = 128 * 1024 * 1024) throws {
+        try array.withUnsafeBufferPointer { array in
+            try writeDataConcurrent(pointer: array, arrayDimensions: arrayDimensions, arrayOffset: arrayOffset, arrayCount: arrayCount, concurrency: concurrency, maxMemory: maxMemory)
+        }
+    }
+
+    /// Compress data using multiple threads and write it to file. The output is identical to `writeData`.
+    /// Chunks are compressed by `om_encoder_pipeline_compress` into output slots. One thread copies them in chunk order to the output buffer and updates the LUT.
+    /// `concurrency` is the number of threads. `maxMemory` limits the memory for compressed chunks that have not yet been written to the output buffer.
+    /// At least one output slot per thread is used.
+    public func writeDataConcurrent(pointer: UnsafeBufferPointer<OmType>, arrayDimensions: [UInt64]? = nil, arrayOffset: [UInt64]? = nil, arrayCount: [UInt64]? = nil, concurrency: Int = ProcessInfo.processInfo.activeProcessorCount, maxMemory: Int = 128 * 1024 * 1024) throws {
+        let arrayDimensions = arrayDimensions ?? self.dimensions
+        let arrayCount = arrayCount ?? arrayDimensions
+        let arrayOffset = arrayOffset ?? [UInt64](repeating: 0, count: arrayDimensions.count)
+
+        let arrayDimsFlat = arrayDimensions.reduce(1, *)
+        if pointer.count != arrayDimsFlat {
+            throw OmFileFormatSwiftError.requireDimensionsToMatch(required: pointer.count, actual: Int(arrayDimsFlat))
+        }
+        assert(zip(arrayDimensions, zip(arrayOffset, arrayCount)).allSatisfy { $1.0 + $1.1 <= $0 })
+
+        /// How many chunks can be written to the output. This could be only a single one, or multiple
+        let numberOfChunksInArray = Int(om_encoder_count_chunks_in_array(&encoder, arrayCount))
+        let concurrency = max(1, min(concurrency, numberOfChunksInArray))
+        if concurrency <= 1 {
+            return try writeData(pointer: pointer, arrayDimensions: arrayDimensions, arrayOffset: arrayOffset, arrayCount: arrayCount)
+        }
+
+        /// Store data start address if this is the first time this read is called
+        if chunkIndex == 0 {
+            lookUpTable[chunkIndex] = UInt64(buffer.totalBytesWritten)
+        }
+
+        let chunkBufferSize = Int(om_encoder_chunk_buffer_size(&encoder))
+
+        /// Number of compressed chunks that can wait to be written to the output buffer
+        let slotsCount = min(numberOfChunksInArray, max(concurrency, maxMemory / Int(compressedChunkBufferSize)))
+        let memorySize = Int(om_encoder_pipeline_memory_size(&encoder, UInt64(slotsCount)))
+        let memory = UnsafeMutableRawPointer.allocate(byteCount: memorySize, alignment: 64)
+        defer { memory.deallocate() }
+        let chunkBuffers = UnsafeMutableRawPointer.allocate(byteCount: concurrency * chunkBufferSize, alignment: 64)
+        defer { chunkBuffers.deallocate() }
+        chunkBuffers.initializeMemory(as: UInt8.self, repeating: 0, count: concurrency * chunkBufferSize)
+
+        let encoder = UnsafeMutablePointer<OmEncoder_t>.allocate(capacity: 1)
+        encoder.initialize(to: self.encoder)
+        defer { encoder.deallocate() }
+        let pipeline = UnsafeMutablePointer<OmEncoderPipeline_t>.allocate(capacity: 1)
+        defer { pipeline.deallocate() }
+        /// The pipeline keeps pointers to the array shape. Store dimensions, offset and count in memory that remains valid.
+        let nDimensions = arrayDimensions.count
+        let shape = UnsafeMutablePointer<UInt64>.allocate(capacity: 3 * nDimensions)
+        defer { shape.deallocate() }
+        shape.initialize(from: arrayDimensions + arrayOffset + arrayCount, count: 3 * nDimensions)
+        let error = om_encoder_pipeline_init(pipeline, encoder, pointer.baseAddress, shape, shape.advanced(by: nDimensions), shape.advanced(by: 2 * nDimensions), UInt64(chunkIndex), memory, UInt64(memorySize))
+        guard error == ERROR_OK else {
+            throw OmFileFormatSwiftError.omEncoder(error: String(cString: om_error_string(error)))
+        }
+        pipeline.pointee.chunk_stats = chunkStats?.baseAddress?.advanced(by: chunkIndex)
+
+        /// Error while writing to the output buffer
+        var writeError: (any Error)? = nil
+
+        // Worker 0 writes compressed chunks in order to the output buffer and compresses chunks if no output is ready
+        DispatchQueue.concurrentPerform(iterations: concurrency) { worker in
+            let chunkBuffer = chunkBuffers.advanced(by: worker * chunkBufferSize).assumingMemoryBound(to: UInt8.self)
+            guard worker == 0 else {
+                while true {
+                    switch om_encoder_pipeline_compress(pipeline, chunkBuffer) {
+                    case ENCODER_PIPELINE_DONE:
+                        return
+                    case ENCODER_PIPELINE_FULL:
+                        sched_yield()
+                    default:
+                        break
+                    }
+                }
+            }
+            while !om_encoder_pipeline_is_complete(pipeline) {
+                var data: UnsafePointer<UInt8>? = nil
+                var size: UInt64 = 0
+                guard om_encoder_pipeline_next_output(pipeline, &data, &size) else {
+                    if om_encoder_pipeline_compress(pipeline, chunkBuffer) != ENCODER_PIPELINE_COMPRESSED {
+                        sched_yield()
+                    }
+                    continue
+                }
+                do {
+                    try buffer.reallocate(minimumCapacity: Int(size))
+                } catch {
+                    writeError = error
+                    om_encoder_pipeline_cancel(pipeline)
+                    return
+                }
+                buffer.bufferAtWritePosition.copyMemory(from: data!, byteCount: Int(size))
+                buffer.incrementWritePosition(by: Int(size))
+                om_encoder_pipeline_release_output(pipeline)
+
+                // Store chunk offset in LUT
+                lookUpTable[chunkIndex+1] = UInt64(buffer.totalBytesWritten)
+                chunkIndex += 1
+            }
+        }
+        if let writeError {
+            throw writeError
+        }
+    }
+
+    /// Append chunks that are already compressed with the compression, scale factor and chunk shape of this array. `ends` holds the end of each chunk relative to the start of `data`.
+    func writeCompressed(data: UnsafeRawBufferPointer, ends: [UInt64], chunkStats stats: ArraySlice<OmChunkStats_t>?) throws {
+        if chunkIndex == 0 {
+            lookUpTable[chunkIndex] = UInt64(buffer.totalBytesWritten)
+        }
+        let start = UInt64(buffer.totalBytesWritten)
+        if let baseAddress = data.baseAddress {
+            try buffer.reallocate(minimumCapacity: data.count)
+            buffer.bufferAtWritePosition.copyMemory(from: baseAddress, byteCount: data.count)
+            buffer.incrementWritePosition(by: data.count)
+        }
+        for (i, end) in ends.enumerated() {
+            if let chunkStats, let stats {
+                chunkStats[chunkIndex] = stats[stats.startIndex + i]
+            }
+            lookUpTable[chunkIndex+1] = start + end
+            chunkIndex += 1
+        }
+    }
+
+    /// Continue an existing array at chunk `lookUpTable.count - 1`. `lookUpTable` holds the offsets of all chunks that are kept and the end of the last kept chunk.
+    func resume(lookUpTable prefix: [UInt64], chunkStats statsPrefix: [OmChunkStats_t]?) {
+        chunkIndex = prefix.count - 1
+        lookUpTable.replaceSubrange(0..<prefix.count, with: prefix)
+        if let chunkStats, let statsPrefix {
+            _ = chunkStats.update(fromContentsOf: statsPrefix)
+        }
+    }
+
     /// Compress the lookup table and write it to the output buffer
     public func finalise() throws -> OmFileWriterArrayFinalised {
         let lut_offset = buffer.totalBytesWritten
 
         /// The size of the total compressed LUT including some padding
-        let buffer_size = om_encoder_lut_buffer_size(lookUpTable, UInt64(lookUpTable.count))
+        let buffer_size = packedLut ?
+            om_encoder_lut_packed_buffer_size(lookUpTable, UInt64(lookUpTable.count)) :
+            om_encoder_lut_buffer_size(lookUpTable, UInt64(lookUpTable.count))
         try buffer.reallocate(minimumCapacity: Int(buffer_size))
 
         /// Compress the LUT and return the actual compressed LUT size
-        let compressed_lut_size = om_encoder_compress_lut(lookUpTable, UInt64(lookUpTable.count), buffer.bufferAtWritePosition, buffer_size)
+        let compressed_lut_size = packedLut ?
+            om_encoder_compress_lut_packed(lookUpTable, UInt64(lookUpTable.count), buffer.bufferAtWritePosition, buffer_size) :
+            om_encoder_compress_lut(lookUpTable, UInt64(lookUpTable.count), buffer.bufferAtWritePosition, buffer_size)
         buffer.incrementWritePosition(by: Int(compressed_lut_size))
+
+        /// Write chunk statistics after the LUT
+        var chunkStatsOffsetSize: (offset: UInt64, size: UInt64)? = nil
+        if let chunkStats {
+            try buffer.alignTo64Bytes()
+            let size = chunkStats.count * MemoryLayout<OmChunkStats_t>.stride
+            try buffer.reallocate(minimumCapacity: size)
+            chunkStatsOffsetSize = (UInt64(buffer.totalBytesWritten), UInt64(size))
+            buffer.bufferAtWritePosition.copyMemory(from: UnsafeRawPointer(chunkStats.baseAddress!), byteCount: size)
+            buffer.incrementWritePosition(by: size)
+        }
         return OmFileWriterArrayFinalised(
             scale_factor: scale_factor,
             add_offset: add_offset,
             compression: compression,
+            adaptive: adaptive,
+            packedLut: packedLut,
             datatype: OmType.dataTypeArray,
             dimensions: dimensions,
             chunks: chunks,
             lutSize: compressed_lut_size,
-            lutOffset: UInt64(lut_offset)
+            lutOffset: UInt64(lut_offset),
+            chunkStats: chunkStatsOffsetSize
         )
     }
 
     deinit {
         chunkBuffer.deallocate()
+        chunkStats?.deallocate()
     }
 }
 
@@ -284,6 +550,12 @@ public struct OmFileWriterArrayFinalised {
     /// Type of compression and coding. E.g. delta, zigzag coding is then implemented in different compression routines
     let compression: OmCompressionType
 
+    /// Each chunk selects its own codec
+    var adaptive: Bool = false
+
+    /// The LUT is stored in bit packed blocks
+    var packedLut: Bool = false
+
     let datatype: OmDataType
 
     /// The dimensions of the file
@@ -295,15 +567,26 @@ public struct OmFileWriterArrayFinalised {
     let lutSize: UInt64
 
     let lutOffset: UInt64
+
+    /// File range of chunk statistics. Nil if chunk statistics are not written.
+    var chunkStats: (offset: UInt64, size: UInt64)? = nil
+
+    /// Compression type as stored in the array meta data
+    var compressionC: OmCompression_t {
+        return compression.toC(adaptive: adaptive, packedLut: packedLut)
+    }
 }
 
 /// Wrapper for the internal C structure to keep offset and size
 public struct OmOffsetSize {
     let offset: UInt64
     let size: UInt64
+    /// Hash of the variable name for the name index of the parent. Nil if not known.
+    let nameHash: UInt64?
 
-    init(offset: UInt64, size: UInt64) {
+    init(offset: UInt64, size: UInt64, nameHash: UInt64? = nil) {
         self.offset = offset
         self.size = size
+        self.nameHash = nameHash
     }
 }
@@ -0,0 +1,132 @@
+import Foundation
+
+/// Downsampled overviews of an array for low resolution reads, e.g. map tiles at low zoom levels.
+/// Each overview halves the selected dimensions of the previous level and stores the mean of all values that are not NaN.
+/// Overviews are stored as children named `overview_<factor>` of the full resolution array.
+enum OmOverview {
+    static let namePrefix = "overview_"
+
+    /// Sum and count of values of one level. Means are computed from the full resolution, so NaN values do not bias coarser levels.
+    struct Level {
+        let dimensions: [UInt64]
+        let sum: [Double]
+        let count: [UInt32]
+
+        init(data: [Float], dimensions: [UInt64]) {
+            self.dimensions = dimensions
+            self.sum = data.map({ $0.isNaN ? 0 : Double($0) })
+            self.count = data.map({ $0.isNaN ? 0 : 1 })
+        }
+
+        init(dimensions: [UInt64], sum: [Double], count: [UInt32]) {
+            self.dimensions = dimensions
+            self.sum = sum
+            self.count = count
+        }
+
+        /// Combine 2 elements of each dimension in `downsample`
+        func downsampled(_ downsample: [Int]) -> Level {
+            let outDimensions = dimensions.enumerated().map({ downsample.contains($0.offset) ? ($0.element + 1) / 2 : $0.element })
+            let n = Int(outDimensions.reduce(1, *))
+            var sum = [Double](repeating: 0, count: n)
+            var count = [UInt32](repeating: 0, count: n)
+            let nDimensions = dimensions.count
+            var coordinate = [UInt64](repeating: 0, count: nDimensions)
+            for i in 0..<self.sum.count {
+                var target = 0
+                for d in 0..<nDimensions {
+                    let c = downsample.contains(d) ? coordinate[d] / 2 : coordinate[d]
+                    target = target * Int(outDimensions[d]) + Int(c)
+                }
+                sum[target] += self.sum[i]
+                count[target] += self.count[i]
+                // Next coordinate with the last dimension being the fastest
+                var d = nDimensions - 1
+                while d >= 0 {
+                    coordinate[d] += 1
+                    if coordinate[d] < dimensions[d] {
+                        break
+                    }
+                    coordinate[d] = 0
+                    d -= 1
+                }
+            }
+            return Level(dimensions: outDimensions, sum: sum, count: count)
+        }
+
+        var mean: [Float] {
+            return zip(sum, count).map({ $1 == 0 ? .nan : Float($0 / Double($1)) })
+        }
+    }
+}
+
+extension OmFileWriter {
+    /// Write downsampled overviews of `data` and return them to be used as children of the full resolution array.
+    /// Each level halves all dimensions in `downsample` until none of them is longer than `minimumSize`.
+    /// Chunk dimensions are the same as for the full resolution array, but limited to the overview dimensions.
+    public func writeOverviews(data: [Float], dimensions: [UInt64], chunkDimensions: [UInt64], compression: OmCompressionType, scale_factor: Float, add_offset: Float, downsample: [Int], minimumSize: UInt64 = 256) throws -> [OmOffsetSize] {
+        guard data.count == dimensions.reduce(1, *) else {
+            throw OmFileFormatSwiftError.requireDimensionsToMatch(required: Int(dimensions.reduce(1, *)), actual: data.count)
+        }
+        guard !downsample.isEmpty, downsample.allSatisfy({ $0 >= 0 && $0 < dimensions.count }) else {
+            throw OmFileFormatSwiftError.requireDimensionsToMatch(required: dimensions.count, actual: downsample.count)
+        }
+        var level = OmOverview.Level(data: data, dimensions: dimensions)
+        var factor = 1
+        var overviews = [OmOffsetSize]()
+        while downsample.contains(where: { level.dimensions[$0] > minimumSize }) {
+            level = level.downsampled(downsample)
+            factor *= 2
+            let chunks = zip(chunkDimensions, level.dimensions).map({ min($0, $1) })
+            let array = try writeArray(data: level.mean, dimensions: level.dimensions, chunkDimensions: chunks, compression: compression, scale_factor: scale_factor, add_offset: add_offset)
+            overviews.append(try write(array: array, name: "\(OmOverview.namePrefix)\(factor)", children: []))
+        }
+        return overviews
+    }
+}
+
+extension OmFileReader {
+    /// Overviews written by `writeOverviews` ordered from fine to coarse. Empty if this variable has no overviews.
+    public func getOverviews<OmType: OmFileArrayDataTypeProtocol>(of: OmType.Type) async throws -> [OmFileReaderArray<Backend, OmType>] {
+        var overviews = [(factor: Int, array: OmFileReaderArray<Backend, OmType>)]()
+        for i in 0..<numberOfChildren {
+            guard let child = try await getChild(i) else {
+                continue
+            }
+            let name = child.getName()
+            guard name.hasPrefix(OmOverview.namePrefix), let factor = Int(name.dropFirst(OmOverview.namePrefix.count)), let array = child.asArray(of: OmType.self) else {
+                continue
+            }
+            overviews.append((factor, array))
+        }
+        return overviews.sorted(by: { $0.factor < $1.factor }).map({ $0.array })
+    }
+
+    /// Select the coarsest overview that still provides `outputDimensions` elements for `range` of the full resolution array.
+    /// Returns the array and `range` scaled to its dimensions. Falls back to the full resolution array. Nil if this variable is not an array of `OmType`.
+    public func overview<OmType: OmFileArrayDataTypeProtocol>(of: OmType.Type, range: [Range<UInt64>]? = nil, outputDimensions: [UInt64]) async throws -> (array: OmFileReaderArray<Backend, OmType>, range: [Range<UInt64>])? {
+        guard let full = asArray(of: OmType.self) else {
+            return nil
+        }
+        let dimensions = full.getDimensions()
+        let range = range ?? dimensions.map({ 0..<$0 })
+        guard range.count == dimensions.count, outputDimensions.count == dimensions.count else {
+            throw OmFileFormatSwiftError.requireDimensionsToMatch(required: dimensions.count, actual: range.count)
+        }
+        for overview in try await getOverviews(of: OmType.self).reversed() {
+            let overviewDimensions = overview.getDimensions()
+            guard overviewDimensions.count == dimensions.count else {
+                continue
+            }
+            let scaled = (0..<dimensions.count).map { i in
+                let lower = range[i].lowerBound * overviewDimensions[i] / dimensions[i]
+                let upper = (range[i].upperBound * overviewDimensions[i] + dimensions[i] - 1) / dimensions[i]
+                return lower ..< max(upper, lower + 1)
+            }
+            if zip(scaled, outputDimensions).allSatisfy({ UInt64($0.count) >= $1 }) {
+                return (overview, scaled)
+            }
+        }
+        return (full, range)
+    }
+}
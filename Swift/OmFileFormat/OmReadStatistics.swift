@@ -0,0 +1,66 @@
+import OmFileFormatC
+
+/// Counters and timings filled by the decoder. Can be shared between multiple arrays, reads and threads to accumulate totals, e.g. for Prometheus metrics.
+public final class OmReadStatistics: @unchecked Sendable {
+    let stats: UnsafeMutablePointer<OmDecoderStats_t>
+
+    public init() {
+        stats = .allocate(capacity: 1)
+        stats.initialize(to: OmDecoderStats_t())
+    }
+
+    deinit {
+        stats.deallocate()
+    }
+
+    /// A copy of all counters. Each counter is read atomically. While reads are running, counters can come from different moments.
+    public var snapshot: Snapshot {
+        var copy = OmDecoderStats_t()
+        om_decoder_stats_copy(stats, &copy)
+        return Snapshot(copy)
+    }
+
+    /// Set all counters to 0
+    public func reset() {
+        om_decoder_stats_reset(stats)
+    }
+
+    public struct Snapshot: Sendable, Equatable {
+        /// Index reads that require IO. Reads served by a LUT cache or pinned LUT are not counted.
+        public let indexReads: UInt64
+        public let indexBytes: UInt64
+        /// Data reads and compressed bytes
+        public let dataReads: UInt64
+        public let dataBytes: UInt64
+        /// Decoded chunks and their uncompressed size
+        public let chunksDecoded: UInt64
+        public let uncompressedBytes: UInt64
+        /// Chunks only read to merge IO that are outside the requested range
+        public let chunksSkipped: UInt64
+        /// Chunks copied from the chunk cache
+        public let chunksCached: UInt64
+        /// Constant chunks of adaptive arrays filled without decompression. Included in `chunksDecoded`.
+        public let chunksConstant: UInt64
+        public let lutChunksDecompressed: UInt64
+        /// Time in seconds
+        public let decompressSeconds: Double
+        public let filterSeconds: Double
+        public let copySeconds: Double
+
+        init(_ stats: OmDecoderStats_t) {
+            indexReads = stats.index_reads
+            indexBytes = stats.index_bytes
+            dataReads = stats.data_reads
+            dataBytes = stats.data_bytes
+            chunksDecoded = stats.chunks_decoded
+            uncompressedBytes = stats.uncompressed_bytes
+            chunksSkipped = stats.chunks_skipped
+            chunksCached = stats.chunks_cached
+            chunksConstant = stats.chunks_constant
+            lutChunksDecompressed = stats.lut_chunks_decompressed
+            decompressSeconds = Double(stats.decompress_ns) / 1e9
+            filterSeconds = Double(stats.filter_ns) / 1e9
+            copySeconds = Double(stats.copy_ns) / 1e9
+        }
+    }
+}
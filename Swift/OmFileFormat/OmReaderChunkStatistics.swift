@@ -0,0 +1,191 @@
+import OmFileFormatC
+
+/// Min, max and NaN count of a single chunk. Values are the decoded values after scaling.
+public struct OmChunkStatistics: Sendable, Equatable {
+    /// NaN if all values are NaN
+    public let min: Float
+    /// NaN if all values are NaN
+    public let max: Float
+    public let nanCount: UInt32
+
+    init(_ stats: OmChunkStats_t) {
+        min = stats.min
+        max = stats.max
+        nanCount = stats.nan_count
+    }
+}
+
+/// Decide from its statistics if a chunk may contain matching values. Chunks that cannot match are not read.
+public struct OmChunkPredicate: Sendable {
+    public let mayMatch: @Sendable (OmChunkStatistics) -> Bool
+
+    public init(mayMatch: @escaping @Sendable (OmChunkStatistics) -> Bool) {
+        self.mayMatch = mayMatch
+    }
+
+    /// Chunks with at least one value greater than `value`
+    public static func greaterThan(_ value: Float) -> Self {
+        return .init(mayMatch: { !$0.max.isNaN && $0.max > value })
+    }
+
+    /// Chunks with at least one value greater than or equal to `value`
+    public static func greaterThanOrEqual(_ value: Float) -> Self {
+        return .init(mayMatch: { !$0.max.isNaN && $0.max >= value })
+    }
+
+    /// Chunks with at least one value less than `value`
+    public static func lessThan(_ value: Float) -> Self {
+        return .init(mayMatch: { !$0.min.isNaN && $0.min < value })
+    }
+
+    /// Chunks with at least one value less than or equal to `value`
+    public static func lessThanOrEqual(_ value: Float) -> Self {
+        return .init(mayMatch: { !$0.min.isNaN && $0.min <= value })
+    }
+
+    /// Chunks that overlap `range`
+    public static func within(_ range: ClosedRange<Float>) -> Self {
+        return .init(mayMatch: { !$0.min.isNaN && $0.max >= range.lowerBound && $0.min <= range.upperBound })
+    }
+
+    /// Chunks with at least one NaN value
+    public static var containsNaN: Self {
+        return .init(mayMatch: { $0.nanCount > 0 })
+    }
+}
+
+extension OmFileReaderArray where OmType == Float {
+    /// File range of the chunk statistics. Nil if the array was written without chunk statistics.
+    var chunkStatisticsRange: (offset: UInt64, size: UInt64)? {
+        return variable.withUnsafeBytes({
+            let variable = om_variable_init($0.baseAddress?.advanced(by: variableOffset))
+            var offset: UInt64 = 0
+            var size: UInt64 = 0
+            guard om_variable_get_chunk_stats(variable, UInt64(variableSize ?? $0.count - variableOffset), &offset, &size) else {
+                return nil
+            }
+            return (offset, size)
+        })
+    }
+
+    /// True if the array was written with `chunkStatistics`
+    public var hasChunkStatistics: Bool {
+        return chunkStatisticsRange != nil
+    }
+
+    /// Read statistics of the chunks with global chunk index in `chunks`. Only the required part of the statistics is read.
+    /// Returns nil if the array was written without chunk statistics.
+    public func readChunkStatistics(chunks: Range<UInt64>? = nil) async throws -> [OmChunkStatistics]? {
+        guard let range = chunkStatisticsRange else {
+            return nil
+        }
+        let stride = UInt64(MemoryLayout<OmChunkStats_t>.stride)
+        let chunksCount = range.size / stride
+        let chunks = chunks ?? 0..<chunksCount
+        guard chunks.upperBound <= chunksCount else {
+            throw OmFileFormatSwiftError.dimensionOutOfBounds(range: Int(chunks.lowerBound)..<Int(chunks.upperBound), allowed: Int(chunksCount))
+        }
+        guard !chunks.isEmpty else {
+            return []
+        }
+        return try await fn.withData(offset: Int(range.offset + chunks.lowerBound * stride), count: chunks.count * Int(stride)) { data in
+            return (0..<chunks.count).map { i in
+                OmChunkStatistics(data.loadUnaligned(fromByteOffset: i * Int(stride), as: OmChunkStats_t.self))
+            }
+        }
+    }
+
+    /// Read `range` but only chunks whose statistics match `predicate`. Values of all other chunks are set to `fill`.
+    /// Consecutive matching chunks along the last dimension are read together and all parts are read in a single batch.
+    /// Without chunk statistics the entire range is read.
+    public func read(range: [Range<UInt64>]? = nil, where predicate: OmChunkPredicate, fill: Float = .nan) async throws -> [Float] {
+        let range = range ?? self.getDimensions().map({ 0..<$0 })
+        let dimensions = getDimensions()
+        let chunks = getChunkDimensions()
+        guard range.count == dimensions.count else {
+            throw OmFileFormatSwiftError.requireDimensionsToMatch(required: dimensions.count, actual: range.count)
+        }
+        for (r, dimension) in zip(range, dimensions) where r.upperBound > dimension {
+            throw OmFileFormatSwiftError.dimensionOutOfBounds(range: Int(r.lowerBound)..<Int(r.upperBound), allowed: Int(dimension))
+        }
+        guard hasChunkStatistics, !range.contains(where: { $0.isEmpty }) else {
+            return try await read(range: range)
+        }
+        let nDimensions = dimensions.count
+        let chunksInDimension = zip(dimensions, chunks).map({ ($0 + $1 - 1) / $1 })
+        let chunkLower = zip(range, chunks).map({ $0.lowerBound / $1 })
+        let chunkUpper = zip(range, chunks).map({ ($0.upperBound + $1 - 1) / $1 })
+
+        /// Global index of a chunk coordinate
+        func globalIndex(_ coordinate: [UInt64]) -> UInt64 {
+            return zip(coordinate, chunksInDimension).reduce(0, { $0 * $1.1 + $1.0 })
+        }
+        let first = globalIndex(chunkLower)
+        let last = globalIndex(chunkUpper.map({ $0 - 1 }))
+        guard let stats = try await readChunkStatistics(chunks: first..<last+1) else {
+            return try await read(range: range)
+        }
+
+        /// Collect hyperslabs of consecutive matching chunks along the last dimension
+        var parts = [[Range<UInt64>]]()
+        var coordinate = chunkLower
+        while true {
+            var runStart: UInt64? = nil
+            for c in chunkLower[nDimensions-1] ..< chunkUpper[nDimensions-1] + 1 {
+                coordinate[nDimensions-1] = c
+                let matches = c < chunkUpper[nDimensions-1] && predicate.mayMatch(stats[Int(globalIndex(coordinate) - first)])
+                if matches, runStart == nil {
+                    runStart = c
+                }
+                if !matches, let start = runStart {
+                    var part = [Range<UInt64>]()
+                    part.reserveCapacity(nDimensions)
+                    for i in 0..<nDimensions {
+                        let lower = i == nDimensions-1 ? start : coordinate[i]
+                        let upper = i == nDimensions-1 ? c : coordinate[i] + 1
+                        part.append(max(lower * chunks[i], range[i].lowerBound) ..< min(upper * chunks[i], range[i].upperBound))
+                    }
+                    parts.append(part)
+                    runStart = nil
+                }
+            }
+            // Move to the next chunk row
+            var i = nDimensions - 2
+            while i >= 0 {
+                coordinate[i] += 1
+                if coordinate[i] < chunkUpper[i] {
+                    break
+                }
+                coordinate[i] = chunkLower[i]
+                i -= 1
+            }
+            if i < 0 {
+                break
+            }
+        }
+
+        let count = range.map({ UInt64($0.count) })
+        var out = [Float](repeating: fill, count: Int(count.reduce(1, *)))
+        let values = try await readBatch(ranges: parts)
+        out.withUnsafeMutableBufferPointer { out in
+            for (part, values) in zip(parts, values) {
+                /// Copy rows of the fast dimension into the output
+                let rowLength = part[nDimensions-1].count
+                for row in 0..<values.count / rowLength {
+                    var position = 0
+                    var rest = row
+                    for i in 0..<nDimensions-1 {
+                        let below = part[(i+1)..<(nDimensions-1)].reduce(1, { $0 * $1.count })
+                        position = position * Int(count[i]) + Int(part[i].lowerBound - range[i].lowerBound) + rest / below
+                        rest %= below
+                    }
+                    position = position * Int(count[nDimensions-1]) + Int(part[nDimensions-1].lowerBound - range[nDimensions-1].lowerBound)
+                    for k in 0..<rowLength {
+                        out[position + k] = values[row * rowLength + k]
+                    }
+                }
+            }
+        }
+        return out
+    }
+}
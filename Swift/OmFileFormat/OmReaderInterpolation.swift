@@ -97,6 +97,67 @@ extension OmFileReaderArrayProtocol where OmType == Float {
     }
 
 
+    /// Read interpolated time series for many locations at once. Assuming dim0 is used for locations and dim1 is a time series.
+    /// All 2x2 stencils are decoded in a single batched pass, so chunks shared between neighbouring points are only read and decompressed once.
+    /// Results are identical to calling `readInterpolated(dim0X:dim0XFraction:dim0Y:dim0YFraction:dim0Nx:dim1:)` for each point.
+    public func readInterpolated(points: [OmInterpolationPoint], dim0Nx: Int, dim1 dim1Read: Range<UInt64>) async throws -> [[Float]] {
+        let dims = getDimensions()
+        guard dims.count == 2 || dims.count == 3 else {
+            throw OmFileFormatSwiftError.requireDimensionsToMatch(required: 3, actual: dims.count)
+        }
+        if points.isEmpty {
+            return []
+        }
+        let dim0Nx = UInt64(dim0Nx)
+        let dim0Ny = dims.count == 2 ? dims[0] / dim0Nx : dims[0]
+
+        // bound x and y for all points
+        var fractions = [(x: Float, y: Float)]()
+        fractions.reserveCapacity(points.count)
+        var offset = [UInt64]()
+        var count = [UInt64]()
+        offset.reserveCapacity(points.count * 6)
+        count.reserveCapacity(points.count * 6)
+        for point in points {
+            var dim0X = UInt64(point.dim0X)
+            var dim0XFraction = point.dim0XFraction
+            if dim0X+2 > dim0Nx {
+                dim0X = dim0Nx-2
+                dim0XFraction = 1
+            }
+            var dim0Y = UInt64(point.dim0Y)
+            var dim0YFraction = point.dim0YFraction
+            if dim0Y+2 > dim0Ny {
+                dim0Y = dim0Ny-2
+                dim0YFraction = 1
+            }
+            fractions.append((dim0XFraction, dim0YFraction))
+            if dims.count == 2 {
+                // Top and bottom row of 2 elements each
+                offset.append(contentsOf: [dim0Y * dim0Nx + dim0X, dim1Read.lowerBound, (dim0Y + 1) * dim0Nx + dim0X, dim1Read.lowerBound])
+                count.append(contentsOf: [2, UInt64(dim1Read.count), 2, UInt64(dim1Read.count)])
+            } else {
+                // New 3D files use [y,x,time] and are able to read 2x2xT slices directly
+                offset.append(contentsOf: [dim0Y, dim0X, dim1Read.lowerBound])
+                count.append(contentsOf: [2, 2, UInt64(dim1Read.count)])
+            }
+        }
+
+        // Both layouts store 4 consecutive time series of length `nt` per point
+        let nt = dim1Read.count
+        let data = UnsafeMutablePointer<Float>.allocate(capacity: points.count * 4 * nt)
+        defer { data.deallocate() }
+        try await readBatch(into: data, offset: offset, count: count, nDimensions: dims.count, nReads: offset.count / dims.count)
+
+        return fractions.enumerated().map { (i, fraction) in
+            let stencil = data.advanced(by: i * 4 * nt)
+            return [Float](unsafeUninitializedCapacity: nt) { buffer, initializedCount in
+                OmInterpolationPoint.interpolate(a: stencil, b: stencil + nt, c: stencil + 2*nt, d: stencil + 3*nt, count: nt, xFraction: fraction.x, yFraction: fraction.y, into: buffer.baseAddress!)
+                initializedCount = nt
+            }
+        }
+    }
+
     /// Read interpolated between 4 points. If one point is NaN, ignore it.
     /*public func readInterpolatedIgnoreNaN(dim0X: Int, dim0XFraction: Float, dim0Y: Int, dim0YFraction: Float, dim0Nx: Int, dim1 dim1Read: Range<Int>) throws -> [Float] {
 
@@ -130,3 +191,43 @@ extension OmFileReaderArrayProtocol where OmType == Float {
         }
     }*/
 }
+
+/// Location for batched interpolated reads. `dim0X` and `dim0Y` are the upper left grid cell and fractions the position towards the next grid cell.
+public struct OmInterpolationPoint: Sendable {
+    public let dim0X: Int
+    public let dim0XFraction: Float
+    public let dim0Y: Int
+    public let dim0YFraction: Float
+
+    public init(dim0X: Int, dim0XFraction: Float, dim0Y: Int, dim0YFraction: Float) {
+        self.dim0X = dim0X
+        self.dim0XFraction = dim0XFraction
+        self.dim0Y = dim0Y
+        self.dim0YFraction = dim0YFraction
+    }
+
+    /// Bilinear interpolation of 4 time series using 8 lanes at once. Operations are evaluated in the same order as the scalar version to produce identical results.
+    @inline(__always)
+    static func interpolate(a: UnsafePointer<Float>, b: UnsafePointer<Float>, c: UnsafePointer<Float>, d: UnsafePointer<Float>, count: Int, xFraction: Float, yFraction: Float, into: UnsafeMutablePointer<Float>) {
+        var i = 0
+        while i + 8 <= count {
+            let va = UnsafeRawPointer(a + i).loadUnaligned(as: SIMD8<Float>.self)
+            let vb = UnsafeRawPointer(b + i).loadUnaligned(as: SIMD8<Float>.self)
+            let vc = UnsafeRawPointer(c + i).loadUnaligned(as: SIMD8<Float>.self)
+            let vd = UnsafeRawPointer(d + i).loadUnaligned(as: SIMD8<Float>.self)
+            let result = va * (1-xFraction) * (1-yFraction) +
+                         vb * (xFraction) * (1-yFraction) +
+                         vc * (1-xFraction) * (yFraction) +
+                         vd * (xFraction) * (yFraction)
+            UnsafeMutableRawPointer(into + i).storeBytes(of: result, as: SIMD8<Float>.self)
+            i += 8
+        }
+        while i < count {
+            into[i] = a[i] * (1-xFraction) * (1-yFraction) +
+                      b[i] * (xFraction) * (1-yFraction) +
+                      c[i] * (1-xFraction) * (yFraction) +
+                      d[i] * (xFraction) * (yFraction)
+            i += 1
+        }
+    }
+}
@@ -0,0 +1,39 @@
+import OmFileFormatC
+
+/// 16 bit float formats for `read(range:outputType:)`
+public enum OmHalfFloatType: Sendable {
+    /// IEEE 754 half precision
+    case float16
+    /// Upper 16 bits of a float with the same exponent range
+    case bfloat16
+
+    var toC: OmOutputType_t {
+        switch self {
+        case .float16:
+            return OUTPUT_TYPE_FLOAT16
+        case .bfloat16:
+            return OUTPUT_TYPE_BFLOAT16
+        }
+    }
+}
+
+extension OmFileReaderArray where OmType == Float {
+    /// Read `range` and convert values to 16 bit floats while decoding. Returns the raw bit patterns, e.g. to fill fp16 or bf16 tensors without an intermediate float array.
+    /// Values are rounded to nearest even. Values outside the range of float16 become infinity.
+    public func read(range: [Range<UInt64>]? = nil, outputType: OmHalfFloatType) async throws -> [UInt16] {
+        let range = range ?? self.getDimensions().map({ 0..<$0 })
+        let offset = range.map({$0.lowerBound})
+        let count = range.map({UInt64($0.count)})
+        let n = Int(count.reduce(1, *))
+        var decoder = try initDecoder(offset: offset, count: count, intoCubeOffset: nil, intoCubeDimension: nil, nDimensions: range.count)
+        let error = om_decoder_set_output_type(&decoder, outputType.toC)
+        guard error == ERROR_OK else {
+            throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
+        }
+        var out = [UInt16].init(unsafeUninitializedCapacity: n) {
+            $1 += n
+        }
+        try await fn.decode(decoder: &decoder, into: &out, lookahead: lookahead)
+        return out
+    }
+}
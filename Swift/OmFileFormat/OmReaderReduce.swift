@@ -0,0 +1,91 @@
+import OmFileFormatC
+
+/// Reductions for `reduce(range:group:reductions:)`
+public enum OmReduction: Sendable {
+    case min
+    case max
+    case sum
+    case mean
+    /// Number of values that are not NaN
+    case count
+
+    var toC: OmReduction_t {
+        switch self {
+        case .min:
+            return OM_REDUCE_MIN
+        case .max:
+            return OM_REDUCE_MAX
+        case .sum:
+            return OM_REDUCE_SUM
+        case .mean:
+            return OM_REDUCE_MEAN
+        case .count:
+            return OM_REDUCE_COUNT
+        }
+    }
+}
+
+extension OmFileReaderArray where OmType == Float {
+    /// Reduce `range` while decoding without reading all values into memory. `group` consecutive elements of each dimension are combined into one output cell.
+    /// A group of 1 keeps a dimension and a group equal to the range count reduces it entirely, e.g. `[1, 1, 24]` turns hourly time series into daily values.
+    /// Returns one array for each reduction with dimensions `ceil(range.count / group)`. NaN values are skipped. Cells without any value are NaN, except for `.count`.
+    public func reduce(range: [Range<UInt64>]? = nil, group: [UInt64], reductions: [OmReduction]) async throws -> [[Float]] {
+        let range = range ?? self.getDimensions().map({ 0..<$0 })
+        guard group.count == range.count else {
+            throw OmFileFormatSwiftError.requireDimensionsToMatch(required: range.count, actual: group.count)
+        }
+        let offset = range.map({$0.lowerBound})
+        let count = range.map({UInt64($0.count)})
+        var decoder = try initDecoder(offset: offset, count: count, intoCubeOffset: nil, intoCubeDimension: nil, nDimensions: range.count)
+        // Cached chunks would be copied into an output array
+        decoder.chunk_cache = nil
+        let cellsCount = Int(om_decoder_reduce_cells_count(&decoder, group))
+        guard cellsCount > 0 else {
+            throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(ERROR_INVALID_READ_COUNT)))
+        }
+        let cells = UnsafeMutablePointer<OmReduceCell_t>.allocate(capacity: cellsCount)
+        defer { cells.deallocate() }
+        om_reduce_cells_init(cells, UInt64(cellsCount))
+        // TODO: Technically memory from `variable` is escaping through decoder. Consider copy all dimension information into decoder
+        try await fn.decodeReduce(decoder: &decoder, group: group, cells: cells, lookahead: lookahead)
+        return reductions.map { reduction in
+            return [Float](unsafeUninitializedCapacity: cellsCount) { buffer, initializedCount in
+                om_reduce_cells_result(cells, UInt64(cellsCount), reduction.toC, buffer.baseAddress)
+                initializedCount = cellsCount
+            }
+        }
+    }
+
+    /// Reduce `range` while decoding. See `reduce(range:group:reductions:)`.
+    public func reduce(range: [Range<UInt64>]? = nil, group: [UInt64], reduction: OmReduction) async throws -> [Float] {
+        return try await reduce(range: range, group: group, reductions: [reduction])[0]
+    }
+}
+
+extension OmFileReaderBackend {
+    /// Read and reduce chunks into `cells`. Chunks may update the same cells, therefore all chunks are reduced sequentially.
+    func decodeReduce(decoder: UnsafePointer<OmDecoder_t>, group: [UInt64], cells: UnsafeMutablePointer<OmReduceCell_t>, lookahead: Int = 0) async throws {
+        var indexRead = OmDecoder_indexRead_t()
+        om_decoder_init_index_read(decoder, &indexRead)
+
+        /// The size to decode a single chunk
+        let bufferSize = om_decoder_read_buffer_size(decoder)
+        let cellsRaw = UnsafeMutableRawPointer(cells)
+
+        /// Loop over index blocks and read index data
+        while om_decoder_next_index_read(decoder, &indexRead) {
+            var indexRead = indexRead
+            let (data, indexDataOffset) = try await getIndexData(decoder: decoder, indexRead: indexRead, lookahead: lookahead)
+            var indexData = data
+            let (reads, chunkIndices) = try await collectDataReads(decoder: decoder, indexRead: &indexRead, indexData: &indexData, indexDataOffset: indexDataOffset, into: cellsRaw, bufferSize: bufferSize)
+            try await self.withDataBatchChecked(reads: reads, window: indexData, windowStart: Int(indexRead.offset) - indexDataOffset, concurrent: false) { i, dataDataBuffer in
+                try OmBufferPool.shared.withBuffer(byteCount: Int(bufferSize)) { buffer in
+                    var error: OmError_t = ERROR_OK
+                    guard om_decoder_reduce_chunks(decoder, chunkIndices[i], dataDataBuffer.baseAddress, UInt64(dataDataBuffer.count), group, cellsRaw.assumingMemoryBound(to: OmReduceCell_t.self), buffer, &error) else {
+                        throw OmFileFormatSwiftError.omDecoder(error: String(cString: om_error_string(error)))
+                    }
+                }
+            }
+        }
+    }
+}
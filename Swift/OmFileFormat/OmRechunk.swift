@@ -0,0 +1,73 @@
+import Foundation
+
+extension OmFileWriterArray {
+    /// Copy all data of `source` into this array with different chunks and optionally a different order of dimensions, e.g. from chunks per timestep to time series chunks.
+    /// Dimension `i` of this array is dimension `permutation[i]` of `source`. Without a permutation, dimensions are kept.
+    ///
+    /// The array is written in slabs of whole destination chunks in chunk order. Each slab is read with `readConcurrent` directly in the destination layout and compressed with `writeDataConcurrent`.
+    /// A slab uses at most `memoryBudget` bytes, unless a single destination chunk is larger. Compressed chunks waiting for output use the memory limit of `writeDataConcurrent`. Source chunks that are shared by multiple slabs are decoded for every slab, so larger budgets need fewer passes over the source.
+    /// Must be called before any other data is written to this array.
+    public func writeData<Backend: OmFileReaderBackend>(rechunking source: OmFileReaderArray<Backend, OmType>, permutation: [Int]? = nil, memoryBudget: Int = 1024 * 1024 * 1024, concurrency: Int = ProcessInfo.processInfo.activeProcessorCount) async throws {
+        let nDimensions = dimensions.count
+        let permutation = permutation ?? Array(0..<nDimensions)
+        let sourceDimensions = source.getDimensions()
+        guard permutation.count == nDimensions, sourceDimensions.count == nDimensions, Set(permutation) == Set(0..<nDimensions) else {
+            throw OmFileFormatSwiftError.requireDimensionsToMatch(required: nDimensions, actual: permutation.count)
+        }
+        for i in 0..<nDimensions where sourceDimensions[permutation[i]] != dimensions[i] {
+            throw OmFileFormatSwiftError.requireDimensionsToMatch(required: Int(dimensions[i]), actual: Int(sourceDimensions[permutation[i]]))
+        }
+        let nChunks = zip(dimensions, chunks).map({ ($0 + $1 - 1) / $1 })
+
+        /// Slabs cover a single chunk in all dimensions before `level`, `chunksPerSlab` chunks in `level` and all dimensions after `level`.
+        /// Pick the slowest level where a slab fits into the budget.
+        let budget = UInt64(max(memoryBudget / MemoryLayout<OmType>.stride, 1))
+        func slabElements(level: Int, chunksInLevel: UInt64) -> UInt64 {
+            return (0..<nDimensions).map({ $0 < level ? chunks[$0] : $0 == level ? chunks[$0] * chunksInLevel : dimensions[$0] }).reduce(1, *)
+        }
+        let level = (0..<nDimensions).first(where: { slabElements(level: $0, chunksInLevel: 1) <= budget }) ?? nDimensions - 1
+        let chunksPerSlab = max(1, min(nChunks[level], budget / slabElements(level: level, chunksInLevel: 1)))
+
+        let buffer = UnsafeMutableBufferPointer<OmType>.allocate(capacity: Int(slabElements(level: level, chunksInLevel: chunksPerSlab)))
+        defer { buffer.deallocate() }
+        let offset = UnsafeMutablePointer<UInt64>.allocate(capacity: 2 * nDimensions)
+        defer { offset.deallocate() }
+        let count = offset.advanced(by: nDimensions)
+        let byteStrides = UnsafeMutablePointer<Int64>.allocate(capacity: nDimensions)
+        defer { byteStrides.deallocate() }
+
+        /// Chunk coordinates of the current slab for all dimensions up to `level`
+        var position = [UInt64](repeating: 0, count: level + 1)
+        while true {
+            var slabDimensions = [UInt64](repeating: 0, count: nDimensions)
+            for i in 0..<nDimensions {
+                let lower = i <= level ? position[i] * chunks[i] : 0
+                let upper = i < level ? min(lower + chunks[i], dimensions[i]) : i == level ? min(lower + chunksPerSlab * chunks[i], dimensions[i]) : dimensions[i]
+                offset[permutation[i]] = lower
+                count[permutation[i]] = upper - lower
+                slabDimensions[i] = upper - lower
+            }
+            /// The slab buffer is dense in destination order. Source dimensions are scattered with strides.
+            var stride = Int64(MemoryLayout<OmType>.stride)
+            for i in (0..<nDimensions).reversed() {
+                byteStrides[permutation[i]] = stride
+                stride *= Int64(slabDimensions[i])
+            }
+            let elements = Int(slabDimensions.reduce(1, *))
+            try await source.readConcurrent(into: buffer.baseAddress!, offset: offset, count: count, byteStrides: byteStrides, nDimensions: nDimensions)
+            try writeDataConcurrent(pointer: UnsafeBufferPointer(rebasing: buffer[0..<elements]), arrayDimensions: slabDimensions, concurrency: concurrency)
+
+            /// Next slab in chunk order
+            position[level] += chunksPerSlab
+            var i = level
+            while position[i] >= nChunks[i] {
+                if i == 0 {
+                    return
+                }
+                position[i] = 0
+                i -= 1
+                position[i] += 1
+            }
+        }
+    }
+}
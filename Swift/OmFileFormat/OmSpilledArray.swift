@@ -0,0 +1,31 @@
+import Foundation
+import OmFileFormatC
+
+extension OmFileWriter {
+    /// Prepare an array that is compressed into its own memory buffer instead of the file. Spilled arrays do not share state with the file or with each other, so multiple variables can be compressed at the same time on different threads.
+    /// Once all data is written, `write(spilled:)` copies the compressed chunks into the file. Parameters are the same as for `prepareArray`.
+    public func prepareSpilledArray<OmType: OmFileArrayDataTypeProtocol>(type: OmType.Type, dimensions: [UInt64], chunkDimensions: [UInt64], compression: OmCompressionType, scale_factor: Float, add_offset: Float, chunkStatistics: Bool = false, adaptive: Bool = false, packedLut: Bool = false, initialCapacity: Int = 1024 * 1024) throws -> OmFileWriterArray<OmType, DataAsClass> {
+        let spill = OmBufferedWriter(backend: DataAsClass(data: Data()), initialCapacity: initialCapacity)
+        return try .init(dimensions: dimensions, chunkDimensions: chunkDimensions, compression: compression, scale_factor: scale_factor, add_offset: add_offset, buffer: spill, chunkStatistics: chunkStatistics, adaptive: adaptive, packedLut: packedLut)
+    }
+
+    /// Copy the compressed chunks of a spilled array to the file and write its LUT. Chunk offsets in the LUT are moved to the position of the chunks in the file. All chunks of the array must have been written.
+    /// Arrays can be added in any order. The memory of the spilled array is released afterwards.
+    public func write<OmType: OmFileArrayDataTypeProtocol>(spilled array: OmFileWriterArray<OmType, DataAsClass>) throws -> OmFileWriterArrayFinalised {
+        guard array.chunkIndex == array.lookUpTable.count - 1 else {
+            throw OmFileFormatSwiftError.omEncoder(error: "Not all chunks of the spilled array have been written")
+        }
+        try array.buffer.writeToFile()
+        let spill = array.buffer.backend
+        defer { spill.data = Data() }
+
+        let target = try prepareArray(type: OmType.self, dimensions: array.dimensions, chunkDimensions: array.chunks, compression: array.compression, scale_factor: array.scale_factor, add_offset: array.add_offset, chunkStatistics: array.chunkStats != nil, adaptive: array.adaptive, packedLut: array.packedLut)
+        let start = array.lookUpTable[0]
+        let ends = array.lookUpTable.dropFirst().map({ $0 - start })
+        let stats = array.chunkStats.map({ ArraySlice($0) })
+        try spill.data.withUnsafeBytes {
+            try target.writeCompressed(data: UnsafeRawBufferPointer(rebasing: $0[Int(start)...]), ends: ends, chunkStats: stats)
+        }
+        return try target.finalise()
+    }
+}
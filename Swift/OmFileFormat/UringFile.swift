@@ -0,0 +1,204 @@
+import Foundation
+import OmFileFormatC
+
+/// Read a file with io_uring on Linux. All data reads of one index block are submitted as a single batch into registered buffers.
+/// If io_uring is not available (macOS, kernels older than 5.7 or blocked by seccomp), the same batches are read with `pread` from worker threads.
+public final class UringFile: @unchecked Sendable {
+    public let file: FileHandle
+    public let count: Int
+    /// True if reads are submitted with io_uring. False if the `pread` fallback is used.
+    public let usesUring: Bool
+    /// Maximum number of reads in flight
+    public let queueDepth: Int
+
+    /// Serial queue that owns the ring
+    private let queue = DispatchQueue(label: "om.uring")
+    private var ring: OmUring_t
+    /// Registered memory split into `slots` regions of `slotSize` bytes. Each batch uses one region while reading and decoding.
+    private let buffer: UnsafeMutableRawPointer
+    private let slotSize: Int
+    private var freeSlots: [Int]
+    private let lock = NSLock()
+
+    /// - Parameters:
+    ///   - queueDepth: Maximum number of reads in flight
+    ///   - slotSize: Maximum number of bytes for one batch of reads. Larger batches are split. Reads larger than this use temporary memory.
+    ///   - slots: Number of batches that can be active at the same time using registered memory
+    public init(fn: FileHandle, queueDepth: Int = 64, slotSize: Int = 4 * 1024 * 1024, slots: Int = 4) throws {
+        self.file = fn
+        try fn.seek(toOffset: 0)
+        self.count = Int(try fn.seekToEnd())
+        self.slotSize = slotSize
+        self.queueDepth = queueDepth
+        self.freeSlots = Array(0..<slots)
+        let buffer = UnsafeMutableRawPointer.allocate(byteCount: slotSize * slots, alignment: 4096)
+        var ring = OmUring_t()
+        self.usesUring = om_uring_init(&ring, UInt32(queueDepth), buffer, UInt64(slotSize * slots)) == 0
+        self.buffer = buffer
+        self.ring = ring
+    }
+
+    deinit {
+        om_uring_destroy(&ring)
+        buffer.deallocate()
+    }
+
+    /// Returns a free region of registered memory or nil if all are in use
+    private func acquireSlot() -> Int? {
+        lock.lock()
+        defer { lock.unlock() }
+        return freeSlots.popLast()
+    }
+
+    private func releaseSlot(_ slot: Int) {
+        lock.lock()
+        freeSlots.append(slot)
+        lock.unlock()
+    }
+
+    /// Read all requests and return once all completed. Throws the first error.
+    private func read(_ reads: [OmUringRead_t]) async throws {
+        let fd = file.fileDescriptor
+        guard usesUring else {
+            // Fallback: `pread` from a thread pool
+            let errors = try await withCheckedThrowingContinuation { (continuation: CheckedContinuation<[Int32], Error>) in
+                let group = DispatchGroup()
+                /// One error code per read. Each worker only writes its own element.
+                let errors = UnsafeMutableRawPointer.allocate(byteCount: reads.count * MemoryLayout<Int32>.stride, alignment: MemoryLayout<Int32>.alignment)
+                for (i, read) in reads.enumerated() {
+                    DispatchQueue.global().async(group: group) {
+                        errors.storeBytes(of: UringFile.preadFully(fd: fd, read: read), toByteOffset: i * MemoryLayout<Int32>.stride, as: Int32.self)
+                    }
+                }
+                group.notify(queue: .global()) {
+                    let result = (0..<reads.count).map { errors.load(fromByteOffset: $0 * MemoryLayout<Int32>.stride, as: Int32.self) }
+                    errors.deallocate()
+                    continuation.resume(returning: result)
+                }
+            }
+            if let error = errors.first(where: { $0 != 0 }) {
+                throw OmFileFormatSwiftError.cannotReadFile(errno: error, error: String(cString: strerror(error)))
+            }
+            return
+        }
+        let result = await withCheckedContinuation { (continuation: CheckedContinuation<Int32, Never>) in
+            queue.async {
+                let result = reads.withUnsafeBufferPointer {
+                    om_uring_read(&self.ring, fd, $0.baseAddress, UInt64($0.count))
+                }
+                continuation.resume(returning: result)
+            }
+        }
+        guard result == 0 else {
+            throw OmFileFormatSwiftError.cannotReadFile(errno: -result, error: String(cString: strerror(-result)))
+        }
+    }
+
+    /// Blocking `pread` until all bytes are read. Returns 0 or errno.
+    private static func preadFully(fd: Int32, read: OmUringRead_t) -> Int32 {
+        guard let buffer = read.buffer else {
+            return EINVAL
+        }
+        var done = 0
+        let count = Int(read.count)
+        while done < count {
+            let n = pread(fd, buffer.advanced(by: done), count - done, off_t(Int(read.offset) + done))
+            if n < 0 && errno == EINTR {
+                continue
+            }
+            if n < 0 {
+                return errno
+            }
+            if n == 0 {
+                return EIO
+            }
+            done += n
+        }
+        return 0
+    }
+}
+
+extension UringFile: OmFileReaderBackend {
+    public func prefetchData(offset: Int, count: Int) async throws {
+        #if os(Linux)
+        posix_fadvise(file.fileDescriptor, off_t(offset), off_t(count), Int32(POSIX_FADV_WILLNEED))
+        #endif
+    }
+
+    /// Typical NVMe SSD with up to `queueDepth` reads in flight
+    public var ioCostModel: OmIoCostModel? {
+        return OmIoCostModel(latency: 0.0001, bandwidth: 500_000_000, parallelism: queueDepth)
+    }
+
+    public func getData(offset: Int, count: Int) async throws -> Data {
+        /// Memory is reused for index reads of later decoder calls
+        let pool = OmBufferPool.shared
+        let (memory, capacity) = pool.acquire(byteCount: count)
+        do {
+            try await read([OmUringRead_t(offset: UInt64(offset), count: UInt64(count), buffer: memory)])
+        } catch {
+            pool.release(memory, capacity: capacity)
+            throw error
+        }
+        return Data(bytesNoCopy: memory, count: count, deallocator: .custom({ memory, _ in pool.release(memory, capacity: capacity) }))
+    }
+
+    public func withData<T>(offset: Int, count: Int, fn: (UnsafeRawBufferPointer) throws -> T) async throws -> T {
+        return try await getData(offset: offset, count: count).withUnsafeBytes(fn)
+    }
+
+    public func withDataBatch(reads: [OmFileRead], concurrent: Bool, fn: @escaping @Sendable (Int, UnsafeRawBufferPointer) throws -> Void) async throws {
+        var start = 0
+        while start < reads.count {
+            // Pack consecutive reads into one region of registered memory
+            var end = start + 1
+            var size = reads[start].count
+            while end < reads.count && size + reads[end].count <= slotSize {
+                size += reads[end].count
+                end += 1
+            }
+            let slot = size <= slotSize ? acquireSlot() : nil
+            let memory = slot.map { buffer.advanced(by: $0 * slotSize) } ?? UnsafeMutableRawPointer.allocate(byteCount: max(size, 1), alignment: 4096)
+            defer {
+                if let slot {
+                    releaseSlot(slot)
+                } else {
+                    memory.deallocate()
+                }
+            }
+            var positions = [Int]()
+            positions.reserveCapacity(end - start)
+            var position = 0
+            let uringReads = reads[start..<end].map { read in
+                positions.append(position)
+                defer { position += read.count }
+                return OmUringRead_t(offset: UInt64(read.offset), count: UInt64(read.count), buffer: memory.advanced(by: position))
+            }
+            try await self.read(uringReads)
+
+            if concurrent {
+                try await withThrowingTaskGroup(of: Void.self) { [start, end, positions] group in
+                    for i in start..<end {
+                        group.addTask {
+                            try fn(i, UnsafeRawBufferPointer(start: memory.advanced(by: positions[i - start]), count: reads[i].count))
+                        }
+                    }
+                    try await group.waitForAll()
+                }
+            } else {
+                for i in start..<end {
+                    try fn(i, UnsafeRawBufferPointer(start: memory.advanced(by: positions[i - start]), count: reads[i].count))
+                }
+            }
+            start = end
+        }
+    }
+}
+
+extension OmFileReader where Backend == UringFile {
+    public init(uringFile: String) async throws {
+        let fn = try FileHandle.openFileReading(file: uringFile)
+        let file = try UringFile(fn: fn)
+        try await self.init(fn: file)
+    }
+}
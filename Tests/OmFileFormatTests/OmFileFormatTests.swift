@@ -1,5 +1,8 @@
 import Testing
 import Foundation
+#if canImport(FoundationNetworking)
+import FoundationNetworking
+#endif
 @testable import OmFileFormat
 import OmFileFormatC
 
@@ -893,6 +896,1221 @@ import OmFileFormatC
         #expect(ints == intsRoundtrip)
     }
 
+    @Test func readBatch() async throws {
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let dims = [UInt64(10), 7]
+        let data = (0..<70).map(Float.init)
+        let writer = try fileWriter.prepareArray(type: Float.self, dimensions: dims, chunkDimensions: [3, 2], compression: .pfor_delta2d_int16, scale_factor: 1, add_offset: 0)
+        try writer.writeData(array: data)
+        let variableMeta = try writer.finalise()
+        let variable = try fileWriter.write(array: variableMeta, name: "data", children: [])
+        try fileWriter.writeTrailer(rootVariable: variable)
+
+        let read = try await OmFileReader(fn: inMemoryBackend).asArray(of: Float.self)!
+        let ranges: [[Range<UInt64>]] = [[0..<1, 0..<1], [2..<5, 1..<4], [9..<10, 6..<7], [0..<1, 0..<1], [4..<5, 0..<7]]
+        let batch = try await read.readBatch(ranges: ranges)
+        #expect(batch.count == ranges.count)
+        for (range, values) in zip(ranges, batch) {
+            await #expect(try read.read(range: range) == values)
+        }
+        #expect(batch[1] == [15, 16, 17, 22, 23, 24, 29, 30, 31])
+        await #expect(try read.readBatch(ranges: []).isEmpty)
+    }
+
+    @Test func writeConcurrent() async throws {
+        let dims = [UInt64(100), 30, 5]
+        let data = (0..<15000).map({ Float($0 % 1000) })
+
+        func write(concurrency: Int?, maxMemory: Int) throws -> Data {
+            let inMemoryBackend = DataAsClass(data: Data())
+            let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+            let writer = try fileWriter.prepareArray(type: Float.self, dimensions: dims, chunkDimensions: [5, 7, 2], compression: .pfor_delta2d_int16, scale_factor: 1, add_offset: 0)
+            if let concurrency {
+                // Write in two parts to check the chunk index is kept between calls
+                try writer.writeDataConcurrent(array: Array(data[0..<7500]), arrayDimensions: [50, 30, 5], concurrency: concurrency, maxMemory: maxMemory)
+                try writer.writeDataConcurrent(array: Array(data[7500..<15000]), arrayDimensions: [50, 30, 5], concurrency: concurrency, maxMemory: maxMemory)
+            } else {
+                try writer.writeData(array: Array(data[0..<7500]), arrayDimensions: [50, 30, 5])
+                try writer.writeData(array: Array(data[7500..<15000]), arrayDimensions: [50, 30, 5])
+            }
+            let variableMeta = try writer.finalise()
+            let variable = try fileWriter.write(array: variableMeta, name: "data", children: [])
+            try fileWriter.writeTrailer(rootVariable: variable)
+            return inMemoryBackend.data
+        }
+
+        let serial = try write(concurrency: nil, maxMemory: 0)
+        #expect(try write(concurrency: 4, maxMemory: 128 * 1024 * 1024) == serial)
+        #expect(try write(concurrency: 3, maxMemory: 1) == serial)
+        #expect(try write(concurrency: 1, maxMemory: 1) == serial)
+
+        let read = try await OmFileReader(fn: DataAsClass(data: serial)).asArray(of: Float.self)!
+        await #expect(try read.read() == data)
+    }
+
+    @Test func readWithLutCache() async throws {
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let dims = [UInt64(100), 30]
+        let data = (0..<3000).map(Float.init)
+        let writer = try fileWriter.prepareArray(type: Float.self, dimensions: dims, chunkDimensions: [3, 2], compression: .pfor_delta2d_int16, scale_factor: 1, add_offset: 0)
+        try writer.writeData(array: data)
+        let variableMeta = try writer.finalise()
+        let variable = try fileWriter.write(array: variableMeta, name: "data", children: [])
+        try fileWriter.writeTrailer(rootVariable: variable)
+
+        let cache = OmLutCache(memoryBudget: 64 * 1024)
+        let read = try await OmFileReader(fn: inMemoryBackend).asArray(of: Float.self)!
+        let cached = read.withLutCache(cache, file: 1)
+        let ranges: [[Range<UInt64>]] = [[0..<100, 0..<30], [2..<5, 1..<4], [50..<90, 7..<8], [99..<100, 29..<30]]
+        for range in ranges {
+            let expected = try await read.read(range: range)
+            // First read fills the cache, second read uses cached LUT chunks
+            await #expect(try cached.read(range: range) == expected)
+            await #expect(try cached.read(range: range) == expected)
+        }
+        await #expect(try cached.readBatch(ranges: ranges) == read.readBatch(ranges: ranges))
+
+        // A cache that is too small is ignored
+        let tiny = read.withLutCache(OmLutCache(memoryBudget: 16), file: 1)
+        await #expect(try tiny.read(range: ranges[0]) == data)
+    }
+
+    @Test func readWithChunkCache() async throws {
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let dims = [UInt64(100), 30]
+        let data = (0..<3000).map(Float.init)
+        let writer = try fileWriter.prepareArray(type: Float.self, dimensions: dims, chunkDimensions: [3, 2], compression: .pfor_delta2d_int16, scale_factor: 1, add_offset: 0)
+        try writer.writeData(array: data)
+        let variableMeta = try writer.finalise()
+        let variable = try fileWriter.write(array: variableMeta, name: "data", children: [])
+        try fileWriter.writeTrailer(rootVariable: variable)
+
+        let lutCache = OmLutCache(memoryBudget: 64 * 1024)
+        let chunkCache = OmChunkCache(memoryBudget: 256 * 1024, maxChunkBytes: 3 * 2 * 4)
+        let read = try await OmFileReader(fn: inMemoryBackend).asArray(of: Float.self)!
+        let cached = read.withLutCache(lutCache, file: 1).withChunkCache(chunkCache, file: 1)
+        let range: [Range<UInt64>] = [50..<60, 7..<12]
+        let expected = try await read.read(range: range)
+        await #expect(try cached.read(range: range) == expected)
+        #expect(chunkCache.statistics.hits == 0)
+        await #expect(try cached.read(range: range) == expected)
+        #expect(chunkCache.statistics.hits > 0)
+        await #expect(try cached.readConcurrent(range: range) == expected)
+        await #expect(try cached.read(range: [0..<100, 0..<30]) == data)
+
+        chunkCache.clear()
+        #expect(chunkCache.statistics.hits == 0)
+        #expect(chunkCache.statistics.misses == 0)
+    }
+
+    @Test func readDirectIntoTarget() async throws {
+        // Chunks of full rows are decoded directly into the output array without the chunk buffer
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let dims = [UInt64(20), 30]
+        let data = (0..<600).map { Int32($0 * 7 - 300) }
+        let writer = try fileWriter.prepareArray(type: Int32.self, dimensions: dims, chunkDimensions: [3, 30], compression: .pfor_delta2d, scale_factor: 1, add_offset: 0)
+        try writer.writeData(array: data)
+        let variableMeta = try writer.finalise()
+        let variable = try fileWriter.write(array: variableMeta, name: "data", children: [])
+        try fileWriter.writeTrailer(rootVariable: variable)
+
+        let read = try await OmFileReader(fn: inMemoryBackend).asArray(of: Int32.self)!
+        await #expect(try read.read() == data)
+        await #expect(try read.readConcurrent() == data)
+        await #expect(try read.read(range: [3..<9, 0..<30]) == Array(data[90..<270]))
+
+        // Target cube with a border row on top and bottom
+        var cube = [Int32](repeating: 0, count: 22 * 30)
+        try await read.read(into: &cube, range: [0..<20, 0..<30], intoCubeOffset: [1, 0], intoCubeDimension: [22, 30])
+        #expect(Array(cube[30..<630]) == data)
+        #expect(cube[0..<30].allSatisfy { $0 == 0 })
+        #expect(cube[630..<660].allSatisfy { $0 == 0 })
+    }
+
+    @Test func readInterpolatedBatch() async throws {
+        // 3x4 grid with 10 time steps as 2D [location, time] and 3D [y, x, time] files
+        let data = (0..<120).map { Float($0) * 0.5 }
+        let points = [
+            OmInterpolationPoint(dim0X: 0, dim0XFraction: 0.1, dim0Y: 0, dim0YFraction: 0.2),
+            OmInterpolationPoint(dim0X: 1, dim0XFraction: 0.5, dim0Y: 1, dim0YFraction: 0.5),
+            OmInterpolationPoint(dim0X: 2, dim0XFraction: 0.9, dim0Y: 0, dim0YFraction: 0.8),
+            OmInterpolationPoint(dim0X: 3, dim0XFraction: 0.3, dim0Y: 2, dim0YFraction: 0.7) // clamped to the border
+        ]
+        for dims in [[UInt64(12), 10], [UInt64(3), 4, 10]] {
+            let inMemoryBackend = DataAsClass(data: Data())
+            let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+            let chunks = dims.count == 2 ? [UInt64(5), 4] : [UInt64(2), 3, 4]
+            let writer = try fileWriter.prepareArray(type: Float.self, dimensions: dims, chunkDimensions: chunks, compression: .pfor_delta2d_int16, scale_factor: 20, add_offset: 0)
+            try writer.writeData(array: data)
+            let variableMeta = try writer.finalise()
+            let variable = try fileWriter.write(array: variableMeta, name: "data", children: [])
+            try fileWriter.writeTrailer(rootVariable: variable)
+
+            let read = try await OmFileReader(fn: inMemoryBackend).asArray(of: Float.self)!
+            for time in [0..<10, 1..<9, 3..<4] {
+                let batch = try await read.readInterpolated(points: points, dim0Nx: 4, dim1: time)
+                #expect(batch.count == points.count)
+                for (point, result) in zip(points, batch) {
+                    await #expect(try read.readInterpolated(dim0X: point.dim0X, dim0XFraction: point.dim0XFraction, dim0Y: point.dim0Y, dim0YFraction: point.dim0YFraction, dim0Nx: 4, dim1: time) == result)
+                }
+            }
+            await #expect(try read.readInterpolated(points: [], dim0Nx: 4, dim1: 0..<10) == [])
+        }
+    }
+
+    @Test func readUringFile() async throws {
+        let file = "readUringFile.om"
+        let fn = try FileHandle.createNewFile(file: file, overwrite: true)
+        defer { try? FileManager.default.removeItem(atPath: file) }
+
+        let fileWriter = OmFileWriter(fn: fn, initialCapacity: 8)
+        let writer = try fileWriter.prepareArray(type: Float.self, dimensions: [100,100,10], chunkDimensions: [2,2,2], compression: .pfor_delta2d_int16, scale_factor: 1, add_offset: 0)
+        let data = (0..<100000).map({Float($0 % 10000)})
+        try writer.writeData(array: data)
+        let variableMeta = try writer.finalise()
+        let variable = try fileWriter.write(array: variableMeta, name: "data", children: [])
+        try fileWriter.writeTrailer(rootVariable: variable)
+
+        // Small slots split batches and force reads into temporary memory
+        for slotSize in [4 * 1024 * 1024, 256] {
+            let readFn = try UringFile(fn: FileHandle.openFileReading(file: file), queueDepth: 8, slotSize: slotSize, slots: 2)
+            let read = try await OmFileReader(fn: readFn).asArray(of: Float.self, io_size_max: 4096, io_size_merge: 512)!
+            await #expect(try read.read(range: [50..<51, 20..<21, 1..<2]) == [201.0])
+            await #expect(try read.read() == data)
+            await #expect(try read.readConcurrent() == data)
+            await #expect(try read.readBatch(ranges: [[0..<2, 0..<2, 0..<10], [98..<100, 0..<100, 5..<6]]) == [
+                try read.read(range: [0..<2, 0..<2, 0..<10]),
+                try read.read(range: [98..<100, 0..<100, 5..<6])
+            ])
+        }
+    }
+
+    @Test func bufferPool() async throws {
+        let pool = OmBufferPool(maxBufferSize: 1024 * 1024, maxBuffersPerSize: 2)
+        // Sizes in the same size class reuse the same buffer
+        let first = pool.withBuffer(byteCount: 5000) { $0 }
+        let second = pool.withBuffer(byteCount: 8192) { $0 }
+        #expect(first == second)
+        #expect(pool.statistics.hits == 1)
+        #expect(pool.statistics.misses == 1)
+
+        // Memory of `Data` is returned to the pool once released
+        do {
+            var data = pool.data(count: 6000)
+            data[5999] = 1
+            #expect(data.count == 6000)
+        }
+        pool.withBuffer(byteCount: 7000) { _ in }
+        #expect(pool.statistics.hits == 3)
+        #expect(pool.statistics.misses == 1)
+
+        // Buffers above the limit are not pooled
+        pool.withBuffer(byteCount: 2 * 1024 * 1024) { _ in }
+        pool.withBuffer(byteCount: 2 * 1024 * 1024) { _ in }
+        #expect(pool.statistics.hits == 3)
+
+        // Reads with the pooled index data and scratch buffers
+        let file = "bufferPool.om"
+        let fn = try FileHandle.createNewFile(file: file, overwrite: true)
+        defer { try? FileManager.default.removeItem(atPath: file) }
+        let fileWriter = OmFileWriter(fn: fn, initialCapacity: 8)
+        let writer = try fileWriter.prepareArray(type: Float.self, dimensions: [100,100,10], chunkDimensions: [2,2,2], compression: .pfor_delta2d_int16, scale_factor: 1, add_offset: 0)
+        let values = (0..<100000).map({Float($0 % 10000)})
+        try writer.writeData(array: values)
+        let variableMeta = try writer.finalise()
+        let variable = try fileWriter.write(array: variableMeta, name: "data", children: [])
+        try fileWriter.writeTrailer(rootVariable: variable)
+        let read = try await OmFileReader(file: file).asArray(of: Float.self)!
+        for _ in 0..<3 {
+            await #expect(try read.read() == values)
+            await #expect(try read.readConcurrent() == values)
+        }
+    }
+
+    @Test func readStatistics() async throws {
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let writer = try fileWriter.prepareArray(type: Float.self, dimensions: [100,100,10], chunkDimensions: [2,2,2], compression: .pfor_delta2d_int16, scale_factor: 1, add_offset: 0)
+        let data = (0..<100000).map({Float($0 % 10000)})
+        try writer.writeData(array: data)
+        let variableMeta = try writer.finalise()
+        let variable = try fileWriter.write(array: variableMeta, name: "data", children: [])
+        try fileWriter.writeTrailer(rootVariable: variable)
+        let read = try await OmFileReader(fn: inMemoryBackend).asArray(of: Float.self)!
+
+        let stats = OmReadStatistics()
+        await #expect(try read.read(stats: stats) == data)
+        let full = stats.snapshot
+        #expect(full.chunksDecoded == 50 * 50 * 5)
+        #expect(full.chunksSkipped == 0)
+        #expect(full.uncompressedBytes == 400000)
+        #expect(full.indexReads > 0)
+        #expect(full.dataReads > 0)
+        #expect(full.dataBytes < full.uncompressedBytes)
+        #expect(full.decompressSeconds > 0)
+
+        // Only one element of the last dimension. Merged reads contain chunks outside the range.
+        stats.reset()
+        let slice = try await read.withStatistics(stats).readConcurrent(range: [0..<100, 0..<100, 0..<1])
+        #expect(slice == (0..<10000).map({ data[$0 * 10] }))
+        #expect(stats.snapshot.chunksDecoded == 50 * 50)
+        #expect(stats.snapshot.chunksSkipped > 0)
+    }
+
+    @Test func chunkAdvisor() async throws {
+        let dimensions: [UInt64] = [20, 20, 48]
+        let data = (0..<19200).map({ Float(($0 / 48) % 20) + sin(Float($0 % 48) / 8) * 10 })
+        let timeSeries = [[0, 0], [5, 17], [19, 3]].map({ OmChunkAdvisor.Query.timeSeries(at: $0, dimensions: dimensions) })
+        let fields = [0, 24, 47].map({ OmChunkAdvisor.Query.field(at: $0, dimensions: dimensions) })
+
+        let pointReport = try await OmChunkAdvisor.analyse(values: data, dimensions: dimensions, queries: timeSeries)
+        #expect(pointReport.candidates.count == OmChunkAdvisor.candidates(dimensions: dimensions).count)
+        #expect(pointReport.recommendation.chunks.last == 48)
+        #expect(pointReport.recommendation.queries.count == 3)
+
+        let fieldReport = try await OmChunkAdvisor.analyse(values: data, dimensions: dimensions, queries: fields)
+        #expect(fieldReport.recommendation.chunks.last == 1)
+
+        // Existing file with its current chunks as an additional candidate
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let writer = try fileWriter.prepareArray(type: Float.self, dimensions: dimensions, chunkDimensions: [3,3,3], compression: .pfor_delta2d_int16, scale_factor: 20, add_offset: 0)
+        try writer.writeData(array: data)
+        let variable = try fileWriter.write(array: try writer.finalise(), name: "data", children: [])
+        try fileWriter.writeTrailer(rootVariable: variable)
+        let read = try await OmFileReader(fn: inMemoryBackend).asArray(of: Float.self)!
+        let fileReport = try await read.analyseChunks(queries: timeSeries, candidates: [[1,8,48], [8,8,8]])
+        #expect(fileReport.candidates.map({ $0.chunks }).sorted(by: { $0.lexicographicallyPrecedes($1) }) == [[1,8,48], [3,3,3], [8,8,8]])
+        #expect(fileReport.recommendation.chunks == [1,8,48])
+
+        await #expect(throws: OmFileFormatSwiftError.self) {
+            try await OmChunkAdvisor.analyse(values: data, dimensions: dimensions, queries: [.init(name: "outside", range: [0..<21, 0..<1, 0..<1])])
+        }
+    }
+
+    @Test func readHttpRangeFile() async throws {
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let writer = try fileWriter.prepareArray(type: Float.self, dimensions: [100,100,10], chunkDimensions: [2,2,2], compression: .pfor_delta2d_int16, scale_factor: 1, add_offset: 0)
+        let data = (0..<100000).map({Float($0 % 10000)})
+        try writer.writeData(array: data)
+        let variableMeta = try writer.finalise()
+        let variable = try fileWriter.write(array: variableMeta, name: "data", children: [])
+        try fileWriter.writeTrailer(rootVariable: variable)
+        RangeURLProtocol.files["/readHttpRangeFile.om"] = inMemoryBackend.data
+
+        let configuration = URLSessionConfiguration.ephemeral
+        configuration.protocolClasses = [RangeURLProtocol.self]
+        let session = URLSession(configuration: configuration)
+        let url = URL(string: "omtest://localhost/readHttpRangeFile.om")!
+
+        // Trailer and root variable are fetched with a single request
+        let readFn = try await HttpRangeFile(url: url, session: session, tailSize: 8192)
+        #expect(readFn.count == inMemoryBackend.data.count)
+        let read = try await OmFileReader(fn: readFn).asArray(of: Float.self)!
+        #expect(RangeURLProtocol.requests(path: url.path) == 1)
+        await #expect(try read.read(range: [50..<51, 20..<21, 1..<2]) == [201.0])
+        // Index data is cached. The next point only requires the data request.
+        let requests = RangeURLProtocol.requests(path: url.path)
+        await #expect(try read.read(range: [50..<51, 22..<23, 1..<2]) == [221.0])
+        #expect(RangeURLProtocol.requests(path: url.path) == requests + 1)
+
+        await #expect(try read.read() == data)
+        await #expect(try read.readConcurrent() == data)
+
+        // Without coalescing and a short tail
+        let readFn2 = try await HttpRangeFile(url: url, session: session, tailSize: 64, coalesceGap: 0, maxConcurrentRequests: 2)
+        let read2 = try await OmFileReader(fn: readFn2).asArray(of: Float.self)!
+        await #expect(try read2.readConcurrent(range: [10..<20, 0..<100, 2..<5]) == read.read(range: [10..<20, 0..<100, 2..<5]))
+    }
+
+    @Test func readPlanCostModel() async throws {
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let writer = try fileWriter.prepareArray(type: Float.self, dimensions: [100,100,10], chunkDimensions: [2,2,2], compression: .pfor_delta2d_int16, scale_factor: 1, add_offset: 0)
+        let data = (0..<100000).map({Float($0 % 10000)})
+        try writer.writeData(array: data)
+        let variableMeta = try writer.finalise()
+        let variable = try fileWriter.write(array: variableMeta, name: "data", children: [])
+        try fileWriter.writeTrailer(rootVariable: variable)
+
+        let s3 = OmIoCostModel(latency: 0.03, bandwidth: 100_000_000, parallelism: 16)
+        #expect(s3.thresholds.io_size_merge == 187500)
+        #expect(s3.thresholds.io_size_max == 3000000)
+        let nvme = OmIoCostModel(latency: 0.0001, bandwidth: 500_000_000, parallelism: 64)
+        #expect(nvme.thresholds.io_size_merge == 781)
+        #expect(nvme.thresholds.io_size_max == 65536)
+
+        // A strided read with gaps between chunks
+        let range: [Range<UInt64>] = [0..<100, 10..<12, 0..<10]
+        let reader = try await OmFileReader(fn: inMemoryBackend)
+        let fixed = try reader.expectArray(of: Float.self, io_size_max: 65536, io_size_merge: 512)
+        let planned = try reader.expectArray(of: Float.self, io_size_max: s3.thresholds.io_size_max, io_size_merge: s3.thresholds.io_size_merge)
+        let fixedPlan = try await fixed.readPlan(range: range)
+        let plannedPlan = try await planned.readPlan(range: range)
+        #expect(plannedPlan.dataReads.count < fixedPlan.dataReads.count)
+        #expect(plannedPlan.estimate(model: s3) < fixedPlan.estimate(model: s3))
+        await #expect(try planned.read(range: range) == fixed.read(range: range))
+
+        // Plans cover the same bytes as the decoder reads
+        for read in plannedPlan.dataReads + plannedPlan.indexReads {
+            #expect(read.offset + read.count <= inMemoryBackend.count)
+        }
+    }
+
+    @Test func readPinnedLutAndLookahead() async throws {
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let writer = try fileWriter.prepareArray(type: Float.self, dimensions: [100,100,10], chunkDimensions: [2,2,2], compression: .pfor_delta2d_int16, scale_factor: 1, add_offset: 0)
+        let data = (0..<100000).map({Float($0 % 10000)})
+        try writer.writeData(array: data)
+        let variableMeta = try writer.finalise()
+        let variable = try fileWriter.write(array: variableMeta, name: "data", children: [])
+        try fileWriter.writeTrailer(rootVariable: variable)
+        RangeURLProtocol.files["/readPinnedLutAndLookahead.om"] = inMemoryBackend.data
+
+        let configuration = URLSessionConfiguration.ephemeral
+        configuration.protocolClasses = [RangeURLProtocol.self]
+        let session = URLSession(configuration: configuration)
+        let url = URL(string: "omtest://localhost/readPinnedLutAndLookahead.om")!
+
+        // With a pinned LUT, every read only requires a single data request
+        let readFn = try await HttpRangeFile(url: url, session: session, tailSize: 64)
+        let pinned = try await OmFileReader(fn: readFn).asArray(of: Float.self)!.pinLut()
+        var requests = RangeURLProtocol.requests(path: url.path)
+        await #expect(try pinned.read(range: [50..<51, 20..<21, 1..<2]) == [201.0])
+        #expect(RangeURLProtocol.requests(path: url.path) == requests + 1)
+        requests = RangeURLProtocol.requests(path: url.path)
+        await #expect(try pinned.read(range: [2..<3, 90..<91, 5..<6]) == [2905.0])
+        #expect(RangeURLProtocol.requests(path: url.path) == requests + 1)
+        await #expect(try pinned.read() == data)
+        await #expect(try pinned.readBatch(ranges: [[0..<2, 0..<2, 0..<10], [98..<100, 0..<100, 5..<6]]) == [
+            try pinned.read(range: [0..<2, 0..<2, 0..<10]),
+            try pinned.read(range: [98..<100, 0..<100, 5..<6])
+        ])
+
+        // Lookahead reads data before the LUT together with index data
+        let readFn2 = try await HttpRangeFile(url: url, session: session, tailSize: 64)
+        let lookahead = try await OmFileReader(fn: readFn2).asArray(of: Float.self)!.withLookahead(inMemoryBackend.count)
+        requests = RangeURLProtocol.requests(path: url.path)
+        await #expect(try lookahead.read(range: [50..<51, 20..<21, 1..<2]) == [201.0])
+        #expect(RangeURLProtocol.requests(path: url.path) == requests + 1)
+        await #expect(try lookahead.read() == data)
+        await #expect(try lookahead.readConcurrent() == data)
+    }
+
+    @Test func readMetadataSubtree() async throws {
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let writer = try fileWriter.prepareArray(type: Float.self, dimensions: [10,10], chunkDimensions: [5,5], compression: .pfor_delta2d_int16, scale_factor: 1, add_offset: 0)
+        let data = (0..<100).map({Float($0)})
+        try writer.writeData(array: data)
+        let variableMeta = try writer.finalise()
+        let unit = try fileWriter.write(value: Int32(7), name: "unit", children: [])
+        let array = try fileWriter.write(array: variableMeta, name: "data", children: [unit])
+        let attributes = try (0..<200).map({ try fileWriter.write(value: Int32($0), name: "attribute\($0)", children: []) })
+        let group = try fileWriter.write(value: Int32(42), name: "group", children: attributes)
+        let root = try fileWriter.write(value: Int32(43), name: "root", children: [array, group] + attributes)
+        try fileWriter.writeTrailer(rootVariable: root)
+        RangeURLProtocol.files["/readMetadataSubtree.om"] = inMemoryBackend.data
+
+        let configuration = URLSessionConfiguration.ephemeral
+        configuration.protocolClasses = [RangeURLProtocol.self]
+        let session = URLSession(configuration: configuration)
+        let url = URL(string: "omtest://localhost/readMetadataSubtree.om")!
+
+        // 200 attributes are resolved from a single read
+        let readFn = try await HttpRangeFile(url: url, session: session, tailSize: 64)
+        let file = try await OmFileReader(fn: readFn)
+        let groupFile = try await file.getChild(1)!
+        var requests = RangeURLProtocol.requests(path: url.path)
+        let groupSubtree = try await groupFile.readMetadataSubtree()
+        #expect(RangeURLProtocol.requests(path: url.path) == requests + 1)
+        for i in 0..<UInt32(200) {
+            await #expect(try groupSubtree.getChild(i)?.readScalar() == Int32(i))
+        }
+        #expect(RangeURLProtocol.requests(path: url.path) == requests + 1)
+
+        // The attribute of the array is stored before the array and requires one read to extend the range
+        requests = RangeURLProtocol.requests(path: url.path)
+        let subtree = try await file.readMetadataSubtree()
+        #expect(RangeURLProtocol.requests(path: url.path) == requests + 2)
+        #expect(subtree.numberOfChildren == 2 + 200)
+        requests = RangeURLProtocol.requests(path: url.path)
+        for i in 0..<UInt32(200) {
+            let child = try await subtree.getChild(i + 2)!
+            #expect(child.getName() == "attribute\(i)")
+            #expect(child.readScalar() == Int32(i))
+        }
+        await #expect(try subtree.getChild(name: "attribute199")?.readScalar() == Int32(199))
+
+        // Children of children are located before the parent and are resolved from the same buffer
+        let child = try await subtree.getChild(0)!
+        #expect(child.getName() == "data")
+        await #expect(try child.getChild(0)?.readScalar() == Int32(7))
+        #expect(RangeURLProtocol.requests(path: url.path) == requests)
+        await #expect(try child.asArray(of: Float.self)!.read() == data)
+        await #expect(try subtree.getChild(1)?.getName() == "group")
+        await #expect(try subtree.getChild(1)?.getChild(5)?.readScalar() == Int32(5))
+
+        // A limit on the buffer size reads children individually
+        let limited = try await file.readMetadataSubtree(maxBytes: 1024)
+        await #expect(try limited.getChild(2)?.readScalar() == Int32(0))
+    }
+
+    @Test func nameIndex() async throws {
+        for minimumChildren in [16, Int.max] {
+            let inMemoryBackend = DataAsClass(data: Data())
+            let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8, nameIndexMinimumChildren: minimumChildren)
+            let levels = try (0..<300).map({ try fileWriter.write(value: Int32($0), name: "level\($0)", children: []) })
+            let root = try fileWriter.writeNone(name: "root", children: levels)
+            try fileWriter.writeTrailer(rootVariable: root)
+            let path = "/nameIndex\(minimumChildren).om"
+            RangeURLProtocol.files[path] = inMemoryBackend.data
+
+            let configuration = URLSessionConfiguration.ephemeral
+            configuration.protocolClasses = [RangeURLProtocol.self]
+            let session = URLSession(configuration: configuration)
+            let url = URL(string: "omtest://localhost\(path)")!
+            let readFn = try await HttpRangeFile(url: url, session: session, tailSize: 64, coalesceGap: 0)
+            let file = try await OmFileReader(fn: readFn)
+            #expect(file.numberOfChildren == 300)
+            #expect(file.getName() == "root")
+
+            var requests = RangeURLProtocol.requests(path: url.path)
+            await #expect(try file.getChild(name: "level250")?.readScalar() == Int32(250))
+            await #expect(try file.getChild(name: "level0")?.readScalar() == Int32(0))
+            await #expect(try file.getChild(222)?.getName() == "level222")
+            if minimumChildren == 16 {
+                // Only the matching child is read
+                #expect(RangeURLProtocol.requests(path: url.path) == requests + 3)
+            } else {
+                #expect(RangeURLProtocol.requests(path: url.path) > requests + 250)
+            }
+            requests = RangeURLProtocol.requests(path: url.path)
+            await #expect(try file.getChild(name: "level300") == nil)
+            if minimumChildren == 16 {
+                #expect(RangeURLProtocol.requests(path: url.path) == requests)
+            }
+        }
+    }
+
+    @Test func reduce() async throws {
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let writer = try fileWriter.prepareArray(type: Float.self, dimensions: [10,10,48], chunkDimensions: [3,3,10], compression: .pfor_delta2d_int16, scale_factor: 10, add_offset: 0)
+        let data = (0..<4800).map({ $0 % 31 == 0 ? .nan : Float($0 % 97) / 10 })
+        try writer.writeData(array: data)
+        let variable = try fileWriter.write(array: try writer.finalise(), name: "data", children: [])
+        try fileWriter.writeTrailer(rootVariable: variable)
+        let read = try await OmFileReader(fn: inMemoryBackend).asArray(of: Float.self)!
+
+        // Daily values of a hourly time series
+        let range: [Range<UInt64>] = [2..<7, 1..<10, 0..<48]
+        let values = try await read.read(range: range)
+        let daily = try await read.reduce(range: range, group: [1, 1, 24], reductions: [.min, .max, .sum, .mean, .count])
+        #expect(daily.count == 5)
+        #expect(daily[0].count == 5 * 9 * 2)
+        for cell in 0..<(5 * 9 * 2) {
+            let day = values[cell * 24 ..< cell * 24 + 24].filter({ !$0.isNaN })
+            #expect(daily[0][cell] == day.min())
+            #expect(daily[1][cell] == day.max())
+            #expect(abs(daily[2][cell] - day.reduce(0, +)) < 0.001)
+            #expect(abs(daily[3][cell] - day.reduce(0, +) / Float(day.count)) < 0.001)
+            #expect(daily[4][cell] == Float(day.count))
+        }
+
+        // Spatial mean of a single timestep
+        let field = try await read.reduce(range: [0..<10, 0..<10, 5..<6], group: [10, 10, 1], reduction: .mean)
+        let fieldValues = try await read.read(range: [0..<10, 0..<10, 5..<6]).filter({ !$0.isNaN })
+        #expect(field.count == 1)
+        #expect(abs(field[0] - fieldValues.reduce(0, +) / Float(fieldValues.count)) < 0.001)
+
+        // Only NaN values
+        let nan = try await read.reduce(range: [0..<1, 0..<1, 0..<1], group: [1, 1, 1], reductions: [.mean, .count])
+        #expect(nan[0][0].isNaN)
+        #expect(nan[1][0] == 0)
+
+        await #expect(throws: OmFileFormatSwiftError.self) {
+            try await read.reduce(group: [1, 0, 1], reduction: .sum)
+        }
+    }
+
+    @Test func chunkStatistics() async throws {
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let writer = try fileWriter.prepareArray(type: Float.self, dimensions: [6,20], chunkDimensions: [2,5], compression: .pfor_delta2d_int16, scale_factor: 10, add_offset: 0, chunkStatistics: true)
+        // Precipitation only in the first row and columns 10..<15
+        let data = (0..<120).map({ $0 / 20 == 0 && ($0 % 20) / 5 == 2 ? Float($0 % 20) : 0 })
+        try writer.writeDataConcurrent(array: data, concurrency: 2)
+        let variable = try fileWriter.write(array: try writer.finalise(), name: "precipitation", children: [])
+        try fileWriter.writeTrailer(rootVariable: variable)
+        let read = try await OmFileReader(fn: inMemoryBackend).asArray(of: Float.self)!
+        #expect(read.hasChunkStatistics)
+
+        let stats = try await read.readChunkStatistics()!
+        #expect(stats.count == 12)
+        #expect(stats[2].min == 0)
+        #expect(stats[2].max == 14)
+        #expect(stats[2].nanCount == 0)
+        #expect(stats[3].max == 0)
+
+        let filtered = try await read.read(range: [0..<6, 3..<18], where: .greaterThan(10), fill: -1)
+        let expected = try await read.read(range: [0..<6, 3..<18])
+        #expect(filtered.count == 6 * 15)
+        for (i, value) in filtered.enumerated() {
+            let x = i % 15 + 3
+            let y = i / 15
+            #expect(value == (y < 2 && x >= 10 && x < 15 ? expected[i] : -1))
+        }
+
+        // Without matching chunks nothing is read
+        let none = try await read.read(where: .greaterThan(100))
+        #expect(none.allSatisfy({ $0.isNaN }))
+
+        // Arrays without statistics are read entirely
+        let plainBackend = DataAsClass(data: Data())
+        let plainWriter = OmFileWriter(fn: plainBackend, initialCapacity: 8)
+        let plainArray = try plainWriter.writeArray(data: data, dimensions: [6,20], chunkDimensions: [2,5], compression: .pfor_delta2d_int16, scale_factor: 10, add_offset: 0)
+        try plainWriter.writeTrailer(rootVariable: try plainWriter.write(array: plainArray, name: "precipitation", children: []))
+        let plain = try await OmFileReader(fn: plainBackend).asArray(of: Float.self)!
+        #expect(!plain.hasChunkStatistics)
+        await #expect(try plain.readChunkStatistics() == nil)
+        await #expect(try plain.read(where: .greaterThan(10)) == data)
+    }
+
+    @Test func overviews() async throws {
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let dimensions: [UInt64] = [36, 70]
+        let data = (0..<(36*70)).map({ $0 % 70 == 3 ? .nan : Float($0 / 70 + $0 % 70) })
+        let overviews = try fileWriter.writeOverviews(data: data, dimensions: dimensions, chunkDimensions: [8, 8], compression: .fpx_xor2d, scale_factor: 1, add_offset: 0, downsample: [0, 1], minimumSize: 10)
+        #expect(overviews.count == 3)
+        let array = try fileWriter.writeArray(data: data, dimensions: dimensions, chunkDimensions: [8, 8], compression: .fpx_xor2d, scale_factor: 1, add_offset: 0)
+        let variable = try fileWriter.write(array: array, name: "temperature", children: overviews)
+        try fileWriter.writeTrailer(rootVariable: variable)
+
+        let read = try await OmFileReader(fn: inMemoryBackend)
+        let levels = try await read.getOverviews(of: Float.self)
+        #expect(levels.map({ $0.getDimensions() }) == [[18, 35], [9, 18], [5, 9]])
+
+        // First level is the mean of 2x2 blocks without NaN
+        let level1 = try await levels[0].read()
+        #expect(level1[0] == (data[0] + data[1] + data[70] + data[71]) / 4)
+        #expect(level1[1] == (data[2] + data[72]) / 2)
+
+        // Coarser levels are computed from the full resolution
+        let level2 = try await levels[1].read()
+        let block = (0..<4).flatMap({ y in (0..<4).map({ x in data[y * 70 + x] }) }).filter({ !$0.isNaN })
+        #expect(abs(level2[0] - block.reduce(0, +) / Float(block.count)) < 0.0001)
+
+        // 8x8 output of the entire field is served by the second level
+        let selected = try await read.overview(of: Float.self, outputDimensions: [8, 8])!
+        #expect(selected.array.getDimensions() == [9, 18])
+        #expect(selected.range == [0..<9, 0..<18])
+
+        // A small region at high resolution falls back to the full array
+        let detail = try await read.overview(of: Float.self, range: [10..<20, 10..<20], outputDimensions: [10, 10])!
+        #expect(detail.array.getDimensions() == dimensions)
+        #expect(detail.range == [10..<20, 10..<20])
+        let half = try await read.overview(of: Float.self, range: [10..<20, 10..<20], outputDimensions: [5, 5])!
+        #expect(half.array.getDimensions() == [18, 35])
+        #expect(half.range == [5..<10, 5..<10])
+    }
+
+    @Test func append() async throws {
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let data = (0..<20).map({ Float($0) })
+        let array = try fileWriter.writeArray(data: data, dimensions: [5, 4], chunkDimensions: [2, 2], compression: .pfor_delta2d_int16, scale_factor: 1, add_offset: 0)
+        // Stored after the data and copied while appending
+        let unit = try fileWriter.write(value: Int32(42), name: "unit", children: [])
+        let variable = try fileWriter.write(array: array, name: "data", children: [unit])
+        try fileWriter.writeTrailer(rootVariable: variable)
+
+        let append = try await OmFileReader(fn: inMemoryBackend).prepareAppend(of: Float.self)
+        // Chunks of the first 4 rows are kept
+        #expect(append.truncateOffset < Int(array.lutOffset))
+        inMemoryBackend.data = Data(inMemoryBackend.data.prefix(append.truncateOffset))
+        let appendWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8, offset: append.truncateOffset)
+        let newData = (20..<32).map({ Float($0) })
+        try append.write(data: newData, writer: appendWriter)
+
+        let read = try await OmFileReader(fn: inMemoryBackend)
+        #expect(read.getName() == "data")
+        let readArray = try read.expectArray(of: Float.self)
+        #expect(readArray.getDimensions() == [8, 4])
+        await #expect(try readArray.read() == data + newData)
+        let child = try await read.getChild(0)!
+        #expect(child.readScalar() == Int32(42))
+    }
+
+    @Test func virtualArray() async throws {
+        // Three files with 4, 3 and 5 time steps of 5 locations
+        var backends = [DataAsClass]()
+        for (start, length) in [(0, 4), (4, 3), (7, 5)] {
+            let inMemoryBackend = DataAsClass(data: Data())
+            let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+            let data = (start * 5 ..< (start + length) * 5).map({ Float($0) })
+            let array = try fileWriter.writeArray(data: data, dimensions: [UInt64(length), 5], chunkDimensions: [2, 2], compression: .pfor_delta2d_int16, scale_factor: 1, add_offset: 0)
+            let variable = try fileWriter.write(array: array, name: "data", children: [])
+            try fileWriter.writeTrailer(rootVariable: variable)
+            backends.append(inMemoryBackend)
+        }
+        let virtual = try await OmFileVirtualArray<DataAsClass, Float>.open(backends, dimension: 0)
+        #expect(virtual.getDimensions() == [12, 5])
+        let all = (0..<60).map({ Float($0) })
+        await #expect(try virtual.read() == all)
+
+        // Spans all files
+        let read = try await virtual.read(range: [2..<10, 1..<4])
+        #expect(read == (2..<10).flatMap({ t in (1..<4).map({ all[t * 5 + $0] }) }))
+
+        // Point time series inside a larger cube
+        var cube = [Float](repeating: .nan, count: 2 * 12)
+        try await virtual.read(into: &cube, range: [0..<12, 3..<4], intoCubeOffset: [0, 1], intoCubeDimension: [12, 2])
+        #expect(cube.enumerated().filter({ $0.offset % 2 == 1 }).map({ $0.element }) == (0..<12).map({ all[$0 * 5 + 3] }))
+        #expect(cube.enumerated().filter({ $0.offset % 2 == 0 }).allSatisfy({ $0.element.isNaN }))
+    }
+
+    @Test func halfFloatOutput() async throws {
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        // Multiples of 0.5 are exact in float16 and bfloat16
+        var data = (0..<20).map({ Float($0) * 0.5 - 3 })
+        data[7] = .nan
+        let array = try fileWriter.writeArray(data: data, dimensions: [4, 5], chunkDimensions: [2, 2], compression: .pfor_delta2d_int16, scale_factor: 20, add_offset: 0)
+        let variable = try fileWriter.write(array: array, name: "data", children: [])
+        try fileWriter.writeTrailer(rootVariable: variable)
+
+        let read = try await OmFileReader(fn: inMemoryBackend).expectArray(of: Float.self)
+        let bfloat16 = try await read.read(outputType: .bfloat16)
+        #expect(bfloat16.enumerated().filter({ $0.offset != 7 }).map({ $0.element }) == data.enumerated().filter({ $0.offset != 7 }).map({ UInt16($0.element.bitPattern >> 16) }))
+        #expect(bfloat16[7] & 0x7F80 == 0x7F80)
+
+        let float16 = try await read.read(range: [0..<2, 1..<3], outputType: .float16)
+        // -2.5, -2, 0, NaN
+        #expect(float16[0] == 0xC100)
+        #expect(float16[1] == 0xC000)
+        #expect(float16[2] == 0x0000)
+        #expect(float16[3] & 0x7C00 == 0x7C00 && float16[3] & 0x3FF != 0)
+    }
+
+    @Test func floatLinear2d() async throws {
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        var data = (0..<(10 * 7 * 3)).map({ 280 + sin(Float($0) / 9) * 12 + Float($0 % 7) * 0.01 })
+        data[5] = .nan
+        data[17] = -.infinity
+        data[40] = -0
+        data[41] = .leastNonzeroMagnitude
+        let doubles = data.map(Double.init)
+        let array = try fileWriter.writeArray(data: data, dimensions: [10, 7, 3], chunkDimensions: [4, 3, 2], compression: .pfor_float_linear2d, scale_factor: 1, add_offset: 0)
+        let variable = try fileWriter.write(array: array, name: "float", children: [])
+        let arrayDouble = try fileWriter.writeArray(data: doubles, dimensions: [10, 7, 3], chunkDimensions: [4, 3, 2], compression: .pfor_float_linear2d, scale_factor: 1, add_offset: 0)
+        let variableDouble = try fileWriter.write(array: arrayDouble, name: "double", children: [])
+        let root = try fileWriter.write(value: Int32(0), name: "root", children: [variable, variableDouble])
+        try fileWriter.writeTrailer(rootVariable: root)
+
+        let read = try await OmFileReader(fn: inMemoryBackend)
+        let float = try await read.getChild(0)!.expectArray(of: Float.self)
+        #expect(float.compression == .pfor_float_linear2d)
+        // Lossless, including NaN, infinity, negative zero and subnormals
+        #expect(try await float.read().map({ $0.bitPattern }) == data.map({ $0.bitPattern }))
+        let subset = try await float.read(range: [3..<9, 1..<5, 1..<3])
+        #expect(subset[0] == data[3 * 21 + 1 * 3 + 1])
+        #expect(subset[23] == data[4 * 21 + 4 * 3 + 2])
+        let double = try await read.getChild(1)!.expectArray(of: Double.self)
+        #expect(try await double.read().map({ $0.bitPattern }) == doubles.map({ $0.bitPattern }))
+
+        // Integer arrays are not supported
+        #expect(throws: OmFileFormatSwiftError.self) {
+            _ = try fileWriter.prepareArray(type: Int32.self, dimensions: [4], chunkDimensions: [2], compression: .pfor_float_linear2d, scale_factor: 1, add_offset: 0)
+        }
+    }
+
+    @Test func adaptiveChunks() async throws {
+        // Rows 0-3 zero, 4-7 NaN, 8-11 smooth
+        let data = (0..<(12 * 10)).map({ i -> Float in
+            let row = i / 10
+            return row < 4 ? 0 : row < 8 ? .nan : Float(i % 10) * 0.5 + Float(row)
+        })
+        let plainBackend = DataAsClass(data: Data())
+        let plainWriter = OmFileWriter(fn: plainBackend, initialCapacity: 8)
+        let plain = try plainWriter.writeArray(data: data, dimensions: [12, 10], chunkDimensions: [4, 5], compression: .pfor_delta2d_int16, scale_factor: 20, add_offset: 0)
+        try plainWriter.writeTrailer(rootVariable: try plainWriter.write(array: plain, name: "data", children: []))
+
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let writer = try fileWriter.prepareArray(type: Float.self, dimensions: [12, 10], chunkDimensions: [4, 5], compression: .pfor_delta2d_int16, scale_factor: 20, add_offset: 0, adaptive: true)
+        try writer.writeData(array: data)
+        let adaptive = try writer.finalise()
+        try fileWriter.writeTrailer(rootVariable: try fileWriter.write(array: adaptive, name: "data", children: []))
+        /// Constant chunks need only a codec byte and one value. Compressed data ends at the LUT.
+        #expect(adaptive.lutOffset < plain.lutOffset)
+
+        let read = try await OmFileReader(fn: inMemoryBackend).expectArray(of: Float.self)
+        let plainRead = try await OmFileReader(fn: plainBackend).expectArray(of: Float.self)
+        #expect(read.isAdaptive)
+        #expect(!plainRead.isAdaptive)
+        #expect(read.compression == .pfor_delta2d_int16)
+        let expected = try await plainRead.read()
+        let values = try await read.read()
+        #expect(values.map({ $0.bitPattern }) == expected.map({ $0.bitPattern }))
+        let subset = try await read.read(range: [3..<9, 2..<7])
+        #expect(subset[0] == 0)
+        #expect(subset[5].isNaN)
+        #expect(subset[25] == expected[8 * 10 + 2])
+
+        /// 2 zero and 2 NaN chunks are filled without decompression
+        let stats = OmReadStatistics()
+        _ = try await read.withStatistics(stats).read()
+        #expect(stats.snapshot.chunksConstant == 4)
+        #expect(stats.snapshot.chunksDecoded == 6)
+    }
+
+    @Test func scheduledConcurrentRead() async throws {
+        let data = (0..<(100 * 100)).map({ Float($0 % 97) * 0.25 })
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let writer = try fileWriter.writeArray(data: data, dimensions: [100, 100], chunkDimensions: [10, 10], compression: .pfor_delta2d_int16, scale_factor: 4, add_offset: 0)
+        try fileWriter.writeTrailer(rootVariable: try fileWriter.write(array: writer, name: "data", children: []))
+
+        /// Not merging reads results in one read per chunk
+        let read = try await OmFileReader(fn: inMemoryBackend).asArray(of: Float.self, io_size_max: 0, io_size_merge: 0)!
+        let stats = OmReadStatistics()
+        /// One read and one decode at a time. Reads larger than the buffer limit still progress one after the other.
+        let serial = read.withScheduler(OmDecodeScheduler(maxConcurrentReads: 1, maxConcurrentDecodes: 1, maxBufferedBytes: 1)).withStatistics(stats)
+        await #expect(try serial.readConcurrent() == data)
+        #expect(stats.snapshot.chunksDecoded == 100)
+        #expect(stats.snapshot.dataReads == 100)
+
+        let wide = read.withScheduler(OmDecodeScheduler(maxConcurrentReads: 8, maxConcurrentDecodes: 3, maxBufferedBytes: 4096))
+        await #expect(try wide.readConcurrent() == data)
+        await #expect(try wide.readConcurrent(range: [15..<37, 3..<91]) == read.read(range: [15..<37, 3..<91]))
+    }
+
+    @Test func scheduledReadKeepsBackendBatches() async throws {
+        let data = (0..<(100 * 100)).map({ Float($0 % 97) * 0.25 })
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let writer = try fileWriter.writeArray(data: data, dimensions: [100, 100], chunkDimensions: [10, 10], compression: .pfor_delta2d_int16, scale_factor: 4, add_offset: 0)
+        try fileWriter.writeTrailer(rootVariable: try fileWriter.write(array: writer, name: "data", children: []))
+
+        /// Without a scheduler, all data reads of an index block are one batch
+        let plainBackend = BatchRecordingBackend(backend: inMemoryBackend)
+        let plain = try await OmFileReader(fn: plainBackend).asArray(of: Float.self, io_size_max: 0, io_size_merge: 0)!
+        await #expect(try plain.readConcurrent() == data)
+        #expect(plainBackend.batches.reduce(0, +) == 100)
+        #expect(plainBackend.batches.max()! > 8)
+
+        /// The scheduler passes windows of up to 8 reads to the backend instead of single reads
+        let scheduledBackend = BatchRecordingBackend(backend: inMemoryBackend)
+        let scheduled = try await OmFileReader(fn: scheduledBackend).asArray(of: Float.self, io_size_max: 0, io_size_merge: 0)!
+            .withScheduler(OmDecodeScheduler(maxConcurrentReads: 8, maxConcurrentDecodes: 2))
+        await #expect(try scheduled.readConcurrent() == data)
+        #expect(scheduledBackend.batches.reduce(0, +) == 100)
+        #expect(scheduledBackend.batches.max() == 8)
+
+        /// Decode workers run alongside a backend with serial callbacks
+        let serialBackend = BatchRecordingBackend(backend: inMemoryBackend, serialCallbacks: true)
+        let serial = try await OmFileReader(fn: serialBackend).asArray(of: Float.self, io_size_max: 0, io_size_merge: 0)!
+            .withScheduler(OmDecodeScheduler(maxConcurrentReads: 8, maxConcurrentDecodes: 4, maxBufferedBytes: 4096))
+        await #expect(try serial.readConcurrent() == data)
+        await #expect(try serial.readConcurrent(range: [15..<37, 3..<91]) == plain.read(range: [15..<37, 3..<91]))
+        #expect(serialBackend.batches.max() == 8)
+    }
+
+    @Test func offsetWriteAtArrayEnd() async throws {
+        /// The written region ends at the last element of the source array. 2 dimensions use nested copy loops, 4 dimensions the generic loop.
+        for dimensions in [[UInt64(5), 7], [3, 2, 4, 5]] {
+            let arrayDimensions = dimensions.map({ $0 + 1 })
+            let arrayOffset = dimensions.map({ _ in UInt64(1) })
+            let source = (0..<Int(arrayDimensions.reduce(1, *))).map({ Float($0) })
+            let inMemoryBackend = DataAsClass(data: Data())
+            let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+            let writer = try fileWriter.prepareArray(type: Float.self, dimensions: dimensions, chunkDimensions: dimensions.map({ ($0 + 1) / 2 }), compression: .pfor_delta2d, scale_factor: 1, add_offset: 0)
+            try writer.writeData(array: source, arrayDimensions: arrayDimensions, arrayOffset: arrayOffset, arrayCount: dimensions)
+            try fileWriter.writeTrailer(rootVariable: try fileWriter.write(array: try writer.finalise(), name: "data", children: []))
+
+            /// Elements of `source` without the first row of each dimension
+            let expected = (0..<Int(dimensions.reduce(1, *))).map { i -> Float in
+                var rest = i
+                var index = 0
+                var stride = 1
+                for d in dimensions.indices.reversed() {
+                    index += (rest % Int(dimensions[d]) + 1) * stride
+                    rest /= Int(dimensions[d])
+                    stride *= Int(arrayDimensions[d])
+                }
+                return source[index]
+            }
+            let read = try await OmFileReader(fn: inMemoryBackend).expectArray(of: Float.self)
+            await #expect(try read.read() == expected)
+        }
+    }
+
+    @Test func packedLut() async throws {
+        let data = (0..<(100 * 100)).map({ Float($0 % 97) * 0.25 })
+        let plainBackend = DataAsClass(data: Data())
+        let plainWriter = OmFileWriter(fn: plainBackend, initialCapacity: 8)
+        let plain = try plainWriter.writeArray(data: data, dimensions: [100, 100], chunkDimensions: [5, 5], compression: .pfor_delta2d_int16, scale_factor: 4, add_offset: 0)
+        try plainWriter.writeTrailer(rootVariable: try plainWriter.write(array: plain, name: "data", children: []))
+
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let writer = try fileWriter.prepareArray(type: Float.self, dimensions: [100, 100], chunkDimensions: [5, 5], compression: .pfor_delta2d_int16, scale_factor: 4, add_offset: 0, packedLut: true)
+        try writer.writeData(array: data)
+        let packed = try writer.finalise()
+        try fileWriter.writeTrailer(rootVariable: try fileWriter.write(array: packed, name: "data", children: []))
+        #expect(packed.lutOffset == plain.lutOffset)
+
+        let read = try await OmFileReader(fn: inMemoryBackend).expectArray(of: Float.self)
+        let plainRead = try await OmFileReader(fn: plainBackend).expectArray(of: Float.self)
+        #expect(read.isLutPacked)
+        #expect(!plainRead.isLutPacked)
+        #expect(read.compression == .pfor_delta2d_int16)
+        #expect(try await read.read() == data)
+        #expect(try await read.read(range: [17..<83, 3..<98]) == plainRead.read(range: [17..<83, 3..<98]))
+
+        /// Chunk offsets are read from the LUT without decompressing LUT chunks
+        let stats = OmReadStatistics()
+        #expect(try await read.withStatistics(stats).read(range: [57..<58, 91..<92]) == [data[57 * 100 + 91]])
+        #expect(stats.snapshot.lutChunksDecompressed == 0)
+        #expect(stats.snapshot.chunksDecoded == 1)
+    }
+
+    @Test func stridedWriteAndRead() async throws {
+        let data = (0..<(20 * 30)).map({ Float($0 % 53) * 0.5 })
+        let denseBackend = DataAsClass(data: Data())
+        let denseWriter = OmFileWriter(fn: denseBackend, initialCapacity: 8)
+        let dense = try denseWriter.writeArray(data: data, dimensions: [20, 30], chunkDimensions: [6, 7], compression: .pfor_delta2d_int16, scale_factor: 2, add_offset: 0)
+        try denseWriter.writeTrailer(rootVariable: try denseWriter.write(array: dense, name: "data", children: []))
+
+        /// Rows stored south to north with 2 elements of padding
+        var flipped = [Float](repeating: .nan, count: 20 * 32)
+        for y in 0..<20 {
+            for x in 0..<30 {
+                flipped[(19 - y) * 32 + x] = data[y * 30 + x]
+            }
+        }
+        let rowBytes = 32 * MemoryLayout<Float>.stride
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let writer = try fileWriter.prepareArray(type: Float.self, dimensions: [20, 30], chunkDimensions: [6, 7], compression: .pfor_delta2d_int16, scale_factor: 2, add_offset: 0)
+        try flipped.withUnsafeBufferPointer {
+            try writer.writeData(pointer: $0.baseAddress!.advanced(by: 19 * 32), byteStrides: [-rowBytes, MemoryLayout<Float>.stride])
+        }
+        let strided = try writer.finalise()
+        try fileWriter.writeTrailer(rootVariable: try fileWriter.write(array: strided, name: "data", children: []))
+        #expect(inMemoryBackend.data == denseBackend.data)
+
+        /// Read a transposed subset
+        let read = try await OmFileReader(fn: inMemoryBackend).expectArray(of: Float.self)
+        var transposed = [Float](repeating: 0, count: 10 * 5)
+        try await read.read(into: &transposed, range: [3..<8, 11..<21], byteStrides: [MemoryLayout<Float>.stride, 5 * MemoryLayout<Float>.stride])
+        #expect(transposed[0] == data[3 * 30 + 11])
+        #expect(transposed[1] == data[4 * 30 + 11])
+        #expect(transposed[5] == data[3 * 30 + 12])
+        #expect(transposed[49] == data[7 * 30 + 20])
+    }
+
+    @Test func rechunkTimeSeries() async throws {
+        /// Source with one chunk per timestep
+        let data = (0..<(6 * 10 * 8)).map({ Float($0 % 37) * 0.5 })
+        let sourceBackend = DataAsClass(data: Data())
+        let sourceWriter = OmFileWriter(fn: sourceBackend, initialCapacity: 8)
+        let source = try sourceWriter.writeArray(data: data, dimensions: [6, 10, 8], chunkDimensions: [1, 10, 8], compression: .pfor_delta2d_int16, scale_factor: 2, add_offset: 0)
+        try sourceWriter.writeTrailer(rootVariable: try sourceWriter.write(array: source, name: "data", children: []))
+
+        /// Time series with time as the fastest dimension
+        var transposed = [Float](repeating: 0, count: data.count)
+        for t in 0..<6 {
+            for y in 0..<10 {
+                for x in 0..<8 {
+                    transposed[(y * 8 + x) * 6 + t] = data[(t * 10 + y) * 8 + x]
+                }
+            }
+        }
+        let expectedBackend = DataAsClass(data: Data())
+        let expectedWriter = OmFileWriter(fn: expectedBackend, initialCapacity: 8)
+        let expected = try expectedWriter.writeArray(data: transposed, dimensions: [10, 8, 6], chunkDimensions: [3, 3, 6], compression: .pfor_delta2d_int16, scale_factor: 2, add_offset: 0)
+        try expectedWriter.writeTrailer(rootVariable: try expectedWriter.write(array: expected, name: "data", children: []))
+
+        let reader = try await OmFileReader(fn: sourceBackend).expectArray(of: Float.self)
+        /// Budgets for one chunk, part of a chunk row and everything
+        for memoryBudget in [3 * 3 * 6 * 4, 3 * 8 * 6 * 4 + 1, 1 << 20] {
+            let inMemoryBackend = DataAsClass(data: Data())
+            let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+            let writer = try fileWriter.prepareArray(type: Float.self, dimensions: [10, 8, 6], chunkDimensions: [3, 3, 6], compression: .pfor_delta2d_int16, scale_factor: 2, add_offset: 0)
+            try await writer.writeData(rechunking: reader, permutation: [1, 2, 0], memoryBudget: memoryBudget, concurrency: 2)
+            try fileWriter.writeTrailer(rootVariable: try fileWriter.write(array: try writer.finalise(), name: "data", children: []))
+            #expect(inMemoryBackend.data == expectedBackend.data)
+        }
+    }
+
+    @Test func copyChunksOfSubset() async throws {
+        let data = (0..<(20 * 30)).map({ Float($0 % 41) * 0.5 })
+        let sourceBackend = DataAsClass(data: Data())
+        let sourceWriter = OmFileWriter(fn: sourceBackend, initialCapacity: 8)
+        let sourceArray = try sourceWriter.writeArray(data: data, dimensions: [20, 30], chunkDimensions: [6, 7], compression: .pfor_delta2d_int16, scale_factor: 2, add_offset: 0)
+        try sourceWriter.writeTrailer(rootVariable: try sourceWriter.write(array: sourceArray, name: "data", children: []))
+        let source = try await OmFileReader(fn: sourceBackend).expectArray(of: Float.self)
+
+        /// The subset ends at the end of the source in the last dimension and inside a chunk in the first dimension
+        let range: [Range<UInt64>] = [6..<15, 7..<30]
+        let subset = try await source.read(range: range)
+        let expectedBackend = DataAsClass(data: Data())
+        let expectedWriter = OmFileWriter(fn: expectedBackend, initialCapacity: 8)
+        let expected = try expectedWriter.writeArray(data: subset, dimensions: [9, 23], chunkDimensions: [6, 7], compression: .pfor_delta2d_int16, scale_factor: 2, add_offset: 0)
+        try expectedWriter.writeTrailer(rootVariable: try expectedWriter.write(array: expected, name: "data", children: []))
+
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let writer = try fileWriter.prepareArray(type: Float.self, dimensions: [9, 23], chunkDimensions: [6, 7], compression: .pfor_delta2d_int16, scale_factor: 2, add_offset: 0)
+        /// 4 chunks of the first chunk row are copied. The second row is only partially covered.
+        #expect(try await writer.writeData(copying: source, range: range, maxCopyBytes: 100) == 4)
+        try fileWriter.writeTrailer(rootVariable: try fileWriter.write(array: try writer.finalise(), name: "data", children: []))
+        #expect(inMemoryBackend.data == expectedBackend.data)
+
+        /// Different scale factors require a new compression
+        let scaledWriter = try OmFileWriter(fn: DataAsClass(data: Data()), initialCapacity: 8).prepareArray(type: Float.self, dimensions: [9, 23], chunkDimensions: [6, 7], compression: .pfor_delta2d_int16, scale_factor: 4, add_offset: 0)
+        #expect(try await scaledWriter.writeData(copying: source, range: range) == 0)
+    }
+
+    @Test func writeBehind() async throws {
+        let data = (0..<(40 * 50)).map({ Float($0 % 97) * 0.25 })
+        func write(writeBehindBuffers: Int, alignment: Int) throws -> Data {
+            let inMemoryBackend = DataAsClass(data: Data())
+            let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 64, writeBehindBuffers: writeBehindBuffers, alignment: alignment)
+            let writer = try fileWriter.prepareArray(type: Float.self, dimensions: [40, 50], chunkDimensions: [5, 7], compression: .pfor_delta2d_int16, scale_factor: 4, add_offset: 0)
+            try writer.writeData(array: data)
+            try fileWriter.writeTrailer(rootVariable: try fileWriter.write(array: try writer.finalise(), name: "data", children: []))
+            return inMemoryBackend.data
+        }
+        let expected = try write(writeBehindBuffers: 0, alignment: 1)
+        #expect(try write(writeBehindBuffers: 2, alignment: 1) == expected)
+        #expect(try write(writeBehindBuffers: 4, alignment: 4096) == expected)
+
+        let read = try await OmFileReader(fn: DataAsClass(data: try write(writeBehindBuffers: 3, alignment: 4096))).expectArray(of: Float.self)
+        #expect(try await read.read() == data)
+    }
+
+    @Test func spilledArraysConcurrent() async throws {
+        let variables = (0..<3).map({ v in (0..<(30 * 20)).map({ Float(($0 * (v + 1)) % 53) }) })
+
+        /// Variables written one after another
+        let expectedBackend = DataAsClass(data: Data())
+        let expectedWriter = OmFileWriter(fn: expectedBackend, initialCapacity: 8)
+        let expectedChildren = try variables.enumerated().map { (v, data) in
+            let array = try expectedWriter.writeArray(data: data, dimensions: [30, 20], chunkDimensions: [7, 6], compression: .pfor_delta2d_int16, scale_factor: 1, add_offset: 0)
+            return try expectedWriter.write(array: array, name: "var\(v)", children: [])
+        }
+        try expectedWriter.writeTrailer(rootVariable: try expectedWriter.writeNone(name: "", children: expectedChildren))
+
+        /// All variables are compressed at the same time and added to the file afterwards
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let spilled = try variables.map({ _ in
+            try fileWriter.prepareSpilledArray(type: Float.self, dimensions: [30, 20], chunkDimensions: [7, 6], compression: .pfor_delta2d_int16, scale_factor: 1, add_offset: 0, initialCapacity: 64)
+        })
+        DispatchQueue.concurrentPerform(iterations: variables.count) { v in
+            try! spilled[v].writeData(array: variables[v])
+        }
+        let children = try spilled.enumerated().map { (v, array) in
+            try fileWriter.write(array: try fileWriter.write(spilled: array), name: "var\(v)", children: [])
+        }
+        try fileWriter.writeTrailer(rootVariable: try fileWriter.writeNone(name: "", children: children))
+        #expect(inMemoryBackend.data == expectedBackend.data)
+
+        let read = try await OmFileReader(fn: inMemoryBackend)
+        #expect(try await read.getChild(1)!.expectArray(of: Float.self).read() == variables[1])
+    }
+
+    @Test func mmapPopulateAndPinLut() async throws {
+        let file = "mmapPopulateAndPinLut.om"
+        let fn = try FileHandle.createNewFile(file: file, overwrite: true)
+        defer { try? FileManager.default.removeItem(atPath: file) }
+
+        let data = (0..<(50 * 40)).map({ Float($0 % 71) })
+        let fileWriter = OmFileWriter(fn: fn, initialCapacity: 8)
+        let array = try fileWriter.writeArray(data: data, dimensions: [50, 40], chunkDimensions: [3, 4], compression: .pfor_delta2d_int16, scale_factor: 1, add_offset: 0)
+        try fileWriter.writeTrailer(rootVariable: try fileWriter.write(array: array, name: "data", children: []))
+
+        let read = try await OmFileReader(mmapFile: file, options: .init(populate: true, hugePages: true)).expectArray(of: Float.self)
+        try await read.prefetchLut(hint: .willNeed)
+        try await read.prefetchLut(hint: .pin)
+        #expect(try await read.read(range: [10..<20, 5..<30]) == (10..<20).flatMap({ i in (5..<30).map({ data[i * 40 + $0] }) }))
+        try await read.prefetchLut(hint: .unpin)
+
+        /// Backends without pinning ignore the hint
+        let inMemory = DataAsClass(data: try Data(contentsOf: URL(fileURLWithPath: file)))
+        try await OmFileReader(fn: inMemory).expectArray(of: Float.self).prefetchLut(hint: .pin)
+    }
+
+    @Test func serialisedReadPlan() async throws {
+        let data = (0..<(40 * 30)).map({ Float($0 % 67) })
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let array = try fileWriter.writeArray(data: data, dimensions: [40, 30], chunkDimensions: [3, 4], compression: .pfor_delta2d_int16, scale_factor: 1, add_offset: 0)
+        try fileWriter.writeTrailer(rootVariable: try fileWriter.write(array: array, name: "data", children: []))
+        let backend = BatchRecordingBackend(backend: inMemoryBackend)
+        let read = try await OmFileReader(fn: backend).expectArray(of: Float.self, io_size_max: 256, io_size_merge: 64)
+        let range: [Range<UInt64>] = [5..<33, 2..<27]
+        let expected = try await read.read(range: range)
+        let unpinnedPlan = try await read.readPlan(range: range)
+        #expect(!unpinnedPlan.indexReads.isEmpty)
+        let reads = backend.reads
+
+        /// The planner only fetches the LUT once
+        let lutRange = try read.lutRange()
+        let planner = read.withPinnedLut(inMemoryBackend.data[lutRange.offset..<lutRange.offset + lutRange.count])
+        let plan = try await planner.readPlan(range: range)
+        #expect(plan.indexReads.isEmpty)
+        #expect(plan.dataReads.count > 1)
+        #expect(plan.dataReads.count == unpinnedPlan.dataReads.count)
+
+        /// Data is fetched from the serialised plan and decoded without IO
+        let decoded = try JSONDecoder().decode(OmReadPlan.self, from: try JSONEncoder().encode(plan))
+        let fetched = decoded.dataReads.map({ inMemoryBackend.data[$0.offset..<$0.offset + $0.count] })
+        #expect(try read.read(plan: decoded, data: fetched) == expected)
+        #expect(backend.reads == reads)
+
+        /// Empty ranges decode nothing
+        let empty = OmReadPlan(range: [5..<5, 2..<27], indexReads: [], dataReads: [], dataChunks: [])
+        #expect(try read.read(plan: empty, data: [Data]()) == [])
+    }
+
+    @Test func pinnedSmallLut() async throws {
+        let data = (0..<(6 * 4)).map({ Float($0) })
+        let inMemoryBackend = DataAsClass(data: Data())
+        let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+        let array = try fileWriter.writeArray(data: data, dimensions: [6, 4], chunkDimensions: [3, 4], compression: .pfor_delta2d_int16, scale_factor: 1, add_offset: 0)
+        try fileWriter.writeTrailer(rootVariable: try fileWriter.write(array: array, name: "data", children: []))
+        let read = try await OmFileReader(fn: inMemoryBackend).expectArray(of: Float.self)
+
+        /// `Data` keeps up to 14 bytes inline. The pinned LUT must not point into a temporary copy.
+        let lutRange = try read.lutRange()
+        #expect(lutRange.count <= 14)
+        let lut = Data(inMemoryBackend.data[lutRange.offset..<lutRange.offset + lutRange.count])
+        let pinned = read.withPinnedLut(lut)
+        #expect(try await pinned.read() == data)
+        #expect(try await pinned.readConcurrent(range: [1..<5, 0..<4]) == read.read(range: [1..<5, 0..<4]))
+        #expect(try await read.pinLut().read() == data)
+    }
+
+    @Test func fpxKernelsEncodeSameBytes() throws {
+        // Constant blocks have no residuals. All kernels must still write the same bytes.
+        let inputs32: [[UInt32]] = [
+            [UInt32](repeating: 0x3f800000, count: 1000),
+            [UInt32](repeating: 0, count: 300),
+            (0..<1000).map { $0 < 512 ? 0x40490fdb : UInt32($0 &* 2654435761 & 0xffffff) }
+        ]
+        let inputs64: [[UInt64]] = inputs32.map { $0.map { UInt64($0) << 29 } }
+        for input in inputs32 {
+            var outputs = [[UInt8]]()
+            for k in 0..<om_kernels_count() {
+                let kernels = om_kernels_at(k)!.pointee
+                var input = input
+                var out = [UInt8](repeating: 0, count: input.count * 8 + 1024)
+                let size = kernels.fpxenc32!(&input, input.count, &out, 0)
+                var decoded = [UInt32](repeating: 0, count: input.count)
+                _ = kernels.fpxdec32!(&out, input.count, &decoded, 0)
+                #expect(decoded == input)
+                outputs.append(Array(out[0..<size]))
+            }
+            #expect(outputs.allSatisfy { $0 == outputs[0] })
+        }
+        for input in inputs64 {
+            var outputs = [[UInt8]]()
+            for k in 0..<om_kernels_count() {
+                let kernels = om_kernels_at(k)!.pointee
+                var input = input
+                var out = [UInt8](repeating: 0, count: input.count * 16 + 1024)
+                let size = kernels.fpxenc64!(&input, input.count, &out, 0)
+                var decoded = [UInt64](repeating: 0, count: input.count)
+                _ = kernels.fpxdec64!(&out, input.count, &decoded, 0)
+                #expect(decoded == input)
+                outputs.append(Array(out[0..<size]))
+            }
+            #expect(outputs.allSatisfy { $0 == outputs[0] })
+        }
+    }
+
+    @Test func appendFileInterrupted() async throws {
+        let file = "appendFileInterrupted.om"
+        let fn = try FileHandle.createNewFile(file: file, overwrite: true)
+        defer { try? FileManager.default.removeItem(atPath: file) }
+        let fileWriter = OmFileWriter(fn: fn, initialCapacity: 8)
+        let data = (0..<20).map({ Float($0) })
+        let array = try fileWriter.writeArray(data: data, dimensions: [5, 4], chunkDimensions: [2, 2], compression: .pfor_delta2d_int16, scale_factor: 1, add_offset: 0)
+        try fileWriter.writeTrailer(rootVariable: try fileWriter.write(array: array, name: "data", children: []))
+        try fn.close()
+        let original = try Data(contentsOf: URL(fileURLWithPath: file))
+
+        /// Fails after existing chunks have been copied into the temporary file. The original file is unchanged.
+        await #expect(throws: OmFileFormatSwiftError.self) {
+            try await OmFileAppend<Float>.append(file: file, data: [1, 2, 3], atomic: true)
+        }
+        #expect(try Data(contentsOf: URL(fileURLWithPath: file)) == original)
+        #expect(!FileManager.default.fileExists(atPath: "\(file)~"))
+        let unchanged = try await OmFileReader(fn: try MmapFile(fn: FileHandle.openFileReading(file: file))).expectArray(of: Float.self)
+        await #expect(try unchanged.read() == data)
+
+        let newData = (20..<32).map({ Float($0) })
+        try await OmFileAppend<Float>.append(file: file, data: newData, atomic: true)
+        let read = try await OmFileReader(fn: try MmapFile(fn: FileHandle.openFileReading(file: file))).expectArray(of: Float.self)
+        #expect(read.getDimensions() == [8, 4])
+        await #expect(try read.read() == data + newData)
+
+        /// In place, only bytes after the last complete row of chunks are written
+        let before = try Data(contentsOf: URL(fileURLWithPath: file))
+        let truncateOffset = try await OmFileReader(fn: try MmapFile(fn: FileHandle.openFileReading(file: file))).prepareAppend(of: Float.self).truncateOffset
+        let moreData = (32..<40).map({ Float($0) })
+        try await OmFileAppend<Float>.append(file: file, data: moreData)
+        let appended = try Data(contentsOf: URL(fileURLWithPath: file))
+        #expect(appended.count > before.count)
+        #expect(appended.prefix(truncateOffset) == before.prefix(truncateOffset))
+        let readMore = try await OmFileReader(fn: try MmapFile(fn: FileHandle.openFileReading(file: file))).expectArray(of: Float.self)
+        #expect(readMore.getDimensions() == [10, 4])
+        await #expect(try readMore.read() == data + newData + moreData)
+    }
+
+    @Test func readChunkTailExceptionsExactBuffer() async throws {
+        /// The last chunk ends exactly at the end of the output and the PFor tail of every chunk has exceptions. Full rows are decoded directly
+        /// into the output, a 5x300 chunk of 5x1000 through the chunk buffer. Both are exact sized, so a kernel writing past the tail is caught by ASan.
+        func roundTrip<T: OmFileArrayDataTypeProtocol & Equatable>(_ type: T.Type, dimensions: [UInt64], chunks: [UInt64], value: (Int) -> T) async throws {
+            let inMemoryBackend = DataAsClass(data: Data())
+            let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
+            let count = Int(dimensions.reduce(1, *))
+            let row = Int(dimensions[1])
+            let data = (0..<count).map { $0 % 37 == 0 || $0 % row >= row - 3 ? value(20000 + $0 % 97) : value($0 * 7 % 5) }
+            let writer = try fileWriter.prepareArray(type: T.self, dimensions: dimensions, chunkDimensions: chunks, compression: .pfor_delta2d, scale_factor: 1, add_offset: 0)
+            try writer.writeData(array: data)
+            let variable = try fileWriter.write(array: try writer.finalise(), name: "data", children: [])
+            try fileWriter.writeTrailer(rootVariable: variable)
+
+            let read = try await OmFileReader(fn: inMemoryBackend).expectArray(of: T.self)
+            let output = UnsafeMutablePointer<T>.allocate(capacity: count)
+            defer { output.deallocate() }
+            try await read.read(into: output, range: dimensions.map { 0..<$0 })
+            #expect(Array(UnsafeBufferPointer(start: output, count: count)) == data)
+            try await read.readConcurrent(into: output, range: dimensions.map { 0..<$0 })
+            #expect(Array(UnsafeBufferPointer(start: output, count: count)) == data)
+        }
+        for (dimensions, chunks) in [([UInt64(10), 300], [UInt64(2), 300]), ([5, 1000], [5, 300])] {
+            try await roundTrip(Int16.self, dimensions: dimensions, chunks: chunks) { Int16($0) }
+            try await roundTrip(UInt16.self, dimensions: dimensions, chunks: chunks) { UInt16($0) }
+            try await roundTrip(Int32.self, dimensions: dimensions, chunks: chunks) { Int32($0) }
+            try await roundTrip(UInt32.self, dimensions: dimensions, chunks: chunks) { UInt32($0) }
+            try await roundTrip(Float.self, dimensions: dimensions, chunks: chunks) { Float($0) }
+        }
+    }
+
     @Test func testWriteArrayWithEmptyDimensions() async throws {
         let inMemoryBackend = DataAsClass(data: Data())
         let fileWriter = OmFileWriter(fn: inMemoryBackend, initialCapacity: 8)
@@ -965,6 +2183,118 @@ import OmFileFormatC
     }
 }
 
+/// Serve range requests for in-memory files with the `omtest` URL scheme
+final class RangeURLProtocol: URLProtocol, @unchecked Sendable {
+    nonisolated(unsafe) static var files = [String: Data]()
+    nonisolated(unsafe) private static var requestCount = [String: Int]()
+    private static let lock = NSLock()
+
+    static func requests(path: String) -> Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return requestCount[path] ?? 0
+    }
+
+    override class func canInit(with request: URLRequest) -> Bool {
+        return request.url?.scheme == "omtest"
+    }
+
+    override class func canonicalRequest(for request: URLRequest) -> URLRequest {
+        return request
+    }
+
+    override func startLoading() {
+        guard let url = request.url, let data = Self.files[url.path] else {
+            client?.urlProtocol(self, didFailWithError: URLError(.fileDoesNotExist))
+            return
+        }
+        Self.lock.lock()
+        Self.requestCount[url.path, default: 0] += 1
+        Self.lock.unlock()
+
+        // Supports `bytes=start-end` and `bytes=-suffix`
+        var range = 0..<data.count
+        if let header = request.value(forHTTPHeaderField: "Range"), header.hasPrefix("bytes=") {
+            let parts = header.dropFirst(6).split(separator: "-", omittingEmptySubsequences: false)
+            if parts[0].isEmpty, let suffix = Int(parts[1]) {
+                range = max(data.count - suffix, 0)..<data.count
+            } else if let start = Int(parts[0]), let end = Int(parts[1]) {
+                range = start..<min(end + 1, data.count)
+            }
+        }
+        let headers = ["Content-Range": "bytes \(range.lowerBound)-\(range.upperBound - 1)/\(data.count)", "Content-Length": "\(range.count)"]
+        let response = HTTPURLResponse(url: url, statusCode: 206, httpVersion: "HTTP/1.1", headerFields: headers)!
+        client?.urlProtocol(self, didReceive: response, cacheStoragePolicy: .notAllowed)
+        client?.urlProtocol(self, didLoad: data.subdata(in: range))
+        client?.urlProtocolDidFinishLoading(self)
+    }
+
+    override func stopLoading() {
+    }
+}
+
+/// Forward reads to `DataAsClass` and record all reads and the number of reads in each batch
+final class BatchRecordingBackend: OmFileReaderBackend, @unchecked Sendable {
+    typealias DataType = Data.SubSequence
+
+    let backend: DataAsClass
+    /// Call back one read after the other from one task like `UringFile`, even if `concurrent` is set
+    let serialCallbacks: Bool
+    private var _batches = [Int]()
+    private var _reads = 0
+    private let lock = NSLock()
+
+    init(backend: DataAsClass, serialCallbacks: Bool = false) {
+        self.backend = backend
+        self.serialCallbacks = serialCallbacks
+    }
+
+    /// Number of reads of each `withDataBatch` call
+    var batches: [Int] {
+        lock.lock()
+        defer { lock.unlock() }
+        return _batches
+    }
+
+    /// Number of reads including reads in batches
+    var reads: Int {
+        lock.lock()
+        defer { lock.unlock() }
+        return _reads
+    }
+
+    private func record(batch: Int?, reads: Int) {
+        lock.lock()
+        defer { lock.unlock() }
+        if let batch {
+            _batches.append(batch)
+        }
+        _reads += reads
+    }
+
+    var count: Int {
+        return backend.count
+    }
+
+    func prefetchData(offset: Int, count: Int) async throws {
+    }
+
+    func getData(offset: Int, count: Int) async throws -> Data.SubSequence {
+        record(batch: nil, reads: 1)
+        return try await backend.getData(offset: offset, count: count)
+    }
+
+    func withData<T>(offset: Int, count: Int, fn: @Sendable (UnsafeRawBufferPointer) throws -> T) async throws -> T {
+        record(batch: nil, reads: 1)
+        return try await backend.withData(offset: offset, count: count, fn: fn)
+    }
+
+    func withDataBatch(reads: [OmFileRead], concurrent: Bool, fn: @escaping @Sendable (Int, UnsafeRawBufferPointer) throws -> Void) async throws {
+        record(batch: reads.count, reads: reads.count)
+        try await backend.withDataBatch(reads: reads, concurrent: concurrent && !serialCallbacks, fn: fn)
+    }
+}
+
 extension Array where Element == Float {
     func testSimilar(_ b: [Element], accuracy: Element = 0.001) -> Bool {
         return testSimilarFloating(b, accuracy: accuracy)
@@ -10,6 +10,10 @@ void delta2d_encode8(const size_t length0, const size_t length1, int8_t* chunkBu
 void delta2d_decode16(const size_t length0, const size_t length1, int16_t* chunkBuffer);
 void delta2d_encode16(const size_t length0, const size_t length1, int16_t* chunkBuffer);
 
+/// Decode elements `[begin, end)` of a chunk with rows of `length1` elements. All elements before `begin` must
+/// already be decoded. Used to filter while the decompressed data is still in cache.
+void delta2d_decode16_range(const size_t length1, const size_t begin, const size_t end, int16_t* chunkBuffer);
+
 void delta2d_decode32(const size_t length0, const size_t length1, int32_t* chunkBuffer);
 void delta2d_encode32(const size_t length0, const size_t length1, int32_t* chunkBuffer);
 
@@ -19,6 +23,14 @@ void delta2d_encode64(const size_t length0, const size_t length1, int64_t* chunk
 void delta2d_encode_xor(const size_t length0, const size_t length1, float* chunkBuffer);
 void delta2d_decode_xor(const size_t length0, const size_t length1, float* chunkBuffer);
 
+/// Delta to the previous row and to the previous element in each row. Used for floats mapped to ordered integers.
+/// Together with PFor zigzag delta coding, the previous two values in a row predict each value linearly.
+void delta2d_decode_linear32(const size_t length0, const size_t length1, int32_t* chunkBuffer);
+void delta2d_encode_linear32(const size_t length0, const size_t length1, int32_t* chunkBuffer);
+
+void delta2d_decode_linear64(const size_t length0, const size_t length1, int64_t* chunkBuffer);
+void delta2d_encode_linear64(const size_t length0, const size_t length1, int64_t* chunkBuffer);
+
 void delta2d_encode_xor_double(const size_t length0, const size_t length1, double* chunkBuffer);
 void delta2d_decode_xor_double(const size_t length0, const size_t length1, double* chunkBuffer);
 
@@ -0,0 +1,79 @@
+//
+//  om_atomic.h
+//  OpenMeteoApi
+//
+//  Created on 14.10.2026.
+//
+
+#ifndef OM_ATOMIC_H
+#define OM_ATOMIC_H
+
+#include "om_common.h"
+
+// Minimal portable atomics for internal synchronisation. The library itself never creates threads.
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+
+static inline void om_spin_lock(volatile long* lock) {
+    while (_InterlockedExchange(lock, 1) != 0) {
+        while (*lock != 0) {}
+    }
+}
+
+static inline void om_spin_unlock(volatile long* lock) {
+    _InterlockedExchange(lock, 0);
+}
+
+/// Load with acquire semantics
+static inline uint64_t om_atomic_load(const volatile uint64_t* value) {
+    return (uint64_t)_InterlockedCompareExchange64((volatile long long*)value, 0, 0);
+}
+
+/// Store with release semantics
+static inline void om_atomic_store(volatile uint64_t* value, uint64_t desired) {
+    _InterlockedExchange64((volatile long long*)value, (long long)desired);
+}
+
+/// Set `value` to `desired` if it is `expected`. Returns true on success.
+static inline bool om_atomic_compare_exchange(volatile uint64_t* value, uint64_t expected, uint64_t desired) {
+    return (uint64_t)_InterlockedCompareExchange64((volatile long long*)value, (long long)desired, (long long)expected) == expected;
+}
+
+/// Add `increment` without ordering guarantees. Used for counters.
+static inline void om_atomic_add(volatile uint64_t* value, uint64_t increment) {
+    _InterlockedExchangeAdd64((volatile long long*)value, (long long)increment);
+}
+#else
+static inline void om_spin_lock(volatile long* lock) {
+    while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE) != 0) {
+        while (__atomic_load_n(lock, __ATOMIC_RELAXED) != 0) {}
+    }
+}
+
+static inline void om_spin_unlock(volatile long* lock) {
+    __atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+}
+
+/// Load with acquire semantics
+static inline uint64_t om_atomic_load(const volatile uint64_t* value) {
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+/// Store with release semantics
+static inline void om_atomic_store(volatile uint64_t* value, uint64_t desired) {
+    __atomic_store_n(value, desired, __ATOMIC_RELEASE);
+}
+
+/// Set `value` to `desired` if it is `expected`. Returns true on success.
+static inline bool om_atomic_compare_exchange(volatile uint64_t* value, uint64_t expected, uint64_t desired) {
+    return __atomic_compare_exchange_n(value, &expected, desired, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE);
+}
+
+/// Add `increment` without ordering guarantees. Used for counters.
+static inline void om_atomic_add(volatile uint64_t* value, uint64_t increment) {
+    __atomic_fetch_add(value, increment, __ATOMIC_RELAXED);
+}
+#endif
+
+#endif // OM_ATOMIC_H
@@ -0,0 +1,88 @@
+//
+//  om_cache.h
+//  OpenMeteoApi
+//
+//  Created on 14.10.2026.
+//
+
+#ifndef OM_CACHE_H
+#define OM_CACHE_H
+
+#include "om_common.h"
+
+/// Number of slots per set. A key can only be stored in one of the slots of its set.
+#define OM_CACHE_WAYS 8
+
+/// Number of locks. Threads accessing different shards do not contend.
+#define OM_CACHE_SHARDS 64
+
+/// Identifies a cached block.
+typedef struct {
+    /// Identifies the file. Chosen by the caller and must be unique for each file that shares a cache.
+    uint64_t file;
+    /// Identifies the variable inside a file. Decoders use the LUT start offset.
+    uint64_t variable;
+    /// Block index inside the variable. E.g. the LUT chunk number.
+    uint64_t index;
+} OmCacheKey_t;
+
+/// Bookkeeping for each slot in the cache
+typedef struct {
+    OmCacheKey_t key;
+    /// Number of bytes stored in this slot. 0 if the slot is empty.
+    uint64_t size;
+    /// Set on access and cleared by the CLOCK eviction.
+    uint64_t referenced;
+} OmCacheSlot_t;
+
+/// Lock and statistics for a group of sets. Padded to 64 bytes to prevent false sharing between shards.
+typedef struct {
+    /// Spin lock
+    volatile long lock;
+    /// Number of successful lookups
+    uint64_t hits;
+    /// Number of failed lookups
+    uint64_t misses;
+    uint8_t padding[64 - 3 * sizeof(uint64_t)];
+} OmCacheShard_t;
+
+/// A set associative cache with fixed size slots and CLOCK eviction. All memory is provided by the caller.
+/// Get and put are thread-safe. Sets are distributed over `OM_CACHE_SHARDS` locks. Data is copied in and out while holding the lock of a set.
+typedef struct {
+    /// Slot bookkeeping. `sets_count * OM_CACHE_WAYS` elements
+    OmCacheSlot_t* slots;
+    /// CLOCK hand for each set
+    uint8_t* hands;
+    /// Payload memory. `slot_size` bytes for each slot
+    uint8_t* data;
+    /// Maximum number of bytes per slot
+    uint64_t slot_size;
+    /// Number of sets. 0 if the memory is too small for a single set and the cache is disabled.
+    uint64_t sets_count;
+    /// Locks and statistics. Set `n` uses shard `n % OM_CACHE_SHARDS`.
+    OmCacheShard_t shards[OM_CACHE_SHARDS];
+} OmCache_t;
+
+/**
+ * @brief Initialise a cache in caller provided memory.
+ *
+ * @param cache Cache to initialise. Must not be copied after initialisation.
+ * @param memory Memory to store slots and data. Must remain valid as long as the cache is used. Should be 8 byte aligned.
+ * @param memory_size Size of `memory` in bytes. This is the memory budget of the cache.
+ * @param slot_size Maximum number of bytes for each cached block.
+ */
+void om_cache_init(OmCache_t* cache, void* memory, uint64_t memory_size, uint64_t slot_size);
+
+/// Copy a cached block into `into` if it is available and has exactly `size` bytes. Returns false if the block is not cached.
+bool om_cache_get(OmCache_t* cache, OmCacheKey_t key, void* into, uint64_t size);
+
+/// Store a block in the cache. Evicts another block of the same set if required. Blocks larger than the slot size are ignored.
+void om_cache_put(OmCache_t* cache, OmCacheKey_t key, const void* data, uint64_t size);
+
+/// Remove all entries and reset statistics
+void om_cache_clear(OmCache_t* cache);
+
+/// Get the number of cache hits and misses of `om_cache_get` since initialisation or the last clear.
+void om_cache_statistics(OmCache_t* cache, uint64_t* hits, uint64_t* misses);
+
+#endif // OM_CACHE_H
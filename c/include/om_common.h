@@ -29,6 +29,8 @@ typedef enum {
     ERROR_INVALID_READ_OFFSET = 8,
     ERROR_INVALID_READ_COUNT = 9,
     ERROR_INVALID_CUBE_OFFSET = 10,
+    ERROR_INVALID_BATCH = 11,
+    ERROR_LUT_CACHE_MISS = 12,
 } OmError_t;
 
 const char* om_error_string(OmError_t error);
@@ -66,9 +68,42 @@ typedef enum {
     COMPRESSION_FPX_XOR2D = 1, // Lossless float/double compression using 2D xor coding.
     COMPRESSION_PFOR_DELTA2D = 2, // PFor integer compression. Floating point values are scaled to 32 bit signed integers. Doubles are scaled to 64 bit signed integers.
     COMPRESSION_PFOR_DELTA2D_INT16_LOGARITHMIC = 3, // Similar to `COMPRESSION_PFOR_DELTA2D_INT16` but applies `log10(1+x)` before.
-    COMPRESSION_NONE = 4
+    COMPRESSION_NONE = 4,
+    COMPRESSION_PFOR_FLOAT_LINEAR2D = 5 // Lossless float/double compression. Values are mapped to ordered integers and predicted from the previous row and linearly from the previous two values in the row. Residuals are PFor encoded.
 } OmCompression_t;
 
+/// Flag that can be combined with the compression type of an array. Each chunk then starts with a `OmChunkCodec_t` byte and the encoder picks the smallest codec per chunk.
+/// Readers without support for this flag reject the array with `ERROR_INVALID_COMPRESSION_TYPE`.
+#define OM_COMPRESSION_ADAPTIVE 0x80
+
+/// Flag that can be combined with the compression type of an array. The LUT is stored in blocks of `LUT_CHUNK_COUNT` bit packed entries of fixed width, so a single entry can be read without decompressing a block.
+/// Readers without support for this flag reject the array with `ERROR_INVALID_COMPRESSION_TYPE`. See `om_encoder_compress_lut_packed`.
+#define OM_COMPRESSION_LUT_PACKED 0x40
+
+/// All flags that can be combined with the compression type of an array
+#define OM_COMPRESSION_FLAGS (OM_COMPRESSION_ADAPTIVE | OM_COMPRESSION_LUT_PACKED)
+
+/// A packed LUT block starts with its first entry as 64 bit integer and the bit width of the differences to the first entry as 8 bit integer.
+/// Differences of all entries follow with the least significant bit first. Each block ends with zero padding, so entries can be read with 64 bit loads.
+#define OM_LUT_PACKED_HEADER_SIZE 9
+#define OM_LUT_PACKED_PADDING 8
+
+/// Codec of a single chunk in an array with `OM_COMPRESSION_ADAPTIVE`. All codecs store values after scaling as they are used by the compression type of the array.
+typedef enum {
+    CHUNK_CODEC_FILTERED = 0, // 2D filter and compression of the compression type. Same as chunks without `OM_COMPRESSION_ADAPTIVE`.
+    CHUNK_CODEC_UNFILTERED = 1, // Compression of the compression type without 2D filter
+    CHUNK_CODEC_RAW = 2, // Uncompressed values
+    CHUNK_CODEC_CONSTANT = 3 // A single value for all elements, e.g. an all zero or all NaN chunk
+} OmChunkCodec_t;
+
+/// Statistics of a single chunk of a float array after scaling and compression, exactly as values are returned by the decoder.
+/// `min` and `max` are NaN if all values are NaN.
+typedef struct {
+    float min;
+    float max;
+    uint32_t nan_count;
+} OmChunkStats_t;
+
 /// Get the number of bytes per element.
 /// This function will set an error if called for an invalid data type.
 /// It only supports array types.
@@ -102,6 +137,20 @@ void om_common_copy_int64_to_double(uint64_t length, float scale_factor, float a
 /// Convert int16 and scale to float with log10
 void om_common_copy_int16_to_float_log10(uint64_t length, float scale_factor, const void* src, void* dst);
 
+/// Convert int16 and scale to IEEE half precision or bfloat16. Values are rounded to nearest even.
+void om_common_copy_int16_to_float16(uint64_t length, float scale_factor, float add_offset, const void* src, void* dst);
+void om_common_copy_int16_to_bfloat16(uint64_t length, float scale_factor, float add_offset, const void* src, void* dst);
+
+/// Convert float to IEEE half precision or bfloat16. Values are rounded to nearest even.
+void om_common_copy_float_to_float16(uint64_t length, const void* src, void* dst);
+void om_common_copy_float_to_bfloat16(uint64_t length, const void* src, void* dst);
+
+/// Map float bits to integers in the same order as the float values and back. The mapping is lossless for all values including NaN.
+void om_common_copy_float_to_ordered32(uint64_t length, const void* src, void* dst);
+void om_common_copy_ordered32_to_float(uint64_t length, const void* src, void* dst);
+void om_common_copy_double_to_ordered64(uint64_t length, const void* src, void* dst);
+void om_common_copy_ordered64_to_double(uint64_t length, const void* src, void* dst);
+
 void om_common_copy8(uint64_t length, const void* src, void* dst);
 void om_common_copy16(uint64_t length, const void* src, void* dst);
 void om_common_copy32(uint64_t length, const void* src, void* dst);
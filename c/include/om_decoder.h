@@ -14,22 +14,82 @@
 
 #include "om_common.h"
 #include "om_variable.h"
+#include "om_cache.h"
 
 typedef struct {
     uint64_t lowerBound;
     uint64_t upperBound;
 } OmRange_t;
 
+/// Reads with up to this number of dimensions advance from one range of chunks to the next without integer division
+#define OM_DECODER_POSITION_DIMENSIONS 8
+
 typedef struct {
     uint64_t offset;
     uint64_t count;
     OmRange_t indexRange;
     OmRange_t chunkIndex;
     OmRange_t nextChunk;
+
+    /// Chunk coordinates of the last chunk in `nextChunk` for dimensions that are not read linearly
+    uint64_t nextChunkPosition[OM_DECODER_POSITION_DIMENSIONS];
+
+    /// Chunk coordinates of the last chunk in `chunkIndex`. The data read starts at this position.
+    uint64_t chunkIndexPosition[OM_DECODER_POSITION_DIMENSIONS];
 } OmDecoder_indexRead_t;
 
+/// Counters of one or more reads. Fields are updated atomically, so decoders used from multiple threads can share one instance.
+/// Use `om_decoder_stats_copy` to read the counters while decoders are running.
+typedef struct {
+    /// Index reads returned by `om_decoder_next_index_read` for decoders without LUT cache or pinned LUT
+    uint64_t index_reads;
+    uint64_t index_bytes;
+
+    /// Data reads returned by `om_decoder_next_data_read` and their compressed size
+    uint64_t data_reads;
+    uint64_t data_bytes;
+
+    /// Decoded chunks and their uncompressed size in the target data type
+    uint64_t chunks_decoded;
+    uint64_t uncompressed_bytes;
+
+    /// Chunks that were only part of a merged data read and are outside the requested hyperslab
+    uint64_t chunks_skipped;
+
+    /// Chunks copied from the chunk cache without IO
+    uint64_t chunks_cached;
+
+    /// Constant chunks of adaptive arrays that were written directly into the target cube. Also counted in `chunks_decoded`.
+    uint64_t chunks_constant;
+
+    /// LUT chunks decompressed from index data
+    uint64_t lut_chunks_decompressed;
+
+    /// Time spent in decompression, 2D filters and copying into the target cube in nanoseconds
+    uint64_t decompress_ns;
+    uint64_t filter_ns;
+    uint64_t copy_ns;
+} OmDecoderStats_t;
+
+/// Copy all counters of `stats` into `out`. Each counter is read atomically, but the copy is not a snapshot.
+/// While decoders are running, counters can come from different moments, e.g. `data_reads` may already include a read whose `data_bytes` are not yet added.
+void om_decoder_stats_copy(const OmDecoderStats_t* stats, OmDecoderStats_t* out);
+
+/// Set all counters to 0
+void om_decoder_stats_reset(OmDecoderStats_t* stats);
+
 typedef OmDecoder_indexRead_t OmDecoder_dataRead_t;
 
+/// Element type of the decoded output. See `om_decoder_set_output_type`.
+typedef enum {
+    /// The data type of the variable
+    OUTPUT_TYPE_NATIVE = 0,
+    /// IEEE 754 half precision. Only for float arrays.
+    OUTPUT_TYPE_FLOAT16 = 1,
+    /// Upper 16 bits of a float. Only for float arrays.
+    OUTPUT_TYPE_BFLOAT16 = 2,
+} OmOutputType_t;
+
 
 typedef struct {
     /// Number of dimensions
@@ -50,6 +110,19 @@ typedef struct {
     /// uint64_t of data chunks in this file. This value is computed in the initialisation.
     uint64_t number_of_chunks;
 
+    /// Range of chunk coordinates of the read and the distance of consecutive chunks in the chunk index for each dimension.
+    /// Computed in the initialisation for up to `OM_DECODER_POSITION_DIMENSIONS` dimensions.
+    uint64_t chunk_lower[OM_DECODER_POSITION_DIMENSIONS];
+    uint64_t chunk_upper[OM_DECODER_POSITION_DIMENSIONS];
+    uint64_t chunk_stride[OM_DECODER_POSITION_DIMENSIONS];
+
+    /// Number of slow dimensions that are iterated chunk by chunk. All faster dimensions are read as one linear range of chunks.
+    uint64_t chunk_outer_dimensions;
+
+    /// Number of chunks in one linear range and the chunk index of its first chunk relative to the outer dimensions
+    uint64_t chunk_run_length;
+    uint64_t chunk_run_offset;
+
     /// The dimensions of the data array. The last dimension is the "fast" dimension meaning the elements are sequential in memory
     const uint64_t* dimensions;
 
@@ -85,6 +158,36 @@ typedef struct {
 
     /// The size of the elements in bytes after compression, e.g. Int16 could be used to scale floats
     uint8_t bytes_per_element_compressed;
+
+    /// Element type of the output array. `bytes_per_element` is the size of the output type.
+    uint8_t output_type;
+
+    /// True if the array was written with `OM_COMPRESSION_ADAPTIVE`. `compression` does not include the flag.
+    uint8_t adaptive;
+
+    /// True if the LUT is stored in bit packed blocks with `OM_COMPRESSION_LUT_PACKED`. Single entries are then read without decompressing a LUT chunk.
+    uint8_t lut_packed;
+
+    /// Optional cache for decompressed LUT chunks. Can be shared between decoders and threads. NULL if not used.
+    OmCache_t* lut_cache;
+
+    /// Optional cache for decompressed and filtered data chunks. Can be shared between decoders and threads. NULL if not used.
+    OmCache_t* chunk_cache;
+
+    /// Identifies the file in cache keys
+    uint64_t cache_file;
+
+    /// Optional LUT of the entire variable held in memory. If set, index data does not need to be read. NULL if not used.
+    const void* lut_pinned;
+
+    /// Size of `lut_pinned` in bytes
+    uint64_t lut_pinned_size;
+
+    /// Optional counters updated by all decoder functions. NULL if not used.
+    OmDecoderStats_t* stats;
+
+    /// Optional byte strides of the target cube for each dimension. NULL if the target cube is dense with `cube_dimensions`.
+    const int64_t* cube_strides;
 } OmDecoder_t;
 
 /**
@@ -120,6 +223,138 @@ OmError_t om_decoder_init(
 
 //OmError_t OmDecoder_init(OmDecoder_t* decoder, float scalefactor, float add_offset, const OmCompression_t compression, const OmDataType_t data_type, uint64_t dimension_count, const uint64_t* dimensions, const uint64_t* chunks, const uint64_t* read_offset, const uint64_t* read_count, const uint64_t* cube_offset, const uint64_t* cube_dimensions, uint64_t lut_size, uint64_t lut_chunk_element_count, uint64_t lut_start, uint64_t io_size_merge, uint64_t io_size_max);
 
+/**
+ * @brief Convert values to a different output type while copying them into the target cube.
+ *
+ * Float arrays can be decoded to half precision or bfloat16 in a single pass without an intermediate float array.
+ * Values are rounded to nearest even. The target cube uses 2 bytes per element. Reductions always use float values.
+ *
+ * @param decoder The decoder
+ * @param output_type The element type of the target cube
+ * @returns `ERROR_INVALID_DATA_TYPE` if the variable is not a float array
+ */
+OmError_t om_decoder_set_output_type(OmDecoder_t* decoder, OmOutputType_t output_type);
+
+/**
+ * @brief Write into a target cube with a byte stride for each dimension instead of a dense `cube_dimensions` array.
+ *
+ * This writes into padded rows, transposed layouts or flipped grids without copying the result again. The target element of
+ * a read coordinate is at `into + sum((coordinate - read_offset + cube_offset) * cube_strides)`, so `into` points to
+ * coordinate 0 of the target cube and strides may be negative. `cube_dimensions` is only used to validate `cube_offset`.
+ * Chunks are then always decoded into the chunk buffer and copied.
+ *
+ * @param decoder The decoder
+ * @param cube_strides Byte stride for each dimension. Must remain valid while the decoder is used. NULL for a dense target cube.
+ */
+void om_decoder_set_cube_strides(OmDecoder_t* decoder, const int64_t* cube_strides);
+
+/**
+ * @brief Use a cache for decompressed LUT chunks.
+ *
+ * LUT chunks are looked up in the cache before they are decompressed from index data. If all LUT chunks
+ * for a data read are cached, `om_decoder_next_data_read` can be called without index data and the index read can be skipped.
+ * Version 1 and 2 files do not compress the LUT and do not use the cache.
+ *
+ * @param decoder The decoder
+ * @param cache A cache initialised with `om_cache_init` and a slot size of at least `LUT_CHUNK_COUNT * sizeof(uint64_t)`. NULL to disable.
+ * @param cache_file Identifies the file. Must be unique for each file that uses the same cache.
+ */
+void om_decoder_set_lut_cache(OmDecoder_t* decoder, OmCache_t* cache, uint64_t cache_file);
+
+/**
+ * @brief Use a cache for decompressed data chunks.
+ *
+ * Chunks are stored after decompression and filtering, but before they are copied into the output array.
+ * `om_decoder_decode_chunks` fills the cache. `om_decoder_decode_cached_chunks` uses cached chunks without reading data.
+ * Combined with a LUT cache, reads of cached regions do not require any IO.
+ *
+ * @param decoder The decoder
+ * @param cache A cache initialised with `om_cache_init` and a slot size of at least `om_decoder_read_buffer_size`.
+ *              Chunks larger than the slot size are not cached. Must not be the same cache as the LUT cache. NULL to disable.
+ * @param cache_file Identifies the file. Must be unique for each file that uses the same cache.
+ */
+void om_decoder_set_chunk_cache(OmDecoder_t* decoder, OmCache_t* cache, uint64_t cache_file);
+
+/**
+ * @brief Get the byte range of the entire LUT of the variable.
+ *
+ * The range can be read once and set with `om_decoder_set_lut_pinned`. Afterwards reads only require data IO.
+ *
+ * @param decoder The decoder
+ * @param[out] offset Byte offset of the LUT in the file
+ * @param[out] count Size of the LUT in bytes
+ */
+void om_decoder_lut_range(const OmDecoder_t* decoder, uint64_t* offset, uint64_t* count);
+
+/**
+ * @brief Use a LUT that is held in memory.
+ *
+ * If set, `om_decoder_next_data_read` and `om_decoder_batch_next_data_read` ignore `index_data` and the index read can be skipped.
+ *
+ * @param decoder The decoder
+ * @param lut The data of the range from `om_decoder_lut_range`. Must remain valid as long as the decoder is used. NULL to disable.
+ * @param lut_size Size of `lut` in bytes
+ */
+void om_decoder_set_lut_pinned(OmDecoder_t* decoder, const void* lut, uint64_t lut_size);
+
+/**
+ * @brief Decompress the entire LUT of the variable.
+ *
+ * Used to extend an existing array. Entry `i` is the file offset where chunk `i` starts and the last entry is the end of the last chunk.
+ *
+ * @param decoder The decoder
+ * @param lut_data The data of the range from `om_decoder_lut_range`
+ * @param lut_data_size Size of `lut_data` in bytes
+ * @param[out] lut Output with `number_of_chunks + 1` entries
+ *
+ * @returns `ERROR_OUT_OF_BOUND_READ` if `lut_data` is too small
+ */
+OmError_t om_decoder_decode_lut(const OmDecoder_t* decoder, const void* lut_data, uint64_t lut_data_size, uint64_t* lut);
+
+/**
+ * @brief Record counters and timings of this decoder.
+ *
+ * Timings use separate decompression and filter passes which are slightly slower than the fused int16 kernel.
+ *
+ * @param decoder The decoder
+ * @param stats Counters to update. Can be shared between decoders and threads. Must remain valid as long as the decoder is used. NULL to disable.
+ */
+void om_decoder_set_stats(OmDecoder_t* decoder, OmDecoderStats_t* stats);
+
+/// A simple cost model of a storage backend to plan IO
+typedef struct {
+    /// Time to first byte of a single request in seconds. E.g. 0.03 for S3 or 0.0001 for NVMe.
+    double latency;
+    /// Throughput of a single request in bytes per second
+    double bandwidth;
+    /// Number of requests that can run concurrently. 0 is treated as 1.
+    uint64_t parallelism;
+} OmIoCostModel_t;
+
+/**
+ * @brief Derive IO merge and split thresholds from an IO cost model.
+ *
+ * `om_decoder_next_index_read` and `om_decoder_next_data_read` build reads greedily. A gap between two reads is read
+ * as well if transferring it is faster than the latency of an additional request, amortised over all parallel requests.
+ * A read is split once transferring it takes longer than the latency of another request, which then runs in parallel.
+ * With these thresholds, each greedy decision minimises the estimated wall time of `om_io_cost_model_estimate`.
+ *
+ * @param[in]  model          The cost model
+ * @param[out] io_size_merge  Gaps smaller than this are merged into a single read
+ * @param[out] io_size_max    Reads larger than this are split. At least 64 KiB and at most 64 MiB.
+ */
+void om_io_cost_model_thresholds(const OmIoCostModel_t* model, uint64_t* io_size_merge, uint64_t* io_size_max);
+
+/**
+ * @brief Estimate the wall time in seconds to perform `requests` reads with a total of `bytes` bytes.
+ */
+double om_io_cost_model_estimate(const OmIoCostModel_t* model, uint64_t requests, uint64_t bytes);
+
+/**
+ * @brief Set `io_size_merge` and `io_size_max` of an initialised decoder from an IO cost model.
+ */
+void om_decoder_set_io_cost_model(OmDecoder_t* decoder, const OmIoCostModel_t* model);
+
 /**
  * @brief Initializes an `om_decoder_index_read_t` structure for reading chunk indices.
  *
@@ -194,13 +429,15 @@ void om_decoder_init_data_read(OmDecoder_dataRead_t *data_read, const OmDecoder_
  *                               the state of the current data read operation. This structure
  *                               is updated to reflect the next segment of data to read.
  * @param[in]  index_data        A pointer to the index data, which provides the compressed
- *                               offset information for each chunk in the LUT.
+ *                               offset information for each chunk in the LUT. May be NULL if a LUT cache is set.
  * @param[in]  index_data_size   The size of the `index_data` buffer in bytes.
  *
  * @returns `true` if the next data segment was successfully prepared and ready for reading,
  *          `false` if there are no more data segments to read or if the range is exhausted.
  *
  * @returns May return an out-of-bounds read error on corrupted data.
+ *          Returns `ERROR_LUT_CACHE_MISS` if `index_data` is NULL and a LUT chunk is not cached. `data_read` is
+ *          not modified and the call can be repeated with index data.
  */
 bool om_decoder_next_data_read(const OmDecoder_t *decoder, OmDecoder_dataRead_t* dataRead, const void* indexData, uint64_t indexDataCount, OmError_t* error);
 
@@ -228,6 +465,21 @@ bool om_decoder_next_data_read(const OmDecoder_t *decoder, OmDecoder_dataRead_t*
 uint64_t om_decoder_read_buffer_size(const OmDecoder_t* decoder);
 
 
+/**
+ * @brief Decodes a range of chunks from the chunk cache.
+ *
+ * Should be called for each data read before data is read. If all chunks of the read are cached, they are copied into `into`
+ * and the data read can be skipped. Otherwise data must be read and decoded with `om_decoder_decode_chunks`.
+ *
+ * @param[in]  decoder       The decoder with a chunk cache
+ * @param[in]  chunk         The range of chunks from `om_decoder_next_data_read`
+ * @param[out] into          The output array
+ * @param[in]  chunk_buffer  A buffer of at least `om_decoder_read_buffer_size` bytes
+ *
+ * @returns True if all chunks were cached. False if no chunk cache is set or a chunk is missing.
+ */
+bool om_decoder_decode_cached_chunks(const OmDecoder_t* decoder, OmRange_t chunk, void* into, void* chunk_buffer);
+
 /**
  * @brief Decodes multiple data chunks from compressed input into a target buffer.
  *
@@ -259,4 +511,135 @@ uint64_t om_decoder_read_buffer_size(const OmDecoder_t* decoder);
  */
 bool om_decoder_decode_chunks(const OmDecoder_t *decoder, OmRange_t chunkIndex, const void *data, uint64_t dataCount, void *into, void *chunkBuffer, OmError_t* error);
 
+/// Accumulator for one output cell of a reduction. NaN values are not counted.
+typedef struct {
+    double sum;
+    uint64_t count;
+    float min;
+    float max;
+} OmReduceCell_t;
+
+typedef enum {
+    OM_REDUCE_MIN = 0,
+    OM_REDUCE_MAX = 1,
+    OM_REDUCE_SUM = 2,
+    OM_REDUCE_MEAN = 3,
+    OM_REDUCE_COUNT = 4,
+} OmReduction_t;
+
+/// Number of output cells if `group[i]` consecutive elements of each read dimension are combined into one cell.
+/// A group of 1 keeps a dimension and a group equal to the read count reduces it to a single cell. Returns 0 if a group is 0.
+uint64_t om_decoder_reduce_cells_count(const OmDecoder_t* decoder, const uint64_t* group);
+
+/// Initialise `count` empty cells
+void om_reduce_cells_init(OmReduceCell_t* cells, uint64_t count);
+
+/// Write the result of `reduction` for each cell to `out`. Cells without values are NaN, except for `OM_REDUCE_COUNT`.
+void om_reduce_cells_result(const OmReduceCell_t* cells, uint64_t count, OmReduction_t reduction, float* out);
+
+/**
+ * @brief Decodes a range of chunks and accumulates the values of the read range into `cells` instead of copying them into an output array.
+ *
+ * Works like `om_decoder_decode_chunks`, but each chunk is reduced straight from the chunk buffer after filtering. Scale factor and add offset are applied
+ * and NaN values are skipped. Only float arrays are supported. Chunks of the same read may update the same cell, therefore calls for different chunks
+ * must not run concurrently with the same cells.
+ *
+ * @param[in]  group        Number of consecutive elements per dimension that are combined into one cell. See `om_decoder_reduce_cells_count`.
+ * @param[out] cells        Accumulators initialised with `om_reduce_cells_init`. Laid out like the read range with dimensions `ceil(read_count / group)`.
+ * @param[out] chunk_buffer A buffer of at least `om_decoder_read_buffer_size` bytes
+ *
+ * @returns `false` if an error occurred.
+ */
+bool om_decoder_reduce_chunks(const OmDecoder_t* decoder, OmRange_t chunk, const void* data, uint64_t data_size, const uint64_t* group, OmReduceCell_t* cells, void* chunk_buffer, OmError_t* error);
+
+
+/// A batch of reads for the same variable. Each read is described by its own decoder with individual read offset, count and target cube.
+/// Chunks that are required by multiple reads are only read and decompressed once.
+typedef struct {
+    /// Decoders for all reads. All decoders must be initialised for the same variable.
+    const OmDecoder_t* decoders;
+
+    /// Number of decoders
+    uint64_t decoders_count;
+
+    /// Sorted list of unique chunk indices required by all reads
+    const uint64_t* chunks;
+
+    /// Number of elements in `chunks`
+    uint64_t chunks_count;
+} OmDecoderBatch_t;
+
+typedef struct {
+    uint64_t offset;
+    uint64_t count;
+    OmRange_t indexRange;
+    /// Range of positions in `OmDecoderBatch_t.chunks` covered by this index read
+    OmRange_t chunksPosition;
+} OmDecoderBatch_indexRead_t;
+
+typedef struct {
+    uint64_t offset;
+    uint64_t count;
+    OmRange_t indexRange;
+    /// Chunks to decode with `om_decoder_batch_decode_chunks`
+    OmRange_t chunkIndex;
+    /// Remaining positions in `OmDecoderBatch_t.chunks` for the current index read
+    OmRange_t chunksPosition;
+} OmDecoderBatch_dataRead_t;
+
+/**
+ * @brief Calculates the number of elements required for the chunk buffer of `om_decoder_batch_init`.
+ *
+ * @param[in] decoders        An array of initialised decoders.
+ * @param[in] decoders_count  Number of decoders.
+ *
+ * @returns The sum of chunks for all reads before duplicates are removed.
+ */
+uint64_t om_decoder_batch_chunks_count(const OmDecoder_t* decoders, uint64_t decoders_count);
+
+/**
+ * @brief Initialises a batch read for multiple hyperslabs of the same variable.
+ *
+ * All chunks of all reads are collected, sorted and deduplicated. The resulting chunk list is
+ * used to plan index and data reads with the IO merge and split limits of the first decoder.
+ * Each chunk is only read and decompressed once, even if multiple reads require it.
+ *
+ * @param[out] batch               The batch to initialise
+ * @param[in]  decoders            An array of decoders initialised with `om_decoder_init` for the same variable.
+ *                                 Must remain valid until the batch is decoded.
+ * @param[in]  decoders_count      Number of decoders
+ * @param[in]  chunks_buffer       A buffer to store the chunk list. Must remain valid until the batch is decoded.
+ * @param[in]  chunks_buffer_count Number of elements in `chunks_buffer`. Must be at least `om_decoder_batch_chunks_count`.
+ *
+ * @returns `ERROR_INVALID_BATCH` if decoders are for different variables or the buffer is too small.
+ */
+OmError_t om_decoder_batch_init(OmDecoderBatch_t* batch, const OmDecoder_t* decoders, uint64_t decoders_count, uint64_t* chunks_buffer, uint64_t chunks_buffer_count);
+
+/// Initialise an index read for a batch. Works like `om_decoder_init_index_read`.
+void om_decoder_batch_init_index_read(OmDecoderBatch_indexRead_t* index_read);
+
+/// Get the next index read for a batch. Works like `om_decoder_next_index_read`.
+bool om_decoder_batch_next_index_read(const OmDecoderBatch_t* batch, OmDecoderBatch_indexRead_t* index_read);
+
+/// Initialise a data read for a batch. Works like `om_decoder_init_data_read`.
+void om_decoder_batch_init_data_read(OmDecoderBatch_dataRead_t* data_read, const OmDecoderBatch_indexRead_t* index_read);
+
+/// Get the next data read for a batch. Works like `om_decoder_next_data_read`. Reads for chunks that are close together are merged.
+bool om_decoder_batch_next_data_read(const OmDecoderBatch_t* batch, OmDecoderBatch_dataRead_t* data_read, const void* index_data, uint64_t index_data_size, OmError_t* error);
+
+/**
+ * @brief Decodes a range of chunks and copies them into all reads of the batch that require them.
+ *
+ * @param[in]  batch         The batch
+ * @param[in]  chunkIndex    The range of chunks from `om_decoder_batch_next_data_read`
+ * @param[in]  data          Compressed data
+ * @param[in]  data_size     Size of compressed data in bytes
+ * @param[out] into          An array of output buffers. One for each decoder in the batch.
+ * @param[out] chunkBuffer   A temporary buffer sized according to `om_decoder_read_buffer_size`
+ * @param[out] error         May return an out-of-bounds read error on corrupted data.
+ *
+ * @returns `false` if an error occurred.
+ */
+bool om_decoder_batch_decode_chunks(const OmDecoderBatch_t* batch, OmRange_t chunkIndex, const void* data, uint64_t data_size, void* const* into, void* chunkBuffer, OmError_t* error);
+
 #endif // OM_DECODER_H
@@ -0,0 +1,73 @@
+//
+//  om_dispatch.h
+//  OpenMeteoApi
+//
+//  Created on 14.10.2026.
+//
+
+#ifndef OM_DISPATCH_H
+#define OM_DISPATCH_H
+
+#include "om_common.h"
+
+/// CPU features detected at runtime
+typedef enum {
+    OM_CPU_SSSE3 = 1 << 0,
+    OM_CPU_SSE41 = 1 << 1,
+    OM_CPU_AVX2 = 1 << 2, // Only set if the operating system saves AVX registers
+    OM_CPU_BMI2 = 1 << 3,
+    OM_CPU_LZCNT = 1 << 4,
+    OM_CPU_NEON = 1 << 5,
+} OmCpuFeature_t;
+
+/// Codec entry points used by the encoder and decoder. Bound once to the best kernels for the running CPU.
+typedef struct {
+    const char* name;
+
+    size_t (*p4nzdec8)(unsigned char *__restrict in, size_t n, uint8_t *__restrict out);
+    size_t (*p4nddec8)(unsigned char *__restrict in, size_t n, uint8_t *__restrict out);
+    size_t (*p4nzdec128v16)(unsigned char *__restrict in, size_t n, uint16_t *__restrict out);
+    size_t (*p4nddec128v16)(unsigned char *__restrict in, size_t n, uint16_t *__restrict out);
+    size_t (*p4nzdec128v32)(unsigned char *__restrict in, size_t n, uint32_t *__restrict out);
+    size_t (*p4nddec128v32)(unsigned char *__restrict in, size_t n, uint32_t *__restrict out);
+    size_t (*p4nzdec64)(unsigned char *__restrict in, size_t n, uint64_t *__restrict out);
+    size_t (*p4nddec64)(unsigned char *__restrict in, size_t n, uint64_t *__restrict out);
+    unsigned char* (*p4zdec128v16)(unsigned char *__restrict in, unsigned n, uint16_t *__restrict out, uint16_t start);
+    unsigned char* (*p4zdec16)(unsigned char *__restrict in, unsigned n, uint16_t *__restrict out, uint16_t start);
+    unsigned char* (*p4ddec128v16)(unsigned char *__restrict in, unsigned n, uint16_t *__restrict out, uint16_t start);
+    unsigned char* (*p4ddec16)(unsigned char *__restrict in, unsigned n, uint16_t *__restrict out, uint16_t start);
+    unsigned char* (*p4zdec128v32)(unsigned char *__restrict in, unsigned n, uint32_t *__restrict out, uint32_t start);
+    unsigned char* (*p4zdec32)(unsigned char *__restrict in, unsigned n, uint32_t *__restrict out, uint32_t start);
+    unsigned char* (*p4ddec128v32)(unsigned char *__restrict in, unsigned n, uint32_t *__restrict out, uint32_t start);
+    unsigned char* (*p4ddec32)(unsigned char *__restrict in, unsigned n, uint32_t *__restrict out, uint32_t start);
+
+    size_t (*p4nzenc8)(uint8_t *__restrict in, size_t n, unsigned char *__restrict out);
+    size_t (*p4ndenc8)(uint8_t *__restrict in, size_t n, unsigned char *__restrict out);
+    size_t (*p4nzenc128v16)(uint16_t *__restrict in, size_t n, unsigned char *__restrict out);
+    size_t (*p4ndenc128v16)(uint16_t *__restrict in, size_t n, unsigned char *__restrict out);
+    size_t (*p4nzenc128v32)(uint32_t *__restrict in, size_t n, unsigned char *__restrict out);
+    size_t (*p4ndenc128v32)(uint32_t *__restrict in, size_t n, unsigned char *__restrict out);
+    size_t (*p4nzenc64)(uint64_t *__restrict in, size_t n, unsigned char *__restrict out);
+    size_t (*p4ndenc64)(uint64_t *__restrict in, size_t n, unsigned char *__restrict out);
+
+    size_t (*fpxenc32)(uint32_t *in, size_t n, unsigned char *out, uint32_t start);
+    size_t (*fpxdec32)(unsigned char *in, size_t n, uint32_t *out, uint32_t start);
+    size_t (*fpxenc64)(uint64_t *in, size_t n, unsigned char *out, uint64_t start);
+    size_t (*fpxdec64)(unsigned char *in, size_t n, uint64_t *out, uint64_t start);
+} OmKernels_t;
+
+/// Detect CPU features with `cpuid`. Result is a combination of `OmCpuFeature_t`.
+uint32_t om_cpu_features(void);
+
+/// Get the kernels for the running CPU. The selection is done once and is thread safe.
+/// On x86_64, kernels compiled for x86-64-v3 are used if the CPU supports AVX2, BMI2 and LZCNT and the library
+/// baseline does not target them already. Define `OM_DISABLE_RUNTIME_DISPATCH` to always use the baseline.
+const OmKernels_t* om_kernels(void);
+
+/// Number of kernel sets that can run on this CPU. Index 0 is the baseline. Used to check that all kernels encode the same bytes.
+uint64_t om_kernels_count(void);
+
+/// Kernel set `index` of `om_kernels_count`. Returns NULL if `index` is out of range.
+const OmKernels_t* om_kernels_at(uint64_t index);
+
+#endif // OM_DISPATCH_H
@@ -33,9 +33,15 @@ typedef struct {
 
     /// The size of the elements in bytes after compression, e.g. Int16 could be used to scale floats
     uint8_t bytes_per_element_compressed;
+
+    /// True if `OM_COMPRESSION_ADAPTIVE` was set and each chunk selects its own codec. `compression` does not include the flag.
+    uint8_t adaptive;
 } OmEncoder_t;
 
 /// Initialise the OmEncoder structure with information about the shape of data
+/// `compression` may include `OM_COMPRESSION_ADAPTIVE` to try filtered, unfiltered, raw and constant encoding for every chunk and keep the smallest.
+/// `OM_COMPRESSION_LUT_PACKED` does not change chunks. The LUT must then be written with `om_encoder_compress_lut_packed`.
+/// The same compression value must be stored in the array meta data.
 /// May return an error on invalid compression or data types
 OmError_t om_encoder_init(OmEncoder_t* encoder, float scale_factor, float add_offset, OmCompression_t compression, OmDataType_t data_type, const uint64_t* dimensions, const uint64_t* chunks, uint64_t dimension_count);
 
@@ -45,7 +51,7 @@ uint64_t om_encoder_count_chunks(const OmEncoder_t* encoder);
 /// Calculate how many chunks can be filled from a given input
 uint64_t om_encoder_count_chunks_in_array(const OmEncoder_t* encoder, const uint64_t* array_count);
 
-/// The buffer size required to collect a single chunk of data
+/// The buffer size required to collect a single chunk of data. With `OM_COMPRESSION_ADAPTIVE` this includes space to compress a second candidate.
 uint64_t om_encoder_chunk_buffer_size(const OmEncoder_t* encoder);
 
 /// The buffer size required to compress a single chunk.
@@ -57,7 +63,110 @@ uint64_t om_encoder_lut_buffer_size(const uint64_t* lookUpTable, uint64_t lookUp
 /// Compress the LUT and return the size of compressed LUT in bytes
 uint64_t om_encoder_compress_lut(const uint64_t* lookUpTable, uint64_t lookUpTableCount, uint8_t* out, uint64_t size_of_compressed_lut);
 
+/// Calculate the required buffer size for the entire LUT in packed blocks. See `OM_COMPRESSION_LUT_PACKED`.
+uint64_t om_encoder_lut_packed_buffer_size(const uint64_t* lookUpTable, uint64_t lookUpTableCount);
+
+/// Store the LUT in blocks of `LUT_CHUNK_COUNT` bit packed entries and return the size in bytes. `size_of_compressed_lut` must be the value of `om_encoder_lut_packed_buffer_size`.
+/// Readers can then look up a single entry without decompressing a block. The LUT is typically larger than the compressed LUT.
+/// The array meta data must include `OM_COMPRESSION_LUT_PACKED` in the compression type.
+uint64_t om_encoder_compress_lut_packed(const uint64_t* lookUpTable, uint64_t lookUpTableCount, uint8_t* out, uint64_t size_of_compressed_lut);
+
 /// Compress a single chunk. Chunk buffer must be of size `OmEncoder_chunkBufferSize`
 uint64_t om_encoder_compress_chunk(const OmEncoder_t* encoder, const void* array, const uint64_t* arrayDimensions, const uint64_t* arrayOffset, const uint64_t* arrayCount, uint64_t chunkIndex, uint64_t chunkIndexOffsetInThisArray, uint8_t* out, uint8_t* chunkBuffer);
 
+/// Compress a single chunk like `om_encoder_compress_chunk` and compute min, max and NaN count of the chunk into `stats`.
+/// Statistics are computed from the scaled values, so they match decoded values exactly. Only float arrays are supported. `stats` may be NULL.
+uint64_t om_encoder_compress_chunk_stats(const OmEncoder_t* encoder, const void* array, const uint64_t* arrayDimensions, const uint64_t* arrayOffset, const uint64_t* arrayCount, uint64_t chunkIndex, uint64_t chunkIndexOffsetInThisArray, uint8_t* out, uint8_t* chunkBuffer, OmChunkStats_t* stats);
+
+/// Compress a single chunk like `om_encoder_compress_chunk_stats`, but read the input with a byte stride for each dimension instead of a dense `arrayDimensions` array.
+/// This reads padded rows, transposed layouts or flipped grids without repacking. `array` points to the element at coordinate 0 of all dimensions and strides may be negative.
+/// The caller must ensure that all elements of `arrayOffset` and `arrayCount` are inside the input. `stats` may be NULL.
+uint64_t om_encoder_compress_chunk_strided(const OmEncoder_t* encoder, const void* array, const int64_t* arrayStrides, const uint64_t* arrayOffset, const uint64_t* arrayCount, uint64_t chunkIndex, uint64_t chunkIndexOffsetInThisArray, uint8_t* out, uint8_t* chunkBuffer, OmChunkStats_t* stats);
+
+/// Status of `om_encoder_pipeline_compress`
+typedef enum {
+    ENCODER_PIPELINE_COMPRESSED = 0, // A chunk has been compressed
+    ENCODER_PIPELINE_FULL = 1, // All output slots are in use. Wait until the output has been consumed
+    ENCODER_PIPELINE_DONE = 2, // All chunks have been compressed or are being compressed by other workers
+} OmEncoderPipelineStatus_t;
+
+/// Compress chunks of an array with multiple workers and return compressed chunks in order.
+///
+/// The library does not start threads. The caller starts workers that call `om_encoder_pipeline_compress` with their own chunk buffer.
+/// A single consumer calls `om_encoder_pipeline_next_output` to append compressed chunks to the file and the LUT in chunk order.
+/// The consumer may also act as a worker. Compressed chunks are stored in a ring of output slots in caller provided memory.
+typedef struct {
+    const OmEncoder_t* encoder;
+    const void* array;
+    const uint64_t* array_dimensions;
+    const uint64_t* array_offset;
+    const uint64_t* array_count;
+
+    /// Global chunk index of the first chunk in the array
+    uint64_t chunk_index_start;
+
+    /// Number of chunks in the array
+    uint64_t chunks_count;
+
+    /// Size of each output slot
+    uint64_t slot_size;
+
+    /// Number of output slots
+    uint64_t slots_count;
+
+    /// Compressed data for each slot
+    uint8_t* slots;
+
+    /// Compressed size for each slot. 0 if the slot has not been compressed yet.
+    volatile uint64_t* slot_sizes;
+
+    /// Optional statistics for each chunk in the array. Set after `om_encoder_pipeline_init`. NULL if not used.
+    OmChunkStats_t* chunk_stats;
+
+    /// Optional byte strides of `array` for `om_encoder_compress_chunk_strided`. Set after `om_encoder_pipeline_init`. `array_dimensions` is then ignored. NULL if not used.
+    const int64_t* array_strides;
+
+    /// The next chunk a worker compresses
+    volatile uint64_t next_compress;
+
+    /// The next chunk the consumer returns
+    volatile uint64_t next_output;
+
+    /// Set if the consumer stops early. Workers stop compressing.
+    volatile uint64_t cancelled;
+} OmEncoderPipeline_t;
+
+/// The memory required for a pipeline with `slots_count` output slots. Use at least one slot per worker.
+uint64_t om_encoder_pipeline_memory_size(const OmEncoder_t* encoder, uint64_t slots_count);
+
+/**
+ * @brief Initialise a pipeline to compress all chunks of an array. Arguments are the same as for `om_encoder_compress_chunk`.
+ *
+ * @param pipeline The pipeline to initialise. Must not be copied while in use.
+ * @param encoder The encoder
+ * @param array The input array. All pointers must remain valid while the pipeline is used.
+ * @param chunk_index_start Global chunk index of the first chunk in `array`
+ * @param memory Memory for output slots. Must remain valid while the pipeline is used.
+ * @param memory_size Size of `memory`. See `om_encoder_pipeline_memory_size`.
+ *
+ * @returns `ERROR_INVALID_DIMENSIONS` if the memory is too small for a single output slot.
+ */
+OmError_t om_encoder_pipeline_init(OmEncoderPipeline_t* pipeline, const OmEncoder_t* encoder, const void* array, const uint64_t* arrayDimensions, const uint64_t* arrayOffset, const uint64_t* arrayCount, uint64_t chunk_index_start, void* memory, uint64_t memory_size);
+
+/// Compress the next chunk. Thread-safe, but each worker must use its own chunk buffer of size `om_encoder_chunk_buffer_size`.
+OmEncoderPipelineStatus_t om_encoder_pipeline_compress(OmEncoderPipeline_t* pipeline, uint8_t* chunkBuffer);
+
+/// Get the next compressed chunk in chunk order. Returns false if the chunk is not compressed yet. Only a single thread may consume output.
+/// The data remains valid until `om_encoder_pipeline_release_output` is called.
+bool om_encoder_pipeline_next_output(const OmEncoderPipeline_t* pipeline, const uint8_t** data, uint64_t* size);
+
+/// Release the output of the last `om_encoder_pipeline_next_output` call. The slot is then reused to compress another chunk.
+void om_encoder_pipeline_release_output(OmEncoderPipeline_t* pipeline);
+
+/// True if all chunks have been returned by `om_encoder_pipeline_next_output` and have been released
+bool om_encoder_pipeline_is_complete(const OmEncoderPipeline_t* pipeline);
+
+/// Stop all workers. `om_encoder_pipeline_compress` returns `ENCODER_PIPELINE_DONE` afterwards.
+void om_encoder_pipeline_cancel(OmEncoderPipeline_t* pipeline);
+
 #endif // OM_ENCODER_H
@@ -3,7 +3,10 @@
 #include "vp4.h"
 #include "fp.h"
 #include "delta2d.h"
+#include "om_cache.h"
 #include "om_decoder.h"
 #include "om_encoder.h"
 #include "om_variable.h"
 #include "om_file.h"
+#include "om_uring.h"
+#include "om_dispatch.h"
@@ -0,0 +1,65 @@
+//
+//  om_uring.h
+//  OpenMeteoApi
+//
+//  Created on 14.10.2026.
+//
+
+#ifndef OM_URING_H
+#define OM_URING_H
+
+#include "om_common.h"
+
+/// A single read of `count` bytes at file `offset` into `buffer`
+typedef struct {
+    uint64_t offset;
+    uint64_t count;
+    void* buffer;
+} OmUringRead_t;
+
+/// Minimal io_uring submission and completion queue for batched file reads on Linux.
+/// Encoder and decoder stay free of IO. Bindings use this to submit all data reads of a decoder loop at once.
+/// A ring must only be used by one thread at a time.
+typedef struct {
+    /// Ring file descriptor. -1 if not initialised.
+    int fd;
+    /// Number of submission queue entries. At most this number of reads are in flight.
+    uint32_t entries;
+
+    uint32_t* sq_head;
+    uint32_t* sq_tail;
+    uint32_t* sq_mask;
+    uint32_t* sq_array;
+    /// Submission queue entries of type `struct io_uring_sqe`
+    void* sqes;
+
+    uint32_t* cq_head;
+    uint32_t* cq_tail;
+    uint32_t* cq_mask;
+    /// Completion queue entries of type `struct io_uring_cqe`
+    void* cqes;
+
+    void* sq_ring;
+    uint64_t sq_ring_size;
+    void* cq_ring;
+    uint64_t cq_ring_size;
+    uint64_t sqes_size;
+
+    /// Registered buffer. Reads into this memory range use fixed buffers and skip page pinning for each read.
+    uint8_t* buffer;
+    uint64_t buffer_size;
+} OmUring_t;
+
+/// Setup a ring with `entries` submission queue entries and optionally register `buffer` for fixed buffer reads.
+/// If registering the buffer fails (e.g. due to `RLIMIT_MEMLOCK`), reads still work without fixed buffers.
+/// Returns 0 or a negative errno. `-ENOSYS` if io_uring is not available on this system or kernel (requires Linux 5.7).
+int om_uring_init(OmUring_t* ring, uint32_t entries, void* buffer, uint64_t buffer_size);
+
+/// Read all `reads` from file descriptor `fd`. Reads are submitted in batches of up to `entries` and this function returns once all are complete.
+/// Short reads are completed synchronously. Returns 0 or a negative errno of the first failed read.
+int om_uring_read(OmUring_t* ring, int fd, const OmUringRead_t* reads, uint64_t count);
+
+/// Unmap the rings and close the ring file descriptor
+void om_uring_destroy(OmUring_t* ring);
+
+#endif // OM_URING_H
@@ -59,6 +59,35 @@ typedef struct {
     //char[name_size] name;
 } OmVariableArrayV3_t;
 
+/// Optional name index to look up children by name. Stored after the variable at the next 8 byte boundary and included in the variable size.
+/// Readers that do not know the index ignore it.
+typedef struct {
+    uint32_t magic; // OM_NAME_INDEX_MAGIC
+    uint32_t children_count;
+
+    // Followed by entries sorted by name hash
+    //OmNameIndexEntry_t[children_count] entries;
+} OmNameIndexV3_t;
+
+typedef struct {
+    uint64_t name_hash; // See `om_variable_name_hash`
+    uint32_t child_index;
+    uint32_t reserved;
+} OmNameIndexEntry_t;
+
+#define OM_NAME_INDEX_MAGIC 0x494E4D4F // "OMNI"
+
+/// Optional location of per-chunk statistics of an array. Stored after the variable and its name index at the next 8 byte boundary and included in the variable size.
+/// The statistics are an uncompressed `OmChunkStats_t[number_of_chunks]`, so statistics of a range of chunks can be read directly. Readers that do not know them ignore them.
+typedef struct {
+    uint32_t magic; // OM_CHUNK_STATS_MAGIC
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t size;
+} OmChunkStatsIndexV3_t;
+
+#define OM_CHUNK_STATS_MAGIC 0x53434D4F // "OMCS"
+
 /// only expose an opaque pointer
 typedef void* OmVariable_t;
 
@@ -76,9 +105,15 @@ const char* om_variable_get_name(const OmVariable_t* variable, uint16_t* length)
 /// Get the type of the current variable
 OmDataType_t om_variable_get_type(const OmVariable_t* variable);
 
-/// Get the compression type of the current variable
+/// Get the compression type of the current variable without `OM_COMPRESSION_ADAPTIVE` and `OM_COMPRESSION_LUT_PACKED`
 OmCompression_t om_variable_get_compression(const OmVariable_t* variable);
 
+/// True if each chunk of the array selects its own codec. See `OM_COMPRESSION_ADAPTIVE`.
+bool om_variable_is_adaptive(const OmVariable_t* variable);
+
+/// True if the LUT of the array is stored in bit packed blocks. See `OM_COMPRESSION_LUT_PACKED`.
+bool om_variable_is_lut_packed(const OmVariable_t* variable);
+
 float om_variable_get_scale_factor(const OmVariable_t* variable);
 
 float om_variable_get_add_offset(const OmVariable_t* variable);
@@ -98,6 +133,23 @@ uint32_t om_variable_get_children_count(const OmVariable_t* variable);
 /// Get the file offset where a specified child or children can be read
 bool om_variable_get_children(const OmVariable_t* variable, uint32_t children_offset, uint32_t children_count, uint64_t* children_offsets, uint64_t* children_sizes);
 
+/// Get the smallest file range that contains the meta data of all direct children. Returns false if there are no children.
+/// Files written with `OmFileWriter` store children before their parent, so reading this range together with the range of each child resolves a metadata subtree with very few IO operations.
+bool om_variable_get_children_range(const OmVariable_t* variable, uint64_t* offset, uint64_t* size);
+
+/// Resolve a child inside a buffer that holds file data starting at `buffer_offset`. The returned variable points into `buffer` and no data is copied.
+/// Returns NULL if the child is not entirely contained in the buffer or fails validation.
+const OmVariable_t* om_variable_get_child_in_buffer(const OmVariable_t* variable, uint32_t index, const void* buffer, uint64_t buffer_offset, uint64_t buffer_size);
+
+/// Look up a child by name using the optional name index. `variable_size` is the size of the variable as stored in the parent or trailer.
+/// Returns false if the variable has no name index. Otherwise `found` is set if a child with the same name hash exists and `child_index` is its position.
+/// The name of the child still needs to be compared, because different names can have the same hash.
+bool om_variable_lookup_child(const OmVariable_t* variable, uint64_t variable_size, const char* name, uint16_t name_size, bool* found, uint32_t* child_index);
+
+/// Get the file range of per-chunk statistics. `variable_size` is the size of the variable as stored in the parent or trailer.
+/// Returns false if the variable has no chunk statistics.
+bool om_variable_get_chunk_stats(const OmVariable_t* variable, uint64_t variable_size, uint64_t* offset, uint64_t* size);
+
 /// Read a variable as a scalar. Returns the size and value into the value and size field. `value` needs to be a pointer that then points to the value
 OmError_t om_variable_get_scalar(const OmVariable_t* variable, void** value, uint64_t* size);
 
@@ -158,6 +210,23 @@ void om_variable_write_numeric_array(void* dst, uint16_t name_size, uint32_t chi
 
 
 
+/// 64 bit FNV-1a hash of a variable name used in the name index
+uint64_t om_variable_name_hash(const char* name, uint16_t name_size);
+
+/// Get the size of the name index for a number of children. The index starts at the variable size rounded up to a multiple of 8.
+size_t om_variable_write_name_index_size(uint32_t children_count);
+
+/// Write a name index to `dst` with one name hash per child. Entries are sorted by hash.
+void om_variable_write_name_index(void* dst, uint32_t children_count, const uint64_t* name_hashes);
+
+/// Get the size of the chunk statistics location. It is stored after the name index or at the variable size rounded up to a multiple of 8.
+size_t om_variable_write_chunk_stats_size(void);
+
+/// Write the location of per-chunk statistics to `dst`
+void om_variable_write_chunk_stats(void* dst, uint64_t offset, uint64_t size);
+
+
+
 /// =========== Internal functions ===============
 
 /// Memory layout types
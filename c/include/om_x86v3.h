@@ -0,0 +1,346 @@
+//
+//  om_x86v3.h
+//  OpenMeteoApi
+//
+//  Created on 14.10.2026.
+//
+
+// Internal header for the `*_x86v3.c` clones of the PFor and FPX codecs. A clone translation unit includes the
+// original source file again, compiled for x86-64-v3 (AVX2, BMI2, LZCNT) and with every exported symbol renamed
+// with a `_x86v3` suffix. `om_dispatch.c` selects the clones at runtime if the CPU supports them, so that portable
+// builds do not depend on `-march`. Clones are only built for x86_64 with GCC or clang if the baseline does not
+// already target AVX2.
+//
+// The list of symbols is generated from the exported symbols of the cloned object files:
+// nm --defined-only -g vp4d_sse.o bitunpack_sse.o vp4c_sse.o bitpack_sse.o vp4d_def.o vp4c_def.o fp.o
+
+#ifndef OM_X86V3_H
+#define OM_X86V3_H
+
+#if defined(__x86_64__) && !defined(__AVX2__) && !defined(_MSC_VER) && !defined(OM_DISABLE_RUNTIME_DISPATCH)
+#define OM_X86V3_CLONES
+#endif
+
+#endif // OM_X86V3_H
+
+#if defined(OM_X86V3_CLONES) && defined(OM_X86V3_CLONE)
+
+// Target attributes for all functions in the clone. GCC also defines the matching feature macros. Every CPU with
+// AVX2 and BMI2 also supports BMI, POPCNT and SSE4.2, therefore `om_kernels()` only checks AVX2, BMI2 and LZCNT.
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx,avx2,bmi,bmi2,lzcnt,popcnt,sse4.2"))), apply_to = function)
+#ifndef __AVX__
+#define __AVX__ 1
+#endif
+#ifndef __AVX2__
+#define __AVX2__ 1
+#endif
+#ifndef __BMI__
+#define __BMI__ 1
+#endif
+#ifndef __BMI2__
+#define __BMI2__ 1
+#endif
+#ifndef __LZCNT__
+#define __LZCNT__ 1
+#endif
+#ifndef __POPCNT__
+#define __POPCNT__ 1
+#endif
+#ifndef __SSE4_2__
+#define __SSE4_2__ 1
+#endif
+#else
+#pragma GCC target("avx,avx2,bmi,bmi2,lzcnt,popcnt,sse4.2")
+#endif
+
+#define _bitd1unpack128v16 _bitd1unpack128v16_x86v3
+#define _bitd1unpack128v32 _bitd1unpack128v32_x86v3
+#define _bitdunpack128v16 _bitdunpack128v16_x86v3
+#define _bitdunpack128v32 _bitdunpack128v32_x86v3
+#define _bits1unpack128v16 _bits1unpack128v16_x86v3
+#define _bits1unpack128v32 _bits1unpack128v32_x86v3
+#define _bitunpack128v16 _bitunpack128v16_x86v3
+#define _bitunpack128v32 _bitunpack128v32_x86v3
+#define _bitunpack128v64 _bitunpack128v64_x86v3
+#define _bitunpack256w32 _bitunpack256w32_x86v3
+#define _bitzunpack128v16 _bitzunpack128v16_x86v3
+#define _bitzunpack128v32 _bitzunpack128v32_x86v3
+#define _p4bits16 _p4bits16_x86v3
+#define _p4bits32 _p4bits32_x86v3
+#define _p4bits64 _p4bits64_x86v3
+#define _p4bits8 _p4bits8_x86v3
+#define _p4d1dec128v16 _p4d1dec128v16_x86v3
+#define _p4d1dec128v32 _p4d1dec128v32_x86v3
+#define _p4d1dec16 _p4d1dec16_x86v3
+#define _p4d1dec32 _p4d1dec32_x86v3
+#define _p4d1dec64 _p4d1dec64_x86v3
+#define _p4d1dec8 _p4d1dec8_x86v3
+#define _p4ddec128v16 _p4ddec128v16_x86v3
+#define _p4ddec128v32 _p4ddec128v32_x86v3
+#define _p4ddec16 _p4ddec16_x86v3
+#define _p4ddec32 _p4ddec32_x86v3
+#define _p4ddec64 _p4ddec64_x86v3
+#define _p4ddec8 _p4ddec8_x86v3
+#define _p4dec128v16 _p4dec128v16_x86v3
+#define _p4dec128v32 _p4dec128v32_x86v3
+#define _p4dec128v64 _p4dec128v64_x86v3
+#define _p4dec16 _p4dec16_x86v3
+#define _p4dec32 _p4dec32_x86v3
+#define _p4dec64 _p4dec64_x86v3
+#define _p4dec8 _p4dec8_x86v3
+#define _p4enc128v16 _p4enc128v16_x86v3
+#define _p4enc128v32 _p4enc128v32_x86v3
+#define _p4enc128v64 _p4enc128v64_x86v3
+#define _p4enc16 _p4enc16_x86v3
+#define _p4enc32 _p4enc32_x86v3
+#define _p4enc64 _p4enc64_x86v3
+#define _p4enc8 _p4enc8_x86v3
+#define _p4zdec128v16 _p4zdec128v16_x86v3
+#define _p4zdec128v32 _p4zdec128v32_x86v3
+#define _p4zdec16 _p4zdec16_x86v3
+#define _p4zdec32 _p4zdec32_x86v3
+#define _p4zdec64 _p4zdec64_x86v3
+#define _p4zdec8 _p4zdec8_x86v3
+#define _shuffle_16 _shuffle_16_x86v3
+#define _shuffle_32 _shuffle_32_x86v3
+#define bitd1pack128v16 bitd1pack128v16_x86v3
+#define bitd1pack128v32 bitd1pack128v32_x86v3
+#define bitd1unpack128v16 bitd1unpack128v16_x86v3
+#define bitd1unpack128v32 bitd1unpack128v32_x86v3
+#define bitdpack128v16 bitdpack128v16_x86v3
+#define bitdpack128v32 bitdpack128v32_x86v3
+#define bitdunpack128v16 bitdunpack128v16_x86v3
+#define bitdunpack128v32 bitdunpack128v32_x86v3
+#define bitf1pack128v16 bitf1pack128v16_x86v3
+#define bitf1pack128v32 bitf1pack128v32_x86v3
+#define bitf1unpack128v16 bitf1unpack128v16_x86v3
+#define bitf1unpack128v32 bitf1unpack128v32_x86v3
+#define bitfpack128v16 bitfpack128v16_x86v3
+#define bitfpack128v32 bitfpack128v32_x86v3
+#define bitfunpack128v16 bitfunpack128v16_x86v3
+#define bitfunpack128v32 bitfunpack128v32_x86v3
+#define bitnd1pack128v16 bitnd1pack128v16_x86v3
+#define bitnd1pack128v32 bitnd1pack128v32_x86v3
+#define bitnd1unpack128v16 bitnd1unpack128v16_x86v3
+#define bitnd1unpack128v32 bitnd1unpack128v32_x86v3
+#define bitndpack128v16 bitndpack128v16_x86v3
+#define bitndpack128v32 bitndpack128v32_x86v3
+#define bitndunpack128v16 bitndunpack128v16_x86v3
+#define bitndunpack128v32 bitndunpack128v32_x86v3
+#define bitnfpack128v16 bitnfpack128v16_x86v3
+#define bitnfpack128v32 bitnfpack128v32_x86v3
+#define bitnfunpack128v16 bitnfunpack128v16_x86v3
+#define bitnfunpack128v32 bitnfunpack128v32_x86v3
+#define bitnpack128v16 bitnpack128v16_x86v3
+#define bitnpack128v32 bitnpack128v32_x86v3
+#define bitnpack128v64 bitnpack128v64_x86v3
+#define bitnpack256w32 bitnpack256w32_x86v3
+#define bitns1pack128v16 bitns1pack128v16_x86v3
+#define bitns1pack128v32 bitns1pack128v32_x86v3
+#define bitns1unpack128v16 bitns1unpack128v16_x86v3
+#define bitns1unpack128v32 bitns1unpack128v32_x86v3
+#define bitnunpack128v16 bitnunpack128v16_x86v3
+#define bitnunpack128v32 bitnunpack128v32_x86v3
+#define bitnunpack128v64 bitnunpack128v64_x86v3
+#define bitnunpack256w32 bitnunpack256w32_x86v3
+#define bitnzpack128v16 bitnzpack128v16_x86v3
+#define bitnzpack128v32 bitnzpack128v32_x86v3
+#define bitnzunpack128v16 bitnzunpack128v16_x86v3
+#define bitnzunpack128v32 bitnzunpack128v32_x86v3
+#define bitpack128v16 bitpack128v16_x86v3
+#define bitpack128v32 bitpack128v32_x86v3
+#define bitpack128v64 bitpack128v64_x86v3
+#define bitpack256w32 bitpack256w32_x86v3
+#define bits1pack128v16 bits1pack128v16_x86v3
+#define bits1pack128v32 bits1pack128v32_x86v3
+#define bits1unpack128v16 bits1unpack128v16_x86v3
+#define bits1unpack128v32 bits1unpack128v32_x86v3
+#define bitunpack128v16 bitunpack128v16_x86v3
+#define bitunpack128v32 bitunpack128v32_x86v3
+#define bitunpack128v64 bitunpack128v64_x86v3
+#define bitunpack256w32 bitunpack256w32_x86v3
+#define bitzpack128v16 bitzpack128v16_x86v3
+#define bitzpack128v32 bitzpack128v32_x86v3
+#define bitzunpack128v16 bitzunpack128v16_x86v3
+#define bitzunpack128v32 bitzunpack128v32_x86v3
+#define bvzdec16 bvzdec16_x86v3
+#define bvzdec32 bvzdec32_x86v3
+#define bvzdec64 bvzdec64_x86v3
+#define bvzdec8 bvzdec8_x86v3
+#define bvzenc16 bvzenc16_x86v3
+#define bvzenc32 bvzenc32_x86v3
+#define bvzenc64 bvzenc64_x86v3
+#define bvzenc8 bvzenc8_x86v3
+#define bvzzdec16 bvzzdec16_x86v3
+#define bvzzdec32 bvzzdec32_x86v3
+#define bvzzdec64 bvzzdec64_x86v3
+#define bvzzdec8 bvzzdec8_x86v3
+#define bvzzenc16 bvzzenc16_x86v3
+#define bvzzenc32 bvzzenc32_x86v3
+#define bvzzenc64 bvzzenc64_x86v3
+#define bvzzenc8 bvzzenc8_x86v3
+#define fp2dfcmdec16 fp2dfcmdec16_x86v3
+#define fp2dfcmdec32 fp2dfcmdec32_x86v3
+#define fp2dfcmdec64 fp2dfcmdec64_x86v3
+#define fp2dfcmdec8 fp2dfcmdec8_x86v3
+#define fp2dfcmenc16 fp2dfcmenc16_x86v3
+#define fp2dfcmenc32 fp2dfcmenc32_x86v3
+#define fp2dfcmenc64 fp2dfcmenc64_x86v3
+#define fp2dfcmenc8 fp2dfcmenc8_x86v3
+#define fpdfcmdec16 fpdfcmdec16_x86v3
+#define fpdfcmdec32 fpdfcmdec32_x86v3
+#define fpdfcmdec64 fpdfcmdec64_x86v3
+#define fpdfcmdec8 fpdfcmdec8_x86v3
+#define fpdfcmenc16 fpdfcmenc16_x86v3
+#define fpdfcmenc32 fpdfcmenc32_x86v3
+#define fpdfcmenc64 fpdfcmenc64_x86v3
+#define fpdfcmenc8 fpdfcmenc8_x86v3
+#define fpfcmdec16 fpfcmdec16_x86v3
+#define fpfcmdec32 fpfcmdec32_x86v3
+#define fpfcmdec64 fpfcmdec64_x86v3
+#define fpfcmdec8 fpfcmdec8_x86v3
+#define fpfcmenc16 fpfcmenc16_x86v3
+#define fpfcmenc32 fpfcmenc32_x86v3
+#define fpfcmenc64 fpfcmenc64_x86v3
+#define fpfcmenc8 fpfcmenc8_x86v3
+#define fpgdec16 fpgdec16_x86v3
+#define fpgdec32 fpgdec32_x86v3
+#define fpgdec64 fpgdec64_x86v3
+#define fpgdec8 fpgdec8_x86v3
+#define fpgenc16 fpgenc16_x86v3
+#define fpgenc32 fpgenc32_x86v3
+#define fpgenc64 fpgenc64_x86v3
+#define fpgenc8 fpgenc8_x86v3
+#define fpxdec16 fpxdec16_x86v3
+#define fpxdec32 fpxdec32_x86v3
+#define fpxdec64 fpxdec64_x86v3
+#define fpxdec8 fpxdec8_x86v3
+#define fpxenc16 fpxenc16_x86v3
+#define fpxenc32 fpxenc32_x86v3
+#define fpxenc64 fpxenc64_x86v3
+#define fpxenc8 fpxenc8_x86v3
+#define p4d1dec128v16 p4d1dec128v16_x86v3
+#define p4d1dec128v32 p4d1dec128v32_x86v3
+#define p4d1dec16 p4d1dec16_x86v3
+#define p4d1dec32 p4d1dec32_x86v3
+#define p4d1dec64 p4d1dec64_x86v3
+#define p4d1dec8 p4d1dec8_x86v3
+#define p4d1enc128v16 p4d1enc128v16_x86v3
+#define p4d1enc128v32 p4d1enc128v32_x86v3
+#define p4d1enc16 p4d1enc16_x86v3
+#define p4d1enc32 p4d1enc32_x86v3
+#define p4d1enc64 p4d1enc64_x86v3
+#define p4d1enc8 p4d1enc8_x86v3
+#define p4ddec128v16 p4ddec128v16_x86v3
+#define p4ddec128v32 p4ddec128v32_x86v3
+#define p4ddec16 p4ddec16_x86v3
+#define p4ddec32 p4ddec32_x86v3
+#define p4ddec64 p4ddec64_x86v3
+#define p4ddec8 p4ddec8_x86v3
+#define p4dec128v16 p4dec128v16_x86v3
+#define p4dec128v32 p4dec128v32_x86v3
+#define p4dec128v64 p4dec128v64_x86v3
+#define p4dec16 p4dec16_x86v3
+#define p4dec256w32 p4dec256w32_x86v3
+#define p4dec32 p4dec32_x86v3
+#define p4dec64 p4dec64_x86v3
+#define p4dec8 p4dec8_x86v3
+#define p4denc128v16 p4denc128v16_x86v3
+#define p4denc128v32 p4denc128v32_x86v3
+#define p4denc16 p4denc16_x86v3
+#define p4denc32 p4denc32_x86v3
+#define p4denc64 p4denc64_x86v3
+#define p4denc8 p4denc8_x86v3
+#define p4enc128v16 p4enc128v16_x86v3
+#define p4enc128v32 p4enc128v32_x86v3
+#define p4enc128v64 p4enc128v64_x86v3
+#define p4enc16 p4enc16_x86v3
+#define p4enc32 p4enc32_x86v3
+#define p4enc64 p4enc64_x86v3
+#define p4enc8 p4enc8_x86v3
+#define p4nd1dec128v16 p4nd1dec128v16_x86v3
+#define p4nd1dec128v32 p4nd1dec128v32_x86v3
+#define p4nd1dec16 p4nd1dec16_x86v3
+#define p4nd1dec32 p4nd1dec32_x86v3
+#define p4nd1dec64 p4nd1dec64_x86v3
+#define p4nd1dec8 p4nd1dec8_x86v3
+#define p4nd1enc128v16 p4nd1enc128v16_x86v3
+#define p4nd1enc128v32 p4nd1enc128v32_x86v3
+#define p4nd1enc16 p4nd1enc16_x86v3
+#define p4nd1enc32 p4nd1enc32_x86v3
+#define p4nd1enc64 p4nd1enc64_x86v3
+#define p4nd1enc8 p4nd1enc8_x86v3
+#define p4nddec128v16 p4nddec128v16_x86v3
+#define p4nddec128v32 p4nddec128v32_x86v3
+#define p4nddec16 p4nddec16_x86v3
+#define p4nddec32 p4nddec32_x86v3
+#define p4nddec64 p4nddec64_x86v3
+#define p4nddec8 p4nddec8_x86v3
+#define p4ndec128v16 p4ndec128v16_x86v3
+#define p4ndec128v32 p4ndec128v32_x86v3
+#define p4ndec128v64 p4ndec128v64_x86v3
+#define p4ndec16 p4ndec16_x86v3
+#define p4ndec256w32 p4ndec256w32_x86v3
+#define p4ndec32 p4ndec32_x86v3
+#define p4ndec64 p4ndec64_x86v3
+#define p4ndec8 p4ndec8_x86v3
+#define p4ndenc128v16 p4ndenc128v16_x86v3
+#define p4ndenc128v32 p4ndenc128v32_x86v3
+#define p4ndenc16 p4ndenc16_x86v3
+#define p4ndenc32 p4ndenc32_x86v3
+#define p4ndenc64 p4ndenc64_x86v3
+#define p4ndenc8 p4ndenc8_x86v3
+#define p4nenc128v16 p4nenc128v16_x86v3
+#define p4nenc128v32 p4nenc128v32_x86v3
+#define p4nenc128v64 p4nenc128v64_x86v3
+#define p4nenc16 p4nenc16_x86v3
+#define p4nenc32 p4nenc32_x86v3
+#define p4nenc64 p4nenc64_x86v3
+#define p4nenc8 p4nenc8_x86v3
+#define p4nsdec16 p4nsdec16_x86v3
+#define p4nsdec32 p4nsdec32_x86v3
+#define p4nsdec64 p4nsdec64_x86v3
+#define p4nsenc16 p4nsenc16_x86v3
+#define p4nsenc32 p4nsenc32_x86v3
+#define p4nsenc64 p4nsenc64_x86v3
+#define p4nzdec128v16 p4nzdec128v16_x86v3
+#define p4nzdec128v32 p4nzdec128v32_x86v3
+#define p4nzdec16 p4nzdec16_x86v3
+#define p4nzdec32 p4nzdec32_x86v3
+#define p4nzdec64 p4nzdec64_x86v3
+#define p4nzdec8 p4nzdec8_x86v3
+#define p4nzenc128v16 p4nzenc128v16_x86v3
+#define p4nzenc128v32 p4nzenc128v32_x86v3
+#define p4nzenc16 p4nzenc16_x86v3
+#define p4nzenc32 p4nzenc32_x86v3
+#define p4nzenc64 p4nzenc64_x86v3
+#define p4nzenc8 p4nzenc8_x86v3
+#define p4nzzdec128v16 p4nzzdec128v16_x86v3
+#define p4nzzdec128v32 p4nzzdec128v32_x86v3
+#define p4nzzdec128v64 p4nzzdec128v64_x86v3
+#define p4nzzdec128v8 p4nzzdec128v8_x86v3
+#define p4nzzenc128v16 p4nzzenc128v16_x86v3
+#define p4nzzenc128v32 p4nzzenc128v32_x86v3
+#define p4nzzenc128v64 p4nzzenc128v64_x86v3
+#define p4nzzenc128v8 p4nzzenc128v8_x86v3
+#define p4sdec16 p4sdec16_x86v3
+#define p4sdec32 p4sdec32_x86v3
+#define p4sdec64 p4sdec64_x86v3
+#define p4senc16 p4senc16_x86v3
+#define p4senc32 p4senc32_x86v3
+#define p4senc64 p4senc64_x86v3
+#define p4zdec128v16 p4zdec128v16_x86v3
+#define p4zdec128v32 p4zdec128v32_x86v3
+#define p4zdec16 p4zdec16_x86v3
+#define p4zdec32 p4zdec32_x86v3
+#define p4zdec64 p4zdec64_x86v3
+#define p4zdec8 p4zdec8_x86v3
+#define p4zenc128v16 p4zenc128v16_x86v3
+#define p4zenc128v32 p4zenc128v32_x86v3
+#define p4zenc16 p4zenc16_x86v3
+#define p4zenc32 p4zenc32_x86v3
+#define p4zenc64 p4zenc64_x86v3
+#define p4zenc8 p4zenc8_x86v3
+
+#endif // OM_X86V3_CLONE
@@ -0,0 +1,18 @@
+//
+//  bitpack_sse_x86v3.c
+//  OpenMeteoApi
+//
+//  Created on 14.10.2026.
+//
+
+// x86-64-v3 clone of `bitpack_sse.c` for runtime CPU dispatch. See `om_x86v3.h`.
+
+#define OM_X86V3_CLONE
+#include "om_x86v3.h"
+
+#ifdef OM_X86V3_CLONES
+#include "bitpack_sse.c"
+#if defined(__clang__)
+#pragma clang attribute pop
+#endif
+#endif
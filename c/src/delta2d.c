@@ -1,137 +1,279 @@
 #include "delta2d.h"
+#include "conf.h"
+
+// Rows are filtered as one flat recurrence `buffer[i] op= buffer[i - length1]` over the whole chunk. Whenever a row
+// is at least one vector wide, the elements `length1` back are already final, so vectors can span row boundaries and
+// short rows like `[3,3,120]` or `[1,50,24]` do not fall back to scalar tails. Kernels are selected at compile time.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define DELTA2D_V256
+#endif
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define DELTA2D_V128
+typedef __m128i delta2d_v128_t;
+#define delta2d_load128(p) _mm_loadu_si128((const __m128i*)(p))
+#define delta2d_store128(p, v) _mm_storeu_si128((__m128i*)(p), v)
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define DELTA2D_V128
+typedef uint8x16_t delta2d_v128_t;
+#define delta2d_load128(p) vld1q_u8((const uint8_t*)(p))
+#define delta2d_store128(p, v) vst1q_u8((uint8_t*)(p), v)
+#endif
+
+typedef enum {
+    DELTA2D_ADD,
+    DELTA2D_SUB,
+    DELTA2D_XOR
+} delta2d_op_t;
+
+#ifdef DELTA2D_V256
+static ALWAYS_INLINE __m256i delta2d_op256(delta2d_op_t op, size_t size, __m256i a, __m256i b) {
+    switch (op) {
+        case DELTA2D_ADD:
+            return size == 1 ? _mm256_add_epi8(a, b) : size == 2 ? _mm256_add_epi16(a, b) : size == 4 ? _mm256_add_epi32(a, b) : _mm256_add_epi64(a, b);
+        case DELTA2D_SUB:
+            return size == 1 ? _mm256_sub_epi8(a, b) : size == 2 ? _mm256_sub_epi16(a, b) : size == 4 ? _mm256_sub_epi32(a, b) : _mm256_sub_epi64(a, b);
+        case DELTA2D_XOR:
+            return _mm256_xor_si256(a, b);
+    }
+    return a;
+}
+#endif
+
+#if defined(DELTA2D_V128) && defined(__SSE2__)
+static ALWAYS_INLINE delta2d_v128_t delta2d_op128(delta2d_op_t op, size_t size, delta2d_v128_t a, delta2d_v128_t b) {
+    switch (op) {
+        case DELTA2D_ADD:
+            return size == 1 ? _mm_add_epi8(a, b) : size == 2 ? _mm_add_epi16(a, b) : size == 4 ? _mm_add_epi32(a, b) : _mm_add_epi64(a, b);
+        case DELTA2D_SUB:
+            return size == 1 ? _mm_sub_epi8(a, b) : size == 2 ? _mm_sub_epi16(a, b) : size == 4 ? _mm_sub_epi32(a, b) : _mm_sub_epi64(a, b);
+        case DELTA2D_XOR:
+            return _mm_xor_si128(a, b);
+    }
+    return a;
+}
+#elif defined(DELTA2D_V128)
+static ALWAYS_INLINE delta2d_v128_t delta2d_op128(delta2d_op_t op, size_t size, delta2d_v128_t a, delta2d_v128_t b) {
+    switch (op) {
+        case DELTA2D_ADD:
+            switch (size) {
+                case 1: return vaddq_u8(a, b);
+                case 2: return vreinterpretq_u8_u16(vaddq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+                case 4: return vreinterpretq_u8_u32(vaddq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+                default: return vreinterpretq_u8_u64(vaddq_u64(vreinterpretq_u64_u8(a), vreinterpretq_u64_u8(b)));
+            }
+        case DELTA2D_SUB:
+            switch (size) {
+                case 1: return vsubq_u8(a, b);
+                case 2: return vreinterpretq_u8_u16(vsubq_u16(vreinterpretq_u16_u8(a), vreinterpretq_u16_u8(b)));
+                case 4: return vreinterpretq_u8_u32(vsubq_u32(vreinterpretq_u32_u8(a), vreinterpretq_u32_u8(b)));
+                default: return vreinterpretq_u8_u64(vsubq_u64(vreinterpretq_u64_u8(a), vreinterpretq_u64_u8(b)));
+            }
+        case DELTA2D_XOR:
+            return veorq_u8(a, b);
+    }
+    return a;
+}
+#endif
+
+/// Scalar operation on unsigned integers. Wrapping behaviour matches the vector lanes.
+static ALWAYS_INLINE void delta2d_op1(delta2d_op_t op, size_t size, void* buffer, size_t i, size_t distance) {
+    #define DELTA2D_OP1(type) { \
+        type* b = (type*)buffer; \
+        switch (op) { \
+            case DELTA2D_ADD: b[i] += b[i - distance]; break; \
+            case DELTA2D_SUB: b[i] -= b[i - distance]; break; \
+            case DELTA2D_XOR: b[i] ^= b[i - distance]; break; \
+        } \
+        break; \
+    }
+    switch (size) {
+        case 1: DELTA2D_OP1(uint8_t)
+        case 2: DELTA2D_OP1(uint16_t)
+        case 4: DELTA2D_OP1(uint32_t)
+        default: DELTA2D_OP1(uint64_t)
+    }
+    #undef DELTA2D_OP1
+}
+
+/// Apply `buffer[i] op= buffer[i - distance]` for `i` in `[begin, end)` in ascending order. Used to decode.
+/// Requires `begin >= distance`.
+static ALWAYS_INLINE void delta2d_forward(delta2d_op_t op, size_t size, size_t begin, size_t end, size_t distance, void* buffer) {
+    uint8_t* bytes = (uint8_t*)buffer;
+    size_t i = begin;
+#ifdef DELTA2D_V256
+    if (distance * size >= 32) {
+        for (; i + 32 / size <= end; i += 32 / size) {
+            const __m256i a = _mm256_loadu_si256((const __m256i*)(bytes + i * size));
+            const __m256i b = _mm256_loadu_si256((const __m256i*)(bytes + (i - distance) * size));
+            _mm256_storeu_si256((__m256i*)(bytes + i * size), delta2d_op256(op, size, a, b));
+        }
+    }
+#endif
+#ifdef DELTA2D_V128
+    if (distance * size >= 16) {
+        for (; i + 16 / size <= end; i += 16 / size) {
+            const delta2d_v128_t a = delta2d_load128(bytes + i * size);
+            const delta2d_v128_t b = delta2d_load128(bytes + (i - distance) * size);
+            delta2d_store128(bytes + i * size, delta2d_op128(op, size, a, b));
+        }
+    }
+#endif
+    for (; i < end; i++) {
+        delta2d_op1(op, size, buffer, i, distance);
+    }
+}
+
+/// Apply `buffer[i] op= buffer[i - distance]` for `i` in `[begin, end)` in descending order. Used to encode.
+/// Requires `begin >= distance`.
+static ALWAYS_INLINE void delta2d_backward(delta2d_op_t op, size_t size, size_t begin, size_t end, size_t distance, void* buffer) {
+    uint8_t* bytes = (uint8_t*)buffer;
+    size_t i = end;
+#ifdef DELTA2D_V256
+    if (distance * size >= 32) {
+        for (; i >= begin + 32 / size; i -= 32 / size) {
+            const size_t j = i - 32 / size;
+            const __m256i a = _mm256_loadu_si256((const __m256i*)(bytes + j * size));
+            const __m256i b = _mm256_loadu_si256((const __m256i*)(bytes + (j - distance) * size));
+            _mm256_storeu_si256((__m256i*)(bytes + j * size), delta2d_op256(op, size, a, b));
+        }
+    }
+#endif
+#ifdef DELTA2D_V128
+    if (distance * size >= 16) {
+        for (; i >= begin + 16 / size; i -= 16 / size) {
+            const size_t j = i - 16 / size;
+            const delta2d_v128_t a = delta2d_load128(bytes + j * size);
+            const delta2d_v128_t b = delta2d_load128(bytes + (j - distance) * size);
+            delta2d_store128(bytes + j * size, delta2d_op128(op, size, a, b));
+        }
+    }
+#endif
+    for (; i > begin; i--) {
+        delta2d_op1(op, size, buffer, i - 1, distance);
+    }
+}
 
 void delta2d_decode8(const size_t length0, const size_t length1, int8_t* chunkBuffer) {
     if (length0 <= 1) {
         return;
     }
-    for (size_t d0 = 1; d0 < length0; d0++) {
-        for (size_t d1 = 0; d1 < length1; d1++) {
-            chunkBuffer[d0*length1 + d1] += chunkBuffer[(d0-1)*length1 + d1];
-        }
-    }
+    delta2d_forward(DELTA2D_ADD, 1, length1, length0 * length1, length1, chunkBuffer);
 }
 
 void delta2d_encode8(const size_t length0, const size_t length1, int8_t* chunkBuffer) {
     if (length0 <= 1) {
         return;
     }
-    for (size_t d0 = length0-1; d0 >= 1; d0--) {
-        for (size_t d1 = 0; d1 < length1; d1++) {
-            chunkBuffer[d0*length1 + d1] -= chunkBuffer[(d0-1)*length1 + d1];
-        }
-    }
+    delta2d_backward(DELTA2D_SUB, 1, length1, length0 * length1, length1, chunkBuffer);
 }
 
 void delta2d_decode16(const size_t length0, const size_t length1, int16_t* chunkBuffer) {
     if (length0 <= 1) {
         return;
     }
-    for (size_t d0 = 1; d0 < length0; d0++) {
-        for (size_t d1 = 0; d1 < length1; d1++) {
-            chunkBuffer[d0*length1 + d1] += chunkBuffer[(d0-1)*length1 + d1];
-        }
+    delta2d_forward(DELTA2D_ADD, 2, length1, length0 * length1, length1, chunkBuffer);
+}
+
+void delta2d_decode16_range(const size_t length1, const size_t begin, const size_t end, int16_t* chunkBuffer) {
+    const size_t first = begin < length1 ? length1 : begin;
+    if (first >= end) {
+        return;
     }
+    delta2d_forward(DELTA2D_ADD, 2, first, end, length1, chunkBuffer);
 }
 
 void delta2d_encode16(const size_t length0, const size_t length1, int16_t* chunkBuffer) {
     if (length0 <= 1) {
         return;
     }
-    for (size_t d0 = length0-1; d0 >= 1; d0--) {
-        for (size_t d1 = 0; d1 < length1; d1++) {
-            chunkBuffer[d0*length1 + d1] -= chunkBuffer[(d0-1)*length1 + d1];
-        }
-    }
+    delta2d_backward(DELTA2D_SUB, 2, length1, length0 * length1, length1, chunkBuffer);
 }
 
 void delta2d_decode32(const size_t length0, const size_t length1, int32_t* chunkBuffer) {
     if (length0 <= 1) {
         return;
     }
-    for (size_t d0 = 1; d0 < length0; d0++) {
-        for (size_t d1 = 0; d1 < length1; d1++) {
-            chunkBuffer[d0*length1 + d1] += chunkBuffer[(d0-1)*length1 + d1];
-        }
-    }
+    delta2d_forward(DELTA2D_ADD, 4, length1, length0 * length1, length1, chunkBuffer);
 }
 
 void delta2d_encode32(const size_t length0, const size_t length1, int32_t* chunkBuffer) {
     if (length0 <= 1) {
         return;
     }
-    for (size_t d0 = length0-1; d0 >= 1; d0--) {
-        for (size_t d1 = 0; d1 < length1; d1++) {
-            chunkBuffer[d0*length1 + d1] -= chunkBuffer[(d0-1)*length1 + d1];
-        }
-    }
+    delta2d_backward(DELTA2D_SUB, 4, length1, length0 * length1, length1, chunkBuffer);
 }
 
 void delta2d_decode64(const size_t length0, const size_t length1, int64_t* chunkBuffer) {
     if (length0 <= 1) {
         return;
     }
-    for (size_t d0 = 1; d0 < length0; d0++) {
-        for (size_t d1 = 0; d1 < length1; d1++) {
-            chunkBuffer[d0*length1 + d1] += chunkBuffer[(d0-1)*length1 + d1];
-        }
-    }
+    delta2d_forward(DELTA2D_ADD, 8, length1, length0 * length1, length1, chunkBuffer);
 }
 
 void delta2d_encode64(const size_t length0, const size_t length1, int64_t* chunkBuffer) {
     if (length0 <= 1) {
         return;
     }
-    for (size_t d0 = length0-1; d0 >= 1; d0--) {
-        for (size_t d1 = 0; d1 < length1; d1++) {
-            chunkBuffer[d0*length1 + d1] -= chunkBuffer[(d0-1)*length1 + d1];
-        }
-    }
+    delta2d_backward(DELTA2D_SUB, 8, length1, length0 * length1, length1, chunkBuffer);
 }
 
 void delta2d_decode_xor(const size_t length0, const size_t length1, float* chunkBuffer) {
     if (length0 <= 1) {
         return;
     }
-    int* chunkBufferInt = (int*)chunkBuffer;
-    for (size_t d0 = 1; d0 < length0; d0++) {
-        for (size_t d1 = 0; d1 < length1; d1++) {
-            chunkBufferInt[d0*length1 + d1] ^= chunkBufferInt[(d0-1)*length1 + d1];
-        }
-    }
+    delta2d_forward(DELTA2D_XOR, 4, length1, length0 * length1, length1, chunkBuffer);
 }
 
 void delta2d_encode_xor(const size_t length0, const size_t length1, float* chunkBuffer) {
     if (length0 <= 1) {
         return;
     }
-    int* chunkBufferInt = (int*)chunkBuffer;
-    for (size_t d0 = length0-1; d0 >= 1; d0--) {
-        for (size_t d1 = 0; d1 < length1; d1++) {
-            chunkBufferInt[d0*length1 + d1] ^= chunkBufferInt[(d0-1)*length1 + d1];
-        }
-    }
+    delta2d_backward(DELTA2D_XOR, 4, length1, length0 * length1, length1, chunkBuffer);
 }
 
+// NOTE: Double arrays are filtered as 32 bit integers with the same lengths. This only covers the first half of the
+// buffer, but is part of the file format and must be kept.
 void delta2d_decode_xor_double(const size_t length0, const size_t length1, double* chunkBuffer) {
     if (length0 <= 1) {
         return;
     }
-    int* chunkBufferInt = (int*)chunkBuffer;
-    for (size_t d0 = 1; d0 < length0; d0++) {
-        for (size_t d1 = 0; d1 < length1; d1++) {
-            chunkBufferInt[d0*length1 + d1] ^= chunkBufferInt[(d0-1)*length1 + d1];
-        }
-    }
+    delta2d_forward(DELTA2D_XOR, 4, length1, length0 * length1, length1, chunkBuffer);
 }
 
 void delta2d_encode_xor_double(const size_t length0, const size_t length1, double* chunkBuffer) {
     if (length0 <= 1) {
         return;
     }
-    int* chunkBufferInt = (int*)chunkBuffer;
-    for (size_t d0 = length0-1; d0 >= 1; d0--) {
-        for (size_t d1 = 0; d1 < length1; d1++) {
-            chunkBufferInt[d0*length1 + d1] ^= chunkBufferInt[(d0-1)*length1 + d1];
-        }
+    delta2d_backward(DELTA2D_XOR, 4, length1, length0 * length1, length1, chunkBuffer);
+}
+
+void delta2d_decode_linear32(const size_t length0, const size_t length1, int32_t* chunkBuffer) {
+    for (size_t row = 0; row < length0; row++) {
+        delta2d_forward(DELTA2D_ADD, 4, 1, length1, 1, chunkBuffer + row * length1);
+    }
+    delta2d_decode32(length0, length1, chunkBuffer);
+}
+
+void delta2d_encode_linear32(const size_t length0, const size_t length1, int32_t* chunkBuffer) {
+    delta2d_encode32(length0, length1, chunkBuffer);
+    for (size_t row = 0; row < length0; row++) {
+        delta2d_backward(DELTA2D_SUB, 4, 1, length1, 1, chunkBuffer + row * length1);
+    }
+}
+
+void delta2d_decode_linear64(const size_t length0, const size_t length1, int64_t* chunkBuffer) {
+    for (size_t row = 0; row < length0; row++) {
+        delta2d_forward(DELTA2D_ADD, 8, 1, length1, 1, chunkBuffer + row * length1);
+    }
+    delta2d_decode64(length0, length1, chunkBuffer);
+}
+
+void delta2d_encode_linear64(const size_t length0, const size_t length1, int64_t* chunkBuffer) {
+    delta2d_encode64(length0, length1, chunkBuffer);
+    for (size_t row = 0; row < length0; row++) {
+        delta2d_backward(DELTA2D_SUB, 8, 1, length1, 1, chunkBuffer + row * length1);
     }
 }
@@ -99,6 +99,10 @@
 
 #define uint_t TEMPLATE3(uint, USIZE, _t)
 #define int_t  TEMPLATE3(int,  USIZE, _t)
+// Leading zeros of the OR of all predictor residuals in a block. `clz` of 0 is undefined, so a block without residuals is defined as
+// USIZE, the result of LZCNT. Baseline and x86-64-v3 kernels then write the same bytes. Shifts by `b` are masked for this case.
+#define CLZB(_x_) ((_x_) ? TEMPLATE2(clz,USIZE)(_x_) : USIZE)
+#define SHB(_b_, _usize_) ((_b_) & ((_usize_) - 1))
 
 //-------- TurboPFor Zigzag of zigzag for unsorted/sorted integer/floating point array ---------------------------------------
 size_t TEMPLATE2(p4nzzenc128v,USIZE)(uint_t *in, size_t n, unsigned char *out, uint_t start) {
@@ -173,8 +177,8 @@ size_t TEMPLATE2(fpxenc,USIZE)(uint_t *in, size_t n, unsigned char *out, uint_t
       #else
     for(p = _p; p != &_p[VSIZE]; p+=4,ip+=4) { FE(0,USIZE); FE(1,USIZE); FE(2,USIZE); FE(3,USIZE); }
       #endif
-    *op++ = b = TEMPLATE2(clz,USIZE)(b);
-    #define TR(i,_usize_) p[i] = TEMPLATE2(rbit,_usize_)(p[i]<<b)
+    *op++ = b = CLZB(b);
+    #define TR(i,_usize_) p[i] = TEMPLATE2(rbit,_usize_)(p[i]<<SHB(b,_usize_))
       #if defined(__AVX2__) && USIZE >= 32
     for(p = _p; p != &_p[VSIZE]; p+=64/(USIZE/8)) {
       __m256i v0 = _mm256_loadu_si256((__m256i *)p);
@@ -204,7 +208,7 @@ size_t TEMPLATE2(fpxenc,USIZE)(uint_t *in, size_t n, unsigned char *out, uint_t
   }
   if((n = (in+n)-ip)) { uint_t b = 0;
     for(p = _p; p != &_p[n]; p++,ip++) FE(0,USIZE);
-    b = TEMPLATE2(clz,USIZE)(b);
+    b = CLZB(b);
     *op++ = b;
     for(p = _p; p != &_p[n]; p++) TR(0,USIZE);
     op = TEMPLATE2(P4ENC,USIZE)(_p, n, op);
@@ -222,7 +226,7 @@ size_t TEMPLATE2(fpxdec,USIZE)(unsigned char *in, size_t n, uint_t *out, uint_t
   #define _mm_set1_epi64(a) _mm_set1_epi64x(a)
   __m128i sv = TEMPLATE2(_mm_set1_epi, USIZE)(start);
     #endif
-  #define FD(i,_usize_) { TEMPLATE3(uint, USIZE, _t) u = p[i]; u = TEMPLATE2(rbit,_usize_)(u)>>b; u = XORDEC(u, start,_usize_); op[i] = start = u; }
+  #define FD(i,_usize_) { TEMPLATE3(uint, USIZE, _t) u = p[i]; u = TEMPLATE2(rbit,_usize_)(u)>>SHB(b,_usize_); u = XORDEC(u, start,_usize_); op[i] = start = u; }
   for(op = out; op != out+(n&~(VSIZE-1)); ) {                           PREFETCH(ip+512,0);
     unsigned b = *ip++; ip = TEMPLATE2(P4DECV,USIZE)(ip, VSIZE, _p);
 
@@ -287,7 +291,7 @@ size_t TEMPLATE2(fpfcmenc,USIZE)(uint_t *in, size_t n, unsigned char *out, uint_
   for(ip = in; ip != in + (n&~(VSIZE-1)); ) { uint_t b = 0;
     #define FE(i,_usize_) { TEMPLATE3(uint, _usize_, _t) u = ip[i]; p[i] = XORENC(u, htab[h],_usize_); b |= p[i]; htab[h] = u; h = TEMPLATE2(HASH,_usize_)(h,u); }
     for(p = _p; p != &_p[VSIZE]; p+=4,ip+=4) { FE(0,USIZE); FE(1,USIZE); FE(2,USIZE); FE(3,USIZE); }
-    *op++ = b = TEMPLATE2(clz,USIZE)(b);
+    *op++ = b = CLZB(b);
       #if defined(__AVX2__) && USIZE >= 32
     for(p = _p; p != &_p[VSIZE]; p+=64/(USIZE/8)) {
       __m256i v0 = _mm256_loadu_si256((__m256i *)p);
@@ -311,14 +315,14 @@ size_t TEMPLATE2(fpfcmenc,USIZE)(uint_t *in, size_t n, unsigned char *out, uint_
       _mm_storeu_si128((__m128i *)(p+16/(USIZE/8)), v1);
     }
       #else
-    #define TR(i,_usize_) p[i] = TEMPLATE2(rbit,_usize_)(p[i]<<b)
+    #define TR(i,_usize_) p[i] = TEMPLATE2(rbit,_usize_)(p[i]<<SHB(b,_usize_))
     for(p = _p; p != &_p[VSIZE]; p+=4) { TR(0,USIZE); TR(1,USIZE); TR(2,USIZE); TR(3,USIZE); }
       #endif
     op = TEMPLATE2(P4ENCV,USIZE)(_p, VSIZE, op);                                                    PREFETCH(ip+512,0);
   }
   if((n = (in+n)-ip)) { uint_t b = 0;
     for(p = _p; p != &_p[n]; p++,ip++) FE(0,USIZE);
-    b = TEMPLATE2(clz,USIZE)(b);
+    b = CLZB(b);
     *op++ = b;
     for(p = _p; p != &_p[n]; p++) TR(0,USIZE);
     op = TEMPLATE2(P4ENC,USIZE)(_p, n, op);
@@ -330,7 +334,7 @@ size_t TEMPLATE2(fpfcmdec,USIZE)(unsigned char *in, size_t n, uint_t *out, uint_
   uint_t *op, htab[1<<HBITS] = {0}, h = 0, _p[VSIZE+32],*p;
   unsigned char *ip = in;
 
-  #define FD(i,_usize_) { TEMPLATE3(uint, _usize_, _t) u = p[i]; u = TEMPLATE2(rbit,_usize_)(u)>>b;\
+  #define FD(i,_usize_) { TEMPLATE3(uint, _usize_, _t) u = p[i]; u = TEMPLATE2(rbit,_usize_)(u)>>SHB(b,_usize_);\
     u = XORDEC(u, htab[h], _usize_); op[i] = u; htab[h] = u; h = TEMPLATE2(HASH,_usize_)(h,u);\
   }
   for(op = (uint_t*)out; op != out+(n&~(VSIZE-1)); ) {                          PREFETCH(ip+512,0);
@@ -354,14 +358,14 @@ size_t TEMPLATE2(fpdfcmenc,USIZE)(uint_t *in, size_t n, unsigned char *out, uint
   }
   for(ip = in; ip != in + (n&~(VSIZE-1)); ) { uint_t b = 0;
     for(p = _p; p != &_p[VSIZE]; p+=4,ip+=4) { FE(0,USIZE); FE(1,USIZE); FE(2,USIZE); FE(3,USIZE); }
-    #define TR(i,_usize_) p[i] = TEMPLATE2(rbit,_usize_)(p[i]<<b)
-    b = TEMPLATE2(clz,USIZE)(b);
+    #define TR(i,_usize_) p[i] = TEMPLATE2(rbit,_usize_)(p[i]<<SHB(b,_usize_))
+    b = CLZB(b);
     for(p = _p; p != &_p[VSIZE]; p+=4) { TR(0,USIZE); TR(1,USIZE); TR(2,USIZE); TR(3,USIZE); }
     *op++ = b; op = TEMPLATE2(P4ENCV,USIZE)(_p, VSIZE, op);                                                     PREFETCH(ip+512,0);
   }
   if((n = (in+n)-ip)) { uint_t b = 0;
     for(p = _p; p != &_p[n]; p++,ip++) FE(0,USIZE);
-    b = TEMPLATE2(clz,USIZE)(b);
+    b = CLZB(b);
     for(p = _p; p != &_p[n]; p++) TR(0,USIZE);
     *op++ = b; op = TEMPLATE2(P4ENC,USIZE)(_p, n, op);
   }
@@ -372,7 +376,7 @@ size_t TEMPLATE2(fpdfcmdec,USIZE)(unsigned char *in, size_t n, uint_t *out, uint
   uint_t        _p[VSIZE+32], *op, h = 0, *p, htab[1<<HBITS] = {0};
   unsigned char *ip = in;
 
-  #define FD(i,_usize_) { TEMPLATE3(uint, _usize_, _t) u = TEMPLATE2(rbit,_usize_)(p[i])>>b; u = XORDEC(u, (htab[h]+start),_usize_); \
+  #define FD(i,_usize_) { TEMPLATE3(uint, _usize_, _t) u = TEMPLATE2(rbit,_usize_)(p[i])>>SHB(b,_usize_); u = XORDEC(u, (htab[h]+start),_usize_); \
     op[i] = u; htab[h] = start = u-start; h = TEMPLATE2(HASH,_usize_)(h,start); start = u;\
   }
   for(op = (uint_t*)out; op != out+(n&~(VSIZE-1)); ) {                                          PREFETCH(ip+512,0);
@@ -396,12 +400,12 @@ size_t TEMPLATE2(fp2dfcmenc,USIZE)(uint_t *in, size_t n, unsigned char *out, uin
   #define FE(i,_usize_) { TEMPLATE3(uint, _usize_, _t) u = ip[i]; p[i] = XORENC(u, (htab[h]+start),_usize_); b |= p[i]; \
     htab[h] = start = u - start; h = TEMPLATE2(HASH,_usize_)(h,start); start = start0; start0 = u;\
   }
-  #define TR(i,_usize_) p[i] = TEMPLATE2(rbit,_usize_)(p[i]<<b)
+  #define TR(i,_usize_) p[i] = TEMPLATE2(rbit,_usize_)(p[i]<<SHB(b,_usize_))
 
   for(ip = in; ip != in + (n&~(VSIZE-1)); ) {
     uint_t b = 0;
     for(p = _p; p != &_p[VSIZE]; p+=4,ip+=4) { FE(0,USIZE); FE(1,USIZE); FE(2,USIZE); FE(3,USIZE); }
-    b = TEMPLATE2(clz,USIZE)(b);
+    b = CLZB(b);
 
     for(p = _p; p != &_p[VSIZE]; p+=4) { TR(0,USIZE); TR(1,USIZE); TR(2,USIZE); TR(3,USIZE); }
     *op++ = b; op = TEMPLATE2(P4ENCV,USIZE)(_p, VSIZE, op);                                                     PREFETCH(ip+512,0);
@@ -409,7 +413,7 @@ size_t TEMPLATE2(fp2dfcmenc,USIZE)(uint_t *in, size_t n, unsigned char *out, uin
   if((n = (in+n)-ip)) {
     uint_t b = 0;
     for(p = _p; p != &_p[n]; p++,ip++) FE(0,USIZE);
-    b = TEMPLATE2(clz,USIZE)(b);
+    b = CLZB(b);
 
     for(p = _p; p != &_p[n]; p++) TR(0,USIZE);
     *op++ = b; op = TEMPLATE2(P4ENC,USIZE)(_p, n, op);
@@ -421,7 +425,7 @@ size_t TEMPLATE2(fp2dfcmdec,USIZE)(unsigned char *in, size_t n, uint_t *out, uin
   uint_t      _p[VSIZE+32], *op, h = 0, *p, htab[1<<HBITS] = {0},start0=start; start=0; ;
   unsigned char *ip = in;
 
-  #define FD(i,_usize_) { TEMPLATE3(uint, _usize_, _t) u = TEMPLATE2(rbit,_usize_)(p[i])>>b; u = XORDEC(u, (htab[h]+start),_usize_);\
+  #define FD(i,_usize_) { TEMPLATE3(uint, _usize_, _t) u = TEMPLATE2(rbit,_usize_)(p[i])>>SHB(b,_usize_); u = XORDEC(u, (htab[h]+start),_usize_);\
     op[i] = u; htab[h] = start = u-start; h = TEMPLATE2(HASH,_usize_)(h,start); start = start0; start0 = u;\
   }
 
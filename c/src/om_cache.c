@@ -0,0 +1,136 @@
+//
+//  om_cache.c
+//  OpenMeteoApi
+//
+//  Created on 14.10.2026.
+//
+
+#include <string.h>
+#include "om_cache.h"
+#include "om_atomic.h"
+
+/// Mix key values to select a set. Based on splitmix64.
+static uint64_t om_cache_hash(OmCacheKey_t key) {
+    uint64_t x = key.file * 0x9E3779B97F4A7C15ULL ^ key.variable * 0xC2B2AE3D27D4EB4FULL ^ key.index;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+static bool om_cache_key_equal(OmCacheKey_t a, OmCacheKey_t b) {
+    return a.file == b.file && a.variable == b.variable && a.index == b.index;
+}
+
+void om_cache_init(OmCache_t* cache, void* memory, uint64_t memory_size, uint64_t slot_size) {
+    // Round slot size up to 8 bytes to keep slots aligned
+    slot_size = (slot_size + 7) / 8 * 8;
+    const uint64_t set_size = OM_CACHE_WAYS * (sizeof(OmCacheSlot_t) + slot_size) + 1;
+    const uint64_t sets_count = memory_size / set_size;
+    const uint64_t slots_count = sets_count * OM_CACHE_WAYS;
+
+    cache->slots = (OmCacheSlot_t*)memory;
+    cache->data = (uint8_t*)memory + slots_count * sizeof(OmCacheSlot_t);
+    cache->hands = cache->data + slots_count * slot_size;
+    cache->slot_size = slot_size;
+    cache->sets_count = sets_count;
+    memset(cache->shards, 0, sizeof(cache->shards));
+    om_cache_clear(cache);
+}
+
+void om_cache_clear(OmCache_t* cache) {
+    // Locks are always taken in the same order. Get and put only hold a single lock.
+    for (uint64_t shard = 0; shard < OM_CACHE_SHARDS; shard++) {
+        om_spin_lock(&cache->shards[shard].lock);
+    }
+    memset(cache->slots, 0, cache->sets_count * OM_CACHE_WAYS * sizeof(OmCacheSlot_t));
+    memset(cache->hands, 0, cache->sets_count);
+    for (uint64_t shard = 0; shard < OM_CACHE_SHARDS; shard++) {
+        cache->shards[shard].hits = 0;
+        cache->shards[shard].misses = 0;
+        om_spin_unlock(&cache->shards[shard].lock);
+    }
+}
+
+void om_cache_statistics(OmCache_t* cache, uint64_t* hits, uint64_t* misses) {
+    (*hits) = 0;
+    (*misses) = 0;
+    for (uint64_t shard = 0; shard < OM_CACHE_SHARDS; shard++) {
+        OmCacheShard_t* s = &cache->shards[shard];
+        om_spin_lock(&s->lock);
+        (*hits) += s->hits;
+        (*misses) += s->misses;
+        om_spin_unlock(&s->lock);
+    }
+}
+
+bool om_cache_get(OmCache_t* cache, OmCacheKey_t key, void* into, uint64_t size) {
+    if (cache->sets_count == 0) {
+        return false;
+    }
+    const uint64_t set = om_cache_hash(key) % cache->sets_count;
+    OmCacheShard_t* shard = &cache->shards[set % OM_CACHE_SHARDS];
+    bool found = false;
+    om_spin_lock(&shard->lock);
+    for (uint64_t way = 0; way < OM_CACHE_WAYS; way++) {
+        const uint64_t slot = set * OM_CACHE_WAYS + way;
+        OmCacheSlot_t* meta = &cache->slots[slot];
+        if (meta->size == size && om_cache_key_equal(meta->key, key)) {
+            meta->referenced = 1;
+            memcpy(into, cache->data + slot * cache->slot_size, size);
+            found = true;
+            break;
+        }
+    }
+    if (found) {
+        shard->hits++;
+    } else {
+        shard->misses++;
+    }
+    om_spin_unlock(&shard->lock);
+    return found;
+}
+
+void om_cache_put(OmCache_t* cache, OmCacheKey_t key, const void* data, uint64_t size) {
+    if (cache->sets_count == 0 || size == 0 || size > cache->slot_size) {
+        return;
+    }
+    const uint64_t set = om_cache_hash(key) % cache->sets_count;
+    OmCacheShard_t* shard = &cache->shards[set % OM_CACHE_SHARDS];
+    om_spin_lock(&shard->lock);
+
+    // Reuse the slot if the key is already present or take an empty slot
+    uint64_t victim = OM_CACHE_WAYS;
+    for (uint64_t way = 0; way < OM_CACHE_WAYS; way++) {
+        const OmCacheSlot_t* meta = &cache->slots[set * OM_CACHE_WAYS + way];
+        if (meta->size != 0 && om_cache_key_equal(meta->key, key)) {
+            victim = way;
+            break;
+        }
+        if (meta->size == 0 && victim == OM_CACHE_WAYS) {
+            victim = way;
+        }
+    }
+
+    // CLOCK eviction: Skip and clear recently referenced slots
+    if (victim == OM_CACHE_WAYS) {
+        uint8_t hand = cache->hands[set];
+        while (true) {
+            OmCacheSlot_t* meta = &cache->slots[set * OM_CACHE_WAYS + hand];
+            if (!meta->referenced) {
+                victim = hand;
+                break;
+            }
+            meta->referenced = 0;
+            hand = (hand + 1) % OM_CACHE_WAYS;
+        }
+        cache->hands[set] = (hand + 1) % OM_CACHE_WAYS;
+    }
+
+    const uint64_t slot = set * OM_CACHE_WAYS + victim;
+    OmCacheSlot_t* meta = &cache->slots[slot];
+    meta->key = key;
+    meta->size = size;
+    meta->referenced = 1;
+    memcpy(cache->data + slot * cache->slot_size, data, size);
+    om_spin_unlock(&shard->lock);
+}
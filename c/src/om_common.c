@@ -7,13 +7,83 @@
 
 #include "om_common.h"
 #include <math.h>
+#include <string.h>
 #include "vp4.h"
 #include "fp.h"
 #include "conf.h"
+#include "om_dispatch.h"
 #pragma clang diagnostic ignored "-Wunused-parameter"
 #pragma clang diagnostic warning "-Wbad-function-cast"
 #pragma clang diagnostic error "-Wswitch"
 
+// SIMD kernels for scale/offset conversions are selected at compile time like the `*_avx2.c` and `*_sse.c` codecs.
+// All kernels are bit-exact to the scalar loops: `roundf` semantics (round half away from zero), true division,
+// NaN sentinels and clamping are reproduced exactly. Remaining elements are processed by the scalar loop.
+// Logarithmic conversions stay scalar, because `log10f` and `powf` have no bit-exact vector equivalent.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define OM_COMMON_AVX2
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>
+#define OM_COMMON_SSE41
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define OM_COMMON_NEON
+#endif
+
+#if defined(OM_COMMON_AVX2)
+/// Round half away from zero like `roundf`. `x - trunc(x)` is exact for all floats.
+static inline __m256 om_round256_ps(__m256 x) {
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 truncated = _mm256_round_ps(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    const __m256 fraction = _mm256_and_ps(_mm256_sub_ps(x, truncated), abs_mask);
+    const __m256 away = _mm256_cmp_ps(fraction, _mm256_set1_ps(0.5f), _CMP_GE_OQ);
+    const __m256 one = _mm256_or_ps(_mm256_set1_ps(1.0f), _mm256_andnot_ps(abs_mask, x));
+    return _mm256_add_ps(truncated, _mm256_and_ps(away, one));
+}
+
+/// Scale, round and clamp 8 floats to int32. NaN inputs are replaced by `nan_value`.
+/// `_mm256_min_ps` returns the second operand for NaN like `fminf` returns the number.
+static inline __m256i om_scale256_ps(__m256 val, __m256 scale, __m256 offset, __m256 min, __m256 max, __m256i nan_value) {
+    const __m256 isnan_mask = _mm256_cmp_ps(val, val, _CMP_UNORD_Q);
+    const __m256 scaled = _mm256_mul_ps(_mm256_add_ps(val, offset), scale);
+    const __m256 clamped = _mm256_max_ps(_mm256_min_ps(om_round256_ps(scaled), max), min);
+    return _mm256_blendv_epi8(_mm256_cvttps_epi32(clamped), nan_value, _mm256_castps_si256(isnan_mask));
+}
+#endif
+
+#if defined(OM_COMMON_SSE41)
+/// Round half away from zero like `roundf`. `x - trunc(x)` is exact for all floats.
+static inline __m128 om_round128_ps(__m128 x) {
+    const __m128 abs_mask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    const __m128 truncated = _mm_round_ps(x, _MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC);
+    const __m128 fraction = _mm_and_ps(_mm_sub_ps(x, truncated), abs_mask);
+    const __m128 away = _mm_cmpge_ps(fraction, _mm_set1_ps(0.5f));
+    const __m128 one = _mm_or_ps(_mm_set1_ps(1.0f), _mm_andnot_ps(abs_mask, x));
+    return _mm_add_ps(truncated, _mm_and_ps(away, one));
+}
+
+/// Scale, round and clamp 4 floats to int32. NaN inputs are replaced by `nan_value`.
+/// `_mm_min_ps` returns the second operand for NaN like `fminf` returns the number.
+static inline __m128i om_scale128_ps(__m128 val, __m128 scale, __m128 offset, __m128 min, __m128 max, __m128i nan_value) {
+    const __m128 isnan_mask = _mm_cmpunord_ps(val, val);
+    const __m128 scaled = _mm_mul_ps(_mm_add_ps(val, offset), scale);
+    const __m128 clamped = _mm_max_ps(_mm_min_ps(om_round128_ps(scaled), max), min);
+    return _mm_blendv_epi8(_mm_cvttps_epi32(clamped), nan_value, _mm_castps_si128(isnan_mask));
+}
+#endif
+
+#if defined(OM_COMMON_NEON)
+/// Scale, round and clamp 4 floats to int32. NaN inputs are replaced by `nan_value`.
+/// `vrndaq` rounds half away from zero like `roundf`. `vminnmq`/`vmaxnmq` return the number for NaN like `fminf`/`fmaxf`.
+static inline int32x4_t om_scale_f32(float32x4_t val, float32x4_t scale, float32x4_t offset, float32x4_t min, float32x4_t max, int32x4_t nan_value) {
+    const uint32x4_t notnan_mask = vceqq_f32(val, val);
+    const float32x4_t scaled = vmulq_f32(vaddq_f32(val, offset), scale);
+    const float32x4_t clamped = vmaxnmq_f32(min, vminnmq_f32(max, vrndaq_f32(scaled)));
+    return vbslq_s32(notnan_mask, vcvtq_s32_f32(clamped), nan_value);
+}
+#endif
+
 const char* om_error_string(OmError_t error) {
     switch (error) {
         case ERROR_OK:
@@ -38,6 +108,10 @@ const char* om_error_string(OmError_t error) {
             return "Invalid read count dimensions";
         case ERROR_INVALID_CUBE_OFFSET:
             return "Invalid read cube offset dimensions";
+        case ERROR_INVALID_BATCH:
+            return "Invalid batch: Reads must be for the same variable";
+        case ERROR_LUT_CACHE_MISS:
+            return "LUT chunk not in cache. Index data required";
     }
     return "";
 }
@@ -106,6 +180,13 @@ uint8_t om_get_bytes_per_element_compressed(OmDataType_t data_type, OmCompressio
         case COMPRESSION_PFOR_DELTA2D:
             return om_get_bytes_per_element(data_type, error);
 
+        case COMPRESSION_PFOR_FLOAT_LINEAR2D:
+            if (data_type != DATA_TYPE_FLOAT_ARRAY && data_type != DATA_TYPE_DOUBLE_ARRAY) {
+                *error = ERROR_INVALID_DATA_TYPE;
+                break;
+            }
+            return om_get_bytes_per_element(data_type, error);
+
         default:
             *error = ERROR_INVALID_COMPRESSION_TYPE;
     }
@@ -113,7 +194,36 @@ uint8_t om_get_bytes_per_element_compressed(OmDataType_t data_type, OmCompressio
 }
 
 void om_common_copy_float_to_int16(uint64_t length, float scale_factor, float add_offset, const void* src, void* dst) {
-    for (uint64_t i = 0; i < length; ++i) {
+    uint64_t i = 0;
+#if defined(OM_COMMON_AVX2)
+    const __m256 scale = _mm256_set1_ps(scale_factor), offset = _mm256_set1_ps(add_offset);
+    const __m256 min = _mm256_set1_ps(INT16_MIN), max = _mm256_set1_ps(INT16_MAX);
+    const __m256i nan_value = _mm256_set1_epi32(INT16_MAX);
+    for (; i + 8 <= length; i += 8) {
+        const __m256i v = om_scale256_ps(_mm256_loadu_ps((float *)src + i), scale, offset, min, max, nan_value);
+        const __m128i packed = _mm_packs_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        _mm_storeu_si128((__m128i *)((int16_t *)dst + i), packed);
+    }
+#elif defined(OM_COMMON_SSE41)
+    const __m128 scale = _mm_set1_ps(scale_factor), offset = _mm_set1_ps(add_offset);
+    const __m128 min = _mm_set1_ps(INT16_MIN), max = _mm_set1_ps(INT16_MAX);
+    const __m128i nan_value = _mm_set1_epi32(INT16_MAX);
+    for (; i + 8 <= length; i += 8) {
+        const __m128i lo = om_scale128_ps(_mm_loadu_ps((float *)src + i), scale, offset, min, max, nan_value);
+        const __m128i hi = om_scale128_ps(_mm_loadu_ps((float *)src + i + 4), scale, offset, min, max, nan_value);
+        _mm_storeu_si128((__m128i *)((int16_t *)dst + i), _mm_packs_epi32(lo, hi));
+    }
+#elif defined(OM_COMMON_NEON)
+    const float32x4_t scale = vdupq_n_f32(scale_factor), offset = vdupq_n_f32(add_offset);
+    const float32x4_t min = vdupq_n_f32(INT16_MIN), max = vdupq_n_f32(INT16_MAX);
+    const int32x4_t nan_value = vdupq_n_s32(INT16_MAX);
+    for (; i + 8 <= length; i += 8) {
+        const int32x4_t lo = om_scale_f32(vld1q_f32((float *)src + i), scale, offset, min, max, nan_value);
+        const int32x4_t hi = om_scale_f32(vld1q_f32((float *)src + i + 4), scale, offset, min, max, nan_value);
+        vst1q_s16((int16_t *)dst + i, vcombine_s16(vqmovn_s32(lo), vqmovn_s32(hi)));
+    }
+#endif
+    for (; i < length; ++i) {
         float val = ((float *)src)[i];
         if (isnan(val)) {
             ((int16_t *)dst)[i] = INT16_MAX;
@@ -126,7 +236,33 @@ void om_common_copy_float_to_int16(uint64_t length, float scale_factor, float ad
 }
 
 void om_common_copy_float_to_int32(uint64_t length, float scale_factor, float add_offset, const void* src, void* dst) {
-    for (uint64_t i = 0; i < length; ++i) {
+    uint64_t i = 0;
+    // Note: `(float)INT32_MAX` rounds up to 2^31. The vector conversion yields the same result as the scalar cast.
+#if defined(OM_COMMON_AVX2)
+    const __m256 scale = _mm256_set1_ps(scale_factor), offset = _mm256_set1_ps(add_offset);
+    const __m256 min = _mm256_set1_ps((float)INT32_MIN), max = _mm256_set1_ps((float)INT32_MAX);
+    const __m256i nan_value = _mm256_set1_epi32(INT32_MAX);
+    for (; i + 8 <= length; i += 8) {
+        const __m256i v = om_scale256_ps(_mm256_loadu_ps((float *)src + i), scale, offset, min, max, nan_value);
+        _mm256_storeu_si256((__m256i *)((int32_t *)dst + i), v);
+    }
+#elif defined(OM_COMMON_SSE41)
+    const __m128 scale = _mm_set1_ps(scale_factor), offset = _mm_set1_ps(add_offset);
+    const __m128 min = _mm_set1_ps((float)INT32_MIN), max = _mm_set1_ps((float)INT32_MAX);
+    const __m128i nan_value = _mm_set1_epi32(INT32_MAX);
+    for (; i + 4 <= length; i += 4) {
+        const __m128i v = om_scale128_ps(_mm_loadu_ps((float *)src + i), scale, offset, min, max, nan_value);
+        _mm_storeu_si128((__m128i *)((int32_t *)dst + i), v);
+    }
+#elif defined(OM_COMMON_NEON)
+    const float32x4_t scale = vdupq_n_f32(scale_factor), offset = vdupq_n_f32(add_offset);
+    const float32x4_t min = vdupq_n_f32((float)INT32_MIN), max = vdupq_n_f32((float)INT32_MAX);
+    const int32x4_t nan_value = vdupq_n_s32(INT32_MAX);
+    for (; i + 4 <= length; i += 4) {
+        vst1q_s32((int32_t *)dst + i, om_scale_f32(vld1q_f32((float *)src + i), scale, offset, min, max, nan_value));
+    }
+#endif
+    for (; i < length; ++i) {
         float val = ((float *)src)[i];
         if (isnan(val)) {
             ((int32_t *)dst)[i] = INT32_MAX;
@@ -139,7 +275,21 @@ void om_common_copy_float_to_int32(uint64_t length, float scale_factor, float ad
 }
 
 void om_common_copy_double_to_int64(uint64_t length, float scale_factor, float add_offset, const void* src, void* dst) {
-    for (uint64_t i = 0; i < length; ++i) {
+    uint64_t i = 0;
+    // x86 has no packed double to int64 conversion before AVX-512DQ. Only NEON is vectorised.
+#if defined(OM_COMMON_NEON)
+    const float64x2_t scale = vdupq_n_f64((double)scale_factor), offset = vdupq_n_f64((double)add_offset);
+    const float64x2_t min = vdupq_n_f64((double)INT64_MIN), max = vdupq_n_f64((double)INT64_MAX);
+    const int64x2_t nan_value = vdupq_n_s64(INT64_MAX);
+    for (; i + 2 <= length; i += 2) {
+        const float64x2_t val = vld1q_f64((double *)src + i);
+        const uint64x2_t notnan_mask = vceqq_f64(val, val);
+        const float64x2_t scaled = vmulq_f64(vaddq_f64(val, offset), scale);
+        const float64x2_t clamped = vmaxnmq_f64(min, vminnmq_f64(max, vrndaq_f64(scaled)));
+        vst1q_s64((int64_t *)dst + i, vbslq_s64(notnan_mask, vcvtq_s64_f64(clamped), nan_value));
+    }
+#endif
+    for (; i < length; ++i) {
         double val = ((double *)src)[i];
         if (isnan(val)) {
             ((int64_t *)dst)[i] = INT64_MAX;
@@ -165,21 +315,88 @@ void om_common_copy_float_to_int16_log10(uint64_t length, float scale_factor, co
 }
 
 void om_common_copy_int16_to_float(uint64_t length, float scale_factor, float add_offset, const void* src, void* dst) {
-    for (uint64_t i = 0; i < length; ++i) {
+    uint64_t i = 0;
+#if defined(OM_COMMON_AVX2)
+    const __m256 scale = _mm256_set1_ps(scale_factor), offset = _mm256_set1_ps(add_offset), nan = _mm256_set1_ps(NAN);
+    const __m256i sentinel = _mm256_set1_epi32(INT16_MAX);
+    for (; i + 8 <= length; i += 8) {
+        const __m256i val = _mm256_cvtepi16_epi32(_mm_loadu_si128((__m128i *)((int16_t *)src + i)));
+        const __m256 converted = _mm256_sub_ps(_mm256_div_ps(_mm256_cvtepi32_ps(val), scale), offset);
+        const __m256 isnan_mask = _mm256_castsi256_ps(_mm256_cmpeq_epi32(val, sentinel));
+        _mm256_storeu_ps((float *)dst + i, _mm256_blendv_ps(converted, nan, isnan_mask));
+    }
+#elif defined(OM_COMMON_SSE41)
+    const __m128 scale = _mm_set1_ps(scale_factor), offset = _mm_set1_ps(add_offset), nan = _mm_set1_ps(NAN);
+    const __m128i sentinel = _mm_set1_epi32(INT16_MAX);
+    for (; i + 4 <= length; i += 4) {
+        const __m128i val = _mm_cvtepi16_epi32(_mm_loadl_epi64((__m128i *)((int16_t *)src + i)));
+        const __m128 converted = _mm_sub_ps(_mm_div_ps(_mm_cvtepi32_ps(val), scale), offset);
+        const __m128 isnan_mask = _mm_castsi128_ps(_mm_cmpeq_epi32(val, sentinel));
+        _mm_storeu_ps((float *)dst + i, _mm_blendv_ps(converted, nan, isnan_mask));
+    }
+#elif defined(OM_COMMON_NEON)
+    const float32x4_t scale = vdupq_n_f32(scale_factor), offset = vdupq_n_f32(add_offset), nan = vdupq_n_f32(NAN);
+    const int32x4_t sentinel = vdupq_n_s32(INT16_MAX);
+    for (; i + 4 <= length; i += 4) {
+        const int32x4_t val = vmovl_s16(vld1_s16((int16_t *)src + i));
+        const float32x4_t converted = vsubq_f32(vdivq_f32(vcvtq_f32_s32(val), scale), offset);
+        vst1q_f32((float *)dst + i, vbslq_f32(vceqq_s32(val, sentinel), nan, converted));
+    }
+#endif
+    for (; i < length; ++i) {
         int16_t val = ((int16_t *)src)[i];
         ((float *)dst)[i] = (val == INT16_MAX) ? NAN : (float)val / scale_factor - add_offset;
     }
 }
 
 void om_common_copy_int32_to_float(uint64_t length, float scale_factor, float add_offset, const void* src, void* dst) {
-    for (uint64_t i = 0; i < length; ++i) {
+    uint64_t i = 0;
+#if defined(OM_COMMON_AVX2)
+    const __m256 scale = _mm256_set1_ps(scale_factor), offset = _mm256_set1_ps(add_offset), nan = _mm256_set1_ps(NAN);
+    const __m256i sentinel = _mm256_set1_epi32(INT32_MAX);
+    for (; i + 8 <= length; i += 8) {
+        const __m256i val = _mm256_loadu_si256((__m256i *)((int32_t *)src + i));
+        const __m256 converted = _mm256_sub_ps(_mm256_div_ps(_mm256_cvtepi32_ps(val), scale), offset);
+        const __m256 isnan_mask = _mm256_castsi256_ps(_mm256_cmpeq_epi32(val, sentinel));
+        _mm256_storeu_ps((float *)dst + i, _mm256_blendv_ps(converted, nan, isnan_mask));
+    }
+#elif defined(OM_COMMON_SSE41)
+    const __m128 scale = _mm_set1_ps(scale_factor), offset = _mm_set1_ps(add_offset), nan = _mm_set1_ps(NAN);
+    const __m128i sentinel = _mm_set1_epi32(INT32_MAX);
+    for (; i + 4 <= length; i += 4) {
+        const __m128i val = _mm_loadu_si128((__m128i *)((int32_t *)src + i));
+        const __m128 converted = _mm_sub_ps(_mm_div_ps(_mm_cvtepi32_ps(val), scale), offset);
+        const __m128 isnan_mask = _mm_castsi128_ps(_mm_cmpeq_epi32(val, sentinel));
+        _mm_storeu_ps((float *)dst + i, _mm_blendv_ps(converted, nan, isnan_mask));
+    }
+#elif defined(OM_COMMON_NEON)
+    const float32x4_t scale = vdupq_n_f32(scale_factor), offset = vdupq_n_f32(add_offset), nan = vdupq_n_f32(NAN);
+    const int32x4_t sentinel = vdupq_n_s32(INT32_MAX);
+    for (; i + 4 <= length; i += 4) {
+        const int32x4_t val = vld1q_s32((int32_t *)src + i);
+        const float32x4_t converted = vsubq_f32(vdivq_f32(vcvtq_f32_s32(val), scale), offset);
+        vst1q_f32((float *)dst + i, vbslq_f32(vceqq_s32(val, sentinel), nan, converted));
+    }
+#endif
+    for (; i < length; ++i) {
         int32_t val = ((int32_t *)src)[i];
         ((float *)dst)[i] = (val == INT32_MAX) ? NAN : (float)val / scale_factor - add_offset;
     }
 }
 
 void om_common_copy_int64_to_double(uint64_t length, float scale_factor, float add_offset, const void* src, void* dst) {
-    for (uint64_t i = 0; i < length; ++i) {
+    uint64_t i = 0;
+    // x86 has no packed int64 to double conversion before AVX-512DQ. Only NEON is vectorised.
+#if defined(OM_COMMON_NEON)
+    const float64x2_t scale = vdupq_n_f64((double)scale_factor), offset = vdupq_n_f64((double)add_offset), nan = vdupq_n_f64(NAN);
+    const int64x2_t sentinel = vdupq_n_s64(INT64_MAX);
+    for (; i + 2 <= length; i += 2) {
+        const int64x2_t val = vld1q_s64((int64_t *)src + i);
+        const float64x2_t converted = vsubq_f64(vdivq_f64(vcvtq_f64_s64(val), scale), offset);
+        vst1q_f64((double *)dst + i, vbslq_f64(vceqq_s64(val, sentinel), nan, converted));
+    }
+#endif
+    for (; i < length; ++i) {
         int64_t val = ((int64_t *)src)[i];
         ((double *)dst)[i] = (val == INT64_MAX) ? NAN : (double)val / (double)scale_factor - (double)add_offset;
     }
@@ -192,6 +409,119 @@ void om_common_copy_int16_to_float_log10(uint64_t length, float scale_factor, co
     }
 }
 
+/// IEEE half precision with round to nearest even. Bit-exact to F16C `_mm256_cvtps_ph`, including NaN payloads.
+static inline uint16_t om_float_to_float16(float value) {
+    uint32_t x;
+    memcpy(&x, &value, sizeof(x));
+    const uint16_t sign = (uint16_t)((x >> 16) & 0x8000);
+    x &= 0x7FFFFFFF;
+    if (x > 0x7F800000) {
+        // NaN: keep the upper payload bits and set the quiet bit
+        return sign | 0x7E00 | (uint16_t)((x >> 13) & 0x3FF);
+    }
+    if (x >= 0x477FF000) {
+        // Infinity and values that round to more than 65504
+        return sign | 0x7C00;
+    }
+    if (x < 0x38800000) {
+        // Subnormal half: Adding 0.5 rounds to a multiple of 2^-24 with the FPU rounding mode
+        float f;
+        memcpy(&f, &x, sizeof(f));
+        f += 0.5f;
+        uint32_t r;
+        memcpy(&r, &f, sizeof(r));
+        return sign | (uint16_t)(r - 0x3F000000);
+    }
+    // Rebias the exponent from 127 to 15 and round the mantissa to nearest even
+    x += 0xC8000FFF + ((x >> 13) & 1);
+    return sign | (uint16_t)(x >> 13);
+}
+
+/// Upper 16 bits of a float with round to nearest even. NaN stays NaN.
+static inline uint16_t om_float_to_bfloat16(float value) {
+    uint32_t x;
+    memcpy(&x, &value, sizeof(x));
+    if ((x & 0x7FFFFFFF) > 0x7F800000) {
+        return (uint16_t)((x >> 16) | 0x40);
+    }
+    x += 0x7FFF + ((x >> 16) & 1);
+    return (uint16_t)(x >> 16);
+}
+
+void om_common_copy_int16_to_float16(uint64_t length, float scale_factor, float add_offset, const void* src, void* dst) {
+    uint64_t i = 0;
+#if defined(OM_COMMON_AVX2) && defined(__F16C__)
+    const __m256 scale = _mm256_set1_ps(scale_factor), offset = _mm256_set1_ps(add_offset), nan = _mm256_set1_ps(NAN);
+    const __m256i sentinel = _mm256_set1_epi32(INT16_MAX);
+    for (; i + 8 <= length; i += 8) {
+        const __m256i val = _mm256_cvtepi16_epi32(_mm_loadu_si128((__m128i *)((int16_t *)src + i)));
+        const __m256 converted = _mm256_sub_ps(_mm256_div_ps(_mm256_cvtepi32_ps(val), scale), offset);
+        const __m256 isnan_mask = _mm256_castsi256_ps(_mm256_cmpeq_epi32(val, sentinel));
+        const __m128i half = _mm256_cvtps_ph(_mm256_blendv_ps(converted, nan, isnan_mask), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i *)((uint16_t *)dst + i), half);
+    }
+#endif
+    for (; i < length; ++i) {
+        int16_t val = ((int16_t *)src)[i];
+        ((uint16_t *)dst)[i] = om_float_to_float16((val == INT16_MAX) ? NAN : (float)val / scale_factor - add_offset);
+    }
+}
+
+void om_common_copy_int16_to_bfloat16(uint64_t length, float scale_factor, float add_offset, const void* src, void* dst) {
+    for (uint64_t i = 0; i < length; ++i) {
+        int16_t val = ((int16_t *)src)[i];
+        ((uint16_t *)dst)[i] = om_float_to_bfloat16((val == INT16_MAX) ? NAN : (float)val / scale_factor - add_offset);
+    }
+}
+
+void om_common_copy_float_to_float16(uint64_t length, const void* src, void* dst) {
+    uint64_t i = 0;
+#if defined(OM_COMMON_AVX2) && defined(__F16C__)
+    for (; i + 8 <= length; i += 8) {
+        const __m128i half = _mm256_cvtps_ph(_mm256_loadu_ps((float *)src + i), _MM_FROUND_TO_NEAREST_INT);
+        _mm_storeu_si128((__m128i *)((uint16_t *)dst + i), half);
+    }
+#endif
+    for (; i < length; ++i) {
+        ((uint16_t *)dst)[i] = om_float_to_float16(((float *)src)[i]);
+    }
+}
+
+void om_common_copy_float_to_bfloat16(uint64_t length, const void* src, void* dst) {
+    for (uint64_t i = 0; i < length; ++i) {
+        ((uint16_t *)dst)[i] = om_float_to_bfloat16(((float *)src)[i]);
+    }
+}
+
+// Negative values have all bits inverted, positive values only the sign bit. Larger floats become larger unsigned integers.
+void om_common_copy_float_to_ordered32(uint64_t length, const void* src, void* dst) {
+    for (uint64_t i = 0; i < length; ++i) {
+        const uint32_t x = ((uint32_t *)src)[i];
+        ((uint32_t *)dst)[i] = x ^ ((uint32_t)((int32_t)x >> 31) | 0x80000000u);
+    }
+}
+
+void om_common_copy_ordered32_to_float(uint64_t length, const void* src, void* dst) {
+    for (uint64_t i = 0; i < length; ++i) {
+        const uint32_t x = ((uint32_t *)src)[i];
+        ((uint32_t *)dst)[i] = x ^ (~(uint32_t)((int32_t)x >> 31) | 0x80000000u);
+    }
+}
+
+void om_common_copy_double_to_ordered64(uint64_t length, const void* src, void* dst) {
+    for (uint64_t i = 0; i < length; ++i) {
+        const uint64_t x = ((uint64_t *)src)[i];
+        ((uint64_t *)dst)[i] = x ^ ((uint64_t)((int64_t)x >> 63) | 0x8000000000000000u);
+    }
+}
+
+void om_common_copy_ordered64_to_double(uint64_t length, const void* src, void* dst) {
+    for (uint64_t i = 0; i < length; ++i) {
+        const uint64_t x = ((uint64_t *)src)[i];
+        ((uint64_t *)dst)[i] = x ^ (~(uint64_t)((int64_t)x >> 63) | 0x8000000000000000u);
+    }
+}
+
 void om_common_copy8(uint64_t length, const void* src, void* dst) {
     for (uint64_t i = 0; i < length; ++i) {
         ((int8_t *)dst)[i] = ((int8_t *)src)[i];
@@ -217,17 +547,17 @@ void om_common_copy64(uint64_t length, const void* src, void* dst) {
 }
 
 uint64_t om_common_compress_fpxenc32(const void* src, uint64_t length, void* dst) {
-    return fpxenc32((uint32_t*)src, length, (unsigned char *)dst, 0);
+    return om_kernels()->fpxenc32((uint32_t*)src, length, (unsigned char *)dst, 0);
 }
 
 uint64_t om_common_compress_fpxenc64(const void* src, uint64_t length, void* dst) {
-    return fpxenc64((uint64_t*)src, length, (unsigned char *)dst, 0);
+    return om_kernels()->fpxenc64((uint64_t*)src, length, (unsigned char *)dst, 0);
 }
 
 uint64_t om_common_decompress_fpxdec32(const void* src, uint64_t length, void* dst) {
-    return fpxdec32((unsigned char *)src, length, (uint32_t *)dst, 0);
+    return om_kernels()->fpxdec32((unsigned char *)src, length, (uint32_t *)dst, 0);
 }
 
 uint64_t om_common_decompress_fpxdec64(const void* src, uint64_t length, void* dst) {
-    return fpxdec64((unsigned char *)src, length, (uint64_t *)dst, 0);
+    return om_kernels()->fpxdec64((unsigned char *)src, length, (uint64_t *)dst, 0);
 }
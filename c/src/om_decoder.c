@@ -6,10 +6,20 @@
 //
 
 #include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <math.h>
+#define VINT_IN
+#define BITUTIL_IN
 #include "vp4.h"
 #include "fp.h"
 #include "conf.h"
+#include "bitutil.h"
+#include "vint.h"
 #include "delta2d.h"
+#include "om_dispatch.h"
+#include "om_atomic.h"
 #include "om_decoder.h"
 
 #pragma clang diagnostic error "-Wswitch"
@@ -21,6 +31,61 @@ void om_decoder_init_data_read(OmDecoder_dataRead_t *data_read, const OmDecoder_
     data_read->chunkIndex.lowerBound = 0;
     data_read->chunkIndex.upperBound = 0;
     data_read->nextChunk = index_read->chunkIndex;
+    memcpy(data_read->nextChunkPosition, index_read->chunkIndexPosition, sizeof(data_read->nextChunkPosition));
+    memcpy(data_read->chunkIndexPosition, index_read->chunkIndexPosition, sizeof(data_read->chunkIndexPosition));
+}
+
+// Internal function to compute the chunk ranges of the read in each dimension. Dimensions are iterated from the fast dimension.
+// Fully read dimensions next to the fast dimension, or a partially read fast dimension, form one linear range of chunks.
+static void _om_decoder_init_chunk_ranges(OmDecoder_t* decoder) {
+    const uint64_t dimensions_count = decoder->dimensions_count;
+    if (dimensions_count > OM_DECODER_POSITION_DIMENSIONS) {
+        return;
+    }
+    uint64_t stride = 1;
+    uint64_t merged = 0;
+    bool linearRead = true;
+    decoder->chunk_run_length = 1;
+    decoder->chunk_run_offset = 0;
+    for (uint64_t i_forward = 0; i_forward < dimensions_count; i_forward++) {
+        const uint64_t i = dimensions_count - i_forward - 1;
+        const uint64_t dimension = decoder->dimensions[i];
+        const uint64_t chunk = decoder->chunks[i];
+        const uint64_t read_offset = decoder->read_offset[i];
+        const uint64_t read_count = decoder->read_count[i];
+        const uint64_t nChunksInThisDimension = divide_rounded_up(dimension, chunk);
+
+        decoder->chunk_lower[i] = read_offset / chunk;
+        decoder->chunk_upper[i] = divide_rounded_up(read_offset + read_count, chunk);
+        decoder->chunk_stride[i] = stride;
+
+        if (i == dimensions_count - 1 && dimension != read_count) {
+            // The fast dimension is only partially read
+            decoder->chunk_run_length = decoder->chunk_upper[i] - decoder->chunk_lower[i];
+            decoder->chunk_run_offset = decoder->chunk_lower[i];
+            merged = 1;
+            linearRead = false;
+        }
+        if (linearRead && dimension == read_count) {
+            decoder->chunk_run_length *= nChunksInThisDimension;
+            merged++;
+        } else {
+            linearRead = false;
+        }
+        stride *= nChunksInThisDimension;
+    }
+    decoder->chunk_outer_dimensions = dimensions_count - merged;
+}
+
+// Internal function to set the coordinates of `chunkIndex` in all outer dimensions
+static void _om_decoder_init_chunk_position(const OmDecoder_t* decoder, uint64_t chunkIndex, uint64_t* position) {
+    if (decoder->dimensions_count > OM_DECODER_POSITION_DIMENSIONS) {
+        return;
+    }
+    for (uint64_t i = 0; i < decoder->chunk_outer_dimensions; i++) {
+        const uint64_t nChunksInThisDimension = divide_rounded_up(decoder->dimensions[i], decoder->chunks[i]);
+        position[i] = (chunkIndex / decoder->chunk_stride[i]) % nChunksInThisDimension;
+    }
 }
 
 OmError_t om_decoder_init(
@@ -120,8 +185,20 @@ OmError_t om_decoder_init(
     decoder->lut_start = lut_start;
     decoder->io_size_merge = io_size_merge;
     decoder->io_size_max = io_size_max;
+    _om_decoder_init_chunk_ranges(decoder);
     decoder->data_type = data_type;
+    decoder->adaptive = (compression & OM_COMPRESSION_ADAPTIVE) != 0;
+    decoder->lut_packed = (compression & OM_COMPRESSION_LUT_PACKED) != 0;
+    compression &= ~OM_COMPRESSION_FLAGS;
     decoder->compression = compression;
+    decoder->lut_cache = NULL;
+    decoder->chunk_cache = NULL;
+    decoder->cache_file = 0;
+    decoder->lut_pinned = NULL;
+    decoder->lut_pinned_size = 0;
+    decoder->stats = NULL;
+    decoder->cube_strides = NULL;
+    decoder->output_type = OUTPUT_TYPE_NATIVE;
 
     OmError_t error = ERROR_OK;
     decoder->bytes_per_element = om_get_bytes_per_element(data_type, &error);
@@ -129,6 +206,87 @@ OmError_t om_decoder_init(
     return error;
 }
 
+/// The scalar PFor tail patches exceptions with 16 byte vector stores and can write up to 16 bytes past the last element.
+/// The tail of less than 128 elements is therefore decoded into a stack buffer and copied, so `out` may end exactly at the last element.
+#define OM_P4_TAIL_OVERSHOOT 16
+
+/// Decode the tail of `n < 128` elements of a 16 bit PFor stream with `p4zdec16` or `p4ddec16` without writing past `out + n`
+ALWAYS_INLINE unsigned char* om_decode_p4tail16(
+    unsigned char* (*tail)(unsigned char *__restrict in, unsigned n, uint16_t *__restrict out, uint16_t start),
+    unsigned char* ip,
+    unsigned n,
+    uint16_t* out,
+    uint16_t start
+) {
+    uint16_t buffer[128 + OM_P4_TAIL_OVERSHOOT / sizeof(uint16_t)];
+    ip = tail(ip, n, buffer, start);
+    memcpy(out, buffer, n * sizeof(uint16_t));
+    return ip;
+}
+
+/// Decode the tail of `n < 128` elements of a 32 bit PFor stream with `p4zdec32` or `p4ddec32` without writing past `out + n`
+ALWAYS_INLINE unsigned char* om_decode_p4tail32(
+    unsigned char* (*tail)(unsigned char *__restrict in, unsigned n, uint32_t *__restrict out, uint32_t start),
+    unsigned char* ip,
+    unsigned n,
+    uint32_t* out,
+    uint32_t start
+) {
+    uint32_t buffer[128 + OM_P4_TAIL_OVERSHOOT / sizeof(uint32_t)];
+    ip = tail(ip, n, buffer, start);
+    memcpy(out, buffer, n * sizeof(uint32_t));
+    return ip;
+}
+
+/// Same as `p4nzdec128v16` or `p4nddec128v16` with the matching `block` and `tail` kernels, but never writes past `output + count`.
+/// A start value, blocks of 128 elements and a tail of less than 128 elements.
+ALWAYS_INLINE uint64_t om_decode_p4ndec16(
+    unsigned char* (*block)(unsigned char *__restrict in, unsigned n, uint16_t *__restrict out, uint16_t start),
+    unsigned char* (*tail)(unsigned char *__restrict in, unsigned n, uint16_t *__restrict out, uint16_t start),
+    const void* input,
+    uint64_t count,
+    uint16_t* output
+) {
+    unsigned char* ip = (unsigned char*)input;
+    if (count == 0) {
+        return 0;
+    }
+    uint16_t start;
+    vbxget16(ip, start);
+    output[0] = start;
+    uint64_t pos = 1;
+    for (; pos + 128 <= count; pos += 128) {
+        ip = block(ip, 128, output + pos, start);
+        start = output[pos + 127];
+    }
+    ip = om_decode_p4tail16(tail, ip, (unsigned)(count - pos), output + pos, start);
+    return (uint64_t)(ip - (unsigned char*)input);
+}
+
+/// Same as `p4nzdec128v32` or `p4nddec128v32` with the matching `block` and `tail` kernels, but never writes past `output + count`
+ALWAYS_INLINE uint64_t om_decode_p4ndec32(
+    unsigned char* (*block)(unsigned char *__restrict in, unsigned n, uint32_t *__restrict out, uint32_t start),
+    unsigned char* (*tail)(unsigned char *__restrict in, unsigned n, uint32_t *__restrict out, uint32_t start),
+    const void* input,
+    uint64_t count,
+    uint32_t* output
+) {
+    unsigned char* ip = (unsigned char*)input;
+    if (count == 0) {
+        return 0;
+    }
+    uint32_t start;
+    vbxget32(ip, start);
+    output[0] = start;
+    uint64_t pos = 1;
+    for (; pos + 128 <= count; pos += 128) {
+        ip = block(ip, 128, output + pos, start);
+        start = output[pos + 127];
+    }
+    ip = om_decode_p4tail32(tail, ip, (unsigned)(count - pos), output + pos, start);
+    return (uint64_t)(ip - (unsigned char*)input);
+}
+
 ALWAYS_INLINE uint64_t om_decode_decompress(
     OmDataType_t data_type,
     OmCompression_t compression_type,
@@ -136,13 +294,14 @@ ALWAYS_INLINE uint64_t om_decode_decompress(
     uint64_t count,
     void* output
 ) {
+    const OmKernels_t* kernels = om_kernels();
     uint64_t result = 0;
 
     switch (compression_type) {
         case COMPRESSION_PFOR_DELTA2D_INT16:
         case COMPRESSION_PFOR_DELTA2D_INT16_LOGARITHMIC:
             assert(data_type == DATA_TYPE_FLOAT_ARRAY && "Expecting float array");
-            result = p4nzdec128v16((unsigned char*)input, (size_t)count, (uint16_t*)output);
+            result = om_decode_p4ndec16(kernels->p4zdec128v16, kernels->p4zdec16, input, count, (uint16_t*)output);
             break;
         case COMPRESSION_FPX_XOR2D:
             assert(data_type == DATA_TYPE_FLOAT_ARRAY || data_type == DATA_TYPE_DOUBLE_ARRAY && "Expecting float or double array");
@@ -155,34 +314,34 @@ ALWAYS_INLINE uint64_t om_decode_decompress(
         case COMPRESSION_PFOR_DELTA2D:
             switch (data_type) {
                 case DATA_TYPE_INT8_ARRAY:
-                    result = p4nzdec8((unsigned char*)input, (size_t)count, (uint8_t*)output);
+                    result = kernels->p4nzdec8((unsigned char*)input, (size_t)count, (uint8_t*)output);
                     break;
                 case DATA_TYPE_UINT8_ARRAY:
-                    result = p4nddec8((unsigned char*)input, (size_t)count, (uint8_t*)output);
+                    result = kernels->p4nddec8((unsigned char*)input, (size_t)count, (uint8_t*)output);
                     break;
                 case DATA_TYPE_INT16_ARRAY:
-                    result = p4nzdec128v16((unsigned char*)input, (size_t)count, (uint16_t*)output);
+                    result = om_decode_p4ndec16(kernels->p4zdec128v16, kernels->p4zdec16, input, count, (uint16_t*)output);
                     break;
                 case DATA_TYPE_UINT16_ARRAY:
-                    result = p4nddec128v16((unsigned char*)input, (size_t)count, (uint16_t*)output);
+                    result = om_decode_p4ndec16(kernels->p4ddec128v16, kernels->p4ddec16, input, count, (uint16_t*)output);
                     break;
                 case DATA_TYPE_INT32_ARRAY:
-                    result = p4nzdec128v32((unsigned char*)input, (size_t)count, (uint32_t*)output);
+                    result = om_decode_p4ndec32(kernels->p4zdec128v32, kernels->p4zdec32, input, count, (uint32_t*)output);
                     break;
                 case DATA_TYPE_UINT32_ARRAY:
-                    result = p4nddec128v32((unsigned char*)input, (size_t)count, (uint32_t*)output);
+                    result = om_decode_p4ndec32(kernels->p4ddec128v32, kernels->p4ddec32, input, count, (uint32_t*)output);
                     break;
                 case DATA_TYPE_INT64_ARRAY:
-                    result = p4nzdec64((unsigned char*)input, (size_t)count, (uint64_t*)output);
+                    result = kernels->p4nzdec64((unsigned char*)input, (size_t)count, (uint64_t*)output);
                     break;
                 case DATA_TYPE_UINT64_ARRAY:
-                    result = p4nddec64((unsigned char*)input, (size_t)count, (uint64_t*)output);
+                    result = kernels->p4nddec64((unsigned char*)input, (size_t)count, (uint64_t*)output);
                     break;
                 case DATA_TYPE_FLOAT_ARRAY:
-                    result = p4nzdec128v32((unsigned char*)input, (size_t)count, (uint32_t*)output);
+                    result = om_decode_p4ndec32(kernels->p4zdec128v32, kernels->p4zdec32, input, count, (uint32_t*)output);
                     break;
                 case DATA_TYPE_DOUBLE_ARRAY:
-                    result = p4nzdec64((unsigned char*)input, (size_t)count, (uint64_t*)output);
+                    result = kernels->p4nzdec64((unsigned char*)input, (size_t)count, (uint64_t*)output);
                     break;
                 case DATA_TYPE_NONE:
                 case DATA_TYPE_STRING:
@@ -201,6 +360,15 @@ ALWAYS_INLINE uint64_t om_decode_decompress(
             }
             break;
 
+        case COMPRESSION_PFOR_FLOAT_LINEAR2D:
+            assert(data_type == DATA_TYPE_FLOAT_ARRAY || data_type == DATA_TYPE_DOUBLE_ARRAY && "Expecting float or double array");
+            if (data_type == DATA_TYPE_FLOAT_ARRAY) {
+                result = om_decode_p4ndec32(kernels->p4zdec128v32, kernels->p4zdec32, input, count, (uint32_t*)output);
+            } else if (data_type == DATA_TYPE_DOUBLE_ARRAY) {
+                result = kernels->p4nzdec64((unsigned char*)input, (size_t)count, (uint64_t*)output);
+            }
+            break;
+
         case COMPRESSION_NONE:
             break;
     }
@@ -254,11 +422,64 @@ ALWAYS_INLINE void om_decode_filter(
             }
             break;
 
+        case COMPRESSION_PFOR_FLOAT_LINEAR2D:
+            assert(data_type == DATA_TYPE_FLOAT_ARRAY || data_type == DATA_TYPE_DOUBLE_ARRAY && "Expecting float or double array");
+            if (data_type == DATA_TYPE_FLOAT_ARRAY) {
+                delta2d_decode_linear32((size_t)(length_in_chunk / length_last), (size_t)length_last, (int32_t*)data);
+            } else if (data_type == DATA_TYPE_DOUBLE_ARRAY) {
+                delta2d_decode_linear64((size_t)(length_in_chunk / length_last), (size_t)length_last, (int64_t*)data);
+            }
+            break;
         case COMPRESSION_NONE:
             break;
     }
 }
 
+/// Same as `p4nzdec128v16` followed by `delta2d_decode16`, but every block of 128 elements is filtered right after
+/// it was decompressed and is still in L1 cache. This saves one full pass over the chunk buffer.
+ALWAYS_INLINE uint64_t om_decode_p4nzdec128v16_delta2d(const void* input, uint64_t count, uint64_t length_last, int16_t* output) {
+    unsigned char* ip = (unsigned char*)input;
+    if (count == 0) {
+        return 0;
+    }
+    const OmKernels_t* kernels = om_kernels();
+    uint16_t* out = (uint16_t*)output;
+    uint16_t start;
+    vbxget16(ip, start);
+    out[0] = start;
+    // Same block layout as `p4nzdec128v16`: A start value, blocks of 128 elements and a scalar tail.
+    // The tail goes through a bounded buffer, because `output` may be the exact sized chunk buffer or the target array.
+    uint64_t pos = 1;
+    for (; pos + 128 <= count; pos += 128) {
+        ip = kernels->p4zdec128v16(ip, 128, out + pos, start);
+        start = out[pos + 127];
+        delta2d_decode16_range((size_t)length_last, (size_t)(pos - 1), (size_t)(pos + 127), output);
+    }
+    ip = om_decode_p4tail16(kernels->p4zdec16, ip, (unsigned)(count - pos), out + pos, start);
+    delta2d_decode16_range((size_t)length_last, (size_t)(pos - 1), (size_t)count, output);
+    return (uint64_t)(ip - (unsigned char*)input);
+}
+
+/// Decompress and apply the 2D filter. Equivalent to `om_decode_decompress` followed by `om_decode_filter`.
+ALWAYS_INLINE uint64_t om_decode_decompress_filter(
+    OmDataType_t data_type,
+    OmCompression_t compression_type,
+    const void* input,
+    uint64_t length_in_chunk,
+    uint64_t length_last,
+    void* output
+) {
+    const bool is_int16 = compression_type == COMPRESSION_PFOR_DELTA2D_INT16 ||
+        compression_type == COMPRESSION_PFOR_DELTA2D_INT16_LOGARITHMIC ||
+        (compression_type == COMPRESSION_PFOR_DELTA2D && data_type == DATA_TYPE_INT16_ARRAY);
+    if (is_int16) {
+        return om_decode_p4nzdec128v16_delta2d(input, length_in_chunk, length_last, (int16_t*)output);
+    }
+    const uint64_t uncompressed_bytes = om_decode_decompress(data_type, compression_type, input, length_in_chunk, output);
+    om_decode_filter(data_type, compression_type, output, length_in_chunk, length_last);
+    return uncompressed_bytes;
+}
+
 ALWAYS_INLINE void om_decode_copy(
     OmDataType_t data_type,
     OmCompression_t compression_type,
@@ -316,11 +537,344 @@ ALWAYS_INLINE void om_decode_copy(
                     break;
             }
             break;
+        case COMPRESSION_PFOR_FLOAT_LINEAR2D:
+            assert(data_type == DATA_TYPE_FLOAT_ARRAY || data_type == DATA_TYPE_DOUBLE_ARRAY && "Expecting float or double array");
+            if (data_type == DATA_TYPE_FLOAT_ARRAY) {
+                om_common_copy_ordered32_to_float(count, input, output);
+            } else if (data_type == DATA_TYPE_DOUBLE_ARRAY) {
+                om_common_copy_ordered64_to_double(count, input, output);
+            }
+            break;
         case COMPRESSION_NONE:
             break;
     }
 }
 
+// Internal function to copy decoded values into the target cube and convert them to the output type
+static void _om_decoder_copy_output(const OmDecoder_t* decoder, uint64_t count, const void* input, void* output) {
+    const bool half = decoder->output_type == OUTPUT_TYPE_FLOAT16;
+    switch (decoder->output_type) {
+        case OUTPUT_TYPE_NATIVE:
+            om_decode_copy(decoder->data_type, decoder->compression, count, decoder->scale_factor, decoder->add_offset, input, output);
+            return;
+        case OUTPUT_TYPE_FLOAT16:
+        case OUTPUT_TYPE_BFLOAT16:
+            break;
+    }
+    switch (decoder->compression) {
+        case COMPRESSION_PFOR_DELTA2D_INT16:
+            if (half) {
+                om_common_copy_int16_to_float16(count, decoder->scale_factor, decoder->add_offset, input, output);
+            } else {
+                om_common_copy_int16_to_bfloat16(count, decoder->scale_factor, decoder->add_offset, input, output);
+            }
+            return;
+        case COMPRESSION_FPX_XOR2D:
+            if (half) {
+                om_common_copy_float_to_float16(count, input, output);
+            } else {
+                om_common_copy_float_to_bfloat16(count, input, output);
+            }
+            return;
+        default:
+            break;
+    }
+    // Other encodings are converted to float in small blocks on the stack
+    float values[256];
+    for (uint64_t i = 0; i < count; i += 256) {
+        const uint64_t n = om_min(count - i, 256);
+        const uint8_t* src = (const uint8_t*)input + i * decoder->bytes_per_element_compressed;
+        om_decode_copy(decoder->data_type, decoder->compression, n, decoder->scale_factor, decoder->add_offset, src, values);
+        if (half) {
+            om_common_copy_float_to_float16(n, values, (uint16_t*)output + i);
+        } else {
+            om_common_copy_float_to_bfloat16(n, values, (uint16_t*)output + i);
+        }
+    }
+}
+
+OmError_t om_decoder_set_output_type(OmDecoder_t* decoder, OmOutputType_t output_type) {
+    switch (output_type) {
+        case OUTPUT_TYPE_NATIVE: {
+            OmError_t error = ERROR_OK;
+            decoder->output_type = output_type;
+            decoder->bytes_per_element = om_get_bytes_per_element(decoder->data_type, &error);
+            return error;
+        }
+        case OUTPUT_TYPE_FLOAT16:
+        case OUTPUT_TYPE_BFLOAT16:
+            if (decoder->data_type != DATA_TYPE_FLOAT_ARRAY) {
+                return ERROR_INVALID_DATA_TYPE;
+            }
+            decoder->output_type = output_type;
+            decoder->bytes_per_element = 2;
+            return ERROR_OK;
+    }
+    return ERROR_INVALID_DATA_TYPE;
+}
+
+void om_decoder_set_cube_strides(OmDecoder_t* decoder, const int64_t* cube_strides) {
+    decoder->cube_strides = cube_strides;
+}
+
+void om_decoder_set_lut_cache(OmDecoder_t* decoder, OmCache_t* cache, uint64_t cache_file) {
+    decoder->lut_cache = cache;
+    decoder->cache_file = cache_file;
+}
+
+void om_decoder_set_chunk_cache(OmDecoder_t* decoder, OmCache_t* cache, uint64_t cache_file) {
+    decoder->chunk_cache = cache;
+    decoder->cache_file = cache_file;
+}
+
+void om_decoder_lut_range(const OmDecoder_t* decoder, uint64_t* offset, uint64_t* count) {
+    *offset = decoder->lut_start;
+    if (decoder->lut_chunk_length == 0) {
+        // Version 1 and 2 files store an uncompressed end position for each chunk
+        *count = decoder->number_of_chunks * sizeof(uint64_t);
+        return;
+    }
+    *count = divide_rounded_up(decoder->number_of_chunks+1, LUT_CHUNK_COUNT) * decoder->lut_chunk_length;
+}
+
+void om_decoder_set_lut_pinned(OmDecoder_t* decoder, const void* lut, uint64_t lut_size) {
+    decoder->lut_pinned = lut;
+    decoder->lut_pinned_size = lut_size;
+}
+
+void om_decoder_set_stats(OmDecoder_t* decoder, OmDecoderStats_t* stats) {
+    decoder->stats = stats;
+}
+
+void om_decoder_stats_copy(const OmDecoderStats_t* stats, OmDecoderStats_t* out) {
+    const uint64_t* src = (const uint64_t*)stats;
+    uint64_t* dst = (uint64_t*)out;
+    for (uint64_t i = 0; i < sizeof(OmDecoderStats_t) / sizeof(uint64_t); i++) {
+        dst[i] = om_atomic_load(&src[i]);
+    }
+}
+
+void om_decoder_stats_reset(OmDecoderStats_t* stats) {
+    uint64_t* dst = (uint64_t*)stats;
+    for (uint64_t i = 0; i < sizeof(OmDecoderStats_t) / sizeof(uint64_t); i++) {
+        om_atomic_store(&dst[i], 0);
+    }
+}
+
+// Internal monotonic clock in nanoseconds for decoder statistics
+static uint64_t _om_decoder_time_ns(void) {
+    struct timespec ts;
+#if defined(_WIN32)
+    timespec_get(&ts, TIME_UTC);
+#else
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+#endif
+    return (uint64_t)ts.tv_sec * 1000000000 + (uint64_t)ts.tv_nsec;
+}
+
+// Internal function to count an index read if statistics are enabled. Reads are not performed with LUT cache or pinned LUT.
+static void _om_decoder_count_index_read(const OmDecoder_t* decoder, uint64_t count) {
+    if (decoder->stats != NULL && decoder->lut_cache == NULL && decoder->lut_pinned == NULL) {
+        om_atomic_add(&decoder->stats->index_reads, 1);
+        om_atomic_add(&decoder->stats->index_bytes, count);
+    }
+}
+
+// Internal function to count a data read if statistics are enabled
+static void _om_decoder_count_data_read(const OmDecoder_t* decoder, uint64_t count) {
+    if (decoder->stats != NULL) {
+        om_atomic_add(&decoder->stats->data_reads, 1);
+        om_atomic_add(&decoder->stats->data_bytes, count);
+    }
+}
+
+// Internal function to get the index data of an index read starting at chunk `index_range_lower` from the pinned LUT.
+static const void* _om_decoder_pinned_index_data(const OmDecoder_t* decoder, uint64_t index_range_lower, uint64_t* index_data_size) {
+    // Offset of index data must match `om_decoder_next_index_read`
+    const uint64_t offset = decoder->lut_chunk_length == 0
+        ? (index_range_lower == 0 ? 0 : index_range_lower - 1) * sizeof(uint64_t)
+        : index_range_lower / LUT_CHUNK_COUNT * decoder->lut_chunk_length;
+    *index_data_size = offset > decoder->lut_pinned_size ? 0 : decoder->lut_pinned_size - offset;
+    return (const uint8_t*)decoder->lut_pinned + om_min(offset, decoder->lut_pinned_size);
+}
+
+void om_io_cost_model_thresholds(const OmIoCostModel_t* model, uint64_t* io_size_merge, uint64_t* io_size_max) {
+    const double parallelism = model->parallelism > 1 ? (double)model->parallelism : 1;
+    /// Bytes that could be transferred during the latency of one request
+    const double latency_bytes = model->latency > 0 && model->bandwidth > 0 ? model->latency * model->bandwidth : 0;
+    const double size_max_min = 64 * 1024;
+    const double size_max_max = 64 * 1024 * 1024;
+    const double size_max = latency_bytes < size_max_min ? size_max_min : latency_bytes > size_max_max ? size_max_max : latency_bytes;
+    const double size_merge = latency_bytes / parallelism;
+    *io_size_max = (uint64_t)size_max;
+    *io_size_merge = size_merge > size_max ? (uint64_t)size_max : (uint64_t)size_merge;
+}
+
+double om_io_cost_model_estimate(const OmIoCostModel_t* model, uint64_t requests, uint64_t bytes) {
+    if (requests == 0) {
+        return 0;
+    }
+    const uint64_t parallelism = model->parallelism > 1 ? model->parallelism : 1;
+    const uint64_t concurrent = requests < parallelism ? requests : parallelism;
+    const uint64_t rounds = divide_rounded_up(requests, parallelism);
+    const double transfer = model->bandwidth > 0 ? (double)bytes / (model->bandwidth * (double)concurrent) : 0;
+    return (double)rounds * model->latency + transfer;
+}
+
+void om_decoder_set_io_cost_model(OmDecoder_t* decoder, const OmIoCostModel_t* model) {
+    om_io_cost_model_thresholds(model, &decoder->io_size_merge, &decoder->io_size_max);
+}
+
+// Internal function to get the bit width of a packed LUT block. Fails if the entries do not fit into the block.
+static bool _om_decoder_lut_packed_bits(const OmDecoder_t *decoder, const uint8_t* block, uint8_t* bits, OmError_t* error) {
+    *bits = block[sizeof(uint64_t)];
+    if (*bits > 64 || OM_LUT_PACKED_HEADER_SIZE + divide_rounded_up(LUT_CHUNK_COUNT * *bits, 8) + OM_LUT_PACKED_PADDING > decoder->lut_chunk_length) {
+        (*error) = ERROR_OUT_OF_BOUND_READ;
+        return false;
+    }
+    return true;
+}
+
+// Internal function to read entry `index` of a packed LUT block with a single unaligned load
+static inline uint64_t _om_decoder_lut_packed_entry(const uint8_t* block, uint8_t bits, uint64_t index) {
+    uint64_t base;
+    memcpy(&base, block, sizeof(uint64_t));
+    if (bits == 0) {
+        return base;
+    }
+    const uint8_t* packed = block + OM_LUT_PACKED_HEADER_SIZE;
+    const uint64_t position = index * bits;
+    const uint64_t shift = position % 8;
+    uint64_t word;
+    memcpy(&word, packed + position / 8, sizeof(uint64_t));
+    uint64_t delta = word >> shift;
+    if (shift + bits > 64) {
+        // Up to 7 bits are in the following byte
+        delta |= (uint64_t)packed[position / 8 + sizeof(uint64_t)] << (64 - shift);
+    }
+    if (bits < 64) {
+        delta &= (UINT64_C(1) << bits) - 1;
+    }
+    return base + delta;
+}
+
+// Internal function to decompress a LUT chunk from index data or get it from the LUT cache.
+static bool _om_decoder_load_lut_chunk(
+    const OmDecoder_t *decoder,
+    uint64_t lutChunk,
+    uint64_t lutOffset,
+    const uint8_t* index_data,
+    uint64_t index_data_size,
+    uint64_t* lut,
+    OmError_t* error
+) {
+    const uint64_t lutChunkLength = decoder->lut_chunk_length;
+    const uint64_t lutChunkElementCount = om_min((lutChunk + 1) * LUT_CHUNK_COUNT, decoder->number_of_chunks+1) - lutChunk * LUT_CHUNK_COUNT;
+    if (lutChunkElementCount > LUT_CHUNK_COUNT) {
+        (*error) = ERROR_OUT_OF_BOUND_READ;
+        return false;
+    }
+    const OmCacheKey_t key = {decoder->cache_file, decoder->lut_start, lutChunk};
+    if (decoder->lut_cache != NULL && om_cache_get(decoder->lut_cache, key, lut, lutChunkElementCount * sizeof(uint64_t))) {
+        return true;
+    }
+    if (index_data == NULL) {
+        (*error) = ERROR_LUT_CACHE_MISS;
+        return false;
+    }
+    const uint64_t start = lutChunk * lutChunkLength - lutOffset;
+    if (lutChunk * lutChunkLength < lutOffset || start + lutChunkLength > index_data_size) {
+        (*error) = ERROR_OUT_OF_BOUND_READ;
+        return false;
+    }
+
+    // Decompress LUT chunk
+    if (decoder->lut_packed) {
+        uint8_t bits;
+        if (!_om_decoder_lut_packed_bits(decoder, index_data + start, &bits, error)) {
+            return false;
+        }
+        for (uint64_t i = 0; i < lutChunkElementCount; i++) {
+            lut[i] = _om_decoder_lut_packed_entry(index_data + start, bits, i);
+        }
+    } else {
+        om_kernels()->p4nddec64((unsigned char*)index_data + start, lutChunkElementCount, lut);
+    }
+    if (decoder->stats != NULL) {
+        om_atomic_add(&decoder->stats->lut_chunks_decompressed, 1);
+    }
+    if (decoder->lut_cache != NULL) {
+        om_cache_put(decoder->lut_cache, key, lut, lutChunkElementCount * sizeof(uint64_t));
+    }
+    return true;
+}
+
+// Internal function to get a single V3 LUT entry. Packed LUT entries are read directly from index data unless a LUT cache is used.
+// Otherwise the LUT chunk is decompressed into `lut` and reused while `lut_chunk_loaded` matches.
+static bool _om_decoder_lut_entry(
+    const OmDecoder_t *decoder,
+    uint64_t entry,
+    uint64_t lutOffset,
+    const uint8_t* index_data,
+    uint64_t index_data_size,
+    uint64_t* lut,
+    uint64_t* lut_chunk_loaded,
+    uint64_t* value,
+    OmError_t* error
+) {
+    const uint64_t lutChunk = entry / LUT_CHUNK_COUNT;
+    if (decoder->lut_packed && decoder->lut_cache == NULL && index_data != NULL) {
+        const uint64_t lutChunkLength = decoder->lut_chunk_length;
+        const uint64_t start = lutChunk * lutChunkLength - lutOffset;
+        if (entry > decoder->number_of_chunks || lutChunk * lutChunkLength < lutOffset || start + lutChunkLength > index_data_size) {
+            (*error) = ERROR_OUT_OF_BOUND_READ;
+            return false;
+        }
+        uint8_t bits;
+        if (!_om_decoder_lut_packed_bits(decoder, index_data + start, &bits, error)) {
+            return false;
+        }
+        *value = _om_decoder_lut_packed_entry(index_data + start, bits, entry % LUT_CHUNK_COUNT);
+        return true;
+    }
+    if (lutChunk != *lut_chunk_loaded) {
+        if (!_om_decoder_load_lut_chunk(decoder, lutChunk, lutOffset, index_data, index_data_size, lut, error)) {
+            return false;
+        }
+        *lut_chunk_loaded = lutChunk;
+    }
+    *value = lut[entry % LUT_CHUNK_COUNT];
+    return true;
+}
+
+OmError_t om_decoder_decode_lut(const OmDecoder_t* decoder, const void* lut_data, uint64_t lut_data_size, uint64_t* lut) {
+    const uint64_t number_of_chunks = decoder->number_of_chunks;
+    if (decoder->lut_chunk_length == 0) {
+        // Version 1 and 2 files store the end position of each chunk relative to the data after the LUT
+        if (lut_data_size < number_of_chunks * sizeof(uint64_t)) {
+            return ERROR_OUT_OF_BOUND_READ;
+        }
+        const uint64_t dataStart = sizeof(OmHeaderV1_t) + number_of_chunks * sizeof(uint64_t);
+        const uint64_t* ends = (const uint64_t*)lut_data;
+        lut[0] = dataStart;
+        for (uint64_t i = 0; i < number_of_chunks; i++) {
+            lut[i+1] = dataStart + ends[i];
+        }
+        return ERROR_OK;
+    }
+    const uint64_t nLutChunks = divide_rounded_up(number_of_chunks + 1, LUT_CHUNK_COUNT);
+    for (uint64_t lutChunk = 0; lutChunk < nLutChunks; lutChunk++) {
+        uint64_t uncompressedLut[LUT_CHUNK_COUNT] = {0};
+        OmError_t error = ERROR_OK;
+        if (!_om_decoder_load_lut_chunk(decoder, lutChunk, 0, (const uint8_t*)lut_data, lut_data_size, uncompressedLut, &error)) {
+            return error;
+        }
+        const uint64_t count = om_min((lutChunk + 1) * LUT_CHUNK_COUNT, number_of_chunks + 1) - lutChunk * LUT_CHUNK_COUNT;
+        memcpy(&lut[lutChunk * LUT_CHUNK_COUNT], uncompressedLut, count * sizeof(uint64_t));
+    }
+    return ERROR_OK;
+}
+
 void om_decoder_init_index_read(const OmDecoder_t* decoder, OmDecoder_indexRead_t *index_read) {
     uint64_t chunkStart = 0;
     uint64_t chunkEnd = 1;
@@ -359,6 +913,9 @@ void om_decoder_init_index_read(const OmDecoder_t* decoder, OmDecoder_indexRead_
     index_read->chunkIndex.upperBound = 0;
     index_read->nextChunk.lowerBound = chunkStart;
     index_read->nextChunk.upperBound = chunkEnd;
+    memset(index_read->nextChunkPosition, 0, sizeof(index_read->nextChunkPosition));
+    memset(index_read->chunkIndexPosition, 0, sizeof(index_read->chunkIndexPosition));
+    _om_decoder_init_chunk_position(decoder, chunkEnd - 1, index_read->nextChunkPosition);
 }
 
 uint64_t om_decoder_read_buffer_size(const OmDecoder_t* decoder) {
@@ -366,10 +923,12 @@ uint64_t om_decoder_read_buffer_size(const OmDecoder_t* decoder) {
     for (uint64_t i = 0; i < decoder->dimensions_count; i++) {
         chunkLength *= decoder->chunks[i];
     }
-    return chunkLength * decoder->bytes_per_element;
+    // The chunk buffer holds decompressed values before conversion to the output type
+    return chunkLength * om_max(decoder->bytes_per_element, decoder->bytes_per_element_compressed);
 }
 
-bool _om_decoder_next_chunk_position(const OmDecoder_t *decoder, OmRange_t *chunk_index) {
+// Internal function to move to the next range of chunks by deriving chunk coordinates from the chunk index. Used for reads with more than `OM_DECODER_POSITION_DIMENSIONS` dimensions.
+static bool _om_decoder_next_chunk_position_divide(const OmDecoder_t *decoder, OmRange_t *chunk_index) {
     uint64_t rollingMultiply = 1;
 
     // Number of consecutive chunks that can be read linearly.
@@ -436,12 +995,39 @@ bool _om_decoder_next_chunk_position(const OmDecoder_t *decoder, OmRange_t *chun
     return true;
 }
 
-bool om_decoder_next_index_read(const OmDecoder_t* decoder, OmDecoder_indexRead_t* index_read) {
+// Internal function to move from the last chunk of `chunk_index` to the next range of chunks. `position` holds the coordinates of the last chunk in all outer dimensions.
+// Outer dimensions are advanced like an odometer, so no division is required. Returns false if all chunks have been visited.
+bool _om_decoder_next_chunk_position(const OmDecoder_t *decoder, OmRange_t *chunk_index, uint64_t *position) {
+    if (decoder->dimensions_count > OM_DECODER_POSITION_DIMENSIONS) {
+        return _om_decoder_next_chunk_position_divide(decoder, chunk_index);
+    }
+    const uint64_t outer = decoder->chunk_outer_dimensions;
+    for (uint64_t i_forward = 0; i_forward < outer; i_forward++) {
+        const uint64_t i = outer - i_forward - 1;
+        position[i] += 1;
+        if (position[i] < decoder->chunk_upper[i]) {
+            uint64_t start = decoder->chunk_run_offset;
+            for (uint64_t j = 0; j < outer; j++) {
+                start += position[j] * decoder->chunk_stride[j];
+            }
+            chunk_index->lowerBound = start;
+            chunk_index->upperBound = start + decoder->chunk_run_length;
+            return true;
+        }
+        position[i] = decoder->chunk_lower[i];
+    }
+    chunk_index->upperBound = chunk_index->lowerBound;
+    return false;
+}
+
+// Internal function to get the next index read. See `om_decoder_next_index_read`.
+static bool _om_decoder_next_index_read(const OmDecoder_t* decoder, OmDecoder_indexRead_t* index_read) {
     if (index_read->nextChunk.lowerBound >= index_read->nextChunk.upperBound) {
         return false;
     }
 
     index_read->chunkIndex = index_read->nextChunk;
+    memcpy(index_read->chunkIndexPosition, index_read->nextChunkPosition, sizeof(index_read->chunkIndexPosition));
     index_read->indexRange.lowerBound = index_read->nextChunk.lowerBound;
 
     uint64_t chunkIndex = index_read->nextChunk.lowerBound;
@@ -462,7 +1048,7 @@ bool om_decoder_next_index_read(const OmDecoder_t* decoder, OmDecoder_indexRead_
         const uint64_t nextIncrement = om_max(1, om_min(maxRead - 1, nextChunkCount - 1));
 
         if (index_read->nextChunk.lowerBound + nextIncrement >= index_read->nextChunk.upperBound) {
-            if (!_om_decoder_next_chunk_position(decoder, &index_read->nextChunk)) {
+            if (!_om_decoder_next_chunk_position(decoder, &index_read->nextChunk, index_read->nextChunkPosition)) {
                 break;
             }
             const uint64_t readEndNext = divide_rounded_up(index_read->nextChunk.lowerBound + endAlignOffset, lut_chunk_element_count) * lut_chunk_length;
@@ -497,11 +1083,33 @@ bool om_decoder_next_index_read(const OmDecoder_t* decoder, OmDecoder_indexRead_
     return true;
 }
 
-bool om_decoder_next_data_read(const OmDecoder_t *decoder, OmDecoder_dataRead_t* data_read, const void* index_data, uint64_t index_data_size, OmError_t* error) {
+bool om_decoder_next_index_read(const OmDecoder_t* decoder, OmDecoder_indexRead_t* index_read) {
+    if (!_om_decoder_next_index_read(decoder, index_read)) {
+        return false;
+    }
+    _om_decoder_count_index_read(decoder, index_read->count);
+    return true;
+}
+
+// Internal function to get the next data read. See `om_decoder_next_data_read`.
+static bool _om_decoder_next_data_read(const OmDecoder_t *decoder, OmDecoder_dataRead_t* data_read, const void* index_data, uint64_t index_data_size, OmError_t* error) {
     if (data_read->nextChunk.lowerBound >= data_read->nextChunk.upperBound) {
         return false;
     }
 
+    if (decoder->lut_pinned != NULL) {
+        index_data = _om_decoder_pinned_index_data(decoder, data_read->indexRange.lowerBound, &index_data_size);
+    }
+
+    // Without index data, LUT chunks must be available in the LUT cache
+    if (index_data == NULL && (decoder->lut_cache == NULL || decoder->lut_chunk_length == 0)) {
+        (*error) = ERROR_LUT_CACHE_MISS;
+        return false;
+    }
+
+    // State to restore if a LUT chunk is not cached
+    const OmDecoder_dataRead_t saved = *data_read;
+
     uint64_t chunkIndex = data_read->nextChunk.lowerBound;
     data_read->chunkIndex.lowerBound = chunkIndex;
 
@@ -543,7 +1151,7 @@ bool om_decoder_next_data_read(const OmDecoder_t *decoder, OmDecoder_dataRead_t*
             chunkIndex = data_read->nextChunk.lowerBound;
 
             if (data_read->nextChunk.lowerBound + 1 >= data_read->nextChunk.upperBound) {
-                if (!_om_decoder_next_chunk_position(decoder, &data_read->nextChunk)) {
+                if (!_om_decoder_next_chunk_position(decoder, &data_read->nextChunk, data_read->nextChunkPosition)) {
                     // No next chunk, finish processing the current one and stop
                     break;
                 }
@@ -574,50 +1182,31 @@ bool om_decoder_next_data_read(const OmDecoder_t *decoder, OmDecoder_dataRead_t*
     uint64_t uncompressedLut[LUT_CHUNK_COUNT] = {0};
 
     // Which LUT chunk is currently loaded into `uncompressedLut`
-    uint64_t lutChunk = chunkIndex / LUT_CHUNK_COUNT;
-
-    const uint64_t lutChunkLength = decoder->lut_chunk_length;
+    uint64_t lutChunk = UINT64_MAX;
 
     // Offset byte in LUT relative to the index range
-    const uint64_t lutOffset = data_read->indexRange.lowerBound / LUT_CHUNK_COUNT * lutChunkLength;
+    const uint64_t lutOffset = data_read->indexRange.lowerBound / LUT_CHUNK_COUNT * decoder->lut_chunk_length;
 
-    // Uncompress the first LUT index chunk and check the length
-    {
-        const uint64_t thisLutChunkElementCount = om_min((lutChunk + 1) * LUT_CHUNK_COUNT, number_of_chunks+1) - lutChunk * LUT_CHUNK_COUNT;
-        const uint64_t start = lutChunk * lutChunkLength - lutOffset;
-        if (start + lutChunkLength > index_data_size || thisLutChunkElementCount > LUT_CHUNK_COUNT) {
-            (*error) = ERROR_OUT_OF_BOUND_READ;
-            return false;
+    // Index data relative to start index
+    uint64_t startPos;
+    if (!_om_decoder_lut_entry(decoder, chunkIndex, lutOffset, indexDataPtr, index_data_size, uncompressedLut, &lutChunk, &startPos, error)) {
+        if (*error == ERROR_LUT_CACHE_MISS) {
+            *data_read = saved;
         }
-
-        // Decompress LUT chunk
-        p4nddec64(indexDataPtr + start, thisLutChunkElementCount, uncompressedLut);
+        return false;
     }
-
-    // Index data relative to start index
-    const uint64_t startPos = uncompressedLut[chunkIndex % LUT_CHUNK_COUNT];
     uint64_t endPos = startPos;
 
     // Loop to the next chunk until the end is reached
     while (true) {
-        const uint64_t nextLutChunk = (data_read->nextChunk.lowerBound + 1) / LUT_CHUNK_COUNT;
-
-        // Maybe the next LUT chunk needs to be uncompressed
-        if (nextLutChunk != lutChunk) {
-            const uint64_t nextLutChunkElementCount = om_min((nextLutChunk + 1) * LUT_CHUNK_COUNT, number_of_chunks+1) - nextLutChunk * LUT_CHUNK_COUNT;
-            const uint64_t start = nextLutChunk * lutChunkLength - lutOffset;
-            if (start + lutChunkLength > index_data_size || nextLutChunkElementCount > LUT_CHUNK_COUNT) {
-                (*error) = ERROR_OUT_OF_BOUND_READ;
-                return false;
+        uint64_t dataEndPos;
+        if (!_om_decoder_lut_entry(decoder, data_read->nextChunk.lowerBound + 1, lutOffset, indexDataPtr, index_data_size, uncompressedLut, &lutChunk, &dataEndPos, error)) {
+            if (*error == ERROR_LUT_CACHE_MISS) {
+                *data_read = saved;
             }
-
-            // Decompress LUT chunk
-            p4nddec64(indexDataPtr + start, nextLutChunkElementCount, uncompressedLut);
-            lutChunk = nextLutChunk;
+            return false;
         }
 
-        const uint64_t dataEndPos = uncompressedLut[(data_read->nextChunk.lowerBound + 1) % LUT_CHUNK_COUNT];
-
         // Merge and split IO requests, ensuring at least one IO request is sent
         if (startPos != endPos && (dataEndPos - startPos > decoder->io_size_max || dataEndPos - endPos > decoder->io_size_merge)) {
             break;
@@ -626,7 +1215,7 @@ bool om_decoder_next_data_read(const OmDecoder_t *decoder, OmDecoder_dataRead_t*
         chunkIndex = data_read->nextChunk.lowerBound;
 
         if (chunkIndex + 1 >= data_read->nextChunk.upperBound) {
-            if (!_om_decoder_next_chunk_position(decoder, &data_read->nextChunk)) {
+            if (!_om_decoder_next_chunk_position(decoder, &data_read->nextChunk, data_read->nextChunkPosition)) {
                 // No next chunk, finish processing the current one and stop
                 break;
             }
@@ -647,56 +1236,288 @@ bool om_decoder_next_data_read(const OmDecoder_t *decoder, OmDecoder_dataRead_t*
     return true;
 }
 
-// Internal function to decode a single chunk.
-uint64_t _om_decoder_decode_chunk(
-    const OmDecoder_t *decoder,
-    uint64_t chunkIndex,
-    const void *data,
-    uint8_t *into,
-    uint8_t *chunk_buffer
-) {
-    uint64_t rollingMultiply = 1;
-    uint64_t rollingMultiplyChunkLength = 1;
-    uint64_t rollingMultiplyTargetCube = 1;
-
-    int64_t d = 0; // Read coordinate.
-    int64_t q = 0; // Write coordinate.
-    int64_t linearReadCount = 1;
-    bool linearRead = true;
-    int64_t lengthLast = 0;
-    bool no_data = false;
+bool om_decoder_next_data_read(const OmDecoder_t *decoder, OmDecoder_dataRead_t* data_read, const void* index_data, uint64_t index_data_size, OmError_t* error) {
+    if (!_om_decoder_next_data_read(decoder, data_read, index_data, index_data_size, error)) {
+        return false;
+    }
+    _om_decoder_count_data_read(decoder, data_read->count);
+    return true;
+}
 
+// Internal function to get the number of elements in a chunk and the length of the fast dimension.
+uint64_t _om_decoder_chunk_length(const OmDecoder_t *decoder, uint64_t chunkIndex, uint64_t *length_last) {
+    uint64_t rollingMultiply = 1;
+    uint64_t lengthInChunk = 1;
     const uint64_t dimensions_count = decoder->dimensions_count;
 
-    //printf("decode dimcount=%d \n", decoder->dims_count );
-
-    // Count length in chunk and find first buffer offset position.
     for (uint64_t i_forward = 0; i_forward < dimensions_count; i_forward++) {
         const uint64_t i = dimensions_count - i_forward - 1;
         const uint64_t dimension = decoder->dimensions[i];
         const uint64_t chunk = decoder->chunks[i];
-        const uint64_t read_offset = decoder->read_offset[i];
-        const uint64_t read_count = decoder->read_count[i];
-        const uint64_t cube_offset = decoder->cube_offset == NULL ? 0 : decoder->cube_offset[i];
-        const uint64_t cube_dimension = decoder->cube_dimensions == NULL ? read_count : decoder->cube_dimensions[i];
 
         const uint64_t nChunksInThisDimension = divide_rounded_up(dimension, chunk);
         const uint64_t c0 = (chunkIndex / rollingMultiply) % nChunksInThisDimension;
-        const uint64_t chunkGlobal0Start = c0 * chunk;
-        const uint64_t chunkGlobal0End = om_min((c0+1) * chunk, dimension);
-        const uint64_t length0 = chunkGlobal0End - chunkGlobal0Start;
-        const uint64_t clampedGlobal0Start = om_max(chunkGlobal0Start, read_offset);
-        const uint64_t clampedGlobal0End = om_min(chunkGlobal0End, read_offset + read_count);
-        const uint64_t clampedLocal0Start = clampedGlobal0Start - c0 * chunk;
-        const uint64_t lengthRead = clampedGlobal0End - clampedGlobal0Start;
+        const uint64_t length0 = om_min((c0+1) * chunk, dimension) - c0 * chunk;
+
+        if (i == dimensions_count - 1) {
+            *length_last = length0;
+        }
+        lengthInChunk *= length0;
+        rollingMultiply *= nChunksInThisDimension;
+    }
+    return lengthInChunk;
+}
+
+// Internal function to check if a chunk contains at least one element of the read range.
+bool _om_decoder_chunk_in_read_range(const OmDecoder_t *decoder, uint64_t chunkIndex) {
+    uint64_t rollingMultiply = 1;
+    const uint64_t dimensions_count = decoder->dimensions_count;
+
+    for (uint64_t i_forward = 0; i_forward < dimensions_count; i_forward++) {
+        const uint64_t i = dimensions_count - i_forward - 1;
+        const uint64_t dimension = decoder->dimensions[i];
+        const uint64_t chunk = decoder->chunks[i];
+        const uint64_t read_offset = decoder->read_offset[i];
+        const uint64_t read_count = decoder->read_count[i];
+
+        const uint64_t nChunksInThisDimension = divide_rounded_up(dimension, chunk);
+        const uint64_t c0 = (chunkIndex / rollingMultiply) % nChunksInThisDimension;
+        const uint64_t chunkGlobal0Start = c0 * chunk;
+        const uint64_t chunkGlobal0End = om_min((c0+1) * chunk, dimension);
 
         if (read_offset + read_count <= chunkGlobal0Start || read_offset >= chunkGlobal0End) {
-            no_data = true;
+            return false;
+        }
+        rollingMultiply *= nChunksInThisDimension;
+    }
+    return true;
+}
+
+// Internal function to set `count` elements of `bytes_per_element` bytes to `value`
+static void _om_decoder_fill(void* output, uint64_t count, const void* value, uint8_t bytes_per_element) {
+    switch (bytes_per_element) {
+        case 1:
+            memset(output, *(const uint8_t*)value, count);
+            return;
+        case 2: {
+            uint16_t v;
+            memcpy(&v, value, 2);
+            for (uint64_t i = 0; i < count; i++) ((uint16_t*)output)[i] = v;
+            return;
+        }
+        case 4: {
+            uint32_t v;
+            memcpy(&v, value, 4);
+            for (uint64_t i = 0; i < count; i++) ((uint32_t*)output)[i] = v;
+            return;
         }
+        case 8: {
+            uint64_t v;
+            memcpy(&v, value, 8);
+            for (uint64_t i = 0; i < count; i++) ((uint64_t*)output)[i] = v;
+            return;
+        }
+    }
+    for (uint64_t i = 0; i < count; i++) {
+        memcpy((uint8_t*)output + i * bytes_per_element, value, bytes_per_element);
+    }
+}
+
+// Internal function to copy `count` elements from position `d` of the chunk buffer to position `q` of the target cube, or fill them with `constant`.
+static inline void _om_decoder_copy_run(
+    const OmDecoder_t *decoder,
+    uint64_t count,
+    const uint8_t *chunk_buffer,
+    uint64_t d,
+    uint8_t *into,
+    uint64_t q,
+    const void *constant
+) {
+    if (constant != NULL) {
+        _om_decoder_fill(into + q * decoder->bytes_per_element, count, constant, decoder->bytes_per_element);
+    } else {
+        _om_decoder_copy_output(
+            decoder,
+            count,
+            chunk_buffer + d * decoder->bytes_per_element_compressed,
+            into + q * decoder->bytes_per_element
+        );
+    }
+}
+
+// Internal function to convert `count` elements from the chunk buffer, or fill them with `constant`, into elements that are `stride` bytes apart.
+// Non contiguous elements are converted into a small buffer first and then scattered.
+static void _om_decoder_copy_run_strided(
+    const OmDecoder_t *decoder,
+    uint64_t count,
+    const uint8_t *chunk_buffer,
+    uint8_t *into,
+    int64_t stride,
+    const void *constant
+) {
+    const uint64_t bytesPerElement = decoder->bytes_per_element;
+    if (stride == (int64_t)bytesPerElement) {
+        if (constant != NULL) {
+            _om_decoder_fill(into, count, constant, bytesPerElement);
+        } else {
+            _om_decoder_copy_output(decoder, count, chunk_buffer, into);
+        }
+        return;
+    }
+    uint64_t buffer[256];
+    for (uint64_t start = 0; start < count; start += 256) {
+        const uint64_t length = om_min(256, count - start);
+        if (constant != NULL) {
+            _om_decoder_fill(buffer, length, constant, bytesPerElement);
+        } else {
+            _om_decoder_copy_output(decoder, length, chunk_buffer + start * decoder->bytes_per_element_compressed, buffer);
+        }
+        for (uint64_t i = 0; i < length; i++) {
+            memcpy(into + (int64_t)(start + i) * stride, (const uint8_t*)buffer + i * bytesPerElement, bytesPerElement);
+        }
+    }
+}
+
+// Internal function to copy a chunk into a target cube with `cube_strides`. Copies one row of the fastest dimension at a time.
+static void _om_decoder_copy_chunk_strided(
+    const OmDecoder_t *decoder,
+    uint64_t chunkIndex,
+    const uint8_t *chunk_buffer,
+    uint8_t *into,
+    const void *constant
+) {
+    const uint64_t dimensions_count = decoder->dimensions_count;
+    const int64_t* strides = decoder->cube_strides;
+
+    uint64_t rollingMultiply = 1;
+    uint64_t rollingMultiplyChunkLength = 1;
+    uint64_t d = 0; // Read coordinate in the chunk buffer
+    int64_t q = 0; // Byte offset in the target cube
+    uint64_t lengthReadLast = 0;
+
+    for (uint64_t i_forward = 0; i_forward < dimensions_count; i_forward++) {
+        const uint64_t i = dimensions_count - i_forward - 1;
+        const uint64_t dimension = decoder->dimensions[i];
+        const uint64_t chunk = decoder->chunks[i];
+        const uint64_t read_offset = decoder->read_offset[i];
+        const uint64_t read_count = decoder->read_count[i];
+        const uint64_t cube_offset = decoder->cube_offset == NULL ? 0 : decoder->cube_offset[i];
+
+        const uint64_t nChunksInThisDimension = divide_rounded_up(dimension, chunk);
+        const uint64_t c0 = (chunkIndex / rollingMultiply) % nChunksInThisDimension;
+        const uint64_t chunkGlobal0Start = c0 * chunk;
+        const uint64_t chunkGlobal0End = om_min((c0+1) * chunk, dimension);
+        const uint64_t clampedGlobal0Start = om_max(chunkGlobal0Start, read_offset);
+        const uint64_t clampedGlobal0End = om_min(chunkGlobal0End, read_offset + read_count);
 
         if (i == dimensions_count - 1) {
-            lengthLast = length0;
+            lengthReadLast = clampedGlobal0End - clampedGlobal0Start;
         }
+        d += rollingMultiplyChunkLength * (clampedGlobal0Start - chunkGlobal0Start);
+        q += strides[i] * (int64_t)(clampedGlobal0Start - read_offset + cube_offset);
+        rollingMultiply *= nChunksInThisDimension;
+        rollingMultiplyChunkLength *= chunkGlobal0End - chunkGlobal0Start;
+    }
+
+    while (true) {
+        _om_decoder_copy_run_strided(decoder, lengthReadLast, chunk_buffer + d * decoder->bytes_per_element_compressed, into + q, strides[dimensions_count - 1], constant);
+
+        // Move to the next row like an odometer
+        d += lengthReadLast - 1;
+        rollingMultiply = 1;
+        rollingMultiplyChunkLength = 1;
+        for (uint64_t i_forward = 0; i_forward < dimensions_count; i_forward++) {
+            const uint64_t i = dimensions_count - i_forward - 1;
+            const uint64_t dimension = decoder->dimensions[i];
+            const uint64_t chunk = decoder->chunks[i];
+            const uint64_t read_offset = decoder->read_offset[i];
+            const uint64_t read_count = decoder->read_count[i];
+
+            const uint64_t nChunksInThisDimension = divide_rounded_up(dimension, chunk);
+            const uint64_t c0 = (chunkIndex / rollingMultiply) % nChunksInThisDimension;
+            const uint64_t chunkGlobal0Start = c0 * chunk;
+            const uint64_t chunkGlobal0End = om_min((c0+1) * chunk, dimension);
+            const uint64_t length0 = chunkGlobal0End - chunkGlobal0Start;
+            const uint64_t clampedGlobal0Start = om_max(chunkGlobal0Start, read_offset);
+            const uint64_t clampedGlobal0End = om_min(chunkGlobal0End, read_offset + read_count);
+            const uint64_t clampedLocal0End = clampedGlobal0End - chunkGlobal0Start;
+            const uint64_t lengthRead = clampedGlobal0End - clampedGlobal0Start;
+
+            d += rollingMultiplyChunkLength;
+            if (i != dimensions_count - 1) {
+                q += strides[i];
+            }
+
+            const uint64_t d0 = (d / rollingMultiplyChunkLength) % length0;
+            if (d0 != clampedLocal0End && d0 != 0) {
+                break; // No overflow in this dimension, break
+            }
+
+            d -= lengthRead * rollingMultiplyChunkLength;
+            if (i != dimensions_count - 1) {
+                q -= (int64_t)lengthRead * strides[i];
+            }
+
+            rollingMultiply *= nChunksInThisDimension;
+            rollingMultiplyChunkLength *= length0;
+            if (i == 0) {
+                return; // All rows have been copied
+            }
+        }
+    }
+}
+
+// Internal function to copy a decompressed and filtered chunk into the target cube.
+// If `constant` is set, `chunk_buffer` is not used and all elements of the chunk are set to `constant` which is already converted to the output type.
+static void _om_decoder_copy_chunk_or_fill(
+    const OmDecoder_t *decoder,
+    uint64_t chunkIndex,
+    const uint8_t *chunk_buffer,
+    uint8_t *into,
+    const void *constant
+) {
+    if (decoder->cube_strides != NULL) {
+        _om_decoder_copy_chunk_strided(decoder, chunkIndex, chunk_buffer, into, constant);
+        return;
+    }
+
+    uint64_t rollingMultiply = 1;
+    uint64_t rollingMultiplyChunkLength = 1;
+    uint64_t rollingMultiplyTargetCube = 1;
+
+    int64_t d = 0; // Read coordinate.
+    int64_t q = 0; // Write coordinate.
+    int64_t linearReadCount = 1;
+    bool linearRead = true;
+
+    const uint64_t dimensions_count = decoder->dimensions_count;
+
+    // Number of fast dimensions that are merged into one linear copy
+    uint64_t merged = 0;
+    // Elements to read, chunk buffer stride and target cube stride per dimension. Only used for up to 3 dimensions.
+    uint64_t lengthReads[3];
+    uint64_t strideChunk[3];
+    uint64_t strideCube[3];
+
+    // Find first buffer offset position.
+    for (uint64_t i_forward = 0; i_forward < dimensions_count; i_forward++) {
+        const uint64_t i = dimensions_count - i_forward - 1;
+        const uint64_t dimension = decoder->dimensions[i];
+        const uint64_t chunk = decoder->chunks[i];
+        const uint64_t read_offset = decoder->read_offset[i];
+        const uint64_t read_count = decoder->read_count[i];
+        const uint64_t cube_offset = decoder->cube_offset == NULL ? 0 : decoder->cube_offset[i];
+        const uint64_t cube_dimension = decoder->cube_dimensions == NULL ? read_count : decoder->cube_dimensions[i];
+
+        const uint64_t nChunksInThisDimension = divide_rounded_up(dimension, chunk);
+        const uint64_t c0 = (chunkIndex / rollingMultiply) % nChunksInThisDimension;
+        const uint64_t chunkGlobal0Start = c0 * chunk;
+        const uint64_t chunkGlobal0End = om_min((c0+1) * chunk, dimension);
+        const uint64_t length0 = chunkGlobal0End - chunkGlobal0Start;
+        const uint64_t clampedGlobal0Start = om_max(chunkGlobal0Start, read_offset);
+        const uint64_t clampedGlobal0End = om_min(chunkGlobal0End, read_offset + read_count);
+        const uint64_t clampedLocal0Start = clampedGlobal0Start - c0 * chunk;
+        const uint64_t lengthRead = clampedGlobal0End - clampedGlobal0Start;
 
         const uint64_t d0 = clampedLocal0Start;
         const uint64_t t0 = chunkGlobal0Start - read_offset + d0;
@@ -705,16 +1526,24 @@ uint64_t _om_decoder_decode_chunk(
         d += rollingMultiplyChunkLength * d0;
         q += rollingMultiplyTargetCube * q0;
 
+        if (dimensions_count <= 3) {
+            lengthReads[i] = lengthRead;
+            strideChunk[i] = rollingMultiplyChunkLength;
+            strideCube[i] = rollingMultiplyTargetCube;
+        }
+
         if (i == dimensions_count - 1 && !(lengthRead == length0 && read_count == length0 && cube_dimension == length0)) {
             // if fast dimension and only partially read
             linearReadCount = lengthRead;
             linearRead = false;
+            merged = 1;
         }
 
         if (linearRead && lengthRead == length0 && read_count == length0 && cube_dimension == length0) {
             // dimension is read entirely
             // and can be copied linearly into the output buffer
             linearReadCount *= length0;
+            merged++;
         } else {
             // dimension is read partly, cannot merge further reads
             linearRead = false;
@@ -725,35 +1554,37 @@ uint64_t _om_decoder_decode_chunk(
         rollingMultiplyChunkLength *= length0;
     }
 
-    const uint64_t lengthInChunk = rollingMultiplyChunkLength;
-
-    const uint64_t uncompressedBytes = om_decode_decompress(
-        decoder->data_type,
-        decoder->compression,
-        data,
-        lengthInChunk,
-        chunk_buffer
-    );
-
-    if (no_data) {
-        return uncompressedBytes;
+    if (dimensions_count <= 3) {
+        // At most 2 dimensions are not merged. Iterate them with nested loops instead of dividing coordinates for every copy.
+        const uint64_t outer = dimensions_count - merged;
+        uint64_t n0 = 1, n1 = 1;
+        uint64_t strideChunk0 = 0, strideCube0 = 0, strideChunk1 = 0, strideCube1 = 0;
+        if (outer == 2) {
+            n0 = lengthReads[0];
+            strideChunk0 = strideChunk[0];
+            strideCube0 = strideCube[0];
+        }
+        if (outer >= 1) {
+            n1 = lengthReads[outer - 1];
+            strideChunk1 = strideChunk[outer - 1];
+            strideCube1 = strideCube[outer - 1];
+        }
+        for (uint64_t i0 = 0; i0 < n0; i0++) {
+            uint64_t dRow = d + i0 * strideChunk0;
+            uint64_t qRow = q + i0 * strideCube0;
+            for (uint64_t i1 = 0; i1 < n1; i1++) {
+                _om_decoder_copy_run(decoder, linearReadCount, chunk_buffer, dRow, into, qRow, constant);
+                dRow += strideChunk1;
+                qRow += strideCube1;
+            }
+        }
+        return;
     }
 
-    // Perform 2D decoding
-    om_decode_filter(decoder->data_type, decoder->compression, chunk_buffer, lengthInChunk, lengthLast);
-
     // Copy data from the chunk buffer to the output buffer.
     while (true) {
         // Copy values from chunk buffer into output buffer
-        om_decode_copy(
-            decoder->data_type,
-            decoder->compression,
-            linearReadCount,
-            decoder->scale_factor,
-            decoder->add_offset,
-            chunk_buffer + d * decoder->bytes_per_element_compressed,
-            into + q * decoder->bytes_per_element
-        );
+        _om_decoder_copy_run(decoder, linearReadCount, chunk_buffer, d, into, q, constant);
 
         q += linearReadCount - 1;
         d += linearReadCount - 1;
@@ -813,13 +1644,255 @@ uint64_t _om_decoder_decode_chunk(
             rollingMultiplyChunkLength *= length0;
             //printf("next iter\n");
             if (i == 0) {
-                return uncompressedBytes; // All chunks have been read. End of iteration
+                return; // All chunks have been read. End of iteration
             }
         }
     }
+}
+
+// Internal function to copy a decompressed and filtered chunk into the target cube.
+void _om_decoder_copy_chunk(
+    const OmDecoder_t *decoder,
+    uint64_t chunkIndex,
+    const uint8_t *chunk_buffer,
+    uint8_t *into
+) {
+    _om_decoder_copy_chunk_or_fill(decoder, chunkIndex, chunk_buffer, into, NULL);
+}
+
+// Internal function to store a decompressed and filtered chunk in the chunk cache.
+static void _om_decoder_cache_put_chunk(const OmDecoder_t* decoder, uint64_t chunkIndex, const void* chunk_buffer, uint64_t lengthInChunk) {
+    if (decoder->chunk_cache == NULL) {
+        return;
+    }
+    const OmCacheKey_t key = {decoder->cache_file, decoder->lut_start, chunkIndex};
+    om_cache_put(decoder->chunk_cache, key, chunk_buffer, lengthInChunk * decoder->bytes_per_element_compressed);
+}
+
+// Internal function to check if decoded data can be used without conversion. Only then a chunk can be decoded
+// directly into the target cube.
+static bool _om_decoder_is_identity_copy(const OmDecoder_t *decoder) {
+    if (decoder->bytes_per_element != decoder->bytes_per_element_compressed) {
+        return false;
+    }
+    switch (decoder->compression) {
+        case COMPRESSION_FPX_XOR2D:
+            return decoder->data_type == DATA_TYPE_FLOAT_ARRAY || decoder->data_type == DATA_TYPE_DOUBLE_ARRAY;
+        case COMPRESSION_PFOR_DELTA2D:
+            return decoder->data_type != DATA_TYPE_FLOAT_ARRAY && decoder->data_type != DATA_TYPE_DOUBLE_ARRAY;
+        default:
+            return false;
+    }
+}
+
+// Internal function to check if a chunk is read entirely and occupies one contiguous range in the target cube.
+// Dimensions faster than the first partially covered target dimension must fill the cube and all slower
+// dimensions must have a length of 1. Returns the element offset of the chunk in the target cube.
+static bool _om_decoder_chunk_is_contiguous(const OmDecoder_t *decoder, uint64_t chunkIndex, uint64_t *target) {
+    if (decoder->cube_strides != NULL) {
+        return false;
+    }
+    uint64_t rollingMultiply = 1;
+    uint64_t rollingMultiplyTargetCube = 1;
+    uint64_t q = 0;
+    bool filled = true;
+
+    for (uint64_t i_forward = 0; i_forward < decoder->dimensions_count; i_forward++) {
+        const uint64_t i = decoder->dimensions_count - i_forward - 1;
+        const uint64_t dimension = decoder->dimensions[i];
+        const uint64_t chunk = decoder->chunks[i];
+        const uint64_t read_offset = decoder->read_offset[i];
+        const uint64_t read_count = decoder->read_count[i];
+        const uint64_t cube_offset = decoder->cube_offset == NULL ? 0 : decoder->cube_offset[i];
+        const uint64_t cube_dimension = decoder->cube_dimensions == NULL ? read_count : decoder->cube_dimensions[i];
+
+        const uint64_t nChunksInThisDimension = divide_rounded_up(dimension, chunk);
+        const uint64_t c0 = (chunkIndex / rollingMultiply) % nChunksInThisDimension;
+        const uint64_t chunkGlobal0Start = c0 * chunk;
+        const uint64_t chunkGlobal0End = om_min((c0+1) * chunk, dimension);
+        const uint64_t length0 = chunkGlobal0End - chunkGlobal0Start;
+        if (chunkGlobal0Start < read_offset || chunkGlobal0End > read_offset + read_count) {
+            return false; // Chunk is only partially read
+        }
+        if (!filled && length0 != 1) {
+            return false;
+        }
+        if (length0 != cube_dimension) {
+            filled = false;
+        }
+        q += rollingMultiplyTargetCube * (chunkGlobal0Start - read_offset + cube_offset);
+        rollingMultiply *= nChunksInThisDimension;
+        rollingMultiplyTargetCube *= cube_dimension;
+    }
+    (*target) = q;
+    return true;
+}
+
+// Internal function to decode a chunk of an array with `OM_COMPRESSION_ADAPTIVE`. The first byte selects the codec of the chunk.
+// If `skip` is set, only the compressed size is required and `output` is only used as scratch space.
+// Returns 0 for an unknown codec, which is then reported as `ERROR_DEFLATED_SIZE_MISMATCH`.
+static uint64_t _om_decoder_decode_adaptive(const OmDecoder_t* decoder, const uint8_t* data, uint64_t lengthInChunk, uint64_t lengthLast, void* output, bool skip) {
+    const uint64_t bytesPerElement = decoder->bytes_per_element_compressed;
+    switch ((OmChunkCodec_t)data[0]) {
+        case CHUNK_CODEC_FILTERED:
+            if (skip) {
+                return 1 + om_decode_decompress(decoder->data_type, decoder->compression, data + 1, lengthInChunk, output);
+            }
+            return 1 + om_decode_decompress_filter(decoder->data_type, decoder->compression, data + 1, lengthInChunk, lengthLast, output);
+        case CHUNK_CODEC_UNFILTERED:
+            return 1 + om_decode_decompress(decoder->data_type, decoder->compression, data + 1, lengthInChunk, output);
+        case CHUNK_CODEC_RAW:
+            if (!skip) {
+                memcpy(output, data + 1, lengthInChunk * bytesPerElement);
+            }
+            return 1 + lengthInChunk * bytesPerElement;
+        case CHUNK_CODEC_CONSTANT:
+            if (!skip) {
+                _om_decoder_fill(output, lengthInChunk, data + 1, bytesPerElement);
+            }
+            return 1 + bytesPerElement;
+    }
+    return 0;
+}
+
+// Internal function to decompress and filter a chunk. With statistics, both steps are timed separately which gives the same result.
+static uint64_t _om_decoder_decompress_filter(const OmDecoder_t* decoder, const void* data, uint64_t lengthInChunk, uint64_t lengthLast, void* output) {
+    OmDecoderStats_t* stats = decoder->stats;
+    if (decoder->adaptive) {
+        // Codecs differ per chunk. All steps are counted as decompression.
+        const uint64_t start = stats == NULL ? 0 : _om_decoder_time_ns();
+        const uint64_t uncompressedBytes = _om_decoder_decode_adaptive(decoder, (const uint8_t*)data, lengthInChunk, lengthLast, output, false);
+        if (stats != NULL) {
+            om_atomic_add(&stats->decompress_ns, _om_decoder_time_ns() - start);
+            om_atomic_add(&stats->chunks_decoded, 1);
+            om_atomic_add(&stats->uncompressed_bytes, lengthInChunk * decoder->bytes_per_element);
+        }
+        return uncompressedBytes;
+    }
+    if (stats == NULL) {
+        return om_decode_decompress_filter(decoder->data_type, decoder->compression, data, lengthInChunk, lengthLast, output);
+    }
+    const uint64_t start = _om_decoder_time_ns();
+    const uint64_t uncompressedBytes = om_decode_decompress(decoder->data_type, decoder->compression, data, lengthInChunk, output);
+    const uint64_t decompressed = _om_decoder_time_ns();
+    om_decode_filter(decoder->data_type, decoder->compression, output, lengthInChunk, lengthLast);
+    const uint64_t filtered = _om_decoder_time_ns();
+    om_atomic_add(&stats->decompress_ns, decompressed - start);
+    om_atomic_add(&stats->filter_ns, filtered - decompressed);
+    om_atomic_add(&stats->chunks_decoded, 1);
+    om_atomic_add(&stats->uncompressed_bytes, lengthInChunk * decoder->bytes_per_element);
     return uncompressedBytes;
 }
 
+// Internal function to decompress a chunk outside the read range. Only the compressed size is required.
+static uint64_t _om_decoder_skip_chunk(const OmDecoder_t* decoder, const void* data, uint64_t lengthInChunk, void* chunk_buffer) {
+    OmDecoderStats_t* stats = decoder->stats;
+    if (stats == NULL) {
+        if (decoder->adaptive) {
+            return _om_decoder_decode_adaptive(decoder, (const uint8_t*)data, lengthInChunk, 0, chunk_buffer, true);
+        }
+        return om_decode_decompress(decoder->data_type, decoder->compression, data, lengthInChunk, chunk_buffer);
+    }
+    const uint64_t start = _om_decoder_time_ns();
+    const uint64_t uncompressedBytes = decoder->adaptive ?
+        _om_decoder_decode_adaptive(decoder, (const uint8_t*)data, lengthInChunk, 0, chunk_buffer, true) :
+        om_decode_decompress(decoder->data_type, decoder->compression, data, lengthInChunk, chunk_buffer);
+    om_atomic_add(&stats->decompress_ns, _om_decoder_time_ns() - start);
+    om_atomic_add(&stats->chunks_skipped, 1);
+    return uncompressedBytes;
+}
+
+// Internal function to copy a chunk into the target cube and record the time if statistics are enabled
+static void _om_decoder_copy_chunk_timed(const OmDecoder_t* decoder, uint64_t chunkIndex, const uint8_t* chunk_buffer, uint8_t* into) {
+    OmDecoderStats_t* stats = decoder->stats;
+    if (stats == NULL) {
+        _om_decoder_copy_chunk(decoder, chunkIndex, chunk_buffer, into);
+        return;
+    }
+    const uint64_t start = _om_decoder_time_ns();
+    _om_decoder_copy_chunk(decoder, chunkIndex, chunk_buffer, into);
+    om_atomic_add(&stats->copy_ns, _om_decoder_time_ns() - start);
+}
+
+// Internal function to write a constant chunk of an adaptive array directly into the target cube.
+// The value is converted once. Decompression, 2D filter and the chunk buffer are skipped.
+static uint64_t _om_decoder_decode_constant(const OmDecoder_t* decoder, uint64_t chunkIndex, const uint8_t* data, uint64_t lengthInChunk, uint8_t* into) {
+    OmDecoderStats_t* stats = decoder->stats;
+    const uint64_t start = stats == NULL ? 0 : _om_decoder_time_ns();
+    uint64_t value = 0;
+    _om_decoder_copy_output(decoder, 1, data + 1, &value);
+    _om_decoder_copy_chunk_or_fill(decoder, chunkIndex, NULL, into, &value);
+    if (stats != NULL) {
+        om_atomic_add(&stats->copy_ns, _om_decoder_time_ns() - start);
+        om_atomic_add(&stats->chunks_decoded, 1);
+        om_atomic_add(&stats->chunks_constant, 1);
+        om_atomic_add(&stats->uncompressed_bytes, lengthInChunk * decoder->bytes_per_element);
+    }
+    return 1 + decoder->bytes_per_element_compressed;
+}
+
+// Internal function to decode a single chunk.
+uint64_t _om_decoder_decode_chunk(
+    const OmDecoder_t *decoder,
+    uint64_t chunkIndex,
+    const void *data,
+    uint8_t *into,
+    uint8_t *chunk_buffer
+) {
+    uint64_t lengthLast = 0;
+    const uint64_t lengthInChunk = _om_decoder_chunk_length(decoder, chunkIndex, &lengthLast);
+
+    if (!_om_decoder_chunk_in_read_range(decoder, chunkIndex)) {
+        // Skipped chunk. Only the compressed size is required.
+        return _om_decoder_skip_chunk(decoder, data, lengthInChunk, chunk_buffer);
+    }
+
+    // Constant chunks, e.g. all zero or all NaN. The chunk cache needs the decoded chunk buffer.
+    if (decoder->adaptive && ((const uint8_t*)data)[0] == CHUNK_CODEC_CONSTANT && decoder->chunk_cache == NULL) {
+        return _om_decoder_decode_constant(decoder, chunkIndex, (const uint8_t*)data, lengthInChunk, into);
+    }
+
+    // Fast path: Decode and filter in place in the target cube without the chunk buffer and copy
+    uint64_t target = 0;
+    if (_om_decoder_is_identity_copy(decoder) && _om_decoder_chunk_is_contiguous(decoder, chunkIndex, &target)) {
+        uint8_t* destination = into + target * decoder->bytes_per_element;
+        const uint64_t uncompressedBytes = _om_decoder_decompress_filter(decoder, data, lengthInChunk, lengthLast, destination);
+        _om_decoder_cache_put_chunk(decoder, chunkIndex, destination, lengthInChunk);
+        return uncompressedBytes;
+    }
+
+    // Decompress and perform 2D decoding
+    const uint64_t uncompressedBytes = _om_decoder_decompress_filter(decoder, data, lengthInChunk, lengthLast, chunk_buffer);
+
+    _om_decoder_cache_put_chunk(decoder, chunkIndex, chunk_buffer, lengthInChunk);
+
+    _om_decoder_copy_chunk_timed(decoder, chunkIndex, chunk_buffer, into);
+    return uncompressedBytes;
+}
+
+bool om_decoder_decode_cached_chunks(const OmDecoder_t* decoder, OmRange_t chunk, void* into, void* chunk_buffer) {
+    if (decoder->chunk_cache == NULL) {
+        return false;
+    }
+    for (uint64_t chunkNum = chunk.lowerBound; chunkNum < chunk.upperBound; ++chunkNum) {
+        // Chunks in between are only read to merge IO and are not required
+        if (!_om_decoder_chunk_in_read_range(decoder, chunkNum)) {
+            continue;
+        }
+        uint64_t lengthLast = 0;
+        const uint64_t lengthInChunk = _om_decoder_chunk_length(decoder, chunkNum, &lengthLast);
+        const OmCacheKey_t key = {decoder->cache_file, decoder->lut_start, chunkNum};
+        if (!om_cache_get(decoder->chunk_cache, key, chunk_buffer, lengthInChunk * decoder->bytes_per_element_compressed)) {
+            return false;
+        }
+        if (decoder->stats != NULL) {
+            om_atomic_add(&decoder->stats->chunks_cached, 1);
+        }
+        _om_decoder_copy_chunk_timed(decoder, chunkNum, chunk_buffer, into);
+    }
+    return true;
+}
+
 bool om_decoder_decode_chunks(const OmDecoder_t *decoder, OmRange_t chunk, const void *data, uint64_t data_size, void *into, void *chunkBuffer, OmError_t *error) {
     uint64_t pos = 0;
     // printf("chunkIndex.lowerBound %lu %lu\n",chunk.lowerBound,chunk.upperBound);
@@ -843,3 +1916,434 @@ bool om_decoder_decode_chunks(const OmDecoder_t *decoder, OmRange_t chunk, const
     }
     return pos;
 }
+
+uint64_t om_decoder_reduce_cells_count(const OmDecoder_t* decoder, const uint64_t* group) {
+    uint64_t count = 1;
+    for (uint64_t i = 0; i < decoder->dimensions_count; i++) {
+        if (group[i] == 0) {
+            return 0;
+        }
+        count *= divide_rounded_up(decoder->read_count[i], group[i]);
+    }
+    return count;
+}
+
+void om_reduce_cells_init(OmReduceCell_t* cells, uint64_t count) {
+    for (uint64_t i = 0; i < count; i++) {
+        cells[i] = (OmReduceCell_t){.sum = 0, .count = 0, .min = INFINITY, .max = -INFINITY};
+    }
+}
+
+void om_reduce_cells_result(const OmReduceCell_t* cells, uint64_t count, OmReduction_t reduction, float* out) {
+    for (uint64_t i = 0; i < count; i++) {
+        const OmReduceCell_t cell = cells[i];
+        if (reduction == OM_REDUCE_COUNT) {
+            out[i] = (float)cell.count;
+            continue;
+        }
+        if (cell.count == 0) {
+            out[i] = NAN;
+            continue;
+        }
+        switch (reduction) {
+            case OM_REDUCE_MIN:
+                out[i] = cell.min;
+                break;
+            case OM_REDUCE_MAX:
+                out[i] = cell.max;
+                break;
+            case OM_REDUCE_SUM:
+                out[i] = (float)cell.sum;
+                break;
+            case OM_REDUCE_MEAN:
+                out[i] = (float)(cell.sum / (double)cell.count);
+                break;
+            case OM_REDUCE_COUNT:
+                break;
+        }
+    }
+}
+
+// Internal function to accumulate the read range of a decompressed and filtered chunk into cells.
+// Each row along the fastest dimension is converted in small blocks, so the values of the hyperslab are never stored.
+static void _om_decoder_reduce_chunk(const OmDecoder_t* decoder, uint64_t chunkIndex, const uint8_t* chunk_buffer, uint64_t lengthInChunk, uint64_t lengthLast, const uint64_t* group, OmReduceCell_t* cells) {
+    const uint64_t dimensions_count = decoder->dimensions_count;
+    const uint64_t rows = lengthInChunk / lengthLast;
+    const uint64_t last = dimensions_count - 1;
+
+    for (uint64_t row = 0; row < rows; row++) {
+        uint64_t rollingMultiply = 1;
+        uint64_t rollingMultiplyRow = 1;
+        uint64_t rollingMultiplyCells = 1;
+        uint64_t cell = 0;
+        uint64_t runStart = 0;
+        uint64_t runEnd = 0;
+        uint64_t chunkStartLast = 0;
+        bool inRange = true;
+
+        for (uint64_t i_forward = 0; i_forward < dimensions_count; i_forward++) {
+            const uint64_t i = dimensions_count - i_forward - 1;
+            const uint64_t dimension = decoder->dimensions[i];
+            const uint64_t chunk = decoder->chunks[i];
+            const uint64_t read_offset = decoder->read_offset[i];
+            const uint64_t read_count = decoder->read_count[i];
+
+            const uint64_t nChunksInThisDimension = divide_rounded_up(dimension, chunk);
+            const uint64_t c0 = (chunkIndex / rollingMultiply) % nChunksInThisDimension;
+            const uint64_t chunkGlobal0Start = c0 * chunk;
+            const uint64_t chunkGlobal0End = om_min((c0+1) * chunk, dimension);
+            const uint64_t length0 = chunkGlobal0End - chunkGlobal0Start;
+
+            if (i == last) {
+                runStart = om_max(chunkGlobal0Start, read_offset);
+                runEnd = om_min(chunkGlobal0End, read_offset + read_count);
+                chunkStartLast = chunkGlobal0Start;
+            } else {
+                const uint64_t global0 = chunkGlobal0Start + (row / rollingMultiplyRow) % length0;
+                if (global0 < read_offset || global0 >= read_offset + read_count) {
+                    inRange = false;
+                    break;
+                }
+                cell += rollingMultiplyCells * ((global0 - read_offset) / group[i]);
+                rollingMultiplyRow *= length0;
+            }
+            rollingMultiply *= nChunksInThisDimension;
+            rollingMultiplyCells *= divide_rounded_up(read_count, group[i]);
+        }
+        if (!inRange || runStart >= runEnd) {
+            continue;
+        }
+
+        const uint8_t* src = chunk_buffer + (row * lengthLast + runStart - chunkStartLast) * decoder->bytes_per_element_compressed;
+        const uint64_t read_offset_last = decoder->read_offset[last];
+        const uint64_t group_last = group[last];
+        for (uint64_t position = runStart; position < runEnd;) {
+            float values[256];
+            const uint64_t count = om_min(runEnd - position, 256);
+            om_decode_copy(decoder->data_type, decoder->compression, count, decoder->scale_factor, decoder->add_offset, src, values);
+            src += count * decoder->bytes_per_element_compressed;
+            for (uint64_t k = 0; k < count; k++) {
+                const float value = values[k];
+                if (isnan(value)) {
+                    continue;
+                }
+                OmReduceCell_t* target = &cells[cell + (position + k - read_offset_last) / group_last];
+                target->sum += value;
+                target->count += 1;
+                target->min = value < target->min ? value : target->min;
+                target->max = value > target->max ? value : target->max;
+            }
+            position += count;
+        }
+    }
+}
+
+bool om_decoder_reduce_chunks(const OmDecoder_t* decoder, OmRange_t chunk, const void* data, uint64_t data_size, const uint64_t* group, OmReduceCell_t* cells, void* chunk_buffer, OmError_t* error) {
+    if (decoder->data_type != DATA_TYPE_FLOAT_ARRAY) {
+        (*error) = ERROR_INVALID_DATA_TYPE;
+        return false;
+    }
+    if (om_decoder_reduce_cells_count(decoder, group) == 0) {
+        (*error) = ERROR_INVALID_READ_COUNT;
+        return false;
+    }
+    uint64_t pos = 0;
+    for (uint64_t chunkNum = chunk.lowerBound; chunkNum < chunk.upperBound; ++chunkNum) {
+        if (pos >= data_size) {
+            (*error) = ERROR_DEFLATED_SIZE_MISMATCH;
+            return false;
+        }
+        uint64_t lengthLast = 0;
+        const uint64_t lengthInChunk = _om_decoder_chunk_length(decoder, chunkNum, &lengthLast);
+        const uint8_t* chunkData = (const uint8_t *)data + pos;
+        if (!_om_decoder_chunk_in_read_range(decoder, chunkNum)) {
+            pos += _om_decoder_skip_chunk(decoder, chunkData, lengthInChunk, chunk_buffer);
+            continue;
+        }
+        pos += _om_decoder_decompress_filter(decoder, chunkData, lengthInChunk, lengthLast, chunk_buffer);
+        _om_decoder_cache_put_chunk(decoder, chunkNum, chunk_buffer, lengthInChunk);
+
+        const uint64_t start = decoder->stats == NULL ? 0 : _om_decoder_time_ns();
+        _om_decoder_reduce_chunk(decoder, chunkNum, chunk_buffer, lengthInChunk, lengthLast, group, cells);
+        if (decoder->stats != NULL) {
+            om_atomic_add(&decoder->stats->copy_ns, _om_decoder_time_ns() - start);
+        }
+    }
+    if (pos != data_size) {
+        (*error) = ERROR_DEFLATED_SIZE_MISMATCH;
+        return false;
+    }
+    return true;
+}
+
+uint64_t om_decoder_batch_chunks_count(const OmDecoder_t* decoders, uint64_t decoders_count) {
+    uint64_t count = 0;
+    for (uint64_t n = 0; n < decoders_count; n++) {
+        const OmDecoder_t* decoder = &decoders[n];
+        uint64_t chunksInRead = 1;
+        for (uint64_t i = 0; i < decoder->dimensions_count; i++) {
+            const uint64_t chunk = decoder->chunks[i];
+            const uint64_t read_offset = decoder->read_offset[i];
+            const uint64_t read_count = decoder->read_count[i];
+            chunksInRead *= divide_rounded_up(read_offset + read_count, chunk) - read_offset / chunk;
+        }
+        count += chunksInRead;
+    }
+    return count;
+}
+
+// Comparator to sort chunk indices
+static int _om_decoder_compare_chunk(const void* a, const void* b) {
+    const uint64_t x = *(const uint64_t*)a;
+    const uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+OmError_t om_decoder_batch_init(OmDecoderBatch_t* batch, const OmDecoder_t* decoders, uint64_t decoders_count, uint64_t* chunks_buffer, uint64_t chunks_buffer_count) {
+    if (decoders_count == 0) {
+        return ERROR_INVALID_BATCH;
+    }
+    if (om_decoder_batch_chunks_count(decoders, decoders_count) > chunks_buffer_count) {
+        return ERROR_INVALID_BATCH;
+    }
+
+    // All decoders must read from the same variable
+    const OmDecoder_t* first = &decoders[0];
+    for (uint64_t n = 1; n < decoders_count; n++) {
+        const OmDecoder_t* decoder = &decoders[n];
+        if (decoder->dimensions_count != first->dimensions_count ||
+            decoder->lut_start != first->lut_start ||
+            decoder->lut_chunk_length != first->lut_chunk_length ||
+            decoder->number_of_chunks != first->number_of_chunks ||
+            decoder->data_type != first->data_type ||
+            decoder->compression != first->compression) {
+            return ERROR_INVALID_BATCH;
+        }
+        for (uint64_t i = 0; i < first->dimensions_count; i++) {
+            if (decoder->dimensions[i] != first->dimensions[i] || decoder->chunks[i] != first->chunks[i]) {
+                return ERROR_INVALID_BATCH;
+            }
+        }
+    }
+
+    // Collect all chunks of all decoders
+    uint64_t count = 0;
+    for (uint64_t n = 0; n < decoders_count; n++) {
+        const OmDecoder_t* decoder = &decoders[n];
+        OmDecoder_indexRead_t index_read;
+        om_decoder_init_index_read(decoder, &index_read);
+        OmRange_t chunk = index_read.nextChunk;
+        while (true) {
+            for (uint64_t chunkIndex = chunk.lowerBound; chunkIndex < chunk.upperBound; chunkIndex++) {
+                chunks_buffer[count++] = chunkIndex;
+            }
+            chunk.lowerBound = chunk.upperBound - 1;
+            if (!_om_decoder_next_chunk_position(decoder, &chunk, index_read.nextChunkPosition)) {
+                break;
+            }
+        }
+    }
+
+    // Sort and remove duplicates
+    qsort(chunks_buffer, (size_t)count, sizeof(uint64_t), _om_decoder_compare_chunk);
+    uint64_t unique = 0;
+    for (uint64_t i = 0; i < count; i++) {
+        if (unique == 0 || chunks_buffer[unique-1] != chunks_buffer[i]) {
+            chunks_buffer[unique++] = chunks_buffer[i];
+        }
+    }
+
+    batch->decoders = decoders;
+    batch->decoders_count = decoders_count;
+    batch->chunks = chunks_buffer;
+    batch->chunks_count = unique;
+    return ERROR_OK;
+}
+
+void om_decoder_batch_init_index_read(OmDecoderBatch_indexRead_t* index_read) {
+    index_read->offset = 0;
+    index_read->count = 0;
+    index_read->indexRange.lowerBound = 0;
+    index_read->indexRange.upperBound = 0;
+    index_read->chunksPosition.lowerBound = 0;
+    index_read->chunksPosition.upperBound = 0;
+}
+
+bool om_decoder_batch_next_index_read(const OmDecoderBatch_t* batch, OmDecoderBatch_indexRead_t* index_read) {
+    const uint64_t startPosition = index_read->chunksPosition.upperBound;
+    if (startPosition >= batch->chunks_count) {
+        return false;
+    }
+
+    const OmDecoder_t* decoder = &batch->decoders[0];
+    const bool isV3LUT = decoder->lut_chunk_length > 1;
+    const uint64_t lut_chunk_element_count = isV3LUT ? LUT_CHUNK_COUNT : 1;
+    const uint64_t lut_chunk_length = isV3LUT ? decoder->lut_chunk_length : sizeof(uint64_t);
+
+    // V3 files require the LUT entry of the next chunk as well. Version 1 files require the entry of the previous chunk.
+    const uint64_t alignOffset = isV3LUT ? 0 : 1;
+    const uint64_t endAlignOffset = isV3LUT ? 1 : 0;
+
+    const uint64_t firstChunk = batch->chunks[startPosition];
+    const uint64_t readStart = (firstChunk == 0 ? 0 : firstChunk - alignOffset) / lut_chunk_element_count * lut_chunk_length;
+    uint64_t readEnd = ((firstChunk + endAlignOffset) / lut_chunk_element_count + 1) * lut_chunk_length;
+    uint64_t lastChunk = firstChunk;
+
+    uint64_t position = startPosition + 1;
+    for (; position < batch->chunks_count; position++) {
+        const uint64_t chunkIndex = batch->chunks[position];
+        const uint64_t readStartNext = (chunkIndex - alignOffset) / lut_chunk_element_count * lut_chunk_length;
+        const uint64_t readEndNext = ((chunkIndex + endAlignOffset) / lut_chunk_element_count + 1) * lut_chunk_length;
+
+        // Merge and split IO requests
+        if (readEndNext - readStart > decoder->io_size_max) {
+            break;
+        }
+        if (readStartNext > readEnd && readStartNext - readEnd > decoder->io_size_merge) {
+            break;
+        }
+        readEnd = om_max(readEnd, readEndNext);
+        lastChunk = chunkIndex;
+    }
+
+    index_read->offset = decoder->lut_start + readStart;
+    index_read->count = readEnd - readStart;
+    index_read->indexRange.lowerBound = firstChunk;
+    index_read->indexRange.upperBound = lastChunk + 1;
+    index_read->chunksPosition.lowerBound = startPosition;
+    index_read->chunksPosition.upperBound = position;
+    _om_decoder_count_index_read(decoder, index_read->count);
+    return true;
+}
+
+void om_decoder_batch_init_data_read(OmDecoderBatch_dataRead_t* data_read, const OmDecoderBatch_indexRead_t* index_read) {
+    data_read->offset = 0;
+    data_read->count = 0;
+    data_read->indexRange = index_read->indexRange;
+    data_read->chunkIndex.lowerBound = 0;
+    data_read->chunkIndex.upperBound = 0;
+    data_read->chunksPosition = index_read->chunksPosition;
+}
+
+// Internal function to get the byte range of a chunk from index data. Decompressed V3 LUT chunks are kept in `lut` to be reused for the next chunk.
+static bool _om_decoder_chunk_address(
+    const OmDecoder_t *decoder,
+    uint64_t index_range_lower,
+    const uint8_t* index_data,
+    uint64_t index_data_size,
+    uint64_t chunkIndex,
+    uint64_t* lut,
+    uint64_t* lut_chunk_loaded,
+    uint64_t* start,
+    uint64_t* end,
+    OmError_t* error
+) {
+    // Version 1 case: index is a flat Int64 array with end positions of each chunk
+    if (decoder->lut_chunk_length == 0) {
+        if (index_data == NULL) {
+            (*error) = ERROR_LUT_CACHE_MISS;
+            return false;
+        }
+        const uint64_t* data = (const uint64_t*)index_data;
+        const uint64_t base = index_range_lower == 0 ? 0 : index_range_lower - 1;
+        const uint64_t endPos = chunkIndex - base;
+        if ((endPos + 1) * sizeof(int64_t) > index_data_size) {
+            (*error) = ERROR_OUT_OF_BOUND_READ;
+            return false;
+        }
+        // Old files do not compress LUT and data is after LUT
+        const uint64_t dataStart = sizeof(OmHeaderV1_t) + decoder->number_of_chunks * sizeof(int64_t);
+        *start = (chunkIndex == 0 ? 0 : data[endPos - 1]) + dataStart;
+        *end = data[endPos] + dataStart;
+        return true;
+    }
+
+    const uint64_t lutOffset = index_range_lower / LUT_CHUNK_COUNT * decoder->lut_chunk_length;
+
+    return _om_decoder_lut_entry(decoder, chunkIndex, lutOffset, index_data, index_data_size, lut, lut_chunk_loaded, start, error) &&
+        _om_decoder_lut_entry(decoder, chunkIndex + 1, lutOffset, index_data, index_data_size, lut, lut_chunk_loaded, end, error);
+}
+
+bool om_decoder_batch_next_data_read(const OmDecoderBatch_t* batch, OmDecoderBatch_dataRead_t* data_read, const void* index_data, uint64_t index_data_size, OmError_t* error) {
+    if (data_read->chunksPosition.lowerBound >= data_read->chunksPosition.upperBound) {
+        return false;
+    }
+
+    const OmDecoder_t* decoder = &batch->decoders[0];
+    if (decoder->lut_pinned != NULL) {
+        index_data = _om_decoder_pinned_index_data(decoder, data_read->indexRange.lowerBound, &index_data_size);
+    }
+    uint64_t uncompressedLut[LUT_CHUNK_COUNT] = {0};
+    uint64_t lutChunkLoaded = UINT64_MAX;
+
+    uint64_t position = data_read->chunksPosition.lowerBound;
+    const uint64_t firstChunk = batch->chunks[position];
+    uint64_t startPos = 0, endPos = 0;
+    if (!_om_decoder_chunk_address(decoder, data_read->indexRange.lowerBound, index_data, index_data_size, firstChunk, uncompressedLut, &lutChunkLoaded, &startPos, &endPos, error)) {
+        return false;
+    }
+    uint64_t lastChunk = firstChunk;
+
+    for (position++; position < data_read->chunksPosition.upperBound; position++) {
+        const uint64_t chunkIndex = batch->chunks[position];
+        uint64_t chunkStart = 0, chunkEnd = 0;
+        if (!_om_decoder_chunk_address(decoder, data_read->indexRange.lowerBound, index_data, index_data_size, chunkIndex, uncompressedLut, &lutChunkLoaded, &chunkStart, &chunkEnd, error)) {
+            return false;
+        }
+        // Merge and split IO requests. Chunks in between are read and skipped while decoding.
+        if (chunkEnd - startPos > decoder->io_size_max || chunkStart - endPos > decoder->io_size_merge) {
+            break;
+        }
+        endPos = chunkEnd;
+        lastChunk = chunkIndex;
+    }
+
+    data_read->offset = startPos;
+    data_read->count = endPos - startPos;
+    data_read->chunkIndex.lowerBound = firstChunk;
+    data_read->chunkIndex.upperBound = lastChunk + 1;
+    data_read->chunksPosition.lowerBound = position;
+    _om_decoder_count_data_read(decoder, data_read->count);
+    return true;
+}
+
+bool om_decoder_batch_decode_chunks(const OmDecoderBatch_t* batch, OmRange_t chunk, const void* data, uint64_t data_size, void* const* into, void* chunk_buffer, OmError_t* error) {
+    const OmDecoder_t* decoder = &batch->decoders[0];
+    uint64_t pos = 0;
+    for (uint64_t chunkNum = chunk.lowerBound; chunkNum < chunk.upperBound; ++chunkNum) {
+        if (pos >= data_size) {
+            (*error) = ERROR_DEFLATED_SIZE_MISMATCH;
+            return false;
+        }
+        uint64_t lengthLast = 0;
+        const uint64_t lengthInChunk = _om_decoder_chunk_length(decoder, chunkNum, &lengthLast);
+        const uint8_t* input = (const uint8_t *)data + pos;
+
+        bool needed = false;
+        for (uint64_t n = 0; n < batch->decoders_count && !needed; n++) {
+            needed = _om_decoder_chunk_in_read_range(&batch->decoders[n], chunkNum);
+        }
+        if (!needed) {
+            // Skipped chunk. Only the compressed size is required.
+            pos += _om_decoder_skip_chunk(decoder, input, lengthInChunk, chunk_buffer);
+            continue;
+        }
+
+        // Filter once and copy into every read that covers this chunk
+        pos += _om_decoder_decompress_filter(decoder, input, lengthInChunk, lengthLast, chunk_buffer);
+        _om_decoder_cache_put_chunk(decoder, chunkNum, chunk_buffer, lengthInChunk);
+        for (uint64_t n = 0; n < batch->decoders_count; n++) {
+            const OmDecoder_t* target = &batch->decoders[n];
+            if (!_om_decoder_chunk_in_read_range(target, chunkNum)) {
+                continue;
+            }
+            _om_decoder_copy_chunk_timed(target, chunkNum, chunk_buffer, into[n]);
+        }
+    }
+
+    if (pos != data_size) {
+        (*error) = ERROR_DEFLATED_SIZE_MISMATCH;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,182 @@
+//
+//  om_dispatch.c
+//  OpenMeteoApi
+//
+//  Created on 14.10.2026.
+//
+
+#include "om_dispatch.h"
+#include "om_atomic.h"
+#include "om_x86v3.h"
+#include "vp4.h"
+#include "fp.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+static void om_cpuid(uint32_t leaf, uint32_t subleaf, uint32_t* regs) {
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, (int)leaf, (int)subleaf);
+    for (int i = 0; i < 4; i++) {
+        regs[i] = (uint32_t)r[i];
+    }
+#else
+    __cpuid_count(leaf, subleaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+/// Read the XCR0 register to check if the operating system saves SSE and AVX registers
+static uint64_t om_xgetbv(void) {
+#if defined(_MSC_VER)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+    return ((uint64_t)edx << 32) | eax;
+#endif
+}
+#endif
+
+uint32_t om_cpu_features(void) {
+    uint32_t features = 0;
+#if defined(__x86_64__) || defined(_M_X64)
+    uint32_t regs[4] = {0};
+    om_cpuid(0, 0, regs);
+    const uint32_t max_leaf = regs[0];
+    om_cpuid(0x80000000, 0, regs);
+    const uint32_t max_extended_leaf = regs[0];
+
+    if (max_leaf >= 1) {
+        om_cpuid(1, 0, regs);
+        const uint32_t ecx = regs[2];
+        if (ecx & (1 << 9)) {
+            features |= OM_CPU_SSSE3;
+        }
+        if (ecx & (1 << 19)) {
+            features |= OM_CPU_SSE41;
+        }
+        const bool osxsave = (ecx & (1 << 27)) != 0;
+        const bool avx = (ecx & (1 << 28)) != 0;
+        const bool os_avx = osxsave && avx && (om_xgetbv() & 0x6) == 0x6;
+        if (max_leaf >= 7) {
+            om_cpuid(7, 0, regs);
+            if (os_avx && (regs[1] & (1 << 5))) {
+                features |= OM_CPU_AVX2;
+            }
+            if (regs[1] & (1 << 8)) {
+                features |= OM_CPU_BMI2;
+            }
+        }
+    }
+    if (max_extended_leaf >= 0x80000001) {
+        om_cpuid(0x80000001, 0, regs);
+        if (regs[2] & (1 << 5)) {
+            features |= OM_CPU_LZCNT;
+        }
+    }
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    // Advanced SIMD is mandatory on AArch64
+    features |= OM_CPU_NEON;
+#endif
+    return features;
+}
+
+static const OmKernels_t om_kernels_baseline = {
+    "baseline",
+    p4nzdec8, p4nddec8, p4nzdec128v16, p4nddec128v16, p4nzdec128v32, p4nddec128v32, p4nzdec64, p4nddec64,
+    p4zdec128v16, p4zdec16, p4ddec128v16, p4ddec16, p4zdec128v32, p4zdec32, p4ddec128v32, p4ddec32,
+    p4nzenc8, p4ndenc8, p4nzenc128v16, p4ndenc128v16, p4nzenc128v32, p4ndenc128v32, p4nzenc64, p4ndenc64,
+    fpxenc32, fpxdec32, fpxenc64, fpxdec64
+};
+
+#ifdef OM_X86V3_CLONES
+// Clones defined in `*_x86v3.c`
+size_t p4nzdec8_x86v3(unsigned char *__restrict in, size_t n, uint8_t *__restrict out);
+size_t p4nddec8_x86v3(unsigned char *__restrict in, size_t n, uint8_t *__restrict out);
+size_t p4nzdec128v16_x86v3(unsigned char *__restrict in, size_t n, uint16_t *__restrict out);
+size_t p4nddec128v16_x86v3(unsigned char *__restrict in, size_t n, uint16_t *__restrict out);
+size_t p4nzdec128v32_x86v3(unsigned char *__restrict in, size_t n, uint32_t *__restrict out);
+size_t p4nddec128v32_x86v3(unsigned char *__restrict in, size_t n, uint32_t *__restrict out);
+size_t p4nzdec64_x86v3(unsigned char *__restrict in, size_t n, uint64_t *__restrict out);
+size_t p4nddec64_x86v3(unsigned char *__restrict in, size_t n, uint64_t *__restrict out);
+unsigned char* p4zdec128v16_x86v3(unsigned char *__restrict in, unsigned n, uint16_t *__restrict out, uint16_t start);
+unsigned char* p4zdec16_x86v3(unsigned char *__restrict in, unsigned n, uint16_t *__restrict out, uint16_t start);
+unsigned char* p4ddec128v16_x86v3(unsigned char *__restrict in, unsigned n, uint16_t *__restrict out, uint16_t start);
+unsigned char* p4ddec16_x86v3(unsigned char *__restrict in, unsigned n, uint16_t *__restrict out, uint16_t start);
+unsigned char* p4zdec128v32_x86v3(unsigned char *__restrict in, unsigned n, uint32_t *__restrict out, uint32_t start);
+unsigned char* p4zdec32_x86v3(unsigned char *__restrict in, unsigned n, uint32_t *__restrict out, uint32_t start);
+unsigned char* p4ddec128v32_x86v3(unsigned char *__restrict in, unsigned n, uint32_t *__restrict out, uint32_t start);
+unsigned char* p4ddec32_x86v3(unsigned char *__restrict in, unsigned n, uint32_t *__restrict out, uint32_t start);
+size_t p4nzenc8_x86v3(uint8_t *__restrict in, size_t n, unsigned char *__restrict out);
+size_t p4ndenc8_x86v3(uint8_t *__restrict in, size_t n, unsigned char *__restrict out);
+size_t p4nzenc128v16_x86v3(uint16_t *__restrict in, size_t n, unsigned char *__restrict out);
+size_t p4ndenc128v16_x86v3(uint16_t *__restrict in, size_t n, unsigned char *__restrict out);
+size_t p4nzenc128v32_x86v3(uint32_t *__restrict in, size_t n, unsigned char *__restrict out);
+size_t p4ndenc128v32_x86v3(uint32_t *__restrict in, size_t n, unsigned char *__restrict out);
+size_t p4nzenc64_x86v3(uint64_t *__restrict in, size_t n, unsigned char *__restrict out);
+size_t p4ndenc64_x86v3(uint64_t *__restrict in, size_t n, unsigned char *__restrict out);
+size_t fpxenc32_x86v3(uint32_t *in, size_t n, unsigned char *out, uint32_t start);
+size_t fpxdec32_x86v3(unsigned char *in, size_t n, uint32_t *out, uint32_t start);
+size_t fpxenc64_x86v3(uint64_t *in, size_t n, unsigned char *out, uint64_t start);
+size_t fpxdec64_x86v3(unsigned char *in, size_t n, uint64_t *out, uint64_t start);
+
+static const OmKernels_t om_kernels_x86v3 = {
+    "x86-64-v3",
+    p4nzdec8_x86v3, p4nddec8_x86v3, p4nzdec128v16_x86v3, p4nddec128v16_x86v3, p4nzdec128v32_x86v3, p4nddec128v32_x86v3, p4nzdec64_x86v3, p4nddec64_x86v3,
+    p4zdec128v16_x86v3, p4zdec16_x86v3, p4ddec128v16_x86v3, p4ddec16_x86v3, p4zdec128v32_x86v3, p4zdec32_x86v3, p4ddec128v32_x86v3, p4ddec32_x86v3,
+    p4nzenc8_x86v3, p4ndenc8_x86v3, p4nzenc128v16_x86v3, p4ndenc128v16_x86v3, p4nzenc128v32_x86v3, p4ndenc128v32_x86v3, p4nzenc64_x86v3, p4ndenc64_x86v3,
+    fpxenc32_x86v3, fpxdec32_x86v3, fpxenc64_x86v3, fpxdec64_x86v3
+};
+#endif
+
+/// 0 = not yet selected, 1 = baseline, 2 = x86-64-v3
+static volatile uint64_t om_kernels_selected = 0;
+
+const OmKernels_t* om_kernels(void) {
+    uint64_t selected = om_atomic_load(&om_kernels_selected);
+    if (selected == 0) {
+        // Concurrent first calls compute the same result. No lock required.
+        selected = 1;
+#ifdef OM_X86V3_CLONES
+        const uint32_t required = OM_CPU_AVX2 | OM_CPU_BMI2 | OM_CPU_LZCNT;
+        if ((om_cpu_features() & required) == required) {
+            selected = 2;
+        }
+#endif
+        om_atomic_store(&om_kernels_selected, selected);
+    }
+#ifdef OM_X86V3_CLONES
+    if (selected == 2) {
+        return &om_kernels_x86v3;
+    }
+#endif
+    return &om_kernels_baseline;
+}
+
+uint64_t om_kernels_count(void) {
+#ifdef OM_X86V3_CLONES
+    if (om_kernels() == &om_kernels_x86v3) {
+        return 2;
+    }
+#endif
+    return 1;
+}
+
+const OmKernels_t* om_kernels_at(uint64_t index) {
+    if (index == 0) {
+        return &om_kernels_baseline;
+    }
+#ifdef OM_X86V3_CLONES
+    if (index == 1 && om_kernels_count() == 2) {
+        return &om_kernels_x86v3;
+    }
+#endif
+    return NULL;
+}
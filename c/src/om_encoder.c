@@ -7,9 +7,13 @@
 
 #include "om_encoder.h"
 #include <assert.h>
+#include <string.h>
+#include <math.h>
+#include "om_atomic.h"
 #include "vp4.h"
 #include "fp.h"
 #include "delta2d.h"
+#include "om_dispatch.h"
 #include "conf.h"
 
 #pragma clang diagnostic error "-Wswitch"
@@ -39,6 +43,9 @@ OmError_t om_encoder_init(
     encoder->chunks = chunks;
     encoder->dimension_count = dimension_count;
     encoder->data_type = data_type;
+    encoder->adaptive = (compression & OM_COMPRESSION_ADAPTIVE) != 0;
+    // The LUT format does not change how chunks are encoded
+    compression = (OmCompression_t)(compression & ~OM_COMPRESSION_FLAGS);
     encoder->compression = compression;
 
     OmError_t error = ERROR_OK;
@@ -62,7 +69,7 @@ ALWAYS_INLINE uint64_t om_encode_compress(
         case COMPRESSION_PFOR_DELTA2D_INT16_LOGARITHMIC:
             // The initializer should have ensured that the data type is float
             assert(data_type == DATA_TYPE_FLOAT_ARRAY && "Expecting float array");
-            result = p4nzenc128v16((uint16_t*)input, (size_t)count, (unsigned char*)output);
+            result = om_kernels()->p4nzenc128v16((uint16_t*)input, (size_t)count, (unsigned char*)output);
             break;
 
         case COMPRESSION_FPX_XOR2D:
@@ -77,34 +84,34 @@ ALWAYS_INLINE uint64_t om_encode_compress(
         case COMPRESSION_PFOR_DELTA2D:
             switch (data_type) {
                 case DATA_TYPE_INT8_ARRAY:
-                    result = p4nzenc8((uint8_t*)input, (size_t)count, (unsigned char*)output);
+                    result = om_kernels()->p4nzenc8((uint8_t*)input, (size_t)count, (unsigned char*)output);
                     break;
                 case DATA_TYPE_UINT8_ARRAY:
-                    result = p4ndenc8((uint8_t*)input, (size_t)count, (unsigned char*)output);
+                    result = om_kernels()->p4ndenc8((uint8_t*)input, (size_t)count, (unsigned char*)output);
                     break;
                 case DATA_TYPE_INT16_ARRAY:
-                    result = p4nzenc128v16((uint16_t*)input, (size_t)count, (unsigned char*)output);
+                    result = om_kernels()->p4nzenc128v16((uint16_t*)input, (size_t)count, (unsigned char*)output);
                     break;
                 case DATA_TYPE_UINT16_ARRAY:
-                    result = p4ndenc128v16((uint16_t*)input, (size_t)count, (unsigned char*)output);
+                    result = om_kernels()->p4ndenc128v16((uint16_t*)input, (size_t)count, (unsigned char*)output);
                     break;
                 case DATA_TYPE_INT32_ARRAY:
-                    result = p4nzenc128v32((uint32_t*)input, (size_t)count, (unsigned char*)output);
+                    result = om_kernels()->p4nzenc128v32((uint32_t*)input, (size_t)count, (unsigned char*)output);
                     break;
                 case DATA_TYPE_UINT32_ARRAY:
-                    result = p4ndenc128v32((uint32_t*)input, (size_t)count, (unsigned char*)output);
+                    result = om_kernels()->p4ndenc128v32((uint32_t*)input, (size_t)count, (unsigned char*)output);
                     break;
                 case DATA_TYPE_INT64_ARRAY:
-                    result = p4nzenc64((uint64_t*)input, (size_t)count, (unsigned char*)output);
+                    result = om_kernels()->p4nzenc64((uint64_t*)input, (size_t)count, (unsigned char*)output);
                     break;
                 case DATA_TYPE_UINT64_ARRAY:
-                    result = p4ndenc64((uint64_t*)input, (size_t)count, (unsigned char*)output);
+                    result = om_kernels()->p4ndenc64((uint64_t*)input, (size_t)count, (unsigned char*)output);
                     break;
                 case DATA_TYPE_FLOAT_ARRAY:
-                    result = p4nzenc128v32((uint32_t*)input, (size_t)count, (unsigned char*)output);
+                    result = om_kernels()->p4nzenc128v32((uint32_t*)input, (size_t)count, (unsigned char*)output);
                     break;
                 case DATA_TYPE_DOUBLE_ARRAY:
-                    result = p4nzenc64((uint64_t*)input, (size_t)count, (unsigned char*)output);
+                    result = om_kernels()->p4nzenc64((uint64_t*)input, (size_t)count, (unsigned char*)output);
                     break;
                 case DATA_TYPE_NONE:
                 case DATA_TYPE_STRING:
@@ -123,6 +130,15 @@ ALWAYS_INLINE uint64_t om_encode_compress(
             }
             break;
 
+        case COMPRESSION_PFOR_FLOAT_LINEAR2D:
+            assert(data_type == DATA_TYPE_FLOAT_ARRAY || data_type == DATA_TYPE_DOUBLE_ARRAY && "Expecting float or double array");
+            if (data_type == DATA_TYPE_FLOAT_ARRAY) {
+                result = om_kernels()->p4nzenc128v32((uint32_t*)input, (size_t)count, (unsigned char*)output);
+            } else if (data_type == DATA_TYPE_DOUBLE_ARRAY) {
+                result = om_kernels()->p4nzenc64((uint64_t*)input, (size_t)count, (unsigned char*)output);
+            }
+            break;
+
         case COMPRESSION_NONE:
             break;
     }
@@ -178,6 +194,14 @@ ALWAYS_INLINE void om_encode_filter(
                     break;
             }
             break;
+        case COMPRESSION_PFOR_FLOAT_LINEAR2D:
+            assert(data_type == DATA_TYPE_FLOAT_ARRAY || data_type == DATA_TYPE_DOUBLE_ARRAY && "Expecting float or double array");
+            if (data_type == DATA_TYPE_FLOAT_ARRAY) {
+                delta2d_encode_linear32((size_t)(length_in_chunk / length_last), (size_t)length_last, (int32_t*)data);
+            } else if (data_type == DATA_TYPE_DOUBLE_ARRAY) {
+                delta2d_encode_linear64((size_t)(length_in_chunk / length_last), (size_t)length_last, (int64_t*)data);
+            }
+            break;
         case COMPRESSION_NONE:
             break;
     }
@@ -241,6 +265,15 @@ ALWAYS_INLINE void om_encode_copy(
             }
             break;
 
+        case COMPRESSION_PFOR_FLOAT_LINEAR2D:
+            assert(data_type == DATA_TYPE_FLOAT_ARRAY || data_type == DATA_TYPE_DOUBLE_ARRAY && "Expecting float or double array");
+            if (data_type == DATA_TYPE_FLOAT_ARRAY) {
+                om_common_copy_float_to_ordered32(count, input, output);
+            } else if (data_type == DATA_TYPE_DOUBLE_ARRAY) {
+                om_common_copy_double_to_ordered64(count, input, output);
+            }
+            break;
+
         case COMPRESSION_NONE:
             break;
     }
@@ -267,6 +300,10 @@ uint64_t om_encoder_chunk_buffer_size(const OmEncoder_t* encoder) {
     for (uint64_t i = 0; i < encoder->dimension_count; i++) {
         chunkLength *= encoder->chunks[i];
     }
+    if (encoder->adaptive) {
+        // Scratch space after the chunk to compress the unfiltered candidate
+        return chunkLength * encoder->bytes_per_element_compressed + om_encoder_compressed_chunk_buffer_size(encoder);
+    }
     return chunkLength * encoder->bytes_per_element_compressed;
 }
 
@@ -275,8 +312,8 @@ uint64_t om_encoder_compressed_chunk_buffer_size(const OmEncoder_t* encoder) {
     for (uint64_t i = 0; i < encoder->dimension_count; i++) {
         chunkLength *= encoder->chunks[i];
     }
-    // P4NENC256_BOUND. Compressor may write 32 integers more
-    return (chunkLength + 255) /256 + (chunkLength + 32) * encoder->bytes_per_element_compressed;
+    // P4NENC256_BOUND. Compressor may write 32 integers more. Adaptive chunks start with the codec byte.
+    return (chunkLength + 255) /256 + (chunkLength + 32) * encoder->bytes_per_element_compressed + (encoder->adaptive ? 1 : 0);
 }
 
 uint64_t om_encoder_lut_buffer_size(const uint64_t* lookUpTable, uint64_t lookUpTableCount) {
@@ -286,7 +323,7 @@ uint64_t om_encoder_lut_buffer_size(const uint64_t* lookUpTable, uint64_t lookUp
     for (uint64_t i = 0; i < nLutChunks; i++) {
         const uint64_t rangeStart = i * LUT_CHUNK_COUNT;
         const uint64_t rangeEnd = om_min(rangeStart + LUT_CHUNK_COUNT, lookUpTableCount);
-        const uint64_t len = p4ndenc64((uint64_t*)&lookUpTable[rangeStart], rangeEnd - rangeStart, (unsigned char *)buffer);
+        const uint64_t len = om_kernels()->p4ndenc64((uint64_t*)&lookUpTable[rangeStart], rangeEnd - rangeStart, (unsigned char *)buffer);
         if (len > maxLength) maxLength = len;
     }
     // Compression function can write 32 integers more
@@ -301,7 +338,7 @@ uint64_t om_encoder_compress_lut(const uint64_t* lookUpTable, uint64_t lookUpTab
     for (uint64_t i = 0; i < nLutChunks; i++) {
         const uint64_t rangeStart = i * LUT_CHUNK_COUNT;
         const uint64_t rangeEnd = om_min(rangeStart + LUT_CHUNK_COUNT, lookUpTableCount);
-        const uint64_t len = p4ndenc64((uint64_t*)&lookUpTable[rangeStart], rangeEnd - rangeStart, &out[i * lutChunkLength]);
+        const uint64_t len = om_kernels()->p4ndenc64((uint64_t*)&lookUpTable[rangeStart], rangeEnd - rangeStart, &out[i * lutChunkLength]);
         for (uint64_t j = i * lutChunkLength + len; j < (i+1) * lutChunkLength; j++) {
             out[j] = 0; // fill remaining space with 0
         }
@@ -309,6 +346,157 @@ uint64_t om_encoder_compress_lut(const uint64_t* lookUpTable, uint64_t lookUpTab
     return lutSize;
 }
 
+// Internal function to get the bit width of the differences to the first entry of a LUT block. LUT entries are increasing.
+static uint8_t _om_encoder_lut_packed_bits(const uint64_t* entries, uint64_t count) {
+    const uint64_t range = entries[count - 1] - entries[0];
+    uint8_t bits = 0;
+    while (bits < 64 && (range >> bits) != 0) {
+        bits++;
+    }
+    return bits;
+}
+
+uint64_t om_encoder_lut_packed_buffer_size(const uint64_t* lookUpTable, uint64_t lookUpTableCount) {
+    const uint64_t nLutChunks = divide_rounded_up(lookUpTableCount, LUT_CHUNK_COUNT);
+    uint64_t maxBits = 0;
+    for (uint64_t i = 0; i < nLutChunks; i++) {
+        const uint64_t rangeStart = i * LUT_CHUNK_COUNT;
+        const uint64_t rangeEnd = om_min(rangeStart + LUT_CHUNK_COUNT, lookUpTableCount);
+        maxBits = om_max(maxBits, _om_encoder_lut_packed_bits(&lookUpTable[rangeStart], rangeEnd - rangeStart));
+    }
+    // All blocks have the same size, so the block of an entry can be located without reading other blocks
+    return nLutChunks * (OM_LUT_PACKED_HEADER_SIZE + divide_rounded_up(LUT_CHUNK_COUNT * maxBits, 8) + OM_LUT_PACKED_PADDING);
+}
+
+uint64_t om_encoder_compress_lut_packed(const uint64_t* lookUpTable, uint64_t lookUpTableCount, uint8_t* out, uint64_t size_of_compressed_lut) {
+    const uint64_t nLutChunks = divide_rounded_up(lookUpTableCount, LUT_CHUNK_COUNT);
+    const uint64_t lutChunkLength = size_of_compressed_lut / nLutChunks;
+    memset(out, 0, size_of_compressed_lut);
+
+    for (uint64_t i = 0; i < nLutChunks; i++) {
+        const uint64_t rangeStart = i * LUT_CHUNK_COUNT;
+        const uint64_t rangeEnd = om_min(rangeStart + LUT_CHUNK_COUNT, lookUpTableCount);
+        uint8_t* block = &out[i * lutChunkLength];
+        const uint64_t base = lookUpTable[rangeStart];
+        const uint8_t bits = _om_encoder_lut_packed_bits(&lookUpTable[rangeStart], rangeEnd - rangeStart);
+        memcpy(block, &base, sizeof(uint64_t));
+        block[sizeof(uint64_t)] = bits;
+        uint8_t* packed = block + OM_LUT_PACKED_HEADER_SIZE;
+        for (uint64_t j = rangeStart; j < rangeEnd; j++) {
+            const uint64_t delta = lookUpTable[j] - base;
+            const uint64_t position = (j - rangeStart) * bits;
+            for (uint64_t b = 0; b < bits; b++) {
+                if ((delta >> b) & 1) {
+                    packed[(position + b) / 8] |= (uint8_t)(1 << ((position + b) % 8));
+                }
+            }
+        }
+    }
+    return size_of_compressed_lut;
+}
+
+// Compute statistics of a chunk buffer before filtering. Values are converted back to float in small blocks.
+static void _om_encoder_chunk_stats(const OmEncoder_t* encoder, const uint8_t* chunkBuffer, uint64_t lengthInChunk, OmChunkStats_t* stats) {
+    float min = NAN;
+    float max = NAN;
+    uint32_t nan_count = 0;
+    for (uint64_t position = 0; position < lengthInChunk;) {
+        float values[256];
+        const uint64_t count = om_min(lengthInChunk - position, 256);
+        const uint8_t* src = chunkBuffer + position * encoder->bytes_per_element_compressed;
+        switch (encoder->compression) {
+            case COMPRESSION_PFOR_DELTA2D_INT16:
+                om_common_copy_int16_to_float(count, encoder->scale_factor, encoder->add_offset, src, values);
+                break;
+            case COMPRESSION_PFOR_DELTA2D_INT16_LOGARITHMIC:
+                om_common_copy_int16_to_float_log10(count, encoder->scale_factor, src, values);
+                break;
+            case COMPRESSION_PFOR_DELTA2D:
+                om_common_copy_int32_to_float(count, encoder->scale_factor, encoder->add_offset, src, values);
+                break;
+            case COMPRESSION_PFOR_FLOAT_LINEAR2D:
+                om_common_copy_ordered32_to_float(count, src, values);
+                break;
+            default:
+                om_common_copy32(count, src, values);
+                break;
+        }
+        for (uint64_t k = 0; k < count; k++) {
+            const float value = values[k];
+            if (isnan(value)) {
+                nan_count++;
+                continue;
+            }
+            if (isnan(min) || value < min) min = value;
+            if (isnan(max) || value > max) max = value;
+        }
+        position += count;
+    }
+    stats->min = min;
+    stats->max = max;
+    stats->nan_count = nan_count;
+}
+
+// True if all elements in the chunk buffer are identical after scaling, e.g. all zero or all NaN.
+// All elements are equal if the buffer equals itself shifted by one element.
+static bool _om_encoder_chunk_is_constant(const OmEncoder_t* encoder, const uint8_t* chunkBuffer, uint64_t lengthInChunk) {
+    const uint64_t bytesPerElement = encoder->bytes_per_element_compressed;
+    return lengthInChunk == 1 || memcmp(chunkBuffer, chunkBuffer + bytesPerElement, (lengthInChunk - 1) * bytesPerElement) == 0;
+}
+
+// Encode a constant chunk as codec byte and a single value
+static uint64_t _om_encoder_compress_constant(const OmEncoder_t* encoder, const uint8_t* chunkBuffer, uint8_t* out) {
+    out[0] = CHUNK_CODEC_CONSTANT;
+    memcpy(out + 1, chunkBuffer, encoder->bytes_per_element_compressed);
+    return 1 + encoder->bytes_per_element_compressed;
+}
+
+// Encode a chunk of an array with `OM_COMPRESSION_ADAPTIVE` that is not constant. Writes a `OmChunkCodec_t` byte followed by the smallest encoding.
+// `chunkBuffer` holds values before filtering. The unfiltered or raw candidate is kept in the scratch space after the chunk.
+static uint64_t _om_encoder_compress_adaptive(const OmEncoder_t* encoder, uint8_t* chunkBuffer, uint64_t lengthInChunk, uint64_t lengthLast, uint8_t* out) {
+    const uint64_t rawSize = lengthInChunk * encoder->bytes_per_element_compressed;
+    uint8_t* scratch = chunkBuffer + rawSize;
+    memset(scratch, 0, om_encoder_compressed_chunk_buffer_size(encoder));
+    uint64_t scratchSize = om_encode_compress(encoder->data_type, encoder->compression, chunkBuffer, lengthInChunk, scratch);
+    OmChunkCodec_t scratchCodec = CHUNK_CODEC_UNFILTERED;
+    if (scratchSize >= rawSize) {
+        memcpy(scratch, chunkBuffer, rawSize);
+        scratchSize = rawSize;
+        scratchCodec = CHUNK_CODEC_RAW;
+    }
+
+    om_encode_filter(encoder->data_type, encoder->compression, chunkBuffer, lengthInChunk, lengthLast);
+    const uint64_t filteredSize = om_encode_compress(encoder->data_type, encoder->compression, chunkBuffer, lengthInChunk, out + 1);
+    if (filteredSize <= scratchSize) {
+        out[0] = CHUNK_CODEC_FILTERED;
+        return 1 + filteredSize;
+    }
+    out[0] = scratchCodec;
+    memcpy(out + 1, scratch, scratchSize);
+    return 1 + scratchSize;
+}
+
+// Internal function to compute statistics, filter and compress a chunk after it has been copied into `chunkBuffer`
+static uint64_t _om_encoder_compress_copied(const OmEncoder_t* encoder, uint8_t* chunkBuffer, uint64_t lengthInChunk, uint64_t lengthLast, uint8_t* out, OmChunkStats_t* stats) {
+    // Constant chunks skip filter and compression. Statistics only need one value.
+    if (encoder->adaptive && _om_encoder_chunk_is_constant(encoder, chunkBuffer, lengthInChunk)) {
+        if (stats != NULL && encoder->data_type == DATA_TYPE_FLOAT_ARRAY) {
+            _om_encoder_chunk_stats(encoder, chunkBuffer, 1, stats);
+            stats->nan_count *= (uint32_t)lengthInChunk;
+        }
+        return _om_encoder_compress_constant(encoder, chunkBuffer, out);
+    }
+    if (stats != NULL && encoder->data_type == DATA_TYPE_FLOAT_ARRAY) {
+        _om_encoder_chunk_stats(encoder, chunkBuffer, lengthInChunk, stats);
+    }
+    if (encoder->adaptive) {
+        return _om_encoder_compress_adaptive(encoder, chunkBuffer, lengthInChunk, lengthLast, out);
+    }
+    om_encode_filter(encoder->data_type, encoder->compression, chunkBuffer, lengthInChunk, lengthLast);
+    uint64_t compressed_length = om_encode_compress(encoder->data_type, encoder->compression, chunkBuffer, lengthInChunk, out);
+    return compressed_length;
+}
+
 uint64_t om_encoder_compress_chunk(
     const OmEncoder_t* encoder,
     const void* array,
@@ -320,6 +508,21 @@ uint64_t om_encoder_compress_chunk(
     uint8_t* out,
     uint8_t* chunkBuffer
 ) {
+    return om_encoder_compress_chunk_stats(encoder, array, arrayDimensions, arrayOffset, arrayCount, chunkIndex, chunkIndexOffsetInThisArray, out, chunkBuffer, NULL);
+}
+
+uint64_t om_encoder_compress_chunk_stats(
+    const OmEncoder_t* encoder,
+    const void* array,
+    const uint64_t* arrayDimensions,
+    const uint64_t* arrayOffset,
+    const uint64_t* arrayCount,
+    uint64_t chunkIndex,
+    uint64_t chunkIndexOffsetInThisArray,
+    uint8_t* out,
+    uint8_t* chunkBuffer,
+    OmChunkStats_t* stats
+) {
 
     const uint64_t dimension_count = encoder->dimension_count;
     // The total size of `arrayDimensions`. Only used to check for out of bound reads
@@ -337,6 +540,13 @@ uint64_t om_encoder_compress_chunk(
     bool linearRead = true;
     uint64_t lengthLast = 0;
 
+    // Number of fast dimensions that are merged into one linear copy
+    uint64_t merged = 0;
+    // Chunk length, array stride and chunk buffer stride per dimension. Only used for up to 3 dimensions.
+    uint64_t lengths[3];
+    uint64_t strideArray[3];
+    uint64_t strideChunk[3];
+
     for (uint64_t i_forward = 0; i_forward < dimension_count; i_forward++) {
         const uint64_t i = dimension_count - i_forward - 1;
         const uint64_t dimension = encoder->dimensions[i];
@@ -355,12 +565,20 @@ uint64_t om_encoder_compress_chunk(
         assert(length0 <= arrayCount[i]);
         assert(length0 <= arrayDimensions[i]);
 
+        if (dimension_count <= 3) {
+            lengths[i] = length0;
+            strideArray[i] = rollingMultiplyTargetCube;
+            strideChunk[i] = rollingMultiplyChunkLength;
+        }
+
         if (i == dimension_count - 1 && !(arrayCount[i] == length0 && arrayDimensions[i] == length0)) {
             linearReadCount = length0;
             linearRead = false;
+            merged = 1;
         }
         if (linearRead && arrayCount[i] == length0 && arrayDimensions[i] == length0) {
             linearReadCount *= length0;
+            merged++;
         } else {
             linearRead = false;
         }
@@ -372,6 +590,43 @@ uint64_t om_encoder_compress_chunk(
 
     const uint64_t lengthInChunk = rollingMultiplyChunkLength;
 
+    if (dimension_count <= 3) {
+        // At most 2 dimensions are not merged. Iterate them with nested loops instead of dividing coordinates for every copy.
+        const uint64_t outer = dimension_count - merged;
+        uint64_t n0 = 1, n1 = 1;
+        uint64_t strideArray0 = 0, strideChunk0 = 0, strideArray1 = 0, strideChunk1 = 0;
+        if (outer == 2) {
+            n0 = lengths[0];
+            strideArray0 = strideArray[0];
+            strideChunk0 = strideChunk[0];
+        }
+        if (outer >= 1) {
+            n1 = lengths[outer - 1];
+            strideArray1 = strideArray[outer - 1];
+            strideChunk1 = strideChunk[outer - 1];
+        }
+        for (uint64_t i0 = 0; i0 < n0; i0++) {
+            uint64_t readRow = readCoordinate + i0 * strideArray0;
+            uint64_t writeRow = i0 * strideChunk0;
+            for (uint64_t i1 = 0; i1 < n1; i1++) {
+                assert(readRow + linearReadCount <= arrayTotalCount);
+                assert(writeRow + linearReadCount <= lengthInChunk);
+                om_encode_copy(
+                    encoder->data_type,
+                    encoder->compression,
+                    linearReadCount,
+                    encoder->scale_factor,
+                    encoder->add_offset,
+                    (const uint8_t*)array + encoder->bytes_per_element * readRow,
+                    chunkBuffer + encoder->bytes_per_element_compressed * writeRow
+                );
+                readRow += strideArray1;
+                writeRow += strideChunk1;
+            }
+        }
+        return _om_encoder_compress_copied(encoder, chunkBuffer, lengthInChunk, lengthLast, out, stats);
+    }
+
     while (true) {
         assert(readCoordinate + linearReadCount <= arrayTotalCount);
         assert(writeCoordinate + linearReadCount <= lengthInChunk);
@@ -398,7 +653,9 @@ uint64_t om_encoder_compress_chunk(
             uint64_t i = dimension_count - i_forward - 1;
             const uint64_t chunk = encoder->chunks[i];
 
-            const uint64_t qPos = ((readCoordinate / rollingMultiplyTargetCube) % arrayDimensions[i] - arrayOffset[i]) / chunk;
+            // Position in `arrayCount` before moving to the next element. The next position may wrap around `arrayDimensions`.
+            const uint64_t local = (readCoordinate / rollingMultiplyTargetCube) % arrayDimensions[i] - arrayOffset[i];
+            const uint64_t qPos = local / chunk;
             const uint64_t length0 = om_min((qPos + 1) * chunk, arrayCount[i]) - qPos * chunk;
             readCoordinate += rollingMultiplyTargetCube;
 
@@ -411,7 +668,7 @@ uint64_t om_encoder_compress_chunk(
             } else {
                 linearRead = false;
             }
-            const uint64_t q0 = ((readCoordinate / rollingMultiplyTargetCube) % arrayDimensions[i] - arrayOffset[i]) % encoder->chunks[i];
+            const uint64_t q0 = (local + 1) % chunk;
             if (q0 != 0 && q0 != length0) {
                 break;
             }
@@ -419,10 +676,211 @@ uint64_t om_encoder_compress_chunk(
             rollingMultiplyTargetCube *= arrayDimensions[i];
 
             if (i == 0) {
-                om_encode_filter(encoder->data_type, encoder->compression, chunkBuffer, lengthInChunk, lengthLast);
-                uint64_t compressed_length = om_encode_compress(encoder->data_type, encoder->compression, chunkBuffer, lengthInChunk, out);
-                return compressed_length;
+                return _om_encoder_compress_copied(encoder, chunkBuffer, lengthInChunk, lengthLast, out, stats);
             }
         }
     }
 }
+
+// Internal function to scale and copy `count` elements that are `stride` bytes apart into the chunk buffer.
+// Non contiguous elements are gathered into a small buffer first, so conversion still runs over contiguous blocks.
+static void _om_encoder_copy_strided(const OmEncoder_t* encoder, uint64_t count, const uint8_t* input, int64_t stride, uint8_t* output) {
+    if (stride == (int64_t)encoder->bytes_per_element) {
+        om_encode_copy(encoder->data_type, encoder->compression, count, encoder->scale_factor, encoder->add_offset, input, output);
+        return;
+    }
+    const uint64_t bytesPerElement = encoder->bytes_per_element;
+    uint64_t buffer[256];
+    for (uint64_t start = 0; start < count; start += 256) {
+        const uint64_t length = om_min(256, count - start);
+        for (uint64_t i = 0; i < length; i++) {
+            memcpy((uint8_t*)buffer + i * bytesPerElement, input + (int64_t)(start + i) * stride, bytesPerElement);
+        }
+        om_encode_copy(encoder->data_type, encoder->compression, length, encoder->scale_factor, encoder->add_offset, buffer, output + start * encoder->bytes_per_element_compressed);
+    }
+}
+
+uint64_t om_encoder_compress_chunk_strided(
+    const OmEncoder_t* encoder,
+    const void* array,
+    const int64_t* arrayStrides,
+    const uint64_t* arrayOffset,
+    const uint64_t* arrayCount,
+    uint64_t chunkIndex,
+    uint64_t chunkIndexOffsetInThisArray,
+    uint8_t* out,
+    uint8_t* chunkBuffer,
+    OmChunkStats_t* stats
+) {
+    const uint64_t dimension_count = encoder->dimension_count;
+    const int64_t strideLast = arrayStrides[dimension_count - 1];
+
+    uint64_t rollingMultiply = 1;
+    uint64_t lengthInChunk = 1;
+    uint64_t lengthLast = 0;
+    int64_t read = 0; // Byte offset of the current row in `array`
+
+    for (uint64_t i_forward = 0; i_forward < dimension_count; i_forward++) {
+        const uint64_t i = dimension_count - i_forward - 1;
+        const uint64_t dimension = encoder->dimensions[i];
+        const uint64_t chunk = encoder->chunks[i];
+
+        const uint64_t nChunksInThisDimension = divide_rounded_up(dimension, chunk);
+        const uint64_t c0 = (chunkIndex / rollingMultiply) % nChunksInThisDimension;
+        const uint64_t c0Offset = (chunkIndexOffsetInThisArray / rollingMultiply) % nChunksInThisDimension;
+        const uint64_t length0 = om_min((c0 + 1) * chunk, dimension) - c0 * chunk;
+        assert(length0 <= arrayCount[i]);
+
+        if (i == dimension_count - 1) {
+            lengthLast = length0;
+        }
+        read += arrayStrides[i] * (int64_t)(c0Offset * chunk + arrayOffset[i]);
+        rollingMultiply *= nChunksInThisDimension;
+        lengthInChunk *= length0;
+    }
+
+    // Copy one row of the fastest dimension at a time and move to the next row like an odometer
+    uint64_t write = 0;
+    while (true) {
+        _om_encoder_copy_strided(encoder, lengthLast, (const uint8_t*)array + read, strideLast, chunkBuffer + encoder->bytes_per_element_compressed * write);
+        write += lengthLast;
+        if (write >= lengthInChunk) {
+            return _om_encoder_compress_copied(encoder, chunkBuffer, lengthInChunk, lengthLast, out, stats);
+        }
+
+        rollingMultiply = divide_rounded_up(encoder->dimensions[dimension_count - 1], encoder->chunks[dimension_count - 1]);
+        uint64_t rollingMultiplyChunkLength = lengthLast;
+        for (uint64_t i_forward = 1; i_forward < dimension_count; i_forward++) {
+            const uint64_t i = dimension_count - i_forward - 1;
+            const uint64_t dimension = encoder->dimensions[i];
+            const uint64_t chunk = encoder->chunks[i];
+            const uint64_t nChunksInThisDimension = divide_rounded_up(dimension, chunk);
+            const uint64_t c0 = (chunkIndex / rollingMultiply) % nChunksInThisDimension;
+            const uint64_t length0 = om_min((c0 + 1) * chunk, dimension) - c0 * chunk;
+
+            read += arrayStrides[i];
+            if ((write / rollingMultiplyChunkLength) % length0 != 0) {
+                break; // No overflow in this dimension
+            }
+            read -= (int64_t)length0 * arrayStrides[i];
+            rollingMultiply *= nChunksInThisDimension;
+            rollingMultiplyChunkLength *= length0;
+        }
+    }
+}
+
+uint64_t om_encoder_pipeline_memory_size(const OmEncoder_t* encoder, uint64_t slots_count) {
+    // Align slots to 64 bytes
+    const uint64_t slot_size = divide_rounded_up(om_encoder_compressed_chunk_buffer_size(encoder), 64) * 64;
+    return slots_count * (slot_size + sizeof(uint64_t));
+}
+
+OmError_t om_encoder_pipeline_init(OmEncoderPipeline_t* pipeline, const OmEncoder_t* encoder, const void* array, const uint64_t* arrayDimensions, const uint64_t* arrayOffset, const uint64_t* arrayCount, uint64_t chunk_index_start, void* memory, uint64_t memory_size) {
+    const uint64_t slot_size = divide_rounded_up(om_encoder_compressed_chunk_buffer_size(encoder), 64) * 64;
+    const uint64_t slots_count = memory_size / (slot_size + sizeof(uint64_t));
+    if (slots_count == 0) {
+        return ERROR_INVALID_DIMENSIONS;
+    }
+    pipeline->encoder = encoder;
+    pipeline->array = array;
+    pipeline->array_dimensions = arrayDimensions;
+    pipeline->array_offset = arrayOffset;
+    pipeline->array_count = arrayCount;
+    pipeline->chunk_index_start = chunk_index_start;
+    pipeline->chunks_count = om_encoder_count_chunks_in_array(encoder, arrayCount);
+    pipeline->slot_size = slot_size;
+    pipeline->slots_count = slots_count;
+    pipeline->slots = (uint8_t*)memory;
+    pipeline->slot_sizes = (volatile uint64_t*)(pipeline->slots + slots_count * slot_size);
+    for (uint64_t i = 0; i < slots_count; i++) {
+        pipeline->slot_sizes[i] = 0;
+    }
+    pipeline->next_compress = 0;
+    pipeline->next_output = 0;
+    pipeline->cancelled = 0;
+    pipeline->chunk_stats = NULL;
+    pipeline->array_strides = NULL;
+    return ERROR_OK;
+}
+
+OmEncoderPipelineStatus_t om_encoder_pipeline_compress(OmEncoderPipeline_t* pipeline, uint8_t* chunkBuffer) {
+    // Claim the next chunk. A chunk can only be compressed once its slot has been released by the consumer.
+    uint64_t chunk;
+    while (true) {
+        if (om_atomic_load(&pipeline->cancelled)) {
+            return ENCODER_PIPELINE_DONE;
+        }
+        chunk = om_atomic_load(&pipeline->next_compress);
+        if (chunk >= pipeline->chunks_count) {
+            return ENCODER_PIPELINE_DONE;
+        }
+        if (chunk >= om_atomic_load(&pipeline->next_output) + pipeline->slots_count) {
+            return ENCODER_PIPELINE_FULL;
+        }
+        if (om_atomic_compare_exchange(&pipeline->next_compress, chunk, chunk + 1)) {
+            break;
+        }
+    }
+    const uint64_t slot = chunk % pipeline->slots_count;
+    uint8_t* out = pipeline->slots + slot * pipeline->slot_size;
+    // The compressor expects zero initialised output memory
+    memset(out, 0, pipeline->slot_size);
+    OmChunkStats_t* stats = pipeline->chunk_stats == NULL ? NULL : &pipeline->chunk_stats[chunk];
+    const uint64_t size = pipeline->array_strides != NULL ? om_encoder_compress_chunk_strided(
+        pipeline->encoder,
+        pipeline->array,
+        pipeline->array_strides,
+        pipeline->array_offset,
+        pipeline->array_count,
+        pipeline->chunk_index_start + chunk,
+        chunk,
+        out,
+        chunkBuffer,
+        stats
+    ) : om_encoder_compress_chunk_stats(
+        pipeline->encoder,
+        pipeline->array,
+        pipeline->array_dimensions,
+        pipeline->array_offset,
+        pipeline->array_count,
+        pipeline->chunk_index_start + chunk,
+        chunk,
+        out,
+        chunkBuffer,
+        stats
+    );
+    // Compressed chunks are never empty. Size 0 marks a slot that is not ready.
+    om_atomic_store(&pipeline->slot_sizes[slot], size);
+    return ENCODER_PIPELINE_COMPRESSED;
+}
+
+bool om_encoder_pipeline_next_output(const OmEncoderPipeline_t* pipeline, const uint8_t** data, uint64_t* size) {
+    const uint64_t chunk = pipeline->next_output;
+    if (chunk >= pipeline->chunks_count) {
+        return false;
+    }
+    const uint64_t slot = chunk % pipeline->slots_count;
+    const uint64_t compressed = om_atomic_load(&pipeline->slot_sizes[slot]);
+    if (compressed == 0) {
+        return false;
+    }
+    (*data) = pipeline->slots + slot * pipeline->slot_size;
+    (*size) = compressed;
+    return true;
+}
+
+void om_encoder_pipeline_release_output(OmEncoderPipeline_t* pipeline) {
+    const uint64_t chunk = pipeline->next_output;
+    const uint64_t slot = chunk % pipeline->slots_count;
+    pipeline->slot_sizes[slot] = 0;
+    // Publish the free slot to workers
+    om_atomic_store(&pipeline->next_output, chunk + 1);
+}
+
+bool om_encoder_pipeline_is_complete(const OmEncoderPipeline_t* pipeline) {
+    return pipeline->next_output >= pipeline->chunks_count;
+}
+
+void om_encoder_pipeline_cancel(OmEncoderPipeline_t* pipeline) {
+    om_atomic_store(&pipeline->cancelled, 1);
+}
@@ -0,0 +1,233 @@
+//
+//  om_uring.c
+//  OpenMeteoApi
+//
+//  Created on 14.10.2026.
+//
+
+#include <errno.h>
+#include <string.h>
+#include "om_uring.h"
+
+#if defined(__linux__) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define OM_URING_AVAILABLE
+#endif
+#endif
+
+#ifdef OM_URING_AVAILABLE
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+static int om_uring_setup(uint32_t entries, struct io_uring_params* params) {
+    return (int)syscall(__NR_io_uring_setup, entries, params);
+}
+
+static int om_uring_enter(int fd, uint32_t to_submit, uint32_t min_complete, uint32_t flags) {
+    return (int)syscall(__NR_io_uring_enter, fd, to_submit, min_complete, flags, NULL, 0);
+}
+
+static int om_uring_register(int fd, uint32_t opcode, const void* arg, uint32_t nr_args) {
+    return (int)syscall(__NR_io_uring_register, fd, opcode, arg, nr_args);
+}
+
+int om_uring_init(OmUring_t* ring, uint32_t entries, void* buffer, uint64_t buffer_size) {
+    memset(ring, 0, sizeof(OmUring_t));
+    ring->fd = -1;
+
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+    const int fd = om_uring_setup(entries, &params);
+    if (fd < 0) {
+        return errno == EPERM ? -ENOSYS : -errno;
+    }
+    // IORING_OP_READ requires Linux 5.6. Fast poll was added in 5.7 and is used as a version check.
+    if (!(params.features & IORING_FEAT_FAST_POLL)) {
+        close(fd);
+        return -ENOSYS;
+    }
+    ring->fd = fd;
+    ring->entries = params.sq_entries;
+
+    ring->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    ring->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+
+    ring->sq_ring = mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    ring->cq_ring = mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_CQ_RING);
+    ring->sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQES);
+    if (ring->sq_ring == MAP_FAILED || ring->cq_ring == MAP_FAILED || ring->sqes == MAP_FAILED) {
+        const int error = -errno;
+        om_uring_destroy(ring);
+        return error;
+    }
+
+    uint8_t* sq = (uint8_t*)ring->sq_ring;
+    ring->sq_head = (uint32_t*)(sq + params.sq_off.head);
+    ring->sq_tail = (uint32_t*)(sq + params.sq_off.tail);
+    ring->sq_mask = (uint32_t*)(sq + params.sq_off.ring_mask);
+    ring->sq_array = (uint32_t*)(sq + params.sq_off.array);
+
+    uint8_t* cq = (uint8_t*)ring->cq_ring;
+    ring->cq_head = (uint32_t*)(cq + params.cq_off.head);
+    ring->cq_tail = (uint32_t*)(cq + params.cq_off.tail);
+    ring->cq_mask = (uint32_t*)(cq + params.cq_off.ring_mask);
+    ring->cqes = cq + params.cq_off.cqes;
+
+    if (buffer && buffer_size > 0) {
+        struct iovec iov = { .iov_base = buffer, .iov_len = buffer_size };
+        if (om_uring_register(fd, IORING_REGISTER_BUFFERS, &iov, 1) == 0) {
+            ring->buffer = (uint8_t*)buffer;
+            ring->buffer_size = buffer_size;
+        }
+    }
+    return 0;
+}
+
+/// Complete a short read with blocking `pread`
+static int om_uring_complete_short_read(int fd, const OmUringRead_t* read, uint64_t done) {
+    while (done < read->count) {
+        const ssize_t n = pread(fd, (uint8_t*)read->buffer + done, read->count - done, (off_t)(read->offset + done));
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n < 0) {
+            return -errno;
+        }
+        if (n == 0) {
+            // Unexpected end of file
+            return -EIO;
+        }
+        done += (uint64_t)n;
+    }
+    return 0;
+}
+
+int om_uring_read(OmUring_t* ring, int fd, const OmUringRead_t* reads, uint64_t count) {
+    if (ring->fd < 0) {
+        return -EBADF;
+    }
+    struct io_uring_sqe* sqes = (struct io_uring_sqe*)ring->sqes;
+    struct io_uring_cqe* cqes = (struct io_uring_cqe*)ring->cqes;
+    const uint32_t sq_mask = *ring->sq_mask;
+    const uint32_t cq_mask = *ring->cq_mask;
+
+    int error = 0;
+    /// Reads after `limit` are not submitted anymore after an error
+    uint64_t limit = count;
+    uint64_t submitted = 0;
+    uint64_t completed = 0;
+    /// Entries in the submission queue which were not yet consumed by the kernel
+    uint32_t pending = 0;
+
+    while (completed < submitted || submitted < limit) {
+        // Fill the submission queue. At most `entries` reads are in flight, so the completion queue cannot overflow.
+        uint32_t tail = *ring->sq_tail;
+        while (submitted < limit && submitted - completed < ring->entries) {
+            const OmUringRead_t* read = &reads[submitted];
+            if (read->count > UINT32_MAX) {
+                error = -EINVAL;
+                limit = submitted;
+                break;
+            }
+            const uint32_t index = tail & sq_mask;
+            struct io_uring_sqe* sqe = &sqes[index];
+            memset(sqe, 0, sizeof(struct io_uring_sqe));
+            const uint8_t* buffer = (const uint8_t*)read->buffer;
+            const bool fixed = ring->buffer && buffer >= ring->buffer && buffer + read->count <= ring->buffer + ring->buffer_size;
+            sqe->opcode = fixed ? IORING_OP_READ_FIXED : IORING_OP_READ;
+            sqe->fd = fd;
+            sqe->off = read->offset;
+            sqe->addr = (uint64_t)(uintptr_t)read->buffer;
+            sqe->len = (uint32_t)read->count;
+            sqe->buf_index = 0;
+            sqe->user_data = submitted;
+            ring->sq_array[index] = index;
+            tail++;
+            submitted++;
+            pending++;
+        }
+        __atomic_store_n(ring->sq_tail, tail, __ATOMIC_RELEASE);
+
+        if (completed == submitted) {
+            break;
+        }
+        const int ret = om_uring_enter(ring->fd, pending, 1, IORING_ENTER_GETEVENTS);
+        if (ret < 0) {
+            if (errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+                continue;
+            }
+            // The ring is unusable. Reads that were already submitted may still complete into caller memory.
+            return -errno;
+        }
+        pending -= (uint32_t)ret;
+
+        // Reap completions
+        uint32_t head = *ring->cq_head;
+        const uint32_t cq_tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+        while (head != cq_tail) {
+            const struct io_uring_cqe* cqe = &cqes[head & cq_mask];
+            const OmUringRead_t* read = &reads[cqe->user_data];
+            int result = 0;
+            if (cqe->res < 0) {
+                result = cqe->res;
+            } else if ((uint64_t)cqe->res < read->count) {
+                result = om_uring_complete_short_read(fd, read, (uint64_t)cqe->res);
+            }
+            if (result != 0 && error == 0) {
+                error = result;
+                limit = submitted;
+            }
+            head++;
+            completed++;
+        }
+        __atomic_store_n(ring->cq_head, head, __ATOMIC_RELEASE);
+    }
+    return error;
+}
+
+void om_uring_destroy(OmUring_t* ring) {
+    if (ring->sqes && ring->sqes != MAP_FAILED) {
+        munmap(ring->sqes, ring->sqes_size);
+    }
+    if (ring->cq_ring && ring->cq_ring != MAP_FAILED) {
+        munmap(ring->cq_ring, ring->cq_ring_size);
+    }
+    if (ring->sq_ring && ring->sq_ring != MAP_FAILED) {
+        munmap(ring->sq_ring, ring->sq_ring_size);
+    }
+    if (ring->fd >= 0) {
+        close(ring->fd);
+    }
+    memset(ring, 0, sizeof(OmUring_t));
+    ring->fd = -1;
+}
+
+#else
+
+int om_uring_init(OmUring_t* ring, uint32_t entries, void* buffer, uint64_t buffer_size) {
+    (void)entries;
+    (void)buffer;
+    (void)buffer_size;
+    memset(ring, 0, sizeof(OmUring_t));
+    ring->fd = -1;
+    return -ENOSYS;
+}
+
+int om_uring_read(OmUring_t* ring, int fd, const OmUringRead_t* reads, uint64_t count) {
+    (void)ring;
+    (void)fd;
+    (void)reads;
+    (void)count;
+    return -ENOSYS;
+}
+
+void om_uring_destroy(OmUring_t* ring) {
+    memset(ring, 0, sizeof(OmUring_t));
+    ring->fd = -1;
+}
+
+#endif
@@ -5,6 +5,7 @@
 //  Created by Patrick Zippenfenig on 16.11.2024.
 //
 
+#include <stdlib.h>
 #include "om_variable.h"
 
 const OmVariable_t* om_variable_init(const void* src) {
@@ -90,11 +91,27 @@ OmCompression_t om_variable_get_compression(const OmVariable_t* variable) {
         case OM_MEMORY_LAYOUT_ARRAY:
         case OM_MEMORY_LAYOUT_SCALAR: {
             const OmVariableV3_t* meta = (const OmVariableV3_t*)variable;
-            return meta->compression_type;
+            return (OmCompression_t)(meta->compression_type & ~OM_COMPRESSION_FLAGS);
         }
     }
 }
 
+bool om_variable_is_adaptive(const OmVariable_t* variable) {
+    if (_om_variable_memory_layout(variable) != OM_MEMORY_LAYOUT_ARRAY) {
+        return false;
+    }
+    const OmVariableV3_t* meta = (const OmVariableV3_t*)variable;
+    return (meta->compression_type & OM_COMPRESSION_ADAPTIVE) != 0;
+}
+
+bool om_variable_is_lut_packed(const OmVariable_t* variable) {
+    if (_om_variable_memory_layout(variable) != OM_MEMORY_LAYOUT_ARRAY) {
+        return false;
+    }
+    const OmVariableV3_t* meta = (const OmVariableV3_t*)variable;
+    return (meta->compression_type & OM_COMPRESSION_LUT_PACKED) != 0;
+}
+
 OmMemoryLayout_t _om_variable_memory_layout(const OmVariable_t* variable) {
     const OmHeaderV3_t* meta = (const OmHeaderV3_t*)variable;
     bool isLegacy = meta->magic_number1 == 'O' && meta->magic_number2 == 'M' && (meta->version == 1 || meta->version == 2);
@@ -211,6 +228,132 @@ bool om_variable_get_children(const OmVariable_t* variable, uint32_t child_offse
     return true;
 }
 
+bool om_variable_get_children_range(const OmVariable_t* variable, uint64_t* offset, uint64_t* size) {
+    const uint32_t count = om_variable_get_children_count(variable);
+    if (count == 0) {
+        return false;
+    }
+    uint64_t start = UINT64_MAX;
+    uint64_t end = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        uint64_t child_offset, child_size;
+        if (!om_variable_get_children(variable, i, 1, &child_offset, &child_size)) {
+            return false;
+        }
+        start = child_offset < start ? child_offset : start;
+        end = child_offset + child_size > end ? child_offset + child_size : end;
+    }
+    *offset = start;
+    *size = end - start;
+    return true;
+}
+
+const OmVariable_t* om_variable_get_child_in_buffer(const OmVariable_t* variable, uint32_t index, const void* buffer, uint64_t buffer_offset, uint64_t buffer_size) {
+    uint64_t child_offset, child_size;
+    if (!om_variable_get_children(variable, index, 1, &child_offset, &child_size)) {
+        return NULL;
+    }
+    if (child_offset < buffer_offset || child_size > buffer_size || child_offset - buffer_offset > buffer_size - child_size) {
+        return NULL;
+    }
+    const void* child = (const uint8_t*)buffer + (child_offset - buffer_offset);
+    if (om_variable_validate(child, child_size) != ERROR_OK) {
+        return NULL;
+    }
+    return om_variable_init(child);
+}
+
+/// Size of the variable without optional name index. Only valid after `om_variable_validate`.
+static uint64_t _om_variable_size(const OmVariable_t* variable) {
+    switch (_om_variable_memory_layout(variable)) {
+        case OM_MEMORY_LAYOUT_LEGACY:
+            return 0;
+        case OM_MEMORY_LAYOUT_ARRAY: {
+            const OmVariableArrayV3_t* meta = (const OmVariableArrayV3_t*)variable;
+            return om_variable_write_numeric_array_size(meta->name_size, meta->children_count, meta->dimension_count);
+        }
+        case OM_MEMORY_LAYOUT_SCALAR: {
+            const OmVariableV3_t* meta = (const OmVariableV3_t*)variable;
+            uint64_t string_size = 0;
+            if (meta->data_type == DATA_TYPE_STRING) {
+                string_size = *(const uint64_t*)((const char*)variable + sizeof(OmVariableV3_t) + 16 * (uint64_t)meta->children_count);
+            }
+            return om_variable_write_scalar_size(meta->name_size, meta->children_count, meta->data_type, string_size);
+        }
+    }
+    return 0;
+}
+
+bool om_variable_lookup_child(const OmVariable_t* variable, uint64_t variable_size, const char* name, uint16_t name_size, bool* found, uint32_t* child_index) {
+    *found = false;
+    if (om_variable_validate(variable, variable_size) != ERROR_OK) {
+        return false;
+    }
+    const uint64_t size = _om_variable_size(variable);
+    if (size == 0) {
+        return false;
+    }
+    const uint64_t index_offset = (size + 7) / 8 * 8;
+    if (variable_size < index_offset + sizeof(OmNameIndexV3_t)) {
+        return false;
+    }
+    const OmNameIndexV3_t* index = (const OmNameIndexV3_t*)((const uint8_t*)variable + index_offset);
+    const uint32_t children_count = om_variable_get_children_count(variable);
+    if (index->magic != OM_NAME_INDEX_MAGIC || index->children_count != children_count) {
+        return false;
+    }
+    if (variable_size - index_offset < om_variable_write_name_index_size(children_count)) {
+        return false;
+    }
+    const OmNameIndexEntry_t* entries = (const OmNameIndexEntry_t*)((const uint8_t*)index + sizeof(OmNameIndexV3_t));
+    const uint64_t hash = om_variable_name_hash(name, name_size);
+
+    // Lower bound binary search
+    uint32_t lower = 0;
+    uint32_t upper = children_count;
+    while (lower < upper) {
+        const uint32_t middle = lower + (upper - lower) / 2;
+        if (entries[middle].name_hash < hash) {
+            lower = middle + 1;
+        } else {
+            upper = middle;
+        }
+    }
+    if (lower < children_count && entries[lower].name_hash == hash && entries[lower].child_index < children_count) {
+        *found = true;
+        *child_index = entries[lower].child_index;
+    }
+    return true;
+}
+
+bool om_variable_get_chunk_stats(const OmVariable_t* variable, uint64_t variable_size, uint64_t* offset, uint64_t* size) {
+    if (om_variable_validate(variable, variable_size) != ERROR_OK) {
+        return false;
+    }
+    if (_om_variable_memory_layout(variable) != OM_MEMORY_LAYOUT_ARRAY) {
+        return false;
+    }
+    uint64_t position = (_om_variable_size(variable) + 7) / 8 * 8;
+
+    // Skip the name index
+    if (variable_size >= position + sizeof(OmNameIndexV3_t)) {
+        const OmNameIndexV3_t* index = (const OmNameIndexV3_t*)((const uint8_t*)variable + position);
+        if (index->magic == OM_NAME_INDEX_MAGIC) {
+            position += om_variable_write_name_index_size(index->children_count);
+        }
+    }
+    if (variable_size < position + sizeof(OmChunkStatsIndexV3_t)) {
+        return false;
+    }
+    const OmChunkStatsIndexV3_t* stats = (const OmChunkStatsIndexV3_t*)((const uint8_t*)variable + position);
+    if (stats->magic != OM_CHUNK_STATS_MAGIC) {
+        return false;
+    }
+    *offset = stats->offset;
+    *size = stats->size;
+    return true;
+}
+
 OmError_t om_variable_get_scalar(const OmVariable_t* variable, void** value, uint64_t* size) {
     if (_om_variable_memory_layout(variable) != OM_MEMORY_LAYOUT_SCALAR) {
         return ERROR_INVALID_DATA_TYPE;
@@ -368,6 +511,57 @@ void om_variable_write_scalar(
     }
 }
 
+uint64_t om_variable_name_hash(const char* name, uint16_t name_size) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (uint16_t i = 0; i < name_size; i++) {
+        hash ^= (uint8_t)name[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+size_t om_variable_write_name_index_size(uint32_t children_count) {
+    return sizeof(OmNameIndexV3_t) + children_count * sizeof(OmNameIndexEntry_t);
+}
+
+static int _om_variable_compare_name_index_entry(const void* a, const void* b) {
+    const OmNameIndexEntry_t* lhs = (const OmNameIndexEntry_t*)a;
+    const OmNameIndexEntry_t* rhs = (const OmNameIndexEntry_t*)b;
+    if (lhs->name_hash != rhs->name_hash) {
+        return lhs->name_hash < rhs->name_hash ? -1 : 1;
+    }
+    return (lhs->child_index > rhs->child_index) - (lhs->child_index < rhs->child_index);
+}
+
+void om_variable_write_name_index(void* dst, uint32_t children_count, const uint64_t* name_hashes) {
+    *(OmNameIndexV3_t*)dst = (OmNameIndexV3_t){
+        .magic = OM_NAME_INDEX_MAGIC,
+        .children_count = children_count
+    };
+    OmNameIndexEntry_t* entries = (OmNameIndexEntry_t*)((uint8_t*)dst + sizeof(OmNameIndexV3_t));
+    for (uint32_t i = 0; i < children_count; i++) {
+        entries[i] = (OmNameIndexEntry_t){
+            .name_hash = name_hashes[i],
+            .child_index = i,
+            .reserved = 0
+        };
+    }
+    qsort(entries, children_count, sizeof(OmNameIndexEntry_t), _om_variable_compare_name_index_entry);
+}
+
+size_t om_variable_write_chunk_stats_size(void) {
+    return sizeof(OmChunkStatsIndexV3_t);
+}
+
+void om_variable_write_chunk_stats(void* dst, uint64_t offset, uint64_t size) {
+    *(OmChunkStatsIndexV3_t*)dst = (OmChunkStatsIndexV3_t){
+        .magic = OM_CHUNK_STATS_MAGIC,
+        .reserved = 0,
+        .offset = offset,
+        .size = size
+    };
+}
+
 size_t om_variable_write_numeric_array_size(uint16_t name_size, uint32_t children_count, uint64_t dimension_count) {
     return sizeof(OmVariableArrayV3_t) + name_size + children_count * 16 + dimension_count * 16;
 }
@@ -61,8 +61,9 @@ fn configure_build_flags(build: &mut cc::Build, config: &BuildConfig, compiler:
                 if config.is_windows && compiler.is_like_msvc() {
                     // No special flags needed for MSVC atm
                 } else {
-                    // x86-64-v3 has AVX2 (2013 Haswell Architecture) and should be a safe and performant baseline
-                    build.flag("-march=x86-64-v3");
+                    // x86-64-v2 (SSE4.2, 2009 Nehalem Architecture) is a portable baseline. Kernels for
+                    // x86-64-v3 (AVX2, BMI2) are compiled as well and selected at runtime, see `om_dispatch.h`.
+                    build.flag("-march=x86-64-v2");
                 }
             }
             _ => {